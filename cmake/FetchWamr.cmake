@@ -4,6 +4,10 @@ cmake_minimum_required(VERSION 3.14)
 include(FetchContent)
 
 # WAMR build configuration
+#
+# The firmware modules lower setjmp/longjmp (Lua error handling) to wasm
+# exception handling, which WAMR only implements in the classic
+# interpreter: neither the fast interpreter nor AOT (wamrc) can run them.
 set(WAMR_BUILD_INTERP 1)
 set(WAMR_BUILD_FAST_INTERP 0)
 set(WAMR_BUILD_AOT 0)
@@ -28,8 +28,11 @@
 #include "yaml_generalsettings.h"
 #include "yaml_modeldata.h"
 #include "labelvalidator.h"
+#include "semanticversion.h"
+#include "version.h"
 
 #include <QMessageBox>
+#include <QRegularExpression>
 
 
 static uint16_t calculateChecksum(const QByteArray& data, uint16_t checksum)
@@ -138,6 +141,31 @@ bool loadModelFromYaml(ModelData& model, const QByteArray& data)
   return true;
 }
 
+bool isNewerModelVersion(const QByteArray& data)
+{
+  static const QRegularExpression semverRe("^semver:\\s*\"?([0-9A-Za-z.+-]+)\"?\\s*$");
+
+  // top level key, anywhere in the file: at the start of a line
+  int start = data.startsWith("semver:") ? 0 : data.indexOf("\nsemver:");
+  if (start < 0)
+    return false;
+  if (start > 0)
+    start++;
+
+  int end = data.indexOf('\n', start);
+  const QByteArray line = data.mid(start, end < 0 ? -1 : end - start);
+
+  QRegularExpressionMatch match = semverRe.match(QString::fromUtf8(line));
+  if (!match.hasMatch())
+    return false;
+
+  const QString semver = match.captured(1);
+  if (!SemanticVersion().isValid(semver))
+    return false;
+
+  return SemanticVersion(semver) > SemanticVersion(VERSION);
+}
+
 bool loadRadioSettingsFromYaml(GeneralSettings& settings, const QByteArray& data)
 {
     if(data.indexOf("checksum:") == 0) {
@@ -191,11 +219,20 @@ bool writeLabelsListToYaml(const RadioData &radioData, QByteArray& data)
 
 bool writeModelToYaml(const ModelData& model, QByteArray& data)
 {
-  YAML::Node node;
-  node = model;
+  // streamed without node tree, into a buffer reused from one model to the next
+  static thread_local std::string buffer;
+  buffer.clear();
+
+  YamlStringStream os(buffer);
+  bool ok;
+  {
+    YamlWriter writer(os);
+    YamlWriteModel(writer, model);
+    ok = writer.good();
+  }
 
-  writeYamlToByteArray(node, data);
-  return true;
+  data = QByteArray(buffer.data(), (int)buffer.size());
+  return ok;
 }
 
 bool writeRadioSettingsToYaml(const GeneralSettings& settings, QByteArray& data)
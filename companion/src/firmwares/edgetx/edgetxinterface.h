@@ -44,6 +44,10 @@ bool loadLabelsListFromYaml(RadioData::ModelLabels& labels,
                             const QByteArray& data);
 
 bool loadModelFromYaml(ModelData& model, const QByteArray& data);
+
+// Models written by a newer firmware prompt the user while decoding,
+// which must happen on the GUI thread.
+bool isNewerModelVersion(const QByteArray& data);
 bool loadRadioSettingsFromYaml(GeneralSettings& settings, const QByteArray& data);
 
 bool writeLabelsListToYaml(const RadioData &radioData, QByteArray& data);
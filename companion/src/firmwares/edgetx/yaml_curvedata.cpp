@@ -53,8 +53,9 @@ void YamlReadCurvePoints(const YAML::Node& node, CurveData* curves)
   }
 }
 
-void YamlWriteCurvePoints(YAML::Node& node, const CurveData* curves)
+void YamlWriteCurvePoints(YamlWriter& w, const CurveData* curves)
 {
+  YamlOptionalBlock points(w, "points");
   int pidx = 0;
   for (int i = 0; i < CPN_MAX_CURVES; i++) {
 
@@ -64,11 +65,11 @@ void YamlWriteCurvePoints(YAML::Node& node, const CurveData* curves)
     const CurveData& curve = curves[i];
     if (!curve.isEmpty()) {
       for (int k = 0; k < curve.count; k++) {
-        node[std::to_string(pidx++)]["val"] = (int)curve.points[k].y;
+        points.next(pidx++).beginMap().key("val").value((int)curve.points[k].y).endMap();
       }
       if (curve.type == CurveData::CURVE_TYPE_CUSTOM) {
         for (int k = 1; k < curve.count - 1; k++) {
-          node[std::to_string(pidx++)]["val"] = (int)curve.points[k].x;
+          points.next(pidx++).beginMap().key("val").value((int)curve.points[k].x).endMap();
         }
       }
     } else {
@@ -77,16 +78,21 @@ void YamlWriteCurvePoints(YAML::Node& node, const CurveData* curves)
   }
 }
 
+void YamlWrite(YamlWriter& w, const CurveData& rhs)
+{
+  w.beginMap();
+  w.key("type").value((int)rhs.type);
+  w.key("smooth").value((int)rhs.smooth);
+  w.key("points").value(rhs.count - 5);
+  w.key("name").value(rhs.name);
+  w.endMap();
+}
+
 namespace YAML
 {
 Node convert<CurveData>::encode(const CurveData& rhs)
 {
-  Node node;
-  node["type"] = (int)rhs.type;
-  node["smooth"] = (int)rhs.smooth;
-  node["points"] = rhs.count - 5;
-  node["name"] = rhs.name;
-  return node;
+  return YamlWriteNode([&](YamlWriter& w) { YamlWrite(w, rhs); });
 }
 
 bool convert<CurveData>::decode(const Node& node, CurveData& rhs)
@@ -20,10 +20,12 @@
  */
 
 #include "yaml_ops.h"
+#include "yaml_writer.h"
 #include "curvedata.h"
 
 void YamlReadCurvePoints(const YAML::Node& node, CurveData* curves);
-void YamlWriteCurvePoints(YAML::Node& node, const CurveData* curves);
+void YamlWriteCurvePoints(YamlWriter& w, const CurveData* curves);
+void YamlWrite(YamlWriter& w, const CurveData& rhs);
 
 namespace YAML
 {
@@ -25,23 +25,29 @@
 #include "yaml_rawsource.h"
 #include "curvereference.h"
 
+// Also builds the node of convert<ExpoData>::encode()
+void YamlWrite(YamlWriter& w, const ExpoData& rhs)
+{
+  w.beginMap();
+  w.key("srcRaw").value(rhs.srcRaw);
+  w.key("scale").value(rhs.scale);
+  w.key("mode").value(rhs.mode);  // InputMode
+  w.key("chn").value(rhs.chn);
+  w.key("swtch").value(rhs.swtch);
+  w.key("flightModes").value(YamlWriteFlightModes(rhs.flightModes));
+  w.key("weight").value(YamlSourceNumRefEncode(rhs.weight));
+  w.key("offset").value(YamlSourceNumRefEncode(rhs.offset));
+  YamlWrite(w.key("curve"), rhs.curve);
+  w.key("trimSource").value(rhs.carryTrim); // temporary for 2.8.1, trimSource in 2.9
+  w.key("name").value(rhs.name);
+  w.endMap();
+}
+
 namespace YAML
 {
 Node convert<ExpoData>::encode(const ExpoData& rhs)
 {
-  Node node;
-  node["srcRaw"] = rhs.srcRaw;
-  node["scale"] = rhs.scale;
-  node["mode"] = rhs.mode;  // InputMode
-  node["chn"] = rhs.chn;
-  node["swtch"] = rhs.swtch;
-  node["flightModes"] = YamlWriteFlightModes(rhs.flightModes);
-  node["weight"] = YamlSourceNumRefEncode(rhs.weight);
-  node["offset"] = YamlSourceNumRefEncode(rhs.offset);
-  node["curve"] = rhs.curve;
-  node["trimSource"] = rhs.carryTrim; // temporary for 2.8.1, trimSource in 2.9
-  node["name"] = rhs.name;
-  return node;
+  return YamlWriteNode([&](YamlWriter& w) { YamlWrite(w, rhs); });
 }
 
 bool convert<ExpoData>::decode(const Node& node, ExpoData& rhs)
@@ -20,8 +20,11 @@
  */
 
 #include "yaml_ops.h"
+#include "yaml_writer.h"
 #include "input_data.h"
 
+void YamlWrite(YamlWriter& w, const ExpoData& rhs);
+
 namespace YAML
 {
 template <>
@@ -63,13 +63,8 @@ static int lswTimerValue(int val)
   return (val < -109 ? 129+val : (val < 7 ? (113+val)*5 : (53+val)*10));
 }
 
-namespace YAML
-{
-Node convert<LogicalSwitchData>::encode(const LogicalSwitchData& rhs)
+static std::string lswDefinition(const LogicalSwitchData& rhs)
 {
-  Node node;
-  node["func"] = funcLut << rhs.func;
-
   std::string def;
 
   switch (rhs.getFunctionFamily()) {
@@ -113,14 +108,28 @@ Node convert<LogicalSwitchData>::encode(const LogicalSwitchData& rhs)
   } break;
   }
 
-  node["def"] = def;
-  node["delay"] = rhs.delay;
-  node["duration"] = rhs.duration;
-  node["andsw"] = YamlRawSwitchEncode(RawSwitch(rhs.andsw));
-  node["lsPersist"] = (int)rhs.lsPersist;
-  node["lsState"] = (int)rhs.lsState;
+  return def;
+}
+
+// Also builds the node of convert<LogicalSwitchData>::encode()
+void YamlWrite(YamlWriter& w, const LogicalSwitchData& rhs)
+{
+  w.beginMap();
+  w.key("func").lookup(funcLut, rhs.func);
+  w.key("def").value(lswDefinition(rhs));
+  w.key("delay").value(rhs.delay);
+  w.key("duration").value(rhs.duration);
+  w.key("andsw").value(YamlRawSwitchEncode(RawSwitch(rhs.andsw)));
+  w.key("lsPersist").value((int)rhs.lsPersist);
+  w.key("lsState").value((int)rhs.lsState);
+  w.endMap();
+}
 
-  return node;
+namespace YAML
+{
+Node convert<LogicalSwitchData>::encode(const LogicalSwitchData& rhs)
+{
+  return YamlWriteNode([&](YamlWriter& w) { YamlWrite(w, rhs); });
 }
 
 bool convert<LogicalSwitchData>::decode(const Node& node,
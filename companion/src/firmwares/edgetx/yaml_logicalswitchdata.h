@@ -20,8 +20,11 @@
  */
 
 #include "yaml_ops.h"
+#include "yaml_writer.h"
 #include "logicalswitchdata.h"
 
+void YamlWrite(YamlWriter& w, const LogicalSwitchData& rhs);
+
 namespace YAML
 {
 template <>
@@ -111,16 +111,46 @@ std::string YamlWriteFlightModes(uint32_t val)
 
 static const YamlLookupTable dummy = {};
 
+// Also build the nodes of convert<CurveReference> and convert<MixData>
+
+void YamlWrite(YamlWriter& w, const CurveReference& rhs)
+{
+  w.beginMap();
+  w.key("type").value((int)rhs.type);
+  w.key("value").value(YamlSourceNumRefEncode(rhs.value));
+  w.endMap();
+}
+
+void YamlWrite(YamlWriter& w, const MixData& rhs)
+{
+  w.beginMap();
+  w.key("destCh").value(rhs.destCh - 1);
+  w.key("srcRaw").value(rhs.srcRaw);
+  w.key("weight").value(YamlSourceNumRefEncode(rhs.weight));
+  w.key("swtch").value(rhs.swtch);
+  YamlWrite(w.key("curve"), rhs.curve);
+  w.key("delayPrec").value(rhs.delayPrec);
+  w.key("delayUp").value(rhs.delayUp);
+  w.key("delayDown").value(rhs.delayDown);
+  w.key("speedPrec").value(rhs.speedPrec);
+  w.key("speedUp").value(rhs.speedUp);
+  w.key("speedDown").value(rhs.speedDown);
+  w.key("carryTrim").value(rhs.carryTrim);
+  w.key("mltpx").lookup(mixMultiplexLut, rhs.mltpx);
+  w.key("mixWarn").value(rhs.mixWarn);
+  w.key("flightModes").value(YamlWriteFlightModes(rhs.flightModes));
+  w.key("offset").value(YamlSourceNumRefEncode(rhs.sOffset));
+  w.key("name").value(rhs.name);
+  w.endMap();
+}
+
 namespace YAML
 {
 ENUM_CONVERTER(MltpxValue, mixMultiplexLut);
 
 Node convert<CurveReference>::encode(const CurveReference& rhs)
 {
-  Node node;
-  node["type"] = (int)rhs.type;
-  node["value"] = YamlSourceNumRefEncode(rhs.value);
-  return node;
+  return YamlWriteNode([&](YamlWriter& w) { YamlWrite(w, rhs); });
 }
 
 bool convert<CurveReference>::decode(const Node& node, CurveReference& rhs)
@@ -137,25 +167,7 @@ bool convert<CurveReference>::decode(const Node& node, CurveReference& rhs)
 
 Node convert<MixData>::encode(const MixData& rhs)
 {
-  Node node;
-  node["destCh"] = rhs.destCh - 1;
-  node["srcRaw"] = rhs.srcRaw;
-  node["weight"] = YamlSourceNumRefEncode(rhs.weight);
-  node["swtch"] = rhs.swtch;
-  node["curve"] = rhs.curve;
-  node["delayPrec"] = rhs.delayPrec;
-  node["delayUp"] = rhs.delayUp;
-  node["delayDown"] = rhs.delayDown;
-  node["speedPrec"] = rhs.speedPrec;
-  node["speedUp"] = rhs.speedUp;
-  node["speedDown"] = rhs.speedDown;
-  node["carryTrim"] = rhs.carryTrim;
-  node["mltpx"] = rhs.mltpx;
-  node["mixWarn"] = rhs.mixWarn;
-  node["flightModes"] = YamlWriteFlightModes(rhs.flightModes);
-  node["offset"] = YamlSourceNumRefEncode(rhs.sOffset);
-  node["name"] = rhs.name;
-  return node;
+  return YamlWriteNode([&](YamlWriter& w) { YamlWrite(w, rhs); });
 }
 
 bool convert<MixData>::decode(const Node& node, MixData& rhs)
@@ -20,6 +20,7 @@
  */
 
 #include "yaml_ops.h"
+#include "yaml_writer.h"
 #include "mixdata.h"
 
 int32_t YamlSourceNumRefDecode(const YAML::Node& node);
@@ -28,6 +29,9 @@ std::string YamlSourceNumRefEncode(int32_t sval);
 uint32_t YamlReadFlightModes(const YAML::Node& node);
 std::string YamlWriteFlightModes(uint32_t val);
 
+void YamlWrite(YamlWriter& w, const CurveReference& rhs);
+void YamlWrite(YamlWriter& w, const MixData& rhs);
+
 
 namespace YAML
 {
@@ -41,8 +41,10 @@
 #include "helpers.h"
 
 #include <string>
+#include <QApplication>
 #include <QMessageBox>
 #include <QPushButton>
+#include <QThread>
 
 void YamlValidateLabelsNames(ModelData& model, Board::Type board)
 {
@@ -464,10 +466,10 @@ void operator >> (const YAML::Node& node, FlightModeData& value)
 
 namespace YAML
 {
-Node convert<TimerData>::encode(const TimerData& rhs)
+static void encodeTimerBeeps(const TimerData& rhs, unsigned int& countdownBeep,
+                             unsigned int& extraHaptic)
 {
-  unsigned int countdownBeep = rhs.countdownBeep;
-  unsigned int extraHaptic = rhs.extraHaptic;
+  countdownBeep = rhs.countdownBeep;
   if (countdownBeep > TimerData::COUNTDOWNBEEP_VOICE + 1) {
     extraHaptic = 1;
     countdownBeep -= TimerData::COUNTDOWNBEEP_VOICE + 1;
@@ -475,19 +477,6 @@ Node convert<TimerData>::encode(const TimerData& rhs)
   else {
     extraHaptic = 0;
   }
-  Node node;
-  node["swtch"] = rhs.swtch;
-  node["mode"] = timerModeLut << rhs.mode;
-  node["name"] = rhs.name;
-  node["minuteBeep"] = (int)rhs.minuteBeep;
-  node["countdownBeep"] = countdownBeep;
-  node["start"] = rhs.val;
-  node["persistent"] = rhs.persistent;
-  node["countdownStart"] = rhs.countdownStart;
-  node["value"] = rhs.pvalue;
-  node["showElapsed"] = rhs.showElapsed;
-  node["extraHaptic"] = extraHaptic;
-  return node;
 }
 
 bool convert<TimerData>::decode(const Node& node, TimerData& rhs)
@@ -570,21 +559,6 @@ static std::string YamlWriteLimitValue(int32_t sval, int32_t shift = 0)
 
 template <>
 struct convert<LimitData> {
-  static Node encode(const LimitData& rhs)
-  {
-    Node node;
-    node["min"] = YamlWriteLimitValue(rhs.min, -1000);
-    node["max"] = YamlWriteLimitValue(rhs.max, 1000);
-    node["revert"] = (int)rhs.revert;
-    node["offset"] = YamlWriteLimitValue(rhs.offset);
-    node["ppmCenter"] = rhs.ppmCenter;
-    node["symetrical"] = (int)rhs.symetrical;
-    node["name"] = rhs.name;
-    node["curve"] = rhs.curve.value;
-    // rhs.curve.type is not encoded
-    return node;
-  }
-
   static bool decode(const Node& node, LimitData& rhs)
   {
     if (node["min"]) {
@@ -608,19 +582,6 @@ struct convert<LimitData> {
 
 template <>
 struct convert<YamlTrim> {
-  static Node encode(const YamlTrim& rhs)
-  {
-    Node node;
-    node["value"] = rhs.value;
-    if (rhs.mode < 0) {
-      node["mode"] = (1 << 5) - 1;
-    } else if (rhs.mode == TRIM_MODE_3POS) {
-      node["mode"] = TRIM_MODE_3POS;
-    } else {
-      node["mode"] = 2 * rhs.ref + rhs.mode;
-    }
-    return node;
-  }
   static bool decode(const Node& node, YamlTrim& rhs)
   {
     node["value"] >> rhs.value;
@@ -639,43 +600,6 @@ struct convert<YamlTrim> {
   }
 };
 
-Node EncodeFMData(const FlightModeData& rhs, int phaseIdx)
-{
-    Node node;
-
-    size_t n_trims = Boards::getCapability(getCurrentBoard(), Board::NumTrims);
-
-    Node trims;
-    for (size_t i=0; i<n_trims; i++) {
-      YamlTrim yt = { rhs.trimMode[i], rhs.trimRef[i], rhs.trim[i] };
-      if (!yt.isEmpty()) {
-        trims[std::to_string(i)] = yt;
-      }
-    }
-    if (trims && trims.IsMap()) {
-      node["trim"] = trims;
-    }
-
-    if (phaseIdx > 0) {
-      node["swtch"] = rhs.swtch;
-    }
-    node["name"] = rhs.name;
-    node["fadeIn"] = rhs.fadeIn;
-    node["fadeOut"] = rhs.fadeOut;
-
-    Node gvars;
-    for (size_t i=0; i<CPN_MAX_GVARS; i++) {
-      if (!rhs.isGVarEmpty(phaseIdx, i)) {
-        gvars[std::to_string(i)]["val"] = rhs.gvars[i];
-      }
-    }
-    if (gvars && gvars.IsMap()) {
-      node["gvars"] = gvars;
-    }
-
-    return node;
-}
-
 bool convert<FlightModeData>::decode(const Node& node,
                                      FlightModeData& rhs)
 {
@@ -726,18 +650,6 @@ struct convert<SwashRingData> {
 
 template <>
 struct convert<GVarData> {
-  static Node encode(const GVarData& rhs)
-  {
-    Node node;
-    node["name"] = rhs.name;
-    node["min"] = rhs.min;
-    node["max"] = rhs.max;
-    node["popup"] = (int)rhs.popup;
-    node["prec"] = rhs.prec;
-    node["unit"] = rhs.unit;
-    return node;
-  }
-
   static bool decode(const Node& node, GVarData& rhs)
   {
     node["name"] >> rhs.name;
@@ -798,13 +710,6 @@ struct RFAlarms {
 
 template <>
 struct convert<RFAlarms> {
-  static Node encode(const RFAlarms& rhs)
-  {
-    Node node;
-    node["warning"] = rhs.warning;
-    node["critical"] = rhs.critical;
-    return node;
-  }
   static bool decode(const Node& node, RFAlarms& rhs)
   {
     node["warning"] >> rhs.warning;
@@ -834,13 +739,6 @@ struct YamlTelemSource {
 
 template <>
 struct convert<YamlTelemSource> {
-  static Node encode(const YamlTelemSource& rhs)
-  {
-    if (rhs.src == 0)
-      return Node("none");
-    return Node(rhs.src - 1);
-  }
-
   static bool decode(const Node& node, YamlTelemSource& rhs)
   {
     if (node && node.IsScalar()) {
@@ -1024,292 +922,6 @@ bool convert<CustomSwitchData>::decode(const Node& node, CustomSwitchData& rhs)
   return true;
 }
 
-Node convert<ModelData>::encode(const ModelData& rhs)
-{
-  modelSettingsVersion = SemanticVersion(VERSION);
-
-  Node node;
-  auto firmware = getCurrentFirmware();
-  auto board = firmware->getBoard();
-
-  bool hasColorLcd = Boards::getCapability(board, Board::HasColorLcd);
-
-  node["semver"] = VERSION;
-
-  Node header;
-  header["name"] = rhs.name;
-  header["bitmap"] = rhs.bitmap;
-  header["labels"] = rhs.labels;
-
-  for (int i=0; i<CPN_MAX_MODULES; i++) {
-    if (rhs.moduleData[i].protocol != PULSES_OFF) {
-      header["modelId"][std::to_string(i)]["val"] = rhs.moduleData[i].modelId;
-    }
-  }
-  node["header"] = header;
-
-  Node timers;
-  for (int i=0; i<CPN_MAX_TIMERS; i++) {
-    if (!rhs.timers[i].isEmpty()) {
-      timers[std::to_string(i)] = rhs.timers[i];
-    }
-  }
-  if (timers && timers.IsMap()) {
-    node["timers"] = timers;
-  }
-
-  node["noGlobalFunctions"] = (int)rhs.noGlobalFunctions;
-  node["thrTrim"] = (int)rhs.thrTrim;
-  node["trimInc"] = rhs.trimInc;
-  node["displayTrims"] = rhs.trimsDisplay;
-  node["ignoreSensorIds"] = (int)rhs.frsky.ignoreSensorIds;
-  node["showInstanceIds"] = (int)rhs.showInstanceIds;
-  node["disableThrottleWarning"] = (int)rhs.disableThrottleWarning;
-  node["enableCustomThrottleWarning"] = (int)rhs.enableCustomThrottleWarning;
-  node["customThrottleWarningPosition"] = (int)rhs.customThrottleWarningPosition;
-  YamlBeepANACenter beepCenter(rhs.beepANACenter);
-  node["beepANACenter"] = beepCenter.value;
-  node["extendedLimits"] = (int)rhs.extendedLimits;
-  node["extendedTrims"] = (int)rhs.extendedTrims;
-  node["throttleReversed"] = (int)rhs.throttleReversed;
-  node["checklistInteractive"] = (int)rhs.checklistInteractive;
-
-  for (int i = 0; i < CPN_MAX_FLIGHT_MODES; i++) {
-    if (!rhs.flightModeData[i].isEmpty(i)) {
-      node["flightModeData"][std::to_string(i)] =
-          EncodeFMData(rhs.flightModeData[i], i);
-    }
-  }
-
-  for (int i = 0; i < CPN_MAX_MIXERS; i++) {
-    const MixData& mix = rhs.mixData[i];
-    if (!mix.isEmpty()) {
-      node["mixData"].push_back(Node(mix));
-    }
-  }
-
-  for (int i = 0; i < CPN_MAX_CHNOUT; i++) {
-    const LimitData& limit = rhs.limitData[i];
-    if (!limit.isEmpty()) {
-      node["limitData"][std::to_string(i)] = limit;
-    }
-  }
-
-  std::set<int> inputs;
-  for (int i = 0; i < CPN_MAX_EXPOS; i++) {
-    const ExpoData& expo = rhs.expoData[i];
-    if (!expo.isEmpty()) {
-      Node expoNode;
-      expoNode = expo;
-      node["expoData"].push_back(expoNode);
-      inputs.insert(expo.chn);
-    }
-  }
-
-  for (auto input : inputs) {
-    if (rhs.inputNames[input][0]) {
-      node["inputNames"][std::to_string(input)]["val"] = rhs.inputNames[input];
-    }
-  }
-
-  for (int i = 0; i < CPN_MAX_CURVES; i++) {
-    const CurveData& curve = rhs.curves[i];
-    if (!curve.isEmpty()) {
-      node["curves"][std::to_string(i)] = curve;
-    }
-  }
-
-  YAML::Node points;
-  YamlWriteCurvePoints(points, rhs.curves);
-  if (points && (points.IsMap() || points.IsSequence())) {
-    node["points"] = points;
-  }
-
-  for (int i = 0; i < CPN_MAX_LOGICAL_SWITCHES; i++) {
-    const LogicalSwitchData& ls = rhs.logicalSw[i];
-    if (!ls.isEmpty()) {
-      node["logicalSw"][std::to_string(i)] = ls;
-    }
-  }
-
-  for (int i = 0; i < CPN_MAX_SPECIAL_FUNCTIONS; i++) {
-    const CustomFunctionData& fn = rhs.customFn[i];
-    if (!fn.isEmpty()) {
-      node["customFn"][std::to_string(i)] = fn;
-    }
-  }
-
-  if (getCurrentFirmware()->getCapability(Heli))
-    node["swashR"] = rhs.swashRingData;
-
-  YamlThrTrace thrTrace(rhs.thrTraceSrc);
-  node["thrTraceSrc"] = thrTrace.src;
-
-  Node sw_warn;
-  YamlSwitchWarning switchWarning(sw_warn, rhs.switchWarningStates);
-  if (sw_warn && sw_warn.IsMap()) {
-    node["switchWarning"] = sw_warn;
-  }
-
-  node["thrTrimSw"] = rhs.thrTrimSwitch;
-  node["potsWarnMode"] = potsWarningModeLut << rhs.potsWarningMode;
-  YamlPotsWarnEnabled potsWarnEnabled(&rhs.potsWarnEnabled[0]);
-  node["potsWarnEnabled"] = potsWarnEnabled.value;
-
-  node["jitterFilter"] = globalOnOffFilterLut << rhs.jitterFilter;
-
-  for (int i = 0; i < CPN_MAX_POTS + CPN_MAX_SLIDERS; i++) {
-    if (rhs.potsWarnPosition[i] != 0)
-      node["potsWarnPosition"][std::to_string(i)]["val"] = rhs.potsWarnPosition[i];
-  }
-
-  node["displayChecklist"] = (int)rhs.displayChecklist;
-
-  for (int i = 0; i < CPN_MAX_GVARS; i++) {
-    const GVarData& gv = rhs.gvarData[i];
-    if (!gv.isEmpty()) {
-      node["gvars"][std::to_string(i)] = gv;
-    }
-  }
-
-  // mavlink ???
-
-  node["telemetryProtocol"] = rhs.telemetryProtocol;
-
-  if (!IS_FAMILY_HORUS_OR_T16(board)) {
-    Node screens;
-    for (int i=0; i<4; i++) {
-      const auto& scr = rhs.frsky.screens[i];
-      if (scr.type != TELEMETRY_SCREEN_NONE) {
-        screens[std::to_string(i)] = rhs.frsky.screens[i];
-      }
-    }
-    if (screens.IsMap()) {
-      node["screens"] = screens;
-    }
-  }
-
-  Node vario;
-  vario["source"] = YamlTelemSource(rhs.frsky.varioSource);
-  vario["centerSilent"] = (int)rhs.frsky.varioCenterSilent;
-  vario["centerMax"] = rhs.frsky.varioCenterMax;
-  vario["centerMin"] = rhs.frsky.varioCenterMin;
-  vario["min"] = rhs.frsky.varioMin;
-  vario["max"] = rhs.frsky.varioMax;
-
-  node["varioData"] = vario;
-  node["rssiSource"] = YamlTelemSource(rhs.rssiSource);
-
-  if (IS_TARANIS_X9(board)) {
-    node["voltsSource"] = YamlTelemSource(rhs.frsky.voltsSource);
-    node["altitudeSource"] = YamlTelemSource(rhs.frsky.altitudeSource);
-  }
-
-  node["rfAlarms"] = RFAlarms(rhs.rssiAlarms);
-  node["disableTelemetryWarning"] = (int)rhs.rssiAlarms.disabled;
-
-  for (int i=0; i<CPN_MAX_MODULES; i++) {
-    if (rhs.moduleData[i].protocol != PULSES_OFF) {
-      node["moduleData"][std::to_string(i)] = rhs.moduleData[i];
-    }
-  }
-
-  for (int i=0; i<CPN_MAX_CHNOUT; i++) {
-    if (rhs.limitData[i].failsafe != 0) {
-      node["failsafeChannels"][std::to_string(i)]["val"] = rhs.limitData[i].failsafe;
-    }
-  }
-
-  node["trainerData"]["mode"] = trainerModeLut << rhs.trainerMode;
-  node["trainerData"]["channelsStart"] = rhs.moduleData[2].channelsStart;
-  node["trainerData"]["channelsCount"] = (rhs.moduleData[2].channelsCount - 8);
-  node["trainerData"]["frameLength"] = rhs.moduleData[2].ppm.frameLength;
-  node["trainerData"]["delay"] = ((rhs.moduleData[2].ppm.delay - 300) / 50);
-  node["trainerData"]["pulsePol"] = (int)rhs.moduleData[2].ppm.pulsePol;
-
-  for (int i=0; i<CPN_MAX_SCRIPTS; i++) {
-    if (strlen(rhs.scriptData[i].filename) > 0) {
-      node["scriptsData"][std::to_string(i)] = rhs.scriptData[i];
-    }
-  }
-
-  for (int i=0; i<CPN_MAX_SENSORS; i++) {
-    if (!rhs.sensorData[i].isEmpty()) {
-      node["telemetrySensors"][std::to_string(i)] = rhs.sensorData[i];
-    }
-  }
-
-  if (IS_TARANIS_X9E(board)) {
-    node["toplcdTimer"] = rhs.toplcdTimer;
-  }
-
-  if (Boards::getCapability(board, Board::HasColorLcd)) {
-    for (int i = 0; i < MAX_CUSTOM_SCREENS; i++) {
-      const auto& csd = rhs.customScreens.customScreenData[i];
-      if (!csd.isEmpty()) {
-        node["screenData"][std::to_string(i)] = csd;
-      }
-    }
-    Node topbarData;
-    topbarData = rhs.topBarData;
-    if (topbarData && topbarData.IsMap()) {
-      node["topbarData"] = topbarData;
-    }
-    for (int i = 0; i < firmware->getCapability(TopBarZones); i++) {
-      if (rhs.topbarWidgetWidth[i] > 0) {
-        node["topbarWidgetWidth"][std::to_string(i)]["val"] = (int)rhs.topbarWidgetWidth[i];
-      }
-    }
-    node["view"] = rhs.view;
-  }
-
-  node["modelRegistrationID"] = rhs.registrationId;
-  node["hatsMode"] = hatsModeLut << rhs.hatsMode;
-
-  int funcSwCnt = Boards::getCapability(board, Board::FunctionSwitches);
-  if (funcSwCnt) {
-    for (int i = 0; i < funcSwCnt; i++) {
-      int sw = Boards::getSwitchIndexForCFS(i);
-      std::string tag = Boards::getSwitchYamlName(sw, BoardJson::YLT_CONFIG).toStdString();
-      node["customSwitches"][tag] = rhs.customSwitches[i];
-    }
-
-    int funcSwGrps = Boards::getCapability(board, Board::FunctionSwitchGroups);
-    if (funcSwGrps) {
-      for (int i = 1; i <= funcSwGrps; i++) {
-        node["cfsGroupOn"][std::to_string(i)]["v"] = rhs.cfsGroupOn[i];
-      }
-    }
-  }
-
-  // Custom USB joytsick mapping
-  node["usbJoystickExtMode"] = rhs.usbJoystickExtMode;
-  node["usbJoystickIfMode"] = usbJoystickIfModeLut << rhs.usbJoystickIfMode;
-  node["usbJoystickCircularCut"] = rhs.usbJoystickCircularCut;
-  for (int i = 0; i < CPN_USBJ_MAX_JOYSTICK_CHANNELS; i++) {
-    if (rhs.usbJoystickCh[i].mode > 0) {
-      node["usbJoystickCh"][std::to_string(i)] = rhs.usbJoystickCh[i];
-    }
-  }
-
-  // Radio level tabs control (global settings)
-  if (hasColorLcd)
-    node["radioThemesDisabled"] = globalOnOffFilterLut << rhs.radioThemesDisabled;
-  node["radioGFDisabled"] = globalOnOffFilterLut << rhs.radioGFDisabled;
-  node["radioTrainerDisabled"] = globalOnOffFilterLut << rhs.radioTrainerDisabled;
-  // Model level tabs control (global setting)
-  node["modelHeliDisabled"] = globalOnOffFilterLut << rhs.modelHeliDisabled;
-  node["modelFMDisabled"] = globalOnOffFilterLut << rhs.modelFMDisabled;
-  node["modelCurvesDisabled"] = globalOnOffFilterLut << rhs.modelCurvesDisabled;
-  node["modelGVDisabled"] = globalOnOffFilterLut << rhs.modelGVDisabled;
-  node["modelLSDisabled"] = globalOnOffFilterLut << rhs.modelLSDisabled;
-  node["modelSFDisabled"] = globalOnOffFilterLut << rhs.modelSFDisabled;
-  node["modelCustomScriptsDisabled"] = globalOnOffFilterLut << rhs.modelCustomScriptsDisabled;
-  node["modelTelemetryDisabled"] = globalOnOffFilterLut << rhs.modelTelemetryDisabled;
-
-  return node;
-}
-
 bool convert<ModelData>::decode(const Node& node, ModelData& rhs)
 {
   if (!node.IsMap()) return false;
@@ -1353,6 +965,12 @@ bool convert<ModelData>::decode(const Node& node, ModelData& rhs)
         SemanticVersion(VERSION) < SemanticVersion("3.0.0")) {
       qDebug() << "Version exception override: radio settings" << modelSettingsVersion.toString()
                << "Companion" << SemanticVersion(VERSION).toString();
+    } else if (!qobject_cast<QApplication *>(QCoreApplication::instance()) ||
+               QThread::currentThread() != QCoreApplication::instance()->thread()) {
+      // no one to ask: worker threads and command line tools decline
+      qDebug() << "Unsupported model settings version" << modelSettingsVersion.toString()
+               << "declined without GUI";
+      return false;
     } else {
       QString prmpt = QCoreApplication::translate("YamlModelSettings", "Warning: '%1' has settings version %2 that is not supported by Companion %3!\n\nModel settings may be corrupted if you continue.");
       prmpt = prmpt.arg(rhs.name.toQString()).arg(modelSettingsVersion.toString()).arg(SemanticVersion(VERSION).toString());
@@ -1687,3 +1305,460 @@ bool convert<ModelData>::decode(const Node& node, ModelData& rhs)
 }
 
 }  // namespace YAML
+
+//
+// Model encoder: streamed without building the node tree first, the
+// convert<> encode() of the same types are built from it. The parts
+// seldom used still go through their (small) nodes.
+//
+
+static void YamlWrite(YamlWriter& w, const TimerData& rhs)
+{
+  unsigned int countdownBeep, extraHaptic;
+  YAML::encodeTimerBeeps(rhs, countdownBeep, extraHaptic);
+
+  w.beginMap();
+  w.key("swtch").value(rhs.swtch);
+  w.key("mode").lookup(timerModeLut, rhs.mode);
+  w.key("name").value(rhs.name);
+  w.key("minuteBeep").value((int)rhs.minuteBeep);
+  w.key("countdownBeep").value(countdownBeep);
+  w.key("start").value(rhs.val);
+  w.key("persistent").value(rhs.persistent);
+  w.key("countdownStart").value(rhs.countdownStart);
+  w.key("value").value(rhs.pvalue);
+  w.key("showElapsed").value(rhs.showElapsed);
+  w.key("extraHaptic").value(extraHaptic);
+  w.endMap();
+}
+
+static void YamlWrite(YamlWriter& w, const YamlTrim& rhs)
+{
+  w.beginMap();
+  w.key("value").value(rhs.value);
+  if (rhs.mode < 0) {
+    w.key("mode").value((1 << 5) - 1);
+  } else if (rhs.mode == TRIM_MODE_3POS) {
+    w.key("mode").value(TRIM_MODE_3POS);
+  } else {
+    w.key("mode").value(2 * rhs.ref + rhs.mode);
+  }
+  w.endMap();
+}
+
+static void YamlWriteFMData(YamlWriter& w, const FlightModeData& rhs, int phaseIdx)
+{
+  size_t n_trims = Boards::getCapability(getCurrentBoard(), Board::NumTrims);
+
+  w.beginMap();
+  {
+    YamlOptionalBlock trims(w, "trim");
+    for (size_t i = 0; i < n_trims; i++) {
+      YamlTrim yt = { rhs.trimMode[i], rhs.trimRef[i], rhs.trim[i] };
+      if (!yt.isEmpty()) {
+        YamlWrite(trims.next(i), yt);
+      }
+    }
+  }
+
+  if (phaseIdx > 0) {
+    w.key("swtch").value(rhs.swtch);
+  }
+  w.key("name").value(rhs.name);
+  w.key("fadeIn").value(rhs.fadeIn);
+  w.key("fadeOut").value(rhs.fadeOut);
+
+  {
+    YamlOptionalBlock gvars(w, "gvars");
+    for (size_t i = 0; i < CPN_MAX_GVARS; i++) {
+      if (!rhs.isGVarEmpty(phaseIdx, i)) {
+        gvars.next(i).beginMap().key("val").value(rhs.gvars[i]).endMap();
+      }
+    }
+  }
+  w.endMap();
+}
+
+static void YamlWrite(YamlWriter& w, const LimitData& rhs)
+{
+  w.beginMap();
+  w.key("min").value(YAML::YamlWriteLimitValue(rhs.min, -1000));
+  w.key("max").value(YAML::YamlWriteLimitValue(rhs.max, 1000));
+  w.key("revert").value((int)rhs.revert);
+  w.key("offset").value(YAML::YamlWriteLimitValue(rhs.offset));
+  w.key("ppmCenter").value(rhs.ppmCenter);
+  w.key("symetrical").value((int)rhs.symetrical);
+  w.key("name").value(rhs.name);
+  w.key("curve").value(rhs.curve.value);
+  // rhs.curve.type is not encoded
+  w.endMap();
+}
+
+static void YamlWrite(YamlWriter& w, const GVarData& rhs)
+{
+  w.beginMap();
+  w.key("name").value(rhs.name);
+  w.key("min").value(rhs.min);
+  w.key("max").value(rhs.max);
+  w.key("popup").value((int)rhs.popup);
+  w.key("prec").value(rhs.prec);
+  w.key("unit").value(rhs.unit);
+  w.endMap();
+}
+
+static void YamlWriteTelemSource(YamlWriter& w, unsigned int src)
+{
+  if (src == 0)
+    w.value("none");
+  else
+    w.value(src - 1);
+}
+
+void YamlWriteModel(YamlWriter& w, const ModelData& rhs)
+{
+  modelSettingsVersion = SemanticVersion(VERSION);
+
+  auto firmware = getCurrentFirmware();
+  auto board = firmware->getBoard();
+
+  bool hasColorLcd = Boards::getCapability(board, Board::HasColorLcd);
+
+  w.beginMap();
+  w.key("semver").value(VERSION);
+
+  w.key("header").beginMap();
+  w.key("name").value(rhs.name);
+  w.key("bitmap").value(rhs.bitmap);
+  w.key("labels").value(rhs.labels);
+  {
+    YamlOptionalBlock modelIds(w, "modelId");
+    for (int i=0; i<CPN_MAX_MODULES; i++) {
+      if (rhs.moduleData[i].protocol != PULSES_OFF) {
+        modelIds.next(i).beginMap().key("val").value(rhs.moduleData[i].modelId).endMap();
+      }
+    }
+  }
+  w.endMap();
+
+  {
+    YamlOptionalBlock timers(w, "timers");
+    for (int i=0; i<CPN_MAX_TIMERS; i++) {
+      if (!rhs.timers[i].isEmpty()) {
+        YamlWrite(timers.next(i), rhs.timers[i]);
+      }
+    }
+  }
+
+  w.key("noGlobalFunctions").value((int)rhs.noGlobalFunctions);
+  w.key("thrTrim").value((int)rhs.thrTrim);
+  w.key("trimInc").value(rhs.trimInc);
+  w.key("displayTrims").value(rhs.trimsDisplay);
+  w.key("ignoreSensorIds").value((int)rhs.frsky.ignoreSensorIds);
+  w.key("showInstanceIds").value((int)rhs.showInstanceIds);
+  w.key("disableThrottleWarning").value((int)rhs.disableThrottleWarning);
+  w.key("enableCustomThrottleWarning").value((int)rhs.enableCustomThrottleWarning);
+  w.key("customThrottleWarningPosition").value((int)rhs.customThrottleWarningPosition);
+  YamlBeepANACenter beepCenter(rhs.beepANACenter);
+  w.key("beepANACenter").value(beepCenter.value);
+  w.key("extendedLimits").value((int)rhs.extendedLimits);
+  w.key("extendedTrims").value((int)rhs.extendedTrims);
+  w.key("throttleReversed").value((int)rhs.throttleReversed);
+  w.key("checklistInteractive").value((int)rhs.checklistInteractive);
+
+  {
+    YamlOptionalBlock flightModes(w, "flightModeData");
+    for (int i = 0; i < CPN_MAX_FLIGHT_MODES; i++) {
+      if (!rhs.flightModeData[i].isEmpty(i)) {
+        YamlWriteFMData(flightModes.next(i), rhs.flightModeData[i], i);
+      }
+    }
+  }
+
+  {
+    YamlOptionalBlock mixes(w, "mixData", true);
+    for (int i = 0; i < CPN_MAX_MIXERS; i++) {
+      const MixData& mix = rhs.mixData[i];
+      if (!mix.isEmpty()) {
+        YamlWrite(mixes.next(), mix);
+      }
+    }
+  }
+
+  {
+    YamlOptionalBlock limits(w, "limitData");
+    for (int i = 0; i < CPN_MAX_CHNOUT; i++) {
+      const LimitData& limit = rhs.limitData[i];
+      if (!limit.isEmpty()) {
+        YamlWrite(limits.next(i), limit);
+      }
+    }
+  }
+
+  std::set<int> inputs;
+  {
+    YamlOptionalBlock expos(w, "expoData", true);
+    for (int i = 0; i < CPN_MAX_EXPOS; i++) {
+      const ExpoData& expo = rhs.expoData[i];
+      if (!expo.isEmpty()) {
+        YamlWrite(expos.next(), expo);
+        inputs.insert(expo.chn);
+      }
+    }
+  }
+
+  {
+    YamlOptionalBlock inputNames(w, "inputNames");
+    for (auto input : inputs) {
+      if (rhs.inputNames[input][0]) {
+        inputNames.next(input).beginMap().key("val").value(rhs.inputNames[input]).endMap();
+      }
+    }
+  }
+
+  {
+    YamlOptionalBlock curves(w, "curves");
+    for (int i = 0; i < CPN_MAX_CURVES; i++) {
+      const CurveData& curve = rhs.curves[i];
+      if (!curve.isEmpty()) {
+        YamlWrite(curves.next(i), curve);
+      }
+    }
+  }
+
+  YamlWriteCurvePoints(w, rhs.curves);
+
+  {
+    YamlOptionalBlock logicalSw(w, "logicalSw");
+    for (int i = 0; i < CPN_MAX_LOGICAL_SWITCHES; i++) {
+      const LogicalSwitchData& ls = rhs.logicalSw[i];
+      if (!ls.isEmpty()) {
+        YamlWrite(logicalSw.next(i), ls);
+      }
+    }
+  }
+
+  {
+    YamlOptionalBlock customFn(w, "customFn");
+    for (int i = 0; i < CPN_MAX_SPECIAL_FUNCTIONS; i++) {
+      const CustomFunctionData& fn = rhs.customFn[i];
+      if (!fn.isEmpty()) {
+        customFn.next(i).value(fn);
+      }
+    }
+  }
+
+  if (getCurrentFirmware()->getCapability(Heli))
+    w.key("swashR").value(rhs.swashRingData);
+
+  YamlThrTrace thrTrace(rhs.thrTraceSrc);
+  w.key("thrTraceSrc").value(thrTrace.src);
+
+  YAML::Node sw_warn;
+  YamlSwitchWarning switchWarning(sw_warn, rhs.switchWarningStates);
+  if (sw_warn && sw_warn.IsMap()) {
+    w.key("switchWarning").node(sw_warn);
+  }
+
+  w.key("thrTrimSw").value(rhs.thrTrimSwitch);
+  w.key("potsWarnMode").lookup(potsWarningModeLut, rhs.potsWarningMode);
+  YamlPotsWarnEnabled potsWarnEnabled(&rhs.potsWarnEnabled[0]);
+  w.key("potsWarnEnabled").value(potsWarnEnabled.value);
+
+  w.key("jitterFilter").lookup(globalOnOffFilterLut, rhs.jitterFilter);
+
+  {
+    YamlOptionalBlock potsWarnPosition(w, "potsWarnPosition");
+    for (int i = 0; i < CPN_MAX_POTS + CPN_MAX_SLIDERS; i++) {
+      if (rhs.potsWarnPosition[i] != 0)
+        potsWarnPosition.next(i).beginMap().key("val").value(rhs.potsWarnPosition[i]).endMap();
+    }
+  }
+
+  w.key("displayChecklist").value((int)rhs.displayChecklist);
+
+  {
+    YamlOptionalBlock gvars(w, "gvars");
+    for (int i = 0; i < CPN_MAX_GVARS; i++) {
+      const GVarData& gv = rhs.gvarData[i];
+      if (!gv.isEmpty()) {
+        YamlWrite(gvars.next(i), gv);
+      }
+    }
+  }
+
+  w.key("telemetryProtocol").value(rhs.telemetryProtocol);
+
+  if (!IS_FAMILY_HORUS_OR_T16(board)) {
+    YamlOptionalBlock screens(w, "screens");
+    for (int i=0; i<4; i++) {
+      const auto& scr = rhs.frsky.screens[i];
+      if (scr.type != TELEMETRY_SCREEN_NONE) {
+        screens.next(i).value(scr);
+      }
+    }
+  }
+
+  w.key("varioData").beginMap();
+  YamlWriteTelemSource(w.key("source"), rhs.frsky.varioSource);
+  w.key("centerSilent").value((int)rhs.frsky.varioCenterSilent);
+  w.key("centerMax").value(rhs.frsky.varioCenterMax);
+  w.key("centerMin").value(rhs.frsky.varioCenterMin);
+  w.key("min").value(rhs.frsky.varioMin);
+  w.key("max").value(rhs.frsky.varioMax);
+  w.endMap();
+
+  YamlWriteTelemSource(w.key("rssiSource"), rhs.rssiSource);
+
+  if (IS_TARANIS_X9(board)) {
+    YamlWriteTelemSource(w.key("voltsSource"), rhs.frsky.voltsSource);
+    YamlWriteTelemSource(w.key("altitudeSource"), rhs.frsky.altitudeSource);
+  }
+
+  YAML::RFAlarms rfAlarms(rhs.rssiAlarms);
+  w.key("rfAlarms").beginMap();
+  w.key("warning").value(rfAlarms.warning);
+  w.key("critical").value(rfAlarms.critical);
+  w.endMap();
+  w.key("disableTelemetryWarning").value((int)rhs.rssiAlarms.disabled);
+
+  {
+    YamlOptionalBlock modules(w, "moduleData");
+    for (int i=0; i<CPN_MAX_MODULES; i++) {
+      if (rhs.moduleData[i].protocol != PULSES_OFF) {
+        modules.next(i).value(rhs.moduleData[i]);
+      }
+    }
+  }
+
+  {
+    YamlOptionalBlock failsafe(w, "failsafeChannels");
+    for (int i=0; i<CPN_MAX_CHNOUT; i++) {
+      if (rhs.limitData[i].failsafe != 0) {
+        failsafe.next(i).beginMap().key("val").value(rhs.limitData[i].failsafe).endMap();
+      }
+    }
+  }
+
+  w.key("trainerData").beginMap();
+  w.key("mode").lookup(trainerModeLut, rhs.trainerMode);
+  w.key("channelsStart").value(rhs.moduleData[2].channelsStart);
+  w.key("channelsCount").value(rhs.moduleData[2].channelsCount - 8);
+  w.key("frameLength").value(rhs.moduleData[2].ppm.frameLength);
+  w.key("delay").value((rhs.moduleData[2].ppm.delay - 300) / 50);
+  w.key("pulsePol").value((int)rhs.moduleData[2].ppm.pulsePol);
+  w.endMap();
+
+  {
+    YamlOptionalBlock scripts(w, "scriptsData");
+    for (int i=0; i<CPN_MAX_SCRIPTS; i++) {
+      if (strlen(rhs.scriptData[i].filename) > 0) {
+        scripts.next(i).value(rhs.scriptData[i]);
+      }
+    }
+  }
+
+  {
+    YamlOptionalBlock sensors(w, "telemetrySensors");
+    for (int i=0; i<CPN_MAX_SENSORS; i++) {
+      if (!rhs.sensorData[i].isEmpty()) {
+        sensors.next(i).value(rhs.sensorData[i]);
+      }
+    }
+  }
+
+  if (IS_TARANIS_X9E(board)) {
+    w.key("toplcdTimer").value(rhs.toplcdTimer);
+  }
+
+  if (Boards::getCapability(board, Board::HasColorLcd)) {
+    {
+      YamlOptionalBlock screens(w, "screenData");
+      for (int i = 0; i < MAX_CUSTOM_SCREENS; i++) {
+        const auto& csd = rhs.customScreens.customScreenData[i];
+        if (!csd.isEmpty()) {
+          screens.next(i).value(csd);
+        }
+      }
+    }
+    YAML::Node topbarData;
+    topbarData = rhs.topBarData;
+    if (topbarData && topbarData.IsMap()) {
+      w.key("topbarData").node(topbarData);
+    }
+    {
+      YamlOptionalBlock widths(w, "topbarWidgetWidth");
+      for (int i = 0; i < firmware->getCapability(TopBarZones); i++) {
+        if (rhs.topbarWidgetWidth[i] > 0) {
+          widths.next(i).beginMap().key("val").value((int)rhs.topbarWidgetWidth[i]).endMap();
+        }
+      }
+    }
+    w.key("view").value(rhs.view);
+  }
+
+  w.key("modelRegistrationID").value(rhs.registrationId);
+  w.key("hatsMode").lookup(hatsModeLut, rhs.hatsMode);
+
+  int funcSwCnt = Boards::getCapability(board, Board::FunctionSwitches);
+  if (funcSwCnt) {
+    w.key("customSwitches").beginMap();
+    for (int i = 0; i < funcSwCnt; i++) {
+      int sw = Boards::getSwitchIndexForCFS(i);
+      std::string tag = Boards::getSwitchYamlName(sw, BoardJson::YLT_CONFIG).toStdString();
+      w.key(tag).value(rhs.customSwitches[i]);
+    }
+    w.endMap();
+
+    int funcSwGrps = Boards::getCapability(board, Board::FunctionSwitchGroups);
+    if (funcSwGrps) {
+      w.key("cfsGroupOn").beginMap();
+      for (int i = 1; i <= funcSwGrps; i++) {
+        w.key(i).beginMap().key("v").value(rhs.cfsGroupOn[i]).endMap();
+      }
+      w.endMap();
+    }
+  }
+
+  // Custom USB joytsick mapping
+  w.key("usbJoystickExtMode").value(rhs.usbJoystickExtMode);
+  w.key("usbJoystickIfMode").lookup(usbJoystickIfModeLut, rhs.usbJoystickIfMode);
+  w.key("usbJoystickCircularCut").value(rhs.usbJoystickCircularCut);
+  {
+    YamlOptionalBlock usbJoystickCh(w, "usbJoystickCh");
+    for (int i = 0; i < CPN_USBJ_MAX_JOYSTICK_CHANNELS; i++) {
+      if (rhs.usbJoystickCh[i].mode > 0) {
+        usbJoystickCh.next(i).value(rhs.usbJoystickCh[i]);
+      }
+    }
+  }
+
+  // Radio level tabs control (global settings)
+  if (hasColorLcd)
+    w.key("radioThemesDisabled").lookup(globalOnOffFilterLut, rhs.radioThemesDisabled);
+  w.key("radioGFDisabled").lookup(globalOnOffFilterLut, rhs.radioGFDisabled);
+  w.key("radioTrainerDisabled").lookup(globalOnOffFilterLut, rhs.radioTrainerDisabled);
+  // Model level tabs control (global setting)
+  w.key("modelHeliDisabled").lookup(globalOnOffFilterLut, rhs.modelHeliDisabled);
+  w.key("modelFMDisabled").lookup(globalOnOffFilterLut, rhs.modelFMDisabled);
+  w.key("modelCurvesDisabled").lookup(globalOnOffFilterLut, rhs.modelCurvesDisabled);
+  w.key("modelGVDisabled").lookup(globalOnOffFilterLut, rhs.modelGVDisabled);
+  w.key("modelLSDisabled").lookup(globalOnOffFilterLut, rhs.modelLSDisabled);
+  w.key("modelSFDisabled").lookup(globalOnOffFilterLut, rhs.modelSFDisabled);
+  w.key("modelCustomScriptsDisabled").lookup(globalOnOffFilterLut, rhs.modelCustomScriptsDisabled);
+  w.key("modelTelemetryDisabled").lookup(globalOnOffFilterLut, rhs.modelTelemetryDisabled);
+
+  w.endMap();
+}
+
+namespace YAML
+{
+Node convert<TimerData>::encode(const TimerData& rhs)
+{
+  return YamlWriteNode([&](YamlWriter& w) { YamlWrite(w, rhs); });
+}
+
+Node convert<ModelData>::encode(const ModelData& rhs)
+{
+  return YamlWriteNode([&](YamlWriter& w) { YamlWriteModel(w, rhs); });
+}
+}  // namespace YAML
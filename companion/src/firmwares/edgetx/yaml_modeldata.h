@@ -20,6 +20,7 @@
  */
 
 #include "yaml_ops.h"
+#include "yaml_writer.h"
 #include "modeldata.h"
 
 namespace YAML {
@@ -41,3 +42,6 @@ struct convert<ModelData> {
   static bool decode(const Node& node, ModelData& rhs);
 };
 }  // namespace YAML
+
+// Streamed without node tree, convert<ModelData>::encode() is built from it
+void YamlWriteModel(YamlWriter& w, const ModelData& rhs);
@@ -24,7 +24,7 @@
 #include "namevalidator.h"
 
 SemanticVersion radioSettingsVersion;
-SemanticVersion modelSettingsVersion;
+thread_local SemanticVersion modelSettingsVersion;
 
 YAML::Node operator >> (const YAML::Node& node, const YamlLookupTable& lut)
 {
@@ -207,4 +207,5 @@ struct convert_enum
   }
 
 extern SemanticVersion radioSettingsVersion;
-extern SemanticVersion modelSettingsVersion;
+// per thread, models may be decoded and encoded concurrently
+extern thread_local SemanticVersion modelSettingsVersion;
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "yaml_writer.h"
+#include "yaml_rawsource.h"
+#include "yaml_rawswitch.h"
+
+YamlWriter& YamlWriter::value(const RawSource& v)
+{
+  out << YamlRawSourceEncode(v);
+  return *this;
+}
+
+YamlWriter& YamlWriter::value(const RawSwitch& v)
+{
+  out << YamlRawSwitchEncode(v);
+  return *this;
+}
+
+YamlWriter& YamlWriter::lookup(const YamlLookupTable& lut, int v)
+{
+  std::string str = YAML::LookupValue(lut, v);
+  if (str.empty())
+    out << YAML::Null;
+  else
+    out << str;
+  return *this;
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include "yaml_ops.h"
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+
+class RawSource;
+class RawSwitch;
+
+// Output stream appending to a string, which keeps its capacity
+// from one document to the next once cleared.
+class YamlStringStream : public std::ostream
+{
+  public:
+    explicit YamlStringStream(std::string& str) : std::ostream(&buf), buf(str) {}
+
+  private:
+    class StringBuf : public std::streambuf
+    {
+      public:
+        explicit StringBuf(std::string& str) : str(str) {}
+
+      protected:
+        int_type overflow(int_type c) override
+        {
+          if (c != traits_type::eof())
+            str.push_back((char)c);
+          return traits_type::not_eof(c);
+        }
+        std::streamsize xsputn(const char* s, std::streamsize n) override
+        {
+          str.append(s, n);
+          return n;
+        }
+
+      private:
+        std::string& str;
+    };
+
+    StringBuf buf;
+};
+
+// Streams YAML through the yaml-cpp emitter, without building the
+// YAML::Node tree first. Values are formatted as yaml-cpp converts them
+// into nodes, and the types without a direct path still go through a
+// node, so that the output is the same as emitting the equivalent tree.
+class YamlWriter
+{
+  public:
+    explicit YamlWriter(std::ostream& os) : out(os) {}
+
+    YamlWriter& beginMap() { out << YAML::BeginMap; return *this; }
+    YamlWriter& endMap() { out << YAML::EndMap; return *this; }
+    YamlWriter& beginSeq() { out << YAML::BeginSeq; return *this; }
+    YamlWriter& endSeq() { out << YAML::EndSeq; return *this; }
+
+    YamlWriter& key(const char* k) { out << YAML::Key << k << YAML::Value; return *this; }
+    YamlWriter& key(const std::string& k) { out << YAML::Key << k << YAML::Value; return *this; }
+    YamlWriter& key(int idx) { return key(std::to_string(idx)); }
+
+    YamlWriter& null() { out << YAML::Null; return *this; }
+    YamlWriter& value(const std::string& v) { out << v; return *this; }
+    YamlWriter& value(const char* v) { out << v; return *this; }
+    YamlWriter& value(const RawSource& v);
+    YamlWriter& value(const RawSwitch& v);
+
+    template <size_t N>
+    YamlWriter& value(const BoundedString<N>& v)
+    {
+      out << v.str();
+      return *this;
+    }
+
+    template <typename T>
+    YamlWriter& value(const T& v)
+    {
+      if constexpr (std::is_same<T, bool>::value) {
+        out << (v ? "true" : "false");
+      } else if constexpr (std::is_integral<T>::value && sizeof(T) > 1) {
+        out << std::to_string(v);
+      } else {
+        // char types are encoded differently by yaml-cpp versions
+        out << YAML::Node(v);
+      }
+      return *this;
+    }
+
+    // as "lut << value": null if not in the table
+    YamlWriter& lookup(const YamlLookupTable& lut, int v);
+
+    YamlWriter& node(const YAML::Node& n) { out << n; return *this; }
+
+    bool good() const { return out.good(); }
+
+  private:
+    YAML::Emitter out;
+};
+
+// Map (or sequence) under a key, only written with its first element:
+// the streamed counterpart of node[key][idx] = ... built on demand.
+class YamlOptionalBlock
+{
+  public:
+    YamlOptionalBlock(YamlWriter& writer, const char* key, bool sequence = false) :
+      writer(writer), key(key), sequence(sequence)
+    {
+    }
+
+    ~YamlOptionalBlock()
+    {
+      if (open)
+        sequence ? writer.endSeq() : writer.endMap();
+    }
+
+    // before each element
+    YamlWriter& next()
+    {
+      if (!open) {
+        writer.key(key);
+        sequence ? writer.beginSeq() : writer.beginMap();
+        open = true;
+      }
+      return writer;
+    }
+
+    YamlWriter& next(int idx) { return next().key(idx); }
+
+  private:
+    YamlWriter& writer;
+    const char* key;
+    bool sequence;
+    bool open = false;
+};
+
+// Node tree of what a writer function streams, for the convert<T>
+// encoders: the fields are only encoded once, by the streamed writers.
+template <typename F>
+YAML::Node YamlWriteNode(F&& write)
+{
+  std::string buffer;
+  {
+    YamlStringStream os(buffer);
+    YamlWriter writer(os);
+    write(writer);
+  }
+  return YAML::Load(buffer);
+}
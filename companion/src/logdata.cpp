@@ -0,0 +1,378 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "logdata.h"
+
+#include <algorithm>
+#include <cstring>
+
+static bool parseDigits(const char *& p, const char * end, int & value)
+{
+  const char * start = p;
+  value = 0;
+  while (p < end && *p >= '0' && *p <= '9') {
+    value = value * 10 + (*p - '0');
+    p++;
+  }
+  return p != start;
+}
+
+static int trimmedLength(const char * line, int length)
+{
+  while (length > 0 && (line[length - 1] == '\r' || line[length - 1] == ' ' || line[length - 1] == '\t'))
+    length--;
+  return length;
+}
+
+LogData::LogData() :
+  data(nullptr),
+  size(0),
+  headerLength(0),
+  lastDayStart(0),
+  errors(0),
+  lines(0)
+{
+}
+
+LogData::~LogData()
+{
+  close();
+}
+
+void LogData::close()
+{
+  if (data) {
+    file.unmap((uchar *)data);
+    data = nullptr;
+  }
+  if (file.isOpen())
+    file.close();
+
+  size = 0;
+  headerLength = 0;
+  columns.clear();
+  records.clear();
+  keys.clear();
+  cache.clear();
+  lastDate.clear();
+  lastDayStart = 0;
+  errors = 0;
+  lines = 0;
+}
+
+bool LogData::open(const QString & filename)
+{
+  close();
+
+  file.setFileName(filename);
+  if (!file.open(QIODevice::ReadOnly))
+    return false;
+
+  size = file.size();
+  if (size > 0)
+    data = (const char *)file.map(0, size);
+
+  if (!data) {
+    close();
+    return false;
+  }
+
+  // header
+  const char * end = data + size;
+  const char * eol = (const char *)memchr(data, '\n', size);
+  headerLength = trimmedLength(data, eol ? int(eol - data) : int(size));
+
+  if (headerLength < 9 || strncmp(data, "Date,Time", 9) != 0) {
+    close();
+    return false;
+  }
+
+  columns = QString::fromUtf8(data, headerLength).split(',');
+  const int numfields = columns.size();
+
+  // index records
+  const char * line = eol ? eol + 1 : end;
+  records.reserve(int(size / (headerLength + 1)));
+  lines = 0;
+
+  while (line < end) {
+    eol = (const char *)memchr(line, '\n', end - line);
+    int length = trimmedLength(line, eol ? int(eol - line) : int(end - line));
+
+    int fields = 1;
+    const char * date = line;
+    const char * time = nullptr;
+    int dateLen = length, timeLen = 0;
+    for (const char * p = line; p < line + length; p++) {
+      if (*p == ',') {
+        if (fields == 1) {
+          dateLen = int(p - line);
+          time = p + 1;
+        }
+        else if (fields == 2) {
+          timeLen = int(p - time);
+        }
+        fields++;
+      }
+    }
+
+    qint64 msecs;
+    if (fields == numfields && time &&
+        parseTimestamp(date, dateLen, time, timeLen, msecs)) {
+      records.append({ qint64(line - data), length, msecs });
+    }
+    else {
+      errors++;
+    }
+
+    lines++;
+    line = eol ? eol + 1 : end;
+  }
+
+  return !records.isEmpty();
+}
+
+bool LogData::parseTimestamp(const char * date, int dateLen, const char * time,
+                             int timeLen, qint64 & msecs)
+{
+  // QDateTime::fromString() is very slow, and so is building a QDateTime
+  // per record: resolve the date once per day and add the time of day.
+
+  int hh, mm, ss, ms = 0;
+  const char * p = time;
+  const char * end = time + timeLen;
+  if (!parseDigits(p, end, hh) || p >= end || *p++ != ':' ||
+      !parseDigits(p, end, mm) || p >= end || *p++ != ':' ||
+      !parseDigits(p, end, ss))
+    return false;
+
+  if (p < end && *p == '.') {
+    p++;
+    if (!parseDigits(p, end, ms))
+      return false;
+  }
+
+  if (p != end)
+    return false;
+
+  if (lastDate.size() != dateLen || memcmp(lastDate.constData(), date, dateLen) != 0) {
+    int y, m, d;
+    const char * q = date;
+    const char * qend = date + dateLen;
+    if (!parseDigits(q, qend, y) || q >= qend || *q++ != '-' ||
+        !parseDigits(q, qend, m) || q >= qend || *q++ != '-' ||
+        !parseDigits(q, qend, d) || q != qend)
+      return false;
+
+    QDate qdate(y, m, d);
+    if (!qdate.isValid())
+      return false;
+
+    lastDate = QByteArray(date, dateLen);
+    lastDayStart = QDateTime(qdate, QTime(0, 0)).toMSecsSinceEpoch();
+  }
+
+  msecs = lastDayStart + ((hh * 60 + mm) * 60 + ss) * 1000LL + ms;
+  return true;
+}
+
+bool LogData::fieldAt(const char * line, int length, int col,
+                      const char ** field, int * fieldLen)
+{
+  const char * p = line;
+  const char * end = line + length;
+
+  while (col > 0) {
+    p = (const char *)memchr(p, ',', end - p);
+    if (!p)
+      return false;
+    p++;
+    col--;
+  }
+
+  const char * next = (const char *)memchr(p, ',', end - p);
+  *field = p;
+  *fieldLen = int((next ? next : end) - p);
+  return true;
+}
+
+QString LogData::cell(int row, int col) const
+{
+  const Record & rec = records.at(row);
+  const char * field;
+  int len;
+
+  if (fieldAt(data + rec.offset, rec.length, col, &field, &len))
+    return QString::fromUtf8(field, len);
+
+  return QString();
+}
+
+QStringList LogData::rowFields(int row) const
+{
+  return QString::fromUtf8(rawLine(row)).split(',');
+}
+
+QByteArray LogData::rawLine(int row) const
+{
+  const Record & rec = records.at(row);
+  return QByteArray::fromRawData(data + rec.offset, rec.length);
+}
+
+QByteArray LogData::rawHeader() const
+{
+  return QByteArray::fromRawData(data, headerLength);
+}
+
+const QVector<double> & LogData::timeKeys()
+{
+  if (keys.size() != records.size()) {
+    keys.resize(records.size());
+    for (int i = 0; i < records.size(); i++) {
+      keys[i] = records.at(i).msecs / 1000.0;
+    }
+  }
+  return keys;
+}
+
+const QVector<double> & LogData::values(int col)
+{
+  auto it = cache.find(col);
+  if (it != cache.end())
+    return it.value();
+
+  QVector<double> & result = cache[col];
+  result.resize(records.size());
+
+  for (int i = 0; i < records.size(); i++) {
+    const Record & rec = records.at(i);
+    const char * field;
+    int len;
+    double value = 0;
+
+    if (fieldAt(data + rec.offset, rec.length, col, &field, &len) && len > 0) {
+      // locale independent, unlike strtod()
+      value = QByteArray::fromRawData(field, len).toDouble();
+    }
+
+    result[i] = value;
+  }
+
+  return result;
+}
+
+void LogData::decimate(const QVector<double> & x, const QVector<double> & y,
+                       double lower, double upper, int buckets,
+                       QVector<double> & outX, QVector<double> & outY)
+{
+  outX.clear();
+  outY.clear();
+
+  if (x.isEmpty())
+    return;
+
+  // keep one point on each side of the visible range so lines reach the edges
+  int first = int(std::lower_bound(x.begin(), x.end(), lower) - x.begin());
+  int last = int(std::upper_bound(x.begin(), x.end(), upper) - x.begin());
+  if (first > 0)
+    first--;
+  if (last < x.size())
+    last++;
+
+  const int count = last - first;
+  const double span = (x.at(last - 1) - x.at(first)) / std::max(buckets, 1);
+  if (buckets < 1 || count <= 2 * buckets || span <= 0) {
+    outX = x.mid(first, count);
+    outY = y.mid(first, count);
+    return;
+  }
+
+  outX.reserve(2 * buckets + 2);
+  outY.reserve(2 * buckets + 2);
+
+  int i = first;
+
+  while (i < last) {
+    const double bucketEnd = x.at(first) + span * (int((x.at(i) - x.at(first)) / span) + 1);
+    int minIdx = i, maxIdx = i;
+
+    for (i++; i < last && x.at(i) < bucketEnd; i++) {
+      if (y.at(i) < y.at(minIdx))
+        minIdx = i;
+      if (y.at(i) > y.at(maxIdx))
+        maxIdx = i;
+    }
+
+    if (minIdx == maxIdx) {
+      outX.append(x.at(minIdx));
+      outY.append(y.at(minIdx));
+    }
+    else {
+      const int a = std::min(minIdx, maxIdx);
+      const int b = std::max(minIdx, maxIdx);
+      outX.append(x.at(a));
+      outY.append(y.at(a));
+      outX.append(x.at(b));
+      outY.append(y.at(b));
+    }
+  }
+}
+
+LogTableModel::LogTableModel(LogData * log, QObject * parent) :
+  QAbstractTableModel(parent),
+  log(log)
+{
+}
+
+void LogTableModel::refresh()
+{
+  beginResetModel();
+  endResetModel();
+}
+
+int LogTableModel::rowCount(const QModelIndex & parent) const
+{
+  return parent.isValid() ? 0 : log->rowCount();
+}
+
+int LogTableModel::columnCount(const QModelIndex & parent) const
+{
+  return parent.isValid() ? 0 : log->columnCount();
+}
+
+QVariant LogTableModel::data(const QModelIndex & index, int role) const
+{
+  if (!index.isValid() || role != Qt::DisplayRole)
+    return QVariant();
+
+  return log->cell(index.row(), index.column());
+}
+
+QVariant LogTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+  if (role != Qt::DisplayRole)
+    return QVariant();
+
+  if (orientation == Qt::Horizontal)
+    return log->header().value(section);
+
+  return section + 1;
+}
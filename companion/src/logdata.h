@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include <QtCore>
+#include <QAbstractTableModel>
+
+/*
+  Read-only columnar view over a radio CSV log.
+
+  The file is memory mapped and scanned once to record the offset of each
+  valid record and its timestamp. Cell text is sliced from the mapping on
+  demand and numeric columns are only converted the first time they are
+  requested, so opening a large log costs one pass over the bytes.
+*/
+class LogData
+{
+  public:
+    LogData();
+    ~LogData();
+
+    bool open(const QString & filename);
+    void close();
+
+    bool isEmpty() const { return records.isEmpty(); }
+    int rowCount() const { return records.size(); }
+    int columnCount() const { return columns.size(); }
+    int errorCount() const { return errors; }
+    int lineCount() const { return lines; }
+
+    const QStringList & header() const { return columns; }
+    int findColumn(const QString & name) const { return columns.indexOf(name); }
+
+    QString cell(int row, int col) const;
+    QStringList rowFields(int row) const;
+    QByteArray rawLine(int row) const;
+    QByteArray rawHeader() const;
+
+    qint64 timestamp(int row) const { return records.at(row).msecs; }
+    // time keys in seconds, as used by QCPAxisTickerDateTime
+    const QVector<double> & timeKeys();
+    // numeric values of a column, converted on first use
+    const QVector<double> & values(int col);
+
+    // Reduce (x, y) to at most 2 points per bucket over [lower, upper]
+    // keeping the min and max of each bucket in time order, so that peaks
+    // survive at any zoom level. x must be sorted ascending.
+    static void decimate(const QVector<double> & x, const QVector<double> & y,
+                         double lower, double upper, int buckets,
+                         QVector<double> & outX, QVector<double> & outY);
+
+  private:
+    struct Record {
+      qint64 offset;
+      int length;
+      qint64 msecs;
+    };
+
+    QFile file;
+    const char * data;
+    qint64 size;
+    int headerLength;
+    QStringList columns;
+    QVector<Record> records;
+    QVector<double> keys;
+    QHash<int, QVector<double>> cache;
+    QByteArray lastDate;
+    qint64 lastDayStart;
+    int errors;
+    int lines;
+
+    bool parseTimestamp(const char * date, int dateLen, const char * time,
+                        int timeLen, qint64 & msecs);
+    static bool fieldAt(const char * line, int length, int col,
+                        const char ** field, int * fieldLen);
+};
+
+class LogTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+  public:
+    explicit LogTableModel(LogData * log, QObject * parent = nullptr);
+
+    void refresh();
+
+    int rowCount(const QModelIndex & parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex & parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex & index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+  private:
+    LogData * log;
+};
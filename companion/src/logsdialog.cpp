@@ -20,6 +20,7 @@
  */
 
 #include <math.h>
+#include <numeric>
 #include "logsdialog.h"
 #include "appdata.h"
 #include "ui_logsdialog.h"
@@ -38,11 +39,13 @@ LogsDialog::LogsDialog(QWidget *parent) :
   cursorB(0),
   cursorLine(0)
 {
-  csvlog.clear();
-
   ui->setupUi(this);
   setWindowIcon(CompanionIcon("logs.png"));
 
+  logModel = new LogTableModel(&logData, this);
+  ui->logTable->setModel(logModel);
+  ui->logTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+
   plotLock=false;
 
   colors.append(Qt::green);
@@ -118,12 +121,14 @@ LogsDialog::LogsDialog(QWidget *parent) :
 
   // make left axes transfer its range to right axes:
   connect(axisRect->axis(QCPAxis::atLeft), static_cast<void(QCPAxis::*)(const QCPRange&)>(&QCPAxis::rangeChanged), this, &LogsDialog::yAxisChangeRanges);
+  // re-decimate the plotted series for the visible time range:
+  connect(axisRect->axis(QCPAxis::atBottom), static_cast<void(QCPAxis::*)(const QCPRange&)>(&QCPAxis::rangeChanged), this, &LogsDialog::xAxisChangeRange);
   // connect some interaction slots:
   connect(title, &QCPTextElement::doubleClicked, this, &LogsDialog::titleDoubleClicked);
   connect(ui->customPlot, &QCustomPlot::axisDoubleClick, this, &LogsDialog::axisLabelDoubleClick);
   connect(ui->customPlot, &QCustomPlot::legendDoubleClick, this, &LogsDialog::legendDoubleClick);
   connect(ui->FieldsTW, &QTableWidget::itemSelectionChanged, this, &LogsDialog::plotLogs);
-  connect(ui->logTable, &QTableWidget::itemSelectionChanged, this, &LogsDialog::plotLogs);
+  connect(ui->logTable->selectionModel(), &QItemSelectionModel::selectionChanged, this, &LogsDialog::plotLogs);
   connect(ui->Reset_PB, &QPushButton::clicked, this, [this]() {
     ui->ZoomX_ChkB->setChecked(false);
     ui->ZoomY_ChkB->setChecked(false);
@@ -255,64 +260,53 @@ void LogsDialog::selectionChanged()
   }
 }
 
-QList<QStringList> LogsDialog::filterGePoints(const QList<QStringList> & input)
+QList<QStringList> LogsDialog::filterGePoints()
 {
   QList<QStringList> result;
 
-  int n = input.count();
-  if (n == 0) {
+  if (logData.isEmpty()) {
     return result;
   }
 
-  int gpscol = 0;
-  for (int i=1; i<input.at(0).count(); i++) {
-    if (input.at(0).at(i) == "GPS") {
-      gpscol=i;
-    }
-  }
-  if (gpscol == 0) {
+  int gpscol = logData.findColumn("GPS");
+  if (gpscol < 0) {
     QMessageBox::critical(this, tr("Error: no GPS data found"),
       tr("The column containing GPS coordinates must be named \"GPS\".\n\n\
 The columns for altitude \"GAlt\" and for speed \"GSpd\" are optional"));
     return result;
   }
 
-  result.append(input.at(0));
-  bool rangeSelected = ui->logTable->selectionModel()->selectedRows().length() > 0;
+  result.append(logData.header());
 
   GpsGlitchFilter glitchFilter;
   GpsLatLonFilter latLonFilter;
 
-  for (int i = 1; i < n; i++) {
-    if ((ui->logTable->item(i-1, 1)->isSelected() && rangeSelected) || !rangeSelected) {
+  for (int row : selectedLogRows()) {
+    GpsCoord coord = extractGpsCoordinates(logData.cell(row, gpscol));
 
-      GpsCoord coord = extractGpsCoordinates(input.at(i).at(gpscol));
-
-      // glitch filter
-      if ( glitchFilter.isGlitch(coord) ) {
-        // qDebug() << "filterGePoints(): GPS glitch detected at" << i << coord.latitude << coord.longitude;
-        continue;
-      }
-
-      // lat long pair filter
-      if ( !latLonFilter.isValid(coord) ) {
-        // qDebug() << "filterGePoints(): Lat-Lon pair wrong, skipping at" << i << coord.latitude << coord.longitude;
-        continue;
-      }
+    // glitch filter
+    if ( glitchFilter.isGlitch(coord) ) {
+      // qDebug() << "filterGePoints(): GPS glitch detected at" << row << coord.latitude << coord.longitude;
+      continue;
+    }
 
-      // qDebug() << "point " << latitude << longitude;
-      result.append(input.at(i));
+    // lat long pair filter
+    if ( !latLonFilter.isValid(coord) ) {
+      // qDebug() << "filterGePoints(): Lat-Lon pair wrong, skipping at" << row << coord.latitude << coord.longitude;
+      continue;
     }
+
+    result.append(logData.rowFields(row));
   }
 
-  // qDebug() << "filterGePoints(): filtered from" << input.count() << "to " << result.count() << "points";
+  // qDebug() << "filterGePoints(): filtered from" << logData.rowCount() << "to " << result.count() << "points";
   return result;
 }
 
 void LogsDialog::exportToGoogleEarth()
 {
   // filter data points
-  QList<QStringList> dataPoints = filterGePoints(csvlog);
+  QList<QStringList> dataPoints = filterGePoints();
   int n = dataPoints.count(); // number of points to export
   if (n == 0) return;
 
@@ -321,7 +315,7 @@ void LogsDialog::exportToGoogleEarth()
 
   QSet<int> extradataCols;
 
-  for (int i = 1; i < dataPoints.at(0).count(); i++) {
+  for (int i = 0; i < dataPoints.at(0).count(); i++) {
     // Date and Time
     // Long,Lat,Course,GPS Speed,GPS Alt
     bool incExtraData = true;
@@ -613,49 +607,23 @@ void LogsDialog::fileOpen()
 
     if (cvsFileParse()) {
       ui->FieldsTW->clear();
-      ui->logTable->clear();
       ui->FieldsTW->setShowGrid(false);
       ui->FieldsTW->setContentsMargins(0, 0, 0, 0);
-      ui->FieldsTW->setRowCount(csvlog.at(0).count() - 2);
+      ui->FieldsTW->setRowCount(logData.columnCount() - 2);
       ui->FieldsTW->setColumnCount(1);
       ui->FieldsTW->setHorizontalHeaderLabels(QStringList(tr("Available fields")));
-      ui->logTable->setSelectionBehavior(QAbstractItemView::SelectRows);
 
-      for (int i = 3; i < csvlog.at(0).count(); i++) {
-        QTableWidgetItem* item= new QTableWidgetItem(csvlog.at(0).at(i));
-        ui->FieldsTW->setItem(i - 3, 0, item);
+      for (int i = 2; i < logData.columnCount(); i++) {
+        QTableWidgetItem* item= new QTableWidgetItem(logData.header().at(i));
+        ui->FieldsTW->setItem(i - 2, 0, item);
       }
 
       ui->FieldsTW->resizeRowsToContents();
-      ui->logTable->setColumnCount(csvlog.at(0).count());
-      ui->logTable->setRowCount(csvlog.count() - 1);
-      ui->logTable->setHorizontalHeaderLabels(csvlog.at(0));
       //s1.report("Load fields");
 
-      QAbstractItemModel *model = ui->logTable->model();
-      for (int i = 1; i < csvlog.count(); i++) {
-        for (int j = 0; j < csvlog.at(0).count(); j++) {
-          model->setData(model->index(i - 1, j, QModelIndex()), csvlog.at(i).at(j));
-        }
-      }
-
-      //s1.report("Load data model");
-
-      ui->logTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
-      QVarLengthArray<int> sizes;
-
-      for (int i = 0; i < ui->logTable->columnCount(); i++) {
-        sizes.append(ui->logTable->columnWidth(i));
-      }
-
+      // the model is virtual: size columns from the first rows only
       ui->logTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
-
-      for (int i = 0; i < ui->logTable->columnCount(); i++) {
-        if (i == 0)
-          ui->logTable->setColumnHidden(i, true); // hide MSecsSinceEpoch column
-        else
-          ui->logTable->setColumnWidth(i, sizes.at(i));
-      }
+      ui->logTable->resizeColumnsToContents();
 
       //s1.report("Adjust headers");
     }
@@ -667,40 +635,25 @@ void LogsDialog::saveSession()
   int index = ui->sessions_CB->currentIndex();
   // ignore index 0 is its all sessions combined
   if(index > 0) {
-    int n = csvlog.count();
-    QList<QStringList> sessionCsvLog;
-    // add CSV headers from first row of source file
-    sessionCsvLog.push_back(csvlog[0]);
-    // find session breaks
-    int currentSession = 0;
-    QDateTime lastvalue;
-    for (int i = 1; i < n; i++) {
-      QDateTime tmp = getRecordTimeStamp(i);
-      if (!lastvalue.isValid() || lastvalue.secsTo(tmp) > 60) {
-        currentSession++;
-      }
-      lastvalue = tmp;
-      if(currentSession == index) {
-        // add records to filtered list
-        sessionCsvLog.push_back(csvlog[i]);
-      }
-      else if (currentSession > index) {
-        break;
-      }
+    int top = ui->sessions_CB->itemData(index, Qt::UserRole).toInt();
+    int bottom = logData.rowCount();
+    if (index < ui->sessions_CB->count() - 1) {
+      bottom = ui->sessions_CB->itemData(index + 1, Qt::UserRole).toInt();
     }
-    // save the filtered records to a new file
+    // save the session records to a new file
     QString newFilename = logFilename;
     newFilename.append(QString("-Session%1.csv").arg(index));
     QString filename = QFileDialog::getSaveFileName(this, "Save log", newFilename, "CSV files (.csv);"); // getting the filename (full path)
     QFile data(filename);
     if(data.open(QFile::WriteOnly |QFile::Truncate)) {
-      QTextStream output(&data);
-      int numRecords = sessionCsvLog.count();
-      for(int i = 0; i < numRecords; i++){
-        output << sessionCsvLog[i].join(",") << '\n';
+      // add CSV headers from first row of source file
+      data.write(logData.rawHeader());
+      data.write("\n");
+      for(int i = top; i < bottom; i++){
+        data.write(logData.rawLine(i));
+        data.write("\n");
       }
     }
-    sessionCsvLog.clear();
   }
 }
 
@@ -708,80 +661,24 @@ bool LogsDialog::cvsFileParse()
 {
   //Stopwatch s("Parse");
 
-  QFile file(ui->FileName_LE->text());
-  int errors=0;
-  int lines=-1;
-
-  if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) { // reading HEX TEXT file
-    return false;
-  }
-  else {
-    csvlog.clear();
-    logFilename.clear();
-    QTextStream inputStream(&file);
-    QString buffer = file.readLine();
-
-    if (buffer.startsWith("Date,Time")) {
-      file.reset();
-    }
-    else {
-      return false;
-    }
-
-    int numfields=-1;
-    while (!file.atEnd()) {
-      QString line = file.readLine().trimmed();
-      QStringList columns = line.split(',');
-
-      if (numfields == -1) {
-        numfields=columns.count();
-      }
+  plotLock = true;
+  removeAllGraphs();
+  graphCoords.clear();
+  logModel->refresh();
+  logFilename.clear();
 
-      if (columns.count() == numfields) {
-        if (lines == -1) {
-          csvlog.append(QStringList("MSecsSinceEpoch") << columns);
-        } else {
-          // Qt v6.2 onwards QDateTime::fromString() is very slow
-          QStringList sDate = columns.at(0).split("-");
-          QStringList sTime = columns.at(1).split(":");
-          QStringList sSecs;
-
-          if (sTime.count() == 3) {
-            sSecs = sTime.at(2).split(".");
-
-            if (sSecs.count() == 1)
-              sSecs.append("0");
-          }
-
-          if (sDate.count() == 3 && sTime.count() == 3 && sSecs.count() == 2) {
-            QDate d(sDate.at(0).toInt(), sDate.at(1).toInt(), sDate.at(2).toInt());
-            QTime t(sTime.at(0).toInt(), sTime.at(1).toInt(), sSecs.at(0).toInt(), sSecs.at(1).toInt());
-            QDateTime dt(d, t);
-            //qDebug() << dt << dt.toString() << dt.toMSecsSinceEpoch() << QDateTime::fromMSecsSinceEpoch(dt.toMSecsSinceEpoch());
-            csvlog.append(QStringList(QString::number(dt.toMSecsSinceEpoch())) << columns);
-            //qDebug() << csvlog.at(csvlog.count() - 1);
-          } else {
-            errors++;
-          }
-        }
-      } else {
-        errors++;
-      }
-      lines++;
-    }
+  bool ok = logData.open(ui->FileName_LE->text());
+  logModel->refresh();
+  plotLock = false;
 
-    logFilename = QFileInfo(file.fileName()).baseName();
+  if (!ok) {
+    return false;
   }
 
-  file.close();
-  if (errors > 1) {
-    QMessageBox::warning(this, CPN_STR_APP_NAME, tr("The selected logfile contains %1 invalid lines out of  %2 total lines").arg(errors).arg(lines));
-  }
+  logFilename = QFileInfo(ui->FileName_LE->text()).baseName();
 
-  int n = csvlog.count();
-  if (n == 1) {
-    csvlog.clear();
-    return false;
+  if (logData.errorCount() > 1) {
+    QMessageBox::warning(this, CPN_STR_APP_NAME, tr("The selected logfile contains %1 invalid lines out of  %2 total lines").arg(logData.errorCount()).arg(logData.lineCount()));
   }
 
   //s.report("Data loaded");
@@ -802,8 +699,7 @@ struct FlightSession {
 
 QDateTime LogsDialog::getRecordTimeStamp(int index)
 {
-  //qDebug() << csvlog.at(index).at(0).toLongLong() << QDateTime::fromMSecsSinceEpoch(csvlog.at(index).at(0).toLongLong());
-  return QDateTime::fromMSecsSinceEpoch(csvlog.at(index).at(0).toLongLong());
+  return QDateTime::fromMSecsSinceEpoch(logData.timestamp(index));
 }
 
 QString LogsDialog::generateDuration(const QDateTime & start, const QDateTime & end)
@@ -825,21 +721,21 @@ void LogsDialog::setFlightSessions()
   ui->sessions_CB->clear();
   ui->SaveSession_PB->setEnabled(false);
 
-  int n = csvlog.count();
+  int n = logData.rowCount();
   // qDebug() << "records" << n;
 
   // find session breaks
   QList<int> sessions;
-  QDateTime lastvalue;
-  for (int i = 1; i < n; i++) {
-    QDateTime tmp = getRecordTimeStamp(i);
-    if (!lastvalue.isValid() || lastvalue.secsTo(tmp) > 60) {
-      sessions.push_back(i-1);
-      // qDebug() << "session index" << i-1;
+  qint64 lastvalue = 0;
+  for (int i = 0; i < n; i++) {
+    qint64 tmp = logData.timestamp(i);
+    if (i == 0 || (tmp - lastvalue) / 1000 > 60) {
+      sessions.push_back(i);
+      // qDebug() << "session index" << i;
     }
     lastvalue = tmp;
   }
-  sessions.push_back(n-1);
+  sessions.push_back(n);
 
   //s.report("Breaks found");
 
@@ -848,14 +744,14 @@ void LogsDialog::setFlightSessions()
   int noSesions = sessions.size() - 1;
   QString label = QString("%1 ").arg(noSesions);
   label += tr(noSesions > 1 ? "sessions" : "session");
-  label += " <" + tr("time span ") + generateDuration(getRecordTimeStamp(1), getRecordTimeStamp(n - 1)) + ">";
+  label += " <" + tr("time span ") + generateDuration(getRecordTimeStamp(0), getRecordTimeStamp(n - 1)) + ">";
   ui->sessions_CB->addItem(label);
 
   // add individual sessions
   if (sessions.size() > 2) {
     for (int i = 1; i < sessions.size(); i++) {
-      QDateTime sessionStart = getRecordTimeStamp(sessions.at(i - 1) + 1);
-      QDateTime sessionEnd = getRecordTimeStamp(sessions.at(i));
+      QDateTime sessionStart = getRecordTimeStamp(sessions.at(i - 1));
+      QDateTime sessionEnd = getRecordTimeStamp(sessions.at(i) - 1);
       QString label = sessionStart.toString("HH:mm:ss") + " <" + tr("duration ") + generateDuration(sessionStart, sessionEnd) + ">";
       ui->sessions_CB->addItem(label, sessions.at(i - 1));
       // qDebug() << "added label" << label << sessions.at(i-1);
@@ -877,13 +773,13 @@ void LogsDialog::sessionsCurrentIndexChanged(int index)
     if (index < ui->sessions_CB->count() - 1) {
       bottom = ui->sessions_CB->itemData(index + 1, Qt::UserRole).toInt();
     } else {
-      bottom = ui->logTable->rowCount();
+      bottom = logModel->rowCount();
     }
 
-    QModelIndex topLeft = ui->logTable->model()->index(
+    QModelIndex topLeft = logModel->index(
       ui->sessions_CB->itemData(index, Qt::UserRole).toInt(), 0 , QModelIndex());
-    QModelIndex bottomRight = ui->logTable->model()->index(
-      bottom - 1, ui->logTable->columnCount() - 1, QModelIndex());
+    QModelIndex bottomRight = logModel->index(
+      bottom - 1, logModel->columnCount() - 1, QModelIndex());
 
     QItemSelection selection(topLeft, bottomRight);
     ui->logTable->selectionModel()->select(selection, QItemSelectionModel::Select);
@@ -898,36 +794,40 @@ void LogsDialog::sessionsCurrentIndexChanged(int index)
   plotLogs();
 }
 
-std::pair<double, double> LogsDialog::GetMinMaxY() const
+QVector<int> LogsDialog::selectedLogRows() const
 {
-  double minVal = 0.0;
-  double maxVal = 0.0;
-  bool found = false;
-
-  // determine selected rows in the log table
-  QModelIndexList sel = ui->logTable->selectionModel()->selectedRows();
-  bool hasSelection = !sel.isEmpty();
-  QVarLengthArray<int> selectedRows;
-
-  if (hasSelection) {
-    selectedRows.reserve(sel.size());
-    for (const QModelIndex &idx : sel) selectedRows.append(idx.row());
+  // selected rows in ascending order, or all rows when nothing is selected;
+  // walk the selection ranges rather than selectedRows() to avoid building
+  // one QModelIndex per row on large logs
+  QVector<int> rows;
+  const QItemSelection selection = ui->logTable->selectionModel()->selection();
+
+  for (const QItemSelectionRange & range : selection) {
+    for (int row = range.top(); row <= range.bottom(); row++) {
+      rows.append(row);
+    }
   }
 
-  // iterate over selected fields and rows to compute global min/max Y
-  for (QTableWidgetItem *fieldItem : ui->FieldsTW->selectedItems()) {
-    const int col = fieldItem->row() + 2;  // Date and Time are first two columns
-    const int rows = hasSelection ? selectedRows.length() : ui->logTable->rowCount();
+  if (rows.isEmpty()) {
+    rows.resize(logData.rowCount());
+    std::iota(rows.begin(), rows.end(), 0);
+  } else {
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+  }
 
-    for (int r = 0; r < rows; ++r) {
-      const int tableRow = hasSelection ? selectedRows.at(r) : r;
-      QTableWidgetItem *cell = ui->logTable->item(tableRow, col);
-      if (!cell) continue;
+  return rows;
+}
 
-      bool ok = false;
-      const double v = cell->text().toDouble(&ok);
-      if (!ok) continue;
+std::pair<double, double> LogsDialog::GetMinMaxY() const
+{
+  double minVal = 0.0;
+  double maxVal = 0.0;
+  bool found = false;
 
+  // iterate over plotted fields to compute global min/max Y
+  for (const coords_t & c : graphCoords) {
+    for (double v : c.y) {
       if (!found) {
         minVal = maxVal = v;
         found = true;
@@ -954,22 +854,9 @@ void LogsDialog::plotLogs()
   //Stopwatch s("Plot");
   plotsCollection plots;
 
-  QModelIndexList selection = ui->logTable->selectionModel()->selectedRows();
-  int rowCount = selection.length();
-  bool hasLogSelection;
   bool useCommonAxes = ui->CommonAxes_ChkB->isChecked();
-  QVarLengthArray<int> selectedRows;
-
-  if (rowCount) {
-    hasLogSelection = true;
-    foreach (QModelIndex index, selection) {
-      selectedRows.append(index.row());
-    }
-    std::sort(selectedRows.begin(), selectedRows.end());
-  } else {
-    hasLogSelection = false;
-    rowCount = ui->logTable->rowCount();
-  }
+  const QVector<int> rows = selectedLogRows();
+  const QVector<double> & keys = logData.timeKeys();
 
   //s.report("Row count");
 
@@ -978,35 +865,25 @@ void LogsDialog::plotLogs()
 
   foreach (QTableWidgetItem *plot, ui->FieldsTW->selectedItems()) {
     coords_t plotCoords;
-    int plotColumn = plot->row() + 3; // Epoch, Date and Time first
+    int plotColumn = plot->row() + 2; // Date and Time first
+    const QVector<double> & values = logData.values(plotColumn);
 
     plotCoords.min_y = INVALID_MIN;
     plotCoords.max_y = INVALID_MAX;
     plotCoords.yaxis = firstLeft;
     plotCoords.name = plot->text();
+    plotCoords.x.reserve(rows.size());
+    plotCoords.y.reserve(rows.size());
 
-    for (int row = 0; row < rowCount; row++) {
-      QTableWidgetItem *logValue;
-      double y;
-      double time;
-      QDateTime datetime;
+    for (int row : rows) {
+      double y = values.at(row);
+      double time = keys.at(row);
 
-      if (hasLogSelection) {
-        logValue = ui->logTable->item(selectedRows.at(row), plotColumn);
-        datetime = QDateTime::fromMSecsSinceEpoch(ui->logTable->item(selectedRows.at(row), 0)->text().toLongLong());
-      } else {
-        logValue = ui->logTable->item(row, plotColumn);
-        datetime = QDateTime::fromMSecsSinceEpoch(ui->logTable->item(row, 0)->text().toLongLong());
-      }
-
-      y = logValue->text().toDouble();
       plotCoords.y.push_back(y);
 
       if (plotCoords.min_y > y) plotCoords.min_y = y;
       if (plotCoords.max_y < y) plotCoords.max_y = y;
 
-      time = QCPAxisTickerDateTime::dateTimeToKey(datetime);
-
       plotCoords.x.push_back(time);
 
       if(plots.min_x == INVALID_MIN)
@@ -1111,6 +988,10 @@ void LogsDialog::plotLogs()
   }
 
   removeAllGraphs();
+  graphCoords.clear();
+  for (const coords_t & c : plots.coords) {
+    graphCoords.append(c);
+  }
 
   //s.report("Remove existing graphs");
 
@@ -1193,8 +1074,7 @@ void LogsDialog::plotLogs()
 
     //s.report("Legend");
 
-    ui->customPlot->graph(i)->setData(plots.coords.at(i).x,
-      plots.coords.at(i).y);
+    setDecimatedData(i);
     pen.setColor(colors.at(i % colors.size()));
     ui->customPlot->graph(i)->setPen(pen);
 
@@ -1218,6 +1098,30 @@ void LogsDialog::plotLogs()
   //s.report("Refresh graph");
 }
 
+void LogsDialog::setDecimatedData(int graph)
+{
+  // feed the plot at most two points per horizontal pixel for the visible
+  // range, the full series stays in graphCoords for cursors and markers
+  const coords_t & c = graphCoords.at(graph);
+  const QCPRange range = axisRect->axis(QCPAxis::atBottom)->range();
+  QVector<double> x, y;
+
+  LogData::decimate(c.x, c.y, range.lower, range.upper, axisRect->width(), x, y);
+  ui->customPlot->graph(graph)->setData(x, y, true);
+}
+
+void LogsDialog::xAxisChangeRange(QCPRange range)
+{
+  Q_UNUSED(range);
+
+  if (plotLock) return;
+
+  const int count = std::min(ui->customPlot->graphCount(), (int)graphCoords.size());
+  for (int i = 0; i < count; i++) {
+    setDecimatedData(i);
+  }
+}
+
 void LogsDialog::yAxisChangeRanges(QCPRange range)
 {
   if (axisRect->axis(QCPAxis::atRight)->visible()) {
@@ -24,6 +24,7 @@
 #include <QtCore>
 #include <QDialog>
 #include "qcustomplot.h"
+#include "logdata.h"
 
 #define INVALID_MIN 999999
 #define INVALID_MAX -999999
@@ -82,10 +83,13 @@ private slots:
   void sessionsCurrentIndexChanged(int index);
   void mapsButtonClicked();
   void yAxisChangeRanges(QCPRange range);
+  void xAxisChangeRange(QCPRange range);
   std::pair<double, double> GetMinMaxY() const;
 
 private:
-  QList<QStringList> csvlog;
+  LogData logData;
+  LogTableModel *logModel;
+  QVector<coords_t> graphCoords;
   Ui::LogsDialog *ui;
   QCPAxisRect *axisRect;
   QCPLegend *rightLegend;
@@ -104,7 +108,9 @@ private:
   QCPItemStraightLine * cursorLine;
 
   bool cvsFileParse();
-  QList<QStringList> filterGePoints(const QList<QStringList> & input);
+  QVector<int> selectedLogRows() const;
+  void setDecimatedData(int graph);
+  QList<QStringList> filterGePoints();
   void exportToGoogleEarth();
   QDateTime getRecordTimeStamp(int index);
   QString generateDuration(const QDateTime & start, const QDateTime & end);
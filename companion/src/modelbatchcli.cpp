@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+// Headless batch model conversion and validation.
+//
+// Models are decoded, optionally converted to another radio, validated
+// and written again by ModelBatch, from a thread pool. A line is printed
+// for each model as soon as it is done, and the output files are replaced
+// atomically, so that an interrupted run never leaves a truncated model.
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QThread>
+
+#include "customdebug.h"
+#include "eeprominterface.h"
+#include "modelbatch.h"
+#include "opentxinterface.h"
+#include "storage.h"
+#include "firmwares/boardfactories.h"
+
+struct BatchOptions {
+  ModelBatch::Options batch;
+  QStringList files;
+};
+
+static Firmware * firmwareForFlavour(const QString & flavour)
+{
+  Firmware * fw = Firmware::getFirmwareForFlavour(flavour);
+  if (!fw || fw->getFlavour() != flavour) {
+    QTextStream(stderr) << "unknown radio " << flavour << "\n";
+    return nullptr;
+  }
+  return fw;
+}
+
+// Model files given, or found in the given folders (or their MODELS folder)
+static QStringList modelFiles(const QStringList & paths)
+{
+  QStringList files;
+
+  for (const auto & path : paths) {
+    QFileInfo info(path);
+    if (!info.isDir()) {
+      files << path;
+      continue;
+    }
+
+    QDir dir(path);
+    if (dir.exists("MODELS"))
+      dir.cd("MODELS");
+    QStringList names = dir.entryList(QStringList() << "model*.yml", QDir::Files, QDir::Name);
+    names.removeAll("models.yml");
+    names.removeAll("modelslist.yml");
+    for (const auto & name : names)
+      files << dir.filePath(name);
+  }
+
+  return files;
+}
+
+static bool parseOptions(BatchOptions & opts)
+{
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Validates, re-exports or converts models to another radio, "
+      "in parallel and without any user interaction.");
+  parser.addHelpOption();
+
+  const QCommandLineOption optRadio("radio", "Radio the models were written for (e.g. tx16s).",
+                                    "flavour");
+  const QCommandLineOption optConvert("convert", "Convert the models to another radio.",
+                                      "flavour");
+  const QCommandLineOption optReexport("reexport", "Write the models again, e.g. to upgrade them.");
+  const QCommandLineOption optNoValidate("no-validate", "Do not report invalid models as errors.");
+  const QCommandLineOption optOutput("output", "Write the models to <path> instead of in place.",
+                                     "path");
+  const QCommandLineOption optJobs("jobs", "Number of models processed in parallel.", "n");
+
+  parser.addOptions({optRadio, optConvert, optReexport, optNoValidate, optOutput, optJobs});
+  parser.addPositionalArgument("models", "Model files, or radio data folders (MODELS/model*.yml).",
+                               "<models...>");
+  parser.process(*QCoreApplication::instance());
+
+  if (!parser.isSet(optRadio) || parser.positionalArguments().isEmpty()) {
+    QTextStream(stderr) << "--radio and at least one model are required\n";
+    return false;
+  }
+
+  ModelBatch::Options & batch = opts.batch;
+  batch.from = firmwareForFlavour(parser.value(optRadio));
+  if (!batch.from)
+    return false;
+
+  if (parser.isSet(optConvert)) {
+    batch.operation = ModelBatch::OP_CONVERT;
+    batch.to = firmwareForFlavour(parser.value(optConvert));
+    if (!batch.to)
+      return false;
+  }
+  else if (parser.isSet(optReexport)) {
+    batch.operation = ModelBatch::OP_REEXPORT;
+  }
+
+  batch.validate = !parser.isSet(optNoValidate);
+  batch.outputDir = parser.value(optOutput);
+  batch.jobs = QThread::idealThreadCount();
+  if (parser.isSet(optJobs))
+    batch.jobs = qMax(1, parser.value(optJobs).toInt());
+
+  opts.files = modelFiles(parser.positionalArguments());
+  if (opts.files.isEmpty()) {
+    QTextStream(stderr) << "no model found\n";
+    return false;
+  }
+
+  return true;
+}
+
+int main(int argc, char ** argv)
+{
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName("modelbatch");
+
+  Q_INIT_RESOURCE(hwdefs);
+  CustomDebug::setFilterRules();
+
+  gBoardFactories = new BoardFactories();
+  registerStorageFactories();
+  registerOpenTxFirmwares();
+
+  BatchOptions opts;
+  int result = 2;
+
+  if (parseOptions(opts)) {
+    QTextStream out(stdout);
+    QElapsedTimer timer;
+    timer.start();
+
+    int changed = 0;
+    ModelBatch batch(opts.batch);
+    int errors = batch.run(opts.files, [&](const ModelBatchReport & report) {
+      out << QFileInfo(report.file).fileName() << ": ";
+      if (!report.ok)
+        out << "ERROR";
+      else if (!report.output.isEmpty())
+        out << "written " << report.output;
+      else
+        out << "OK";
+      out << "\n";
+      for (const auto & error : report.errors)
+        out << "  " << error << "\n";
+      for (const auto & message : report.messages)
+        out << "  " << message << "\n";
+      out.flush();
+
+      if (report.changed)
+        changed++;
+    });
+
+    out << opts.files.size() << " model(s), " << changed << " changed, " << errors
+        << " error(s) in " << timer.elapsed() / 1000.0 << "s with " << opts.batch.jobs
+        << " job(s)\n";
+    out.flush();
+
+    result = errors ? 1 : 0;
+  }
+
+  unregisterOpenTxFirmwares();
+  unregisterStorageFactories();
+  gBoardFactories->unregisterBoardFactories();
+
+  return result;
+}
@@ -142,7 +142,11 @@ void SimulatedUIWidget::onLcdChange(bool backlightEnable)
     return;
 
   uint8_t* lcdBuf = m_simulator->getLcd();
-  m_lcd->onLcdChanged(lcdBuf, backlightEnable);
+  QRect dirty;
+  if (m_simulator->getLcdDirtyRect(dirty))
+    m_lcd->onLcdChanged(lcdBuf, backlightEnable, &dirty);
+  else
+    m_lcd->onLcdChanged(lcdBuf, backlightEnable);
   m_simulator->lcdFlushed();
 
   setLightOn(backlightEnable);
@@ -32,6 +32,7 @@
 #include <QByteArray>
 #include <QDir>
 #include <QMap>
+#include <QRect>
 #include <QSerialPort>
 
 #define SIMULATOR_INTERFACE_HEARTBEAT_PERIOD    1000  // ms
@@ -141,6 +142,9 @@ class SimulatorInterface : public QObject
     virtual bool isRunning() = 0;
     virtual void readRadioData(QByteArray & dest) = 0;
     virtual uint8_t * getLcd() = 0;
+    // Area of getLcd() changed since the last call. Returns false if
+    // unknown (the whole LCD must be assumed changed).
+    virtual bool getLcdDirtyRect(QRect & rect) { return false; }
     virtual uint8_t getSensorInstance(uint16_t id, uint8_t defaultValue = 0) = 0;
     virtual uint16_t getSensorRatio(uint16_t id) = 0;
     virtual const int getCapability(Capability cap) = 0;
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "wasmhost.h"
+
+static WasmHost * hostOf(wasm_exec_env_t exec_env)
+{
+  auto * inst = wasm_runtime_get_module_inst(exec_env);
+  return static_cast<WasmHost *>(wasm_runtime_get_custom_data(inst));
+}
+
+// The WASM ADC driver does a direct passthrough, so the host must provide
+// values in ADC range (0..4096, center=2048).
+static uint32_t host_simuGetAnalog(wasm_exec_env_t exec_env, uint32_t idx)
+{
+  auto * host = hostOf(exec_env);
+  if (host) {
+    int16_t raw = host->getAnalogValue((uint8_t)idx);
+    uint16_t adc = (uint16_t)((raw + 1024) * 2); // -1024..+1024 → 0..4096
+    return (uint32_t)adc;
+  }
+  return 2048;
+}
+
+static void host_simuQueueAudio(wasm_exec_env_t exec_env, uint8_t * buf,
+                                uint32_t len)
+{
+  auto * host = hostOf(exec_env);
+  if (host && buf && len > 0)
+    host->queueAudio(buf, len);
+}
+
+static void host_simuTrace(wasm_exec_env_t exec_env, const char * text)
+{
+  auto * host = hostOf(exec_env);
+  if (host && text)
+    host->writeTrace(text);
+}
+
+static void host_simuLcdNotify(wasm_exec_env_t exec_env)
+{
+  auto * host = hostOf(exec_env);
+  if (host)
+    host->notifyLcdReady();
+}
+
+static void host_simuAuxSerialStart(wasm_exec_env_t exec_env, uint32_t port_nr,
+                                    uint32_t baudrate, uint32_t encoding)
+{
+  auto * host = hostOf(exec_env);
+  if (host)
+    host->onAuxSerialStart((uint8_t)port_nr, baudrate, (uint8_t)encoding);
+}
+
+static void host_simuAuxSerialStop(wasm_exec_env_t exec_env, uint32_t port_nr)
+{
+  auto * host = hostOf(exec_env);
+  if (host)
+    host->onAuxSerialStop((uint8_t)port_nr);
+}
+
+static void host_simuAuxSerialSetBaudrate(wasm_exec_env_t exec_env,
+                                          uint32_t port_nr, uint32_t baudrate)
+{
+  auto * host = hostOf(exec_env);
+  if (host)
+    host->onAuxSerialSetBaudrate((uint8_t)port_nr, baudrate);
+}
+
+static void host_simuAuxSerialSendBuffer(wasm_exec_env_t exec_env,
+                                         uint32_t port_nr, uint8_t * data,
+                                         uint32_t len)
+{
+  auto * host = hostOf(exec_env);
+  if (host && data && len > 0)
+    host->onAuxSerialSendBuffer((uint8_t)port_nr, data, len);
+}
+
+static NativeSymbol s_nativeSymbols[] = {
+    {"simuGetAnalog", (void *)host_simuGetAnalog, "(i)i", nullptr},
+    {"simuQueueAudio", (void *)host_simuQueueAudio, "(*~)", nullptr},
+    {"simuTrace", (void *)host_simuTrace, "($)", nullptr},
+    {"simuLcdNotify", (void *)host_simuLcdNotify, "()", nullptr},
+    {"simuAuxSerialStart", (void *)host_simuAuxSerialStart, "(iii)", nullptr},
+    {"simuAuxSerialStop", (void *)host_simuAuxSerialStop, "(i)", nullptr},
+    {"simuAuxSerialSetBaudrate", (void *)host_simuAuxSerialSetBaudrate,
+     "(ii)", nullptr},
+    {"simuAuxSerialSendBuffer", (void *)host_simuAuxSerialSendBuffer,
+     "(i*~)", nullptr},
+};
+
+bool wasmHostRegisterNatives()
+{
+  return wasm_runtime_register_natives(
+      "env", s_nativeSymbols, sizeof(s_nativeSymbols) / sizeof(NativeSymbol));
+}
+
+void wasmHostAttach(wasm_module_inst_t inst, WasmHost * host)
+{
+  wasm_runtime_set_custom_data(inst, host);
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "wasm_export.h"
+
+// Host side of the WASM imports of the firmware simulator modules
+// (simuGetAnalog, simuTrace...). Each module instance is bound to a
+// WasmHost, which receives the calls. They are made from the firmware
+// threads, not from the thread that created the instance.
+class WasmHost
+{
+  public:
+    virtual ~WasmHost() = default;
+
+    // Called by WASM import simuGetAnalog (-1024..+1024, center=0)
+    virtual int16_t getAnalogValue(uint8_t index) = 0;
+
+    // Called by WASM import simuTrace
+    virtual void writeTrace(const char * text) {}
+
+    // Called by WASM import simuQueueAudio
+    virtual void queueAudio(const uint8_t * buf, uint32_t len) {}
+
+    // Called by WASM import simuLcdNotify
+    virtual void notifyLcdReady() {}
+
+    // Called by WASM aux serial imports
+    virtual void onAuxSerialStart(uint8_t port_nr, uint32_t baudrate,
+                                  uint8_t encoding) {}
+    virtual void onAuxSerialStop(uint8_t port_nr) {}
+    virtual void onAuxSerialSetBaudrate(uint8_t port_nr, uint32_t baudrate) {}
+    virtual void onAuxSerialSendBuffer(uint8_t port_nr, const uint8_t * data,
+                                       uint32_t len) {}
+};
+
+// Registers the imports with WAMR: once, after wasm_runtime_init()
+bool wasmHostRegisterNatives();
+
+// Binds a module instance to the host receiving its imports
+void wasmHostAttach(wasm_module_inst_t inst, WasmHost * host);
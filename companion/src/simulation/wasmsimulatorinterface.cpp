@@ -22,112 +22,11 @@
 #include <QTimer>
 #include <QDir>
 
-// WAMR native callback: called by WASM module to get analog values in
-// ADC range (0..4096, center=2048).  The WASM ADC driver does a direct
-// passthrough, so the host must provide values in ADC range.
-// UI widgets emit -1024..+1024 (center=0); we convert here.
-static uint32_t host_simuGetAnalog(wasm_exec_env_t exec_env, uint32_t idx)
-{
-  auto * inst = wasm_runtime_get_module_inst(exec_env);
-  auto * iface = static_cast<WasmSimulatorInterface *>(
-      wasm_runtime_get_custom_data(inst));
-  if (iface) {
-    int16_t raw = iface->getAnalogValue((uint8_t)idx);
-    uint16_t adc = (uint16_t)((raw + 1024) * 2); // -1024..+1024 → 0..4096
-    return (uint32_t)adc;
-  }
-  return 2048;
-}
-
-// WAMR native callback: called by WASM module to queue audio PCM data
-static void host_simuQueueAudio(wasm_exec_env_t exec_env, uint8_t * buf,
-                                uint32_t len)
-{
-  auto * inst = wasm_runtime_get_module_inst(exec_env);
-  auto * iface = static_cast<WasmSimulatorInterface *>(
-      wasm_runtime_get_custom_data(inst));
-  if (iface && buf && len > 0)
-    iface->queueAudio(buf, len);
-}
-
-// WAMR native callback: called by WASM module to send trace/debug output
-static void host_simuTrace(wasm_exec_env_t exec_env, const char * text)
-{
-  auto * inst = wasm_runtime_get_module_inst(exec_env);
-  auto * iface = static_cast<WasmSimulatorInterface *>(
-      wasm_runtime_get_custom_data(inst));
-  if (iface && text)
-    iface->writeTrace(text);
-}
+// LCD areas read per frame: the firmware merges any extra ones
+constexpr uint32_t LCD_MAX_DIRTY_RECTS = 16;
 
 static bool s_wamrInitialized = false;
 
-static void host_simuLcdNotify(wasm_exec_env_t exec_env)
-{
-  auto * inst = wasm_runtime_get_module_inst(exec_env);
-  auto * iface = static_cast<WasmSimulatorInterface *>(
-      wasm_runtime_get_custom_data(inst));
-  if (iface)
-    iface->notifyLcdReady();
-}
-
-// WAMR native callbacks: aux serial bridge (firmware -> host).  These run on
-// the WAMR worker thread; the WasmSimulatorInterface methods they call emit
-// Qt signals, which Qt::AutoConnection automatically queues to the GUI
-// thread where HostSerialConnector lives.
-static void host_simuAuxSerialStart(wasm_exec_env_t exec_env, uint32_t port_nr,
-                                    uint32_t baudrate, uint32_t encoding)
-{
-  auto * inst = wasm_runtime_get_module_inst(exec_env);
-  auto * iface = static_cast<WasmSimulatorInterface *>(
-      wasm_runtime_get_custom_data(inst));
-  if (iface)
-    iface->onAuxSerialStart((uint8_t)port_nr, baudrate, (uint8_t)encoding);
-}
-
-static void host_simuAuxSerialStop(wasm_exec_env_t exec_env, uint32_t port_nr)
-{
-  auto * inst = wasm_runtime_get_module_inst(exec_env);
-  auto * iface = static_cast<WasmSimulatorInterface *>(
-      wasm_runtime_get_custom_data(inst));
-  if (iface)
-    iface->onAuxSerialStop((uint8_t)port_nr);
-}
-
-static void host_simuAuxSerialSetBaudrate(wasm_exec_env_t exec_env,
-                                          uint32_t port_nr, uint32_t baudrate)
-{
-  auto * inst = wasm_runtime_get_module_inst(exec_env);
-  auto * iface = static_cast<WasmSimulatorInterface *>(
-      wasm_runtime_get_custom_data(inst));
-  if (iface)
-    iface->onAuxSerialSetBaudrate((uint8_t)port_nr, baudrate);
-}
-
-static void host_simuAuxSerialSendBuffer(wasm_exec_env_t exec_env,
-                                         uint32_t port_nr, uint8_t * data,
-                                         uint32_t len)
-{
-  auto * inst = wasm_runtime_get_module_inst(exec_env);
-  auto * iface = static_cast<WasmSimulatorInterface *>(
-      wasm_runtime_get_custom_data(inst));
-  if (iface && data && len > 0)
-    iface->onAuxSerialSendBuffer((uint8_t)port_nr, data, len);
-}
-
-static NativeSymbol s_nativeSymbols[] = {
-    {"simuGetAnalog", (void *)host_simuGetAnalog, "(i)i", nullptr},
-    {"simuQueueAudio", (void *)host_simuQueueAudio, "(*~)", nullptr},
-    {"simuTrace", (void *)host_simuTrace, "($)", nullptr},
-    {"simuLcdNotify", (void *)host_simuLcdNotify, "()", nullptr},
-    {"simuAuxSerialStart", (void *)host_simuAuxSerialStart, "(iii)", nullptr},
-    {"simuAuxSerialStop", (void *)host_simuAuxSerialStop, "(i)", nullptr},
-    {"simuAuxSerialSetBaudrate", (void *)host_simuAuxSerialSetBaudrate,
-     "(ii)", nullptr},
-    {"simuAuxSerialSendBuffer", (void *)host_simuAuxSerialSendBuffer,
-     "(i*~)", nullptr},
-};
-
 WasmSimulatorInterface::WasmSimulatorInterface(const QString & wasmPath,
                                                const QString & boardName,
                                                Board::Type boardType)
@@ -172,6 +71,16 @@ uint8_t * WasmSimulatorInterface::getLcd()
   return m_lcdBuffer;
 }
 
+bool WasmSimulatorInterface::getLcdDirtyRect(QRect & rect)
+{
+  QMutexLocker lckr(&m_mutex);
+  if (!m_lcdDirtyKnown)
+    return false;
+  rect = m_lcdDirty;
+  m_lcdDirty = QRect();
+  return true;
+}
+
 uint8_t WasmSimulatorInterface::getSensorInstance(uint16_t id,
                                                   uint8_t defaultValue)
 {
@@ -205,9 +114,7 @@ bool WasmSimulatorInterface::loadModule()
       return false;
     }
     wasm_runtime_set_log_level(WASM_LOG_LEVEL_WARNING);
-    wasm_runtime_register_natives("env", s_nativeSymbols,
-                                  sizeof(s_nativeSymbols) /
-                                      sizeof(NativeSymbol));
+    wasmHostRegisterNatives();
     s_wamrInitialized = true;
   }
 
@@ -269,8 +176,8 @@ bool WasmSimulatorInterface::loadModule()
     return false;
   }
 
-  // Store pointer to this instance for native callbacks
-  wasm_runtime_set_custom_data(m_moduleInst, this);
+  // Route the native callbacks to this instance
+  wasmHostAttach(m_moduleInst, this);
 
   // Create execution environment
   m_execEnv =
@@ -338,6 +245,10 @@ bool WasmSimulatorInterface::resolveExports()
       wasm_runtime_lookup_function(m_moduleInst, "simuLcdGetWidth");
   m_fnLcdGetHeight =
       wasm_runtime_lookup_function(m_moduleInst, "simuLcdGetHeight");
+  m_fnLcdGetBuffer =
+      wasm_runtime_lookup_function(m_moduleInst, "simuLcdGetBuffer");
+  m_fnLcdGetDirtyRects =
+      wasm_runtime_lookup_function(m_moduleInst, "simuLcdGetDirtyRects");
   m_fnLcdGetDepth =
       wasm_runtime_lookup_function(m_moduleInst, "simuLcdGetDepth");
   m_fnTouchDown =
@@ -407,6 +318,8 @@ bool WasmSimulatorInterface::resolveExports()
 
   // Haptic feedback polling
   m_fnGetHaptic = wasm_runtime_lookup_function(m_moduleInst, "simuGetHaptic");
+  m_fnGetMixerCycles =
+      wasm_runtime_lookup_function(m_moduleInst, "simuGetMixerCycles");
 
   m_fnMalloc = wasm_runtime_lookup_function(m_moduleInst, "malloc");
   m_fnFree = wasm_runtime_lookup_function(m_moduleInst, "free");
@@ -443,6 +356,9 @@ void WasmSimulatorInterface::init()
   m_stopRequested = false;
   memset(m_analogValues, 0, sizeof(m_analogValues));
 
+  m_benchPeriod = qEnvironmentVariableIntValue("EDGETX_WASM_BENCHMARK");
+  m_benchTimer.invalidate();
+
   // Call simuInit
   QMutexLocker lckr(&m_mutex);
   wasm_runtime_call_wasm(m_execEnv, m_fnInit, 0, nullptr);
@@ -483,10 +399,13 @@ void WasmSimulatorInterface::init()
   }
 
   // Allocate persistent scratch buffer in WASM memory for bulk copies.
-  // Sized for max(channels * sizeof(int16_t), logical switches).
+  // Sized for max(channels * sizeof(int16_t), logical switches,
+  // LCD dirty rects).
   m_wasmScratchSize = CPN_MAX_CHNOUT * sizeof(int16_t);
   if (CPN_MAX_LOGICAL_SWITCHES > m_wasmScratchSize)
     m_wasmScratchSize = CPN_MAX_LOGICAL_SWITCHES;
+  if (LCD_MAX_DIRTY_RECTS * 4 * sizeof(uint16_t) > m_wasmScratchSize)
+    m_wasmScratchSize = LCD_MAX_DIRTY_RECTS * 4 * sizeof(uint16_t);
   if (m_fnMalloc) {
     uint32_t allocArgv[1] = {m_wasmScratchSize};
     if (wasm_runtime_call_wasm(m_execEnv, m_fnMalloc, 1, allocArgv) &&
@@ -745,9 +664,58 @@ void WasmSimulatorInterface::onLcdNotify()
 {
   if (!m_lcdNotified.exchange(false))
     return;
+  ++m_benchLcdFrames;
   refreshLcd();
 }
 
+// Copy only the areas redrawn by the firmware, straight from its
+// framebuffer in linear memory. Returns false if the module does not
+// support it (older firmware) or the framebuffer cannot be mapped.
+// Must be called with m_mutex held.
+bool WasmSimulatorInterface::copyLcdDirtyRects()
+{
+  if (m_lcdDepth != 16 || !m_fnLcdGetBuffer || !m_fnLcdGetDirtyRects ||
+      !m_wasmScratchBuf)
+    return false;
+
+  uint32_t argv[2] = {0};
+  if (!wasm_runtime_call_wasm(m_execEnv, m_fnLcdGetBuffer, 0, argv) ||
+      !argv[0] ||
+      !wasm_runtime_validate_app_addr(m_moduleInst, argv[0], m_lcdBufferSize))
+    return false;
+
+  auto fb = (const uint8_t *)wasm_runtime_addr_app_to_native(m_moduleInst,
+                                                             argv[0]);
+  auto rects = (const uint16_t *)wasm_runtime_addr_app_to_native(
+      m_moduleInst, m_wasmScratchBuf);
+  if (!fb || !rects)
+    return false;
+
+  argv[0] = m_wasmScratchBuf;
+  argv[1] = LCD_MAX_DIRTY_RECTS;
+  if (!wasm_runtime_call_wasm(m_execEnv, m_fnLcdGetDirtyRects, 2, argv))
+    return false;
+
+  const QRect screen(0, 0, m_lcdWidth, m_lcdHeight);
+  const uint32_t stride = m_lcdWidth * sizeof(uint16_t);
+
+  uint32_t count = qMin(argv[0], (uint32_t)LCD_MAX_DIRTY_RECTS);
+  for (uint32_t i = 0; i < count; i++, rects += 4) {
+    QRect rect = QRect(rects[0], rects[1], rects[2], rects[3]) & screen;
+    if (rect.isEmpty())
+      continue;
+
+    uint32_t offset = rect.y() * stride + rect.x() * sizeof(uint16_t);
+    uint32_t len = rect.width() * sizeof(uint16_t);
+    for (int y = 0; y < rect.height(); y++, offset += stride) {
+      memcpy(m_lcdBuffer + offset, fb + offset, len);
+    }
+    m_lcdDirty |= rect;
+  }
+
+  return true;
+}
+
 void WasmSimulatorInterface::refreshLcd()
 {
   if (!m_fnLcdCopy || !m_execEnv || !m_wasmLcdBuf || !m_lcdBuffer)
@@ -757,14 +725,19 @@ void WasmSimulatorInterface::refreshLcd()
   {
     QMutexLocker lckr(&m_mutex);
 
-    uint32_t copyArgv[2] = {m_wasmLcdBuf, m_lcdBufferSize};
-    if (wasm_runtime_call_wasm(m_execEnv, m_fnLcdCopy, 2, copyArgv)) {
-      uint32_t bytesWritten = copyArgv[0];
-      void * nativePtr =
-          wasm_runtime_addr_app_to_native(m_moduleInst, m_wasmLcdBuf);
-      if (nativePtr && bytesWritten > 0) {
-        memcpy(m_lcdBuffer, nativePtr, qMin(bytesWritten, m_lcdBufferSize));
+    if (copyLcdDirtyRects()) {
+      m_lcdDirtyKnown = true;
+    } else {
+      uint32_t copyArgv[2] = {m_wasmLcdBuf, m_lcdBufferSize};
+      if (wasm_runtime_call_wasm(m_execEnv, m_fnLcdCopy, 2, copyArgv)) {
+        uint32_t bytesWritten = copyArgv[0];
+        void * nativePtr =
+            wasm_runtime_addr_app_to_native(m_moduleInst, m_wasmLcdBuf);
+        if (nativePtr && bytesWritten > 0) {
+          memcpy(m_lcdBuffer, nativePtr, qMin(bytesWritten, m_lcdBufferSize));
+        }
       }
+      m_lcdDirtyKnown = false;
     }
 
     if (m_fnGetBacklightState) {
@@ -997,6 +970,9 @@ void WasmSimulatorInterface::run()
     emit heartbeat(loops, 0);
   }
 
+  if (m_benchPeriod > 0)
+    updateBenchmark();
+
   if (!isRunning()) {
     emit stopped();
     return;
@@ -1050,6 +1026,46 @@ void WasmSimulatorInterface::run()
   }
 }
 
+// Reports how fast the firmware runs in the simulator: mixer cycles and
+// LCD frames per second, and how late the 10ms host timer ticks are
+// (100% = on time).
+void WasmSimulatorInterface::updateBenchmark()
+{
+  uint32_t mixerCycles = 0;
+  if (m_fnGetMixerCycles) {
+    QMutexLocker lckr(&m_mutex);
+    uint32_t argv[1] = {0};
+    if (wasm_runtime_call_wasm(m_execEnv, m_fnGetMixerCycles, 0, argv))
+      mixerCycles = argv[0];
+  }
+
+  if (!m_benchTimer.isValid()) {
+    m_benchTimer.start();
+    m_benchLoops = 0;
+    m_benchMixerCycles = mixerCycles;
+    m_benchLcdFrames = 0;
+    return;
+  }
+
+  ++m_benchLoops;
+  qint64 elapsed = m_benchTimer.elapsed();
+  if (elapsed < m_benchPeriod * 1000)
+    return;
+
+  double secs = elapsed / 1000.0;
+  qInfo().noquote()
+      << QString("WASM benchmark %1: %2 mixer cycles/s, %3 LCD fps, "
+                 "%4% timer ticks")
+             .arg(m_boardName)
+             .arg((mixerCycles - m_benchMixerCycles) / secs, 0, 'f', 1)
+             .arg(m_benchLcdFrames.exchange(0) / secs, 0, 'f', 1)
+             .arg(m_benchLoops * 10 * 100 / (double)elapsed, 0, 'f', 1);
+
+  m_benchTimer.restart();
+  m_benchLoops = 0;
+  m_benchMixerCycles = mixerCycles;
+}
+
 // Helper: call a WASM function with 0 args, return int32 result
 static int32_t wasmCall0(wasm_exec_env_t env, wasm_function_inst_t fn)
 {
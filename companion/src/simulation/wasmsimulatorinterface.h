@@ -16,7 +16,9 @@
 #pragma once
 
 #include "simulatorinterface.h"
+#include "wasmhost.h"
 
+#include <QElapsedTimer>
 #include <QMutex>
 #include <QTimer>
 #include <QVector>
@@ -26,7 +28,7 @@
 
 #include <SDL.h>
 
-class WasmSimulatorInterface : public SimulatorInterface
+class WasmSimulatorInterface : public SimulatorInterface, public WasmHost
 {
   Q_OBJECT
 
@@ -39,6 +41,7 @@ class WasmSimulatorInterface : public SimulatorInterface
     bool isRunning() override;
     void readRadioData(QByteArray & dest) override {}
     uint8_t * getLcd() override;
+    bool getLcdDirtyRect(QRect & rect) override;
     uint8_t getSensorInstance(uint16_t id, uint8_t defaultValue = 0) override;
     uint16_t getSensorRatio(uint16_t id) override;
     const int getCapability(Capability cap) override;
@@ -72,26 +75,20 @@ class WasmSimulatorInterface : public SimulatorInterface
     void receiveAuxSerialData(const quint8 port_num,
                               const QByteArray & data) override;
 
-    // Called by WASM import simuGetAnalog
-    int16_t getAnalogValue(uint8_t index);
-
-    // Called by WASM import simuTrace
-    void writeTrace(const char * text);
-
-    // Called by WASM import simuQueueAudio
-    void queueAudio(const uint8_t * buf, uint32_t len);
-
-    // Called by WASM import simuLcdNotify (from WAMR thread)
-    void notifyLcdReady();
-
-    // Called by WASM aux serial imports (from WAMR thread).  These re-emit
-    // the matching SimulatorInterface signals so that HostSerialConnector
-    // (wired up in SimulatorMainWindow) drives the real host serial port.
-    void onAuxSerialStart(uint8_t port_nr, uint32_t baudrate, uint8_t encoding);
-    void onAuxSerialStop(uint8_t port_nr);
-    void onAuxSerialSetBaudrate(uint8_t port_nr, uint32_t baudrate);
+    // WasmHost (called from the WAMR thread).  The aux serial callbacks
+    // re-emit the matching SimulatorInterface signals so that
+    // HostSerialConnector (wired up in SimulatorMainWindow) drives the real
+    // host serial port.
+    int16_t getAnalogValue(uint8_t index) override;
+    void writeTrace(const char * text) override;
+    void queueAudio(const uint8_t * buf, uint32_t len) override;
+    void notifyLcdReady() override;
+    void onAuxSerialStart(uint8_t port_nr, uint32_t baudrate,
+                          uint8_t encoding) override;
+    void onAuxSerialStop(uint8_t port_nr) override;
+    void onAuxSerialSetBaudrate(uint8_t port_nr, uint32_t baudrate) override;
     void onAuxSerialSendBuffer(uint8_t port_nr, const uint8_t * data,
-                               uint32_t len);
+                               uint32_t len) override;
 
   protected slots:
     void run();
@@ -102,7 +99,9 @@ class WasmSimulatorInterface : public SimulatorInterface
     void unloadModule();
     bool resolveExports();
     void refreshLcd();
+    bool copyLcdDirtyRects();
     void checkOutputsChanged();
+    void updateBenchmark();
     void initAudio();
     void deinitAudio();
 
@@ -142,6 +141,8 @@ class WasmSimulatorInterface : public SimulatorInterface
     uint32_t m_lcdWidth = 0;
     uint32_t m_lcdHeight = 0;
     uint32_t m_lcdDepth = 0;
+    QRect m_lcdDirty;  // changed since the last getLcdDirtyRect()
+    bool m_lcdDirtyKnown = false;
 
     // WAMR handles
     wasm_module_t m_module = nullptr;
@@ -162,6 +163,8 @@ class WasmSimulatorInterface : public SimulatorInterface
     wasm_function_inst_t m_fnLcdGetWidth = nullptr;
     wasm_function_inst_t m_fnLcdGetHeight = nullptr;
     wasm_function_inst_t m_fnLcdGetDepth = nullptr;
+    wasm_function_inst_t m_fnLcdGetBuffer = nullptr;
+    wasm_function_inst_t m_fnLcdGetDirtyRects = nullptr;
     wasm_function_inst_t m_fnTouchDown = nullptr;
     wasm_function_inst_t m_fnTouchUp = nullptr;
     wasm_function_inst_t m_fnFatfsSetPaths = nullptr;
@@ -211,6 +214,14 @@ class WasmSimulatorInterface : public SimulatorInterface
 
     uint32_t m_lastHaptic = 0;
 
+    // Benchmark (EDGETX_WASM_BENCHMARK=<report period in seconds>)
+    wasm_function_inst_t m_fnGetMixerCycles = nullptr;
+    int m_benchPeriod = 0;
+    QElapsedTimer m_benchTimer;
+    uint32_t m_benchLoops = 0;
+    uint32_t m_benchMixerCycles = 0;
+    std::atomic<uint32_t> m_benchLcdFrames{0};
+
     wasm_function_inst_t m_fnMalloc = nullptr;
     wasm_function_inst_t m_fnFree = nullptr;
 };
@@ -69,14 +69,35 @@ void LcdWidget::makeScreenshot(const QString &fileName)
   }
 }
 
-void LcdWidget::onLcdChanged(uint8_t* lcdBuf, bool light)
+void LcdWidget::onLcdChanged(uint8_t* lcdBuf, bool light,
+                             const QRect* dirtyRect)
 {
   // Ingest only: store the latest frame and let frameTimer drive the repaint.
   // Sampling on a fixed cadence caps the repaint rate without dropping the
   // final frame of a burst, regardless of how frames are delivered.
   QMutexLocker locker(&lcdMtx);
-  lightEnable = light;
-  if (lcdBuf) memcpy(localBuf, lcdBuf, lcdSize);
+
+  // Color LCDs are drawn unscaled and regardless of the backlight, so
+  // that only the changed area needs to be copied and repainted.
+  if (dirtyRect && lcdDepth == 16) {
+    QRect area = *dirtyRect & QRect(0, 0, lcdWidth, lcdHeight);
+    if (area.isEmpty())
+      return;
+
+    if (lcdBuf) {
+      int stride = lcdWidth * 2;
+      int offset = area.y() * stride + area.x() * 2;
+      for (int y = 0; y < area.height(); y++, offset += stride)
+        memcpy(localBuf + offset, lcdBuf + offset, area.width() * 2);
+    }
+    lightEnable = light;
+    dirtyArea |= area;
+  } else {
+    lightEnable = light;
+    if (lcdBuf) memcpy(localBuf, lcdBuf, lcdSize);
+    dirtyArea = rect();
+  }
+
   dirty = true;
   if (!frameTimer.isActive())
     frameTimer.start();
@@ -90,7 +111,8 @@ void LcdWidget::onFrameTick()
     return;
   }
   dirty = false;
-  update();
+  update(dirtyArea);
+  dirtyArea = QRect();
 }
 
 void LcdWidget::doPaint(QPainter &p)
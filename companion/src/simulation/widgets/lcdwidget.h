@@ -69,7 +69,9 @@ class LcdWidget : public QWidget
 
   void makeScreenshot(const QString &fileName);
 
-  void onLcdChanged(uint8_t* lcdBuf, bool light);
+  // 'dirtyRect': area of 'lcdBuf' that changed, the whole LCD if null
+  void onLcdChanged(uint8_t* lcdBuf, bool light,
+                    const QRect* dirtyRect = nullptr);
 
  signals:
   void touchEvent(int type, int x, int y);
@@ -89,6 +91,7 @@ class LcdWidget : public QWidget
   QMutex lcdMtx;
   QTimer frameTimer;
   bool dirty = false;
+  QRect dirtyArea;  // to be repainted, in widget coordinates
 
   void onFrameTick();
   void doPaint(QPainter &p);
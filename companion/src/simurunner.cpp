@@ -0,0 +1,650 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+// Headless model regression runner.
+//
+// Each model is simulated in its own instance of a firmware WASM module:
+// every instance has its own linear memory, hence its own copy of the
+// firmware globals (g_model, g_eeGeneral, channelOutputs, tasks...), so
+// that many models can run in parallel from a thread pool.
+//
+// For each model, a fixed sequence of stick positions is applied and the
+// channel outputs are recorded once the mixer has settled. The results
+// are either written as a baseline, or compared against one.
+//
+// Exit code: 0 when no model changed, 1 on differences, 2 on errors.
+// Models without a baseline are reported as such and do not fail the run.
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+
+#include <algorithm>
+#include <atomic>
+
+#include "wasmhost.h"
+
+constexpr int MAX_ANALOGS = 32;
+constexpr int MAX_CHANNELS = 32;
+
+struct RunnerOptions {
+  QString wasmPath;
+  QString dataDir;       // RADIO/radio.yml + MODELS/*.yml
+  QString sdPath;        // shared (read-only) SD card content
+  QString baselineDir;   // compare against
+  QString outputDir;     // write results to
+  QStringList models;    // all models in dataDir if empty
+  int jobs = 1;
+  int sticks = 4;        // number of analog inputs to move
+  int settleCycles = 50; // mixer cycles to wait after each input change
+  int tolerance = 0;
+  int timeoutMs = 20000;
+};
+
+struct Step {
+  QString name;
+  QVector<int16_t> outputs;
+};
+
+struct ModelResult {
+  QString model;
+  QString error;
+  QVector<Step> steps;
+  QStringList diffs;
+  bool noBaseline = false;  // new model: nothing to compare against
+};
+
+//
+// One firmware instance
+//
+
+class SimuInstance : public WasmHost
+{
+  public:
+    explicit SimuInstance(wasm_module_t module) : m_module(module) {}
+    ~SimuInstance() override { destroy(); }
+
+    bool create(QString & error);
+    bool start(const QString & settingsPath, const QString & sdPath,
+               QString & error);
+    void stop();
+
+    void setAnalog(int idx, int16_t value) { m_analogs[idx] = value; }
+    bool waitMixerCycles(uint32_t cycles, int timeoutMs);
+    QVector<int16_t> channelOutputs();
+
+    // WasmHost (called from the firmware threads): audio, traces and
+    // serial ports are not used by the runner
+    int16_t getAnalogValue(uint8_t index) override
+    {
+      return index < MAX_ANALOGS ? m_analogs[index].load() : 0;
+    }
+    void notifyLcdReady() override { m_lcdPending = true; }
+
+  private:
+    void destroy();
+    uint32_t call(wasm_function_inst_t fn, uint32_t argc = 0,
+                  uint32_t arg0 = 0, uint32_t arg1 = 0);
+    uint32_t dupString(const QByteArray & str);
+
+    wasm_module_t m_module;
+    wasm_module_inst_t m_inst = nullptr;
+    wasm_exec_env_t m_env = nullptr;
+    uint32_t m_scratch = 0;
+    bool m_started = false;
+
+    std::atomic<int16_t> m_analogs[MAX_ANALOGS] = {};
+    std::atomic<bool> m_lcdPending{false};
+
+    wasm_function_inst_t m_fnInit = nullptr;
+    wasm_function_inst_t m_fnStart = nullptr;
+    wasm_function_inst_t m_fnStop = nullptr;
+    wasm_function_inst_t m_fnIsRunning = nullptr;
+    wasm_function_inst_t m_fnFatfsSetPaths = nullptr;
+    wasm_function_inst_t m_fnGetMixerCycles = nullptr;
+    wasm_function_inst_t m_fnCopyChannelOutputs = nullptr;
+    wasm_function_inst_t m_fnLcdFlushed = nullptr;
+    wasm_function_inst_t m_fnMalloc = nullptr;
+    wasm_function_inst_t m_fnFree = nullptr;
+};
+
+// instantiation is not reentrant
+static QMutex s_instantiateMutex;
+
+bool SimuInstance::create(QString & error)
+{
+  char errorBuf[128];
+  uint32_t stackSize = 256 * 1024;
+  uint32_t heapSize = 16 * 1024 * 1024;
+
+  QMutexLocker lckr(&s_instantiateMutex);
+  m_inst = wasm_runtime_instantiate(m_module, stackSize, heapSize, errorBuf,
+                                    sizeof(errorBuf));
+  if (!m_inst) {
+    error = QString("instantiation failed: %1").arg(errorBuf);
+    return false;
+  }
+
+  wasmHostAttach(m_inst, this);
+
+  m_env = wasm_runtime_create_exec_env(m_inst, stackSize);
+  if (!m_env) {
+    error = "failed to create execution environment";
+    return false;
+  }
+
+  m_fnInit = wasm_runtime_lookup_function(m_inst, "simuInit");
+  m_fnStart = wasm_runtime_lookup_function(m_inst, "simuStart");
+  m_fnStop = wasm_runtime_lookup_function(m_inst, "simuStop");
+  m_fnIsRunning = wasm_runtime_lookup_function(m_inst, "simuIsRunning");
+  m_fnFatfsSetPaths = wasm_runtime_lookup_function(m_inst, "simuFatfsSetPaths");
+  m_fnGetMixerCycles = wasm_runtime_lookup_function(m_inst, "simuGetMixerCycles");
+  m_fnCopyChannelOutputs =
+      wasm_runtime_lookup_function(m_inst, "simuCopyChannelOutputs");
+  m_fnLcdFlushed = wasm_runtime_lookup_function(m_inst, "simuLcdFlushed");
+  m_fnMalloc = wasm_runtime_lookup_function(m_inst, "malloc");
+  m_fnFree = wasm_runtime_lookup_function(m_inst, "free");
+
+  if (!m_fnInit || !m_fnStart || !m_fnStop || !m_fnIsRunning ||
+      !m_fnFatfsSetPaths || !m_fnGetMixerCycles || !m_fnCopyChannelOutputs ||
+      !m_fnMalloc || !m_fnFree) {
+    error = "missing WASM exports (firmware too old?)";
+    return false;
+  }
+
+  m_scratch = call(m_fnMalloc, 1, MAX_CHANNELS * sizeof(int16_t));
+  if (!m_scratch) {
+    error = "out of WASM memory";
+    return false;
+  }
+
+  return true;
+}
+
+void SimuInstance::destroy()
+{
+  stop();
+  if (m_env) {
+    wasm_runtime_destroy_exec_env(m_env);
+    m_env = nullptr;
+  }
+  if (m_inst) {
+    QMutexLocker lckr(&s_instantiateMutex);
+    wasm_runtime_deinstantiate(m_inst);
+    m_inst = nullptr;
+  }
+}
+
+uint32_t SimuInstance::call(wasm_function_inst_t fn, uint32_t argc,
+                            uint32_t arg0, uint32_t arg1)
+{
+  uint32_t argv[2] = {arg0, arg1};
+  if (!wasm_runtime_call_wasm(m_env, fn, argc, argv))
+    return 0;
+  return argv[0];
+}
+
+uint32_t SimuInstance::dupString(const QByteArray & str)
+{
+  uint32_t addr = call(m_fnMalloc, 1, str.size() + 1);
+  if (!addr)
+    return 0;
+  auto * native = (char *)wasm_runtime_addr_app_to_native(m_inst, addr);
+  memcpy(native, str.constData(), str.size() + 1);
+  return addr;
+}
+
+bool SimuInstance::start(const QString & settingsPath, const QString & sdPath,
+                         QString & error)
+{
+  call(m_fnInit);
+
+  uint32_t sd = dupString(sdPath.toUtf8());
+  uint32_t settings = dupString(settingsPath.toUtf8());
+  if (!sd || !settings) {
+    error = "out of WASM memory";
+    return false;
+  }
+  call(m_fnFatfsSetPaths, 2, sd, settings);
+  call(m_fnFree, 1, sd);
+  call(m_fnFree, 1, settings);
+
+  // no splash, no calibration, no checks (throttle, switches...)
+  uint32_t argv[2] = {
+      0, (uint32_t)(int32_t)QDateTime::currentDateTime().offsetFromUtc()};
+  if (!wasm_runtime_call_wasm(m_env, m_fnStart, 2, argv)) {
+    error = QString("simuStart failed: %1")
+                .arg(wasm_runtime_get_exception(m_inst));
+    return false;
+  }
+
+  m_started = true;
+  return true;
+}
+
+void SimuInstance::stop()
+{
+  if (!m_started)
+    return;
+  m_started = false;
+
+  // let the UI task finish its frame if it waits for the host
+  if (m_fnLcdFlushed)
+    call(m_fnLcdFlushed);
+  call(m_fnStop);
+}
+
+bool SimuInstance::waitMixerCycles(uint32_t cycles, int timeoutMs)
+{
+  uint32_t start = call(m_fnGetMixerCycles);
+
+  QElapsedTimer timer;
+  timer.start();
+  while (call(m_fnGetMixerCycles) - start < cycles) {
+    // color radios wait for the host to release the frame buffer
+    if (m_lcdPending.exchange(false) && m_fnLcdFlushed)
+      call(m_fnLcdFlushed);
+
+    if (!call(m_fnIsRunning) || timer.elapsed() > timeoutMs)
+      return false;
+    QThread::msleep(1);
+  }
+
+  return true;
+}
+
+QVector<int16_t> SimuInstance::channelOutputs()
+{
+  uint32_t count = call(m_fnCopyChannelOutputs, 2, m_scratch, MAX_CHANNELS);
+  auto * values = (const int16_t *)wasm_runtime_addr_app_to_native(m_inst,
+                                                                  m_scratch);
+  QVector<int16_t> result;
+  for (uint32_t i = 0; i < count && values; i++)
+    result.append(values[i]);
+  return result;
+}
+
+//
+// Model runs
+//
+
+// Radio settings selecting 'model' as the current model
+static QByteArray radioSettingsFor(const QByteArray & radio,
+                                   const QString & model)
+{
+  QString yaml = QString::fromUtf8(radio);
+  QString line = QString("currModelFilename: \"%1\"").arg(model);
+
+  static const QRegularExpression re("^currModelFilename:.*$",
+                                     QRegularExpression::MultilineOption);
+  if (yaml.contains(re))
+    yaml.replace(re, line);
+  else
+    yaml.append(line % "\n");
+
+  return yaml.toUtf8();
+}
+
+static bool prepareSettings(const RunnerOptions & opts, const QString & model,
+                            const QString & dir, QString & error)
+{
+  QFile radio(opts.dataDir % "/RADIO/radio.yml");
+  if (!radio.open(QIODevice::ReadOnly)) {
+    error = "cannot read " % radio.fileName();
+    return false;
+  }
+
+  if (!QDir().mkpath(dir % "/RADIO") || !QDir().mkpath(dir % "/MODELS")) {
+    error = "cannot create " % dir;
+    return false;
+  }
+
+  QFile out(dir % "/RADIO/radio.yml");
+  if (!out.open(QIODevice::WriteOnly) ||
+      out.write(radioSettingsFor(radio.readAll(), model)) < 0) {
+    error = "cannot write " % out.fileName();
+    return false;
+  }
+
+  if (!QFile::copy(opts.dataDir % "/MODELS/" % model,
+                   dir % "/MODELS/" % model)) {
+    error = "cannot copy " % model;
+    return false;
+  }
+
+  return true;
+}
+
+static ModelResult runModel(wasm_module_t module, const RunnerOptions & opts,
+                            const QString & model, const QString & workDir)
+{
+  ModelResult result;
+  result.model = model;
+
+  QString settingsDir = workDir % "/" % QFileInfo(model).completeBaseName();
+  if (!prepareSettings(opts, model, settingsDir, result.error))
+    return result;
+
+  SimuInstance simu(module);
+  QString sdPath = opts.sdPath.isEmpty() ? settingsDir : opts.sdPath;
+  if (!simu.create(result.error) ||
+      !simu.start(settingsDir, sdPath, result.error))
+    return result;
+
+  // wait for the model to be loaded and the mixer running
+  if (!simu.waitMixerCycles(opts.settleCycles, opts.timeoutMs)) {
+    result.error = "mixer not running";
+    return result;
+  }
+
+  auto capture = [&](const QString & name) {
+    if (!simu.waitMixerCycles(opts.settleCycles, opts.timeoutMs))
+      return false;
+    result.steps.append({name, simu.channelOutputs()});
+    return true;
+  };
+
+  bool ok = capture("center");
+  for (int i = 0; ok && i < opts.sticks; i++) {
+    QString input = QString("A%1").arg(i + 1);
+    simu.setAnalog(i, 1024);
+    ok = capture(input % "+");
+    simu.setAnalog(i, -1024);
+    ok = ok && capture(input % "-");
+    simu.setAnalog(i, 0);
+  }
+
+  if (!ok)
+    result.error = "timeout";
+
+  return result;
+}
+
+//
+// Baselines
+//
+
+static QString resultPath(const QString & dir, const QString & model)
+{
+  return dir % "/" % QFileInfo(model).completeBaseName() % ".csv";
+}
+
+static bool writeResult(const QString & dir, const ModelResult & result)
+{
+  QFile file(resultPath(dir, result.model));
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    return false;
+
+  QTextStream out(&file);
+  for (const auto & step : result.steps) {
+    out << step.name;
+    for (auto value : step.outputs)
+      out << "," << value;
+    out << "\n";
+  }
+  return true;
+}
+
+static bool readBaseline(const QString & dir, const QString & model,
+                         QVector<Step> & steps)
+{
+  QFile file(resultPath(dir, model));
+  if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    return false;
+
+  QTextStream in(&file);
+  while (!in.atEnd()) {
+    QStringList fields = in.readLine().split(',');
+    if (fields.size() < 1 || fields[0].isEmpty())
+      continue;
+
+    Step step{fields.takeFirst(), {}};
+    for (const auto & field : fields)
+      step.outputs.append((int16_t)field.toInt());
+    steps.append(step);
+  }
+  return true;
+}
+
+static void compareResult(const RunnerOptions & opts, ModelResult & result)
+{
+  QVector<Step> baseline;
+  if (!readBaseline(opts.baselineDir, result.model, baseline)) {
+    result.noBaseline = true;
+    return;
+  }
+
+  for (const auto & step : result.steps) {
+    auto ref = std::find_if(baseline.begin(), baseline.end(),
+                            [&](const Step & s) { return s.name == step.name; });
+    if (ref == baseline.end()) {
+      result.diffs.append(step.name % ": not in baseline");
+      continue;
+    }
+
+    int count = qMax(step.outputs.size(), ref->outputs.size());
+    for (int ch = 0; ch < count; ch++) {
+      int before = ch < ref->outputs.size() ? ref->outputs[ch] : 0;
+      int after = ch < step.outputs.size() ? step.outputs[ch] : 0;
+      if (qAbs(after - before) > opts.tolerance) {
+        result.diffs.append(QString("%1 CH%2: %3 -> %4")
+                                .arg(step.name)
+                                .arg(ch + 1)
+                                .arg(before)
+                                .arg(after));
+      }
+    }
+  }
+}
+
+//
+// Main
+//
+
+static bool parseOptions(RunnerOptions & opts)
+{
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Runs models in parallel firmware simulator instances and compares "
+      "their channel outputs against a baseline.");
+  parser.addHelpOption();
+
+  const QCommandLineOption optWasm("wasm", "Firmware simulator module.", "file");
+  const QCommandLineOption optData(
+      "data", "Radio data folder (RADIO/radio.yml and MODELS/*.yml).", "path");
+  const QCommandLineOption optSd("sd-path", "SD card content shared by all models.",
+                                 "path");
+  const QCommandLineOption optBaseline("baseline", "Compare against the results in <path>.",
+                                       "path");
+  const QCommandLineOption optOutput("output", "Write the results to <path> (e.g. a new baseline).",
+                                     "path");
+  const QCommandLineOption optJobs("jobs", "Number of models simulated in parallel.", "n");
+  const QCommandLineOption optSticks("sticks", "Number of analog inputs to move (default 4).",
+                                     "n");
+  const QCommandLineOption optCycles("cycles", "Mixer cycles to wait after each input change (default 50).",
+                                     "n");
+  const QCommandLineOption optTolerance("tolerance", "Accepted output difference (default 0).",
+                                        "n");
+  const QCommandLineOption optTimeout("timeout", "Seconds to wait for each step before giving up (default 20).",
+                                      "s");
+
+  parser.addOptions({optWasm, optData, optSd, optBaseline, optOutput, optJobs,
+                     optSticks, optCycles, optTolerance, optTimeout});
+  parser.addPositionalArgument("models", "Models to run (all models in the data folder by default).",
+                               "[models...]");
+  parser.process(*QCoreApplication::instance());
+
+  opts.wasmPath = parser.value(optWasm);
+  opts.dataDir = parser.value(optData);
+  opts.sdPath = parser.value(optSd);
+  opts.baselineDir = parser.value(optBaseline);
+  opts.outputDir = parser.value(optOutput);
+  opts.models = parser.positionalArguments();
+
+  // roughly 4 firmware threads per instance
+  opts.jobs = qMax(1, QThread::idealThreadCount() / 4);
+  if (parser.isSet(optJobs))
+    opts.jobs = qMax(1, parser.value(optJobs).toInt());
+  if (parser.isSet(optSticks))
+    opts.sticks = qBound(0, parser.value(optSticks).toInt(), MAX_ANALOGS);
+  if (parser.isSet(optCycles))
+    opts.settleCycles = qMax(1, parser.value(optCycles).toInt());
+  if (parser.isSet(optTolerance))
+    opts.tolerance = qMax(0, parser.value(optTolerance).toInt());
+  if (parser.isSet(optTimeout))
+    opts.timeoutMs = qMax(1, parser.value(optTimeout).toInt()) * 1000;
+
+  if (opts.wasmPath.isEmpty() || opts.dataDir.isEmpty()) {
+    QTextStream(stderr) << "--wasm and --data are required\n";
+    return false;
+  }
+
+  if (opts.models.isEmpty()) {
+    opts.models = QDir(opts.dataDir % "/MODELS")
+                      .entryList(QStringList() << "model*.yml", QDir::Files,
+                                 QDir::Name);
+    opts.models.removeAll("modelslist.yml");
+  }
+
+  return true;
+}
+
+int main(int argc, char * argv[])
+{
+  QCoreApplication app(argc, argv);
+  app.setApplicationName("simurunner");
+
+  RunnerOptions opts;
+  if (!parseOptions(opts))
+    return 2;
+
+  QTextStream out(stdout);
+
+  QFile file(opts.wasmPath);
+  if (!file.open(QIODevice::ReadOnly)) {
+    QTextStream(stderr) << "cannot read " << opts.wasmPath << "\n";
+    return 2;
+  }
+  QByteArray binary = file.readAll();
+
+  QTemporaryDir workDir(QDir::tempPath() % "/etx-simurunner-XXXXXX");
+  if (!workDir.isValid()) {
+    QTextStream(stderr) << "cannot create work directory\n";
+    return 2;
+  }
+
+  if (!wasm_runtime_init()) {
+    QTextStream(stderr) << "failed to initialize WAMR runtime\n";
+    return 2;
+  }
+  wasm_runtime_set_log_level(WASM_LOG_LEVEL_ERROR);
+  wasmHostRegisterNatives();
+
+  char errorBuf[128];
+  wasm_module_t module = wasm_runtime_load((uint8_t *)binary.data(),
+                                           binary.size(), errorBuf,
+                                           sizeof(errorBuf));
+  if (!module) {
+    QTextStream(stderr) << "failed to load " << opts.wasmPath << ": "
+                        << errorBuf << "\n";
+    wasm_runtime_destroy();
+    return 2;
+  }
+
+  // All instances share the same WASI pre-opened directories: each model
+  // gets its own settings folder below the work directory, where all the
+  // firmware writes go.
+  QByteArray workPath = workDir.path().toUtf8();
+  QByteArray sdPath = opts.sdPath.toUtf8();
+  const char * dirList[2] = {workPath.constData(), sdPath.constData()};
+  wasm_runtime_set_wasi_args(module, dirList, opts.sdPath.isEmpty() ? 1 : 2,
+                             nullptr, 0, nullptr, 0, nullptr, 0);
+
+  if (!opts.outputDir.isEmpty())
+    QDir().mkpath(opts.outputDir);
+
+  QMutex resultsMutex;
+  QVector<ModelResult> results;
+
+  QThreadPool pool;
+  pool.setMaxThreadCount(opts.jobs);
+
+  QElapsedTimer timer;
+  timer.start();
+
+  for (const auto & model : opts.models) {
+    pool.start([&, model]() {
+      wasm_runtime_init_thread_env();
+      ModelResult result = runModel(module, opts, model, workDir.path());
+      wasm_runtime_destroy_thread_env();
+
+      if (result.error.isEmpty() && !opts.baselineDir.isEmpty())
+        compareResult(opts, result);
+      if (result.error.isEmpty() && !opts.outputDir.isEmpty() &&
+          !writeResult(opts.outputDir, result))
+        result.error = "cannot write results";
+
+      QMutexLocker lckr(&resultsMutex);
+      results.append(result);
+    });
+  }
+  pool.waitForDone();
+
+  std::sort(results.begin(), results.end(),
+            [](const ModelResult & a, const ModelResult & b) {
+              return a.model < b.model;
+            });
+
+  int errors = 0, changed = 0, missing = 0;
+  for (const auto & result : results) {
+    if (!result.error.isEmpty()) {
+      out << result.model << ": ERROR " << result.error << "\n";
+      errors++;
+    } else if (result.noBaseline) {
+      out << result.model << ": NO BASELINE\n";
+      missing++;
+    } else if (!result.diffs.isEmpty()) {
+      out << result.model << ": " << result.diffs.size() << " difference(s)\n";
+      for (const auto & diff : result.diffs)
+        out << "  " << diff << "\n";
+      changed++;
+    } else {
+      out << result.model << ": OK\n";
+    }
+  }
+
+  out << results.size() << " model(s), " << changed << " changed, ";
+  if (missing)
+    out << missing << " without baseline, ";
+  out << errors << " error(s) in " << timer.elapsed() / 1000.0 << "s with " << opts.jobs
+      << " job(s)\n";
+  out.flush();
+
+  wasm_runtime_unload(module);
+  wasm_runtime_destroy();
+
+  return errors ? 2 : (changed ? 1 : 0);
+}
@@ -24,8 +24,47 @@
 #include "firmwares/edgetx/edgetxinterface.h"
 #include "progressdialog.h"
 
+#include <QtConcurrent>
 #include <regex>
 
+// Model YAML is decoded and encoded on the global thread pool, file access
+// stays on the calling thread as the archive backends are not reentrant.
+// Results are always consumed in model order so that the resulting
+// RadioData and the progress reporting are deterministic.
+
+namespace {
+
+struct ModelLoadJob {
+  ModelData * model;
+  QByteArray buffer;
+  QString filename;
+  bool interactive;
+};
+
+struct ModelWriteJob {
+  const ModelData * model;
+  QString filename;
+};
+
+struct ModelWriteResult {
+  QByteArray data;
+  bool ok;
+};
+
+QString decodeModel(const ModelLoadJob & job)
+{
+  try {
+    if (!loadModelFromYaml(*job.model, job.buffer))
+      return LabelsStorageFormat::tr("Cannot convert to yaml %1").arg(job.filename);
+  } catch(const std::runtime_error& e) {
+    return LabelsStorageFormat::tr("Cannot convert to yaml %1:\n%2").arg(job.filename).arg(QString(e.what()));
+  }
+
+  return QString();
+}
+
+}
+
 StorageType LabelsStorageFormat::probeFormat()
 {
   if (QFile(filename + "/RADIO/radio.yml").exists()) // converted
@@ -124,14 +163,18 @@ bool LabelsStorageFormat::load(RadioData & radioData)
     radioData.models.resize(modelFiles.size());
 
   QList<QString> modelImages;
+  QList<ModelLoadJob> jobs;
+  QList<const EtxModelfiles::value_type *> jobFiles;
 
+  // read all model files first, the archive readers are not thread safe
   for (const auto& mc : modelFiles) {
     qDebug() << "Filename: " << mc.filename.c_str();
 
     if (!hasLabels) {
       if (mc.modelIdx >= 0 && mc.modelIdx < (int)radioData.models.size()) {
         modelIdx = mc.modelIdx;
-        if (!radioData.models[modelIdx].isEmpty()) {
+        if (!radioData.models[modelIdx].isEmpty() || std::any_of(jobs.begin(), jobs.end(),
+              [&](const ModelLoadJob & job) { return job.model == &radioData.models[modelIdx]; })) {
           statusMsg(tr("Warning: file %1 skipped as slot %2 already used")
                     .arg(mc.filename.c_str()).arg(mc.modelIdx + 1), QtWarningMsg);
           continue;
@@ -154,20 +197,41 @@ bool LabelsStorageFormat::load(RadioData & radioData)
     // Please note:
     //  ModelData() use memset to clear everything to 0
     //
-    auto& model = radioData.models[modelIdx];
+    jobs.append({ &radioData.models[modelIdx], modelBuffer, filename,
+                  isNewerModelVersion(modelBuffer) });
+    jobFiles.append(&mc);
 
-    try {
-      if (!loadModelFromYaml(model,modelBuffer)) {
-        fatalMsg(tr("Cannot convert to yaml %1").arg(filename));
-        return false;
-      }
-    } catch(const std::runtime_error& e) {
-      fatalMsg(tr("Cannot convert to yaml %1:\n%2").arg(filename).arg(QString(e.what())));
+    if (hasLabels)
+      modelIdx++;
+  }
+
+  QFuture<QString> decoded = QtConcurrent::mapped(jobs, [](const ModelLoadJob & job) {
+    return job.interactive ? QString() : decodeModel(job);
+  });
+
+  for (int i = 0; i < jobs.size(); i++) {
+    const ModelLoadJob & job = jobs.at(i);
+    const auto& mc = *jobFiles.at(i);
+    QString error = decoded.resultAt(i);
+
+    if (job.interactive)
+      error = decodeModel(job);
+
+    if (!error.isEmpty()) {
+      decoded.cancel();
+      decoded.waitForFinished();
+      fatalMsg(error);
       return false;
     }
 
-    if (!loadChecklist(model))
+    auto& model = *job.model;
+    modelIdx = (int)(job.model - &radioData.models[0]);
+
+    if (!loadChecklist(model)) {
+      decoded.cancel();
+      decoded.waitForFinished();
       return false;
+    }
 
     if (!model.isBitmapEmpty()) {
       const QString fname(model.getImageFilename());
@@ -184,9 +248,8 @@ bool LabelsStorageFormat::load(RadioData & radioData)
       radioData.generalSettings.currModelIndex = modelIdx;
 
     model.used = true;
-    modelIdx++;
     progressSetValue(++steps);
-    statusMsg(tr("Loaded: %1").arg(filename));
+    statusMsg(tr("Loaded: %1").arg(job.filename));
   }
 
   statusMsg(tr("Loading model images..."));
@@ -236,11 +299,43 @@ bool LabelsStorageFormat::write(RadioData & radioData)
   progressSetMaximum(steps);
   steps = 0;
 
+  QList<ModelWriteJob> jobs;
+
+  for (const auto& model : radioData.models) {
+    if (model.isEmpty())
+      continue;
+
+    QString modelFilename;
+
+    if (hasLabels) {
+      std::string ymlFilename = patchFilenameToYaml(model.filename);
+      modelFilename = QString("MODELS/%1").arg(QString::fromStdString(ymlFilename));
+    } else {
+      modelFilename = QString("MODELS/model%1.yml").arg(model.modelIndex, 2, 10, QLatin1Char('0'));
+    }
+
+    jobs.append({ &model, modelFilename });
+  }
+
+  // start encoding now, it overlaps with the radio settings below
+  QFuture<ModelWriteResult> encoded = QtConcurrent::mapped(jobs, [](const ModelWriteJob & job) {
+    ModelWriteResult result;
+    result.ok = writeModelToYaml(*job.model, result.data);
+    return result;
+  });
+
+  QSet<QString> writtenFiles;
+  for (const auto& job : jobs) {
+    writtenFiles.insert(job.filename.toLower());
+  }
+
   std::list<std::string> filelist;
   getFileList(filelist);
+  QSet<QString> existingFiles;
 
   if (filelist.size()) {
-    // Delete all old modelxx.yml from radio MODELS folder before writing new modelxx.yml files
+    // Delete old modelxx.yml from radio MODELS folder that are not rewritten,
+    // the others are only replaced when their content changed
     progressSetInfoAndMsg(tr("Deleting existing models..."));
 
     progressSetValue(++steps);
@@ -250,11 +345,16 @@ bool LabelsStorageFormat::write(RadioData & radioData)
       std::smatch match;
       if (std::regex_match(f, match, yml_regex)) {
         if (match.size() == 3) {
-          if (!deleteFile(QString(f.c_str()))) {
-            fatalMsg(tr("Unable to delete file: %1").arg(QDir::toNativeSeparators(QString(f.c_str()))));
+          const QString fname(QString(f.c_str()));
+
+          if (writtenFiles.contains(fname.toLower())) {
+            existingFiles.insert(fname.toLower());
+          } else if (!deleteFile(fname)) {
+            encoded.waitForFinished();
+            fatalMsg(tr("Unable to delete file: %1").arg(QDir::toNativeSeparators(fname)));
             return false;
           } else {
-            statusMsg(tr("Deleted file: %1").arg(QString(f.c_str())));
+            statusMsg(tr("Deleted file: %1").arg(fname));
           }
         }
       }
@@ -280,6 +380,7 @@ bool LabelsStorageFormat::write(RadioData & radioData)
         gsNew.inputConfig[i].calib = gsCur.inputConfig[i].calib;
       }
     } else {
+      encoded.waitForFinished();
       fatalMsg(tr("Error reading radio calibration from %1")
                   .arg(displaySettingsPath));
       return false;
@@ -293,11 +394,13 @@ bool LabelsStorageFormat::write(RadioData & radioData)
 
   QByteArray radioSettingsBuffer;
   if (!writeRadioSettingsToYaml(radioData.generalSettings, radioSettingsBuffer)) {
+    encoded.waitForFinished();
     fatalMsg(tr("Error converting radio settings to yaml"));
     return false;
   }
 
   if (!writeFile(radioSettingsBuffer, settingsPath)) {
+    encoded.waitForFinished();
     fatalMsg(tr("Error writing: %1").arg(displaySettingsPath));
     return false;
   }
@@ -305,32 +408,30 @@ bool LabelsStorageFormat::write(RadioData & radioData)
   progressSetValue(++steps);
   progressSetInfoAndMsg(tr("Writing models..."));
 
-  EtxModelfiles modelFiles;
   QList<QString> modelImages;
 
-  for (const auto& model : radioData.models) {
-    if (model.isEmpty())
-      continue;
-
-    QString modelFilename;
-
-    if (hasLabels) {
-      std::string ymlFilename = patchFilenameToYaml(model.filename);
-      modelFilename = QString("MODELS/%1").arg(QString::fromStdString(ymlFilename));
-      modelFiles.push_back({ymlFilename, std::string(model.name)});
-    } else {
-      modelFilename = QString("MODELS/model%1.yml").arg(model.modelIndex, 2, 10, QLatin1Char('0'));
-    }
+  for (int i = 0; i < jobs.size(); i++) {
+    const ModelData & model = *jobs.at(i).model;
+    const QString & modelFilename = jobs.at(i).filename;
+    const ModelWriteResult result = encoded.resultAt(i);
 
-    QByteArray modelData;
-    if (!writeModelToYaml(model, modelData)) {
+    if (!result.ok) {
+      encoded.waitForFinished();
       fatalMsg(tr("Error converting model to yaml: %1").arg(model.name.toQString()));
       return false;
     }
 
-    if (!writeFile(modelData, modelFilename)) {
+    QByteArray current;
+    if (existingFiles.contains(modelFilename.toLower()) &&
+        loadFile(current, modelFilename, true) &&
+        current == result.data) {
+      statusMsg(tr("Model unchanged: %1").arg(model.name.toQString()));
+    } else if (!writeFile(result.data, modelFilename)) {
+      encoded.waitForFinished();
       fatalMsg(tr("Error writing: %1").arg(QDir::toNativeSeparators(filename % "/" % modelFilename)));
       return false;
+    } else {
+      statusMsg(tr("Model written: %1").arg(model.name.toQString()));
     }
 
     if (!model.isBitmapEmpty()) {
@@ -341,10 +442,11 @@ bool LabelsStorageFormat::write(RadioData & radioData)
       }
     }
 
-    if (!writeChecklist(model))
+    if (!writeChecklist(model)) {
+      encoded.waitForFinished();
       return false;
+    }
 
-    statusMsg(tr("Model written: %1").arg(model.name.toQString()));
     progressSetValue(++steps);
   }
 
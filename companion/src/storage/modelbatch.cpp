@@ -0,0 +1,282 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "modelbatch.h"
+#include "eeprominterface.h"
+#include "radiodataconversionstate.h"
+#include "firmwares/edgetx/edgetxinterface.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QMutex>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <vector>
+
+// Number of models decoded before they are converted: bounds the memory
+// used, while keeping the firmware switches between phases rare
+constexpr int MODELS_PER_THREAD_CHUNK = 8;
+
+struct ModelBatch::Job {
+  explicit Job(const QString & file) { report.file = file; }
+
+  ModelBatchReport report;
+  QByteArray source;
+  ModelData model;
+  bool decoded = false;
+};
+
+ModelBatch::ModelBatch(const Options & options, QObject * parent) :
+  QObject(parent),
+  options(options),
+  canceled(false)
+{
+  qRegisterMetaType<ModelBatchReport>();
+}
+
+ModelBatch::~ModelBatch()
+{
+  cancel();
+  waitForFinished();
+}
+
+void ModelBatch::decode(Job & job) const
+{
+  ModelBatchReport & report = job.report;
+
+  if (canceled) {
+    report.errors << tr("Canceled");
+    return;
+  }
+
+  QFile file(report.file);
+  if (!file.open(QIODevice::ReadOnly)) {
+    report.errors << tr("Cannot open: %1").arg(file.errorString());
+    return;
+  }
+  job.source = file.readAll();
+
+  // decoding would ask the user what to do
+  if (isNewerModelVersion(job.source)) {
+    report.errors << tr("Model written by a newer firmware version");
+    return;
+  }
+
+  try {
+    job.decoded = loadModelFromYaml(job.model, job.source);
+  } catch (const std::runtime_error & e) {
+    report.errors << tr("Cannot decode: %1").arg(e.what());
+  }
+}
+
+void ModelBatch::process(Job & job, const GeneralSettings & convertedSettings) const
+{
+  ModelBatchReport & report = job.report;
+
+  if (job.decoded && !canceled) {
+    if (fromFw != toFw) {
+      // the capability sized model list is only allocated once per thread
+      static thread_local RadioData radio;
+      radio.models.resize(1);
+      radio.models[0] = job.model;
+      radio.generalSettings = options.settings;
+
+      RadioDataConversionState cstate(fromFw->getBoard(), toFw->getBoard(), &radio);
+      radio.generalSettings = convertedSettings;
+      radio.models[0].convert(cstate.withModelIndex(0));
+      job.model = radio.models[0];
+
+      for (const auto & record : cstate.log) {
+        int event = record.fields.at(RadioDataConversionState::FLD_EVT_TYPE).id;
+        if (event < RadioDataConversionState::EVT_WRN)
+          continue;
+        QStringList fields;
+        for (int fld : { RadioDataConversionState::FLD_COMP, RadioDataConversionState::FLD_SUB_COMP,
+                         RadioDataConversionState::FLD_COMP_FIELD, RadioDataConversionState::FLD_ITM_BEFORE,
+                         RadioDataConversionState::FLD_MSG, RadioDataConversionState::FLD_ITM_AFTER }) {
+          if (!record.fields.at(fld).name.isEmpty())
+            fields << record.fields.at(fld).name;
+        }
+        report.messages << QString("%1: %2").arg(cstate.eventTypeToString(event)).arg(fields.join(" "));
+      }
+    }
+
+    if (options.transform)
+      options.transform(job.model, report);
+
+    if (options.validate) {
+      job.model.validate();
+      if (!job.model.isValid()) {
+        for (const QString & error : job.model.errorsList()) {
+          if (!error.isEmpty())
+            report.errors << error;
+        }
+      }
+    }
+
+    if (options.operation != OP_VALIDATE) {
+      QByteArray data;
+      if (!writeModelToYaml(job.model, data))
+        report.errors << tr("Cannot encode");
+      else {
+        report.changed = (data != job.source);
+        writeOutput(job, data);
+      }
+    }
+  }
+
+  report.ok = job.decoded && report.errors.isEmpty();
+
+  // not needed anymore, while the rest of the chunk is processed
+  job.source.clear();
+}
+
+bool ModelBatch::writeOutput(Job & job, const QByteArray & data) const
+{
+  ModelBatchReport & report = job.report;
+
+  QString path = report.file;
+  if (!options.outputDir.isEmpty()) {
+    // models of several folders may have the same name
+    QString relative = inputDir.relativeFilePath(QFileInfo(report.file).absoluteFilePath());
+    path = QDir(options.outputDir).filePath(relative);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+  }
+  else if (!report.changed)
+    return true;  // left untouched
+
+  QSaveFile file(path);
+  if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+    report.errors << tr("Cannot write %1: %2").arg(path).arg(file.errorString());
+    return false;
+  }
+
+  report.output = path;
+  return true;
+}
+
+// Deepest folder containing all the files
+static QString commonFolder(const QStringList & files)
+{
+  QStringList common;
+  for (int i = 0; i < files.size(); i++) {
+    QStringList parts = QFileInfo(files.at(i)).absolutePath().split('/');
+    if (i == 0) {
+      common = parts;
+      continue;
+    }
+    int count = 0;
+    while (count < common.size() && count < parts.size() && common.at(count) == parts.at(count))
+      count++;
+    common = common.mid(0, count);
+  }
+
+  QString folder = common.join('/');
+  return folder.isEmpty() ? QString("/") : folder;
+}
+
+bool ModelBatch::switchesFirmware() const
+{
+  Firmware * current = Firmware::getCurrentVariant();
+  Firmware * from = options.from ? options.from : current;
+  Firmware * to = (options.operation == OP_CONVERT && options.to) ? options.to : from;
+  return from != current || to != current;
+}
+
+int ModelBatch::run(const QStringList & files, const ReportCallback & onReport)
+{
+  Firmware * previous = Firmware::getCurrentVariant();
+  fromFw = options.from ? options.from : previous;
+  toFw = (options.operation == OP_CONVERT && options.to) ? options.to : fromFw;
+
+  if (!options.outputDir.isEmpty()) {
+    QDir().mkpath(options.outputDir);
+    inputDir = QDir(commonFolder(files));
+  }
+
+  QThreadPool pool;
+  if (options.jobs > 0)
+    pool.setMaxThreadCount(options.jobs);
+
+  // the radio settings are the same for all the models
+  GeneralSettings convertedSettings = options.settings;
+  if (fromFw != toFw) {
+    Firmware::setCurrentVariant(toFw);
+    RadioData radio;
+    radio.models.clear();
+    radio.generalSettings = options.settings;
+    RadioDataConversionState cstate(fromFw->getBoard(), toFw->getBoard(), &radio);
+    radio.generalSettings.convert(cstate.withModelIndex(-1));
+    convertedSettings = radio.generalSettings;
+  }
+
+  QMutex reportMutex;
+  int errors = 0;
+  auto deliver = [&](const ModelBatchReport & report) {
+    QMutexLocker locker(&reportMutex);
+    if (!report.ok)
+      errors++;
+    if (onReport)
+      onReport(report);
+  };
+
+  const int chunkSize = pool.maxThreadCount() * MODELS_PER_THREAD_CHUNK;
+  for (int first = 0; first < files.size() && !canceled; first += chunkSize) {
+    std::vector<Job> jobs;
+    jobs.reserve(chunkSize);
+    for (int i = first; i < files.size() && i < first + chunkSize; i++)
+      jobs.emplace_back(files.at(i));
+
+    Firmware::setCurrentVariant(fromFw);
+    if (fromFw != toFw) {
+      QtConcurrent::blockingMap(&pool, jobs, [this](Job & job) {
+        decode(job);
+      });
+      Firmware::setCurrentVariant(toFw);
+      QtConcurrent::blockingMap(&pool, jobs, [&](Job & job) {
+        process(job, convertedSettings);
+        deliver(job.report);
+      });
+    }
+    else {
+      QtConcurrent::blockingMap(&pool, jobs, [&](Job & job) {
+        decode(job);
+        process(job, convertedSettings);
+        deliver(job.report);
+      });
+    }
+  }
+
+  Firmware::setCurrentVariant(previous);
+  return errors;
+}
+
+bool ModelBatch::start(const QStringList & files)
+{
+  // the GUI keeps using the current firmware meanwhile
+  if (switchesFirmware())
+    return false;
+
+  canceled = false;
+  future = QtConcurrent::run([this, files]() {
+    int errors = run(files, [this](const ModelBatchReport & report) {
+      emit modelDone(report);
+    });
+    emit finished(errors);
+  });
+  return true;
+}
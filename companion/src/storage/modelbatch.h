@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include "generalsettings.h"
+
+#include <QDir>
+#include <QFuture>
+#include <QObject>
+#include <QStringList>
+
+#include <atomic>
+#include <functional>
+
+class Firmware;
+class ModelData;
+
+struct ModelBatchReport {
+  QString file;          // source model file
+  QString output;        // written file, empty if not written
+  bool ok = false;       // decoded, and valid if validating
+  bool changed = false;  // output differs from the source
+  QStringList errors;
+  QStringList messages;  // conversion log, warnings and above
+};
+
+// Processes YAML model files (radio MODELS/*.yml) without any user
+// interaction: each model is decoded, optionally converted to another
+// radio, validated and encoded again. Models are processed in parallel,
+// a report is delivered for each of them as soon as it is done, and the
+// output files are replaced atomically (QSaveFile).
+//
+// As the YAML decoding and the conversion both use the current firmware,
+// a batch with other firmwares than the current one switches it between
+// the decoding and the converting phases of each chunk of models, and
+// restores it when done: nothing else may use the firmware meanwhile. Such
+// a batch can only be run(), from the thread owning the firmware, eg. by a
+// command line tool: start() refuses it.
+class ModelBatch : public QObject
+{
+  Q_OBJECT
+
+  public:
+    enum Operation {
+      OP_VALIDATE,  // decode and validate only, nothing written
+      OP_REEXPORT,  // decode and write again with the current firmware
+      OP_CONVERT,   // decode with "from", convert and write with "to"
+    };
+
+    struct Options {
+      Operation operation = OP_VALIDATE;
+      Firmware * from = nullptr;  // current firmware if null
+      Firmware * to = nullptr;    // OP_CONVERT only
+      // models rewritten in place if empty, else written with their path
+      // relative to the folder containing all of them
+      QString outputDir;
+      int jobs = 0;               // ideal thread count if 0
+      bool validate = true;       // report invalid models as errors
+      GeneralSettings settings;   // radio settings for the conversion
+      // applied to each model before validation, eg. to remap sources
+      std::function<void(ModelData &, ModelBatchReport &)> transform;
+    };
+
+    typedef std::function<void(const ModelBatchReport &)> ReportCallback;
+
+    explicit ModelBatch(const Options & options, QObject * parent = nullptr);
+    ~ModelBatch();
+
+    // Blocking: reports are delivered to the callback from the worker
+    // threads, one at a time. Returns the number of models with errors.
+    int run(const QStringList & files, const ReportCallback & onReport = ReportCallback());
+
+    // Runs in the background, reports are delivered by the signals.
+    // Returns false, without starting, if the firmware has to be switched.
+    bool start(const QStringList & files);
+    void cancel() { canceled = true; }
+    bool isRunning() const { return future.isRunning(); }
+    void waitForFinished() { future.waitForFinished(); }
+
+  signals:
+    void modelDone(const ModelBatchReport & report);
+    void finished(int errors);
+
+  private:
+    struct Job;
+
+    void decode(Job & job) const;
+    void process(Job & job, const GeneralSettings & convertedSettings) const;
+    bool writeOutput(Job & job, const QByteArray & data) const;
+    bool switchesFirmware() const;
+
+    Options options;
+    Firmware * fromFw = nullptr;
+    Firmware * toFw = nullptr;
+    QDir inputDir;  // contains all the models
+    std::atomic<bool> canceled;
+    QFuture<void> future;
+};
+
+Q_DECLARE_METATYPE(ModelBatchReport)
@@ -34,11 +34,15 @@
 #include "gtests.h"
 
 #include <QByteArray>
+#include <QElapsedTimer>
+#include <cstring>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include "firmwares/eeprominterface.h"
 #include "firmwares/edgetx/edgetxinterface.h"
+#include "firmwares/edgetx/yaml_modeldata.h"
 
 namespace {
 
@@ -53,6 +57,275 @@ ModelData roundTrip(const ModelData& in, QByteArray& yamlOut)
   return out;
 }
 
+// The YAML emitted from the node tree of convert<ModelData>, which is loaded
+// from the streamed output.
+std::string nodeYaml(const ModelData& model)
+{
+  YAML::Node node;
+  node = model;
+  std::stringstream os;
+  os << node;
+  return os.str();
+}
+
+std::string streamedYaml(const ModelData& model)
+{
+  QByteArray data;
+  EXPECT_TRUE(writeModelToYaml(model, data));
+  return data.toStdString();
+}
+
+// A model using most of the sections, varied by seed.
+ModelData makeModel(int seed)
+{
+  ModelData m;
+  m.clear();
+  m.used = true;
+  m.name = "Model" + std::to_string(seed);
+  m.labels = (seed % 2) ? "fav,race" : "park";
+
+  m.timers[0].mode = TimerData::TIMERMODE_ON;
+  m.timers[0].val = 60 + seed;
+  strcpy(m.timers[0].name, "T1");
+  m.timers[1].mode = TimerData::TIMERMODE_START;
+  m.timers[1].swtch = RawSwitch(SWITCH_TYPE_VIRTUAL, 1 + seed % 4);
+  m.timers[1].countdownBeep = TimerData::COUNTDOWNBEEP_VOICE + 2;  // extra haptic
+
+  m.flightModeData[1].swtch = RawSwitch(SWITCH_TYPE_VIRTUAL, 2);
+  strcpy(m.flightModeData[1].name, "Thermal");
+  m.flightModeData[1].trimMode[0] = 0;
+  m.flightModeData[1].trimRef[0] = 1;
+  m.flightModeData[1].trim[1] = -12 - seed;
+  m.flightModeData[1].gvars[0] = 25;
+
+  for (int i = 0; i < 4 + seed % 8; i++) {
+    ExpoData& expo = m.expoData[i];
+    expo.chn = i;
+    expo.mode = INPUT_MODE_BOTH;
+    expo.srcRaw = RawSource(SOURCE_TYPE_INPUT, i + 1);
+    expo.weight = 100 - i;
+    expo.offset = seed % 5;
+    if (i == 1)
+      expo.curve = CurveReference(CurveReference::CURVE_REF_EXPO, 30);
+    snprintf(m.inputNames[i], sizeof(m.inputNames[i]), "I%d", i);
+  }
+
+  for (int i = 0; i < 8 + seed % 16; i++) {
+    MixData& mix = m.mixData[i];
+    mix.destCh = 1 + i % 8;
+    mix.srcRaw = RawSource(SOURCE_TYPE_VIRTUAL_INPUT, i % 4);
+    mix.weight = (i % 3) ? 100 : -50;
+    mix.sOffset = i;
+    mix.mltpx = (i % 2) ? MLTPX_MUL : MLTPX_ADD;
+    if (i == 2)
+      mix.curve = CurveReference(CurveReference::CURVE_REF_CUSTOM, 2);
+    if (i == 3)
+      mix.swtch = RawSwitch(SWITCH_TYPE_VIRTUAL, 3);
+    snprintf(mix.name, sizeof(mix.name), "M%d", i);
+  }
+
+  for (int i = 0; i < 8; i++) {
+    m.limitData[i].min = -1000 + 10 * i;
+    m.limitData[i].offset = (i == 3) ? 10001 : seed;
+    m.limitData[i].revert = (i == 5);
+  }
+  m.limitData[6].failsafe = -200;
+
+  m.curves[0].count = 5;
+  m.curves[0].points[2].y = 10;
+  strcpy(m.curves[0].name, "C1");
+  m.curves[1].type = CurveData::CURVE_TYPE_CUSTOM;
+  m.curves[1].count = 5;
+  for (int k = 0; k < 5; k++) {
+    m.curves[1].points[k].x = -100 + 50 * k - (k % 4 ? seed % 7 : 0);
+    m.curves[1].points[k].y = -80 + 40 * k;
+  }
+
+  m.logicalSw[0].func = LS_FN_VPOS;
+  m.logicalSw[0].val1 = RawSource(SOURCE_TYPE_INPUT, 1).toValue();
+  m.logicalSw[0].val2 = seed;
+  m.logicalSw[1].func = LS_FN_AND;
+  m.logicalSw[1].val1 = RawSwitch(SWITCH_TYPE_VIRTUAL, 1).toValue();
+  m.logicalSw[1].val2 = RawSwitch(SWITCH_TYPE_VIRTUAL, 2).toValue();
+  m.logicalSw[1].delay = 5;
+  m.logicalSw[2].func = LS_FN_TIMER;
+  m.logicalSw[2].val1 = 10;
+  m.logicalSw[2].val2 = 20;
+
+  m.customFn[0].swtch = RawSwitch(SWITCH_TYPE_VIRTUAL, 1);
+  m.customFn[0].func = FuncPlaySound;
+
+  strcpy(m.gvarData[0].name, "GV1");
+  m.gvarData[0].min = -100;
+  m.gvarData[0].max = 100;
+  m.gvarData[0].popup = true;
+
+  strcpy(m.sensorData[0].label, "RSSI");
+  m.sensorData[0].id = 0xF101;
+  m.sensorData[0].unit = 1;
+
+  return m;
+}
+
+// Every field written directly by the streamed writers set to a value
+// other than its default, so that a field forgotten or written differently
+// by either path shows.
+ModelData makeFullModel()
+{
+  ModelData m = makeModel(5);
+  strcpy(m.bitmap, "plane.png");
+
+  for (int i = 0; i < 2; i++) {
+    TimerData& t = m.timers[i];
+    t.swtch = RawSwitch(SWITCH_TYPE_VIRTUAL, 4);
+    t.mode = TimerData::TIMERMODE_THR_REL;
+    strcpy(t.name, "Full");
+    t.minuteBeep = true;
+    t.countdownBeep = TimerData::COUNTDOWNBEEP_VOICE + i;
+    t.val = 125;
+    t.persistent = 2;
+    t.countdownStart = -1;
+    t.pvalue = 37;
+    t.showElapsed = 1;
+  }
+
+  m.noGlobalFunctions = true;
+  m.thrTrim = true;
+  m.trimInc = 2;
+  m.trimsDisplay = 1;
+  m.frsky.ignoreSensorIds = true;
+  m.showInstanceIds = true;
+  m.disableThrottleWarning = true;
+  m.enableCustomThrottleWarning = true;
+  m.customThrottleWarningPosition = -40;
+  m.beepANACenter = 0x05;
+  m.extendedLimits = true;
+  m.extendedTrims = true;
+  m.throttleReversed = true;
+  m.checklistInteractive = true;
+
+  for (int i = 0; i < 3; i++) {
+    FlightModeData& fm = m.flightModeData[i];
+    if (i > 0)
+      fm.swtch = RawSwitch(SWITCH_TYPE_VIRTUAL, i + 4);
+    snprintf(fm.name, sizeof(fm.name), "FM%d", i);
+    fm.fadeIn = 10 + i;
+    fm.fadeOut = 20 + i;
+    fm.trimMode[0] = -1;  // trim disabled
+    fm.trimMode[1] = 2 * CPN_MAX_FLIGHT_MODES;  // 3POS toggle switch
+    fm.trimMode[2] = 1;
+    fm.trimRef[2] = i ? 0 : 1;
+    fm.trim[2] = 33;
+    fm.gvars[1] = 42 + i;
+  }
+
+  MixData& mix = m.mixData[0];
+  mix.swtch = RawSwitch(SWITCH_TYPE_VIRTUAL, 2);
+  mix.curve = CurveReference(CurveReference::CURVE_REF_FUNC, 3);
+  mix.delayPrec = 1;
+  mix.delayUp = 11;
+  mix.delayDown = 12;
+  mix.speedPrec = 1;
+  mix.speedUp = 13;
+  mix.speedDown = 14;
+  mix.carryTrim = 1;
+  mix.mltpx = MLTPX_REP;
+  mix.mixWarn = 2;
+  mix.flightModes = 0x05;
+
+  ExpoData& expo = m.expoData[0];
+  expo.scale = 50;
+  expo.mode = INPUT_MODE_POS;
+  expo.swtch = RawSwitch(SWITCH_TYPE_VIRTUAL, 3);
+  expo.flightModes = 0x0a;
+  expo.curve = CurveReference(CurveReference::CURVE_REF_DIFF, -20);
+  expo.carryTrim = 1;
+  strcpy(expo.name, "Rate");
+
+  LimitData& limit = m.limitData[2];
+  limit.max = 1200;
+  limit.ppmCenter = 25;
+  limit.symetrical = true;
+  strcpy(limit.name, "Flap");
+  limit.curve = CurveReference(CurveReference::CURVE_REF_CUSTOM, 1);
+
+  m.curves[1].smooth = true;
+  strcpy(m.curves[1].name, "C2");
+
+  LogicalSwitchData& ls = m.logicalSw[3];
+  ls.func = LS_FN_VPOS;
+  ls.val1 = RawSource(SOURCE_TYPE_INPUT, 2).toValue();
+  ls.val2 = -10;
+  ls.delay = 3;
+  ls.duration = 4;
+  ls.andsw = RawSwitch(SWITCH_TYPE_VIRTUAL, 1).toValue();
+  ls.lsPersist = true;
+  ls.lsState = true;
+
+  GVarData& gv = m.gvarData[1];
+  strcpy(gv.name, "GV2");
+  gv.min = -50;
+  gv.max = 75;
+  gv.prec = 1;
+  gv.unit = 1;
+
+  m.thrTraceSrc = 3;
+  m.thrTrimSwitch = 2;
+  m.potsWarningMode = 2;
+  m.potsWarnEnabled[1] = true;
+  m.potsWarnPosition[1] = -20;
+  m.jitterFilter = 2;
+  m.displayChecklist = true;
+  m.telemetryProtocol = 1;
+
+  m.frsky.varioSource = 2;
+  m.frsky.varioCenterSilent = true;
+  m.frsky.varioCenterMax = 3;
+  m.frsky.varioCenterMin = -3;
+  m.frsky.varioMin = -8;
+  m.frsky.varioMax = 8;
+  m.frsky.voltsSource = 3;
+  m.frsky.altitudeSource = 4;
+  m.rssiSource = 1;
+  m.rssiAlarms.warning = 50;
+  m.rssiAlarms.critical = 40;
+  m.rssiAlarms.disabled = true;
+
+  m.moduleData[1].protocol = PULSES_PPM;
+  m.moduleData[1].modelId = 7;
+  m.trainerMode = TRAINER_MODE_MASTER_JACK;
+  m.moduleData[2].channelsStart = 2;
+  m.moduleData[2].channelsCount = 10;
+  m.moduleData[2].ppm.frameLength = 4;
+  m.moduleData[2].ppm.delay = 400;
+  m.moduleData[2].ppm.pulsePol = true;
+
+  m.toplcdTimer = 1;
+  m.topbarWidgetWidth[0] = 2;
+  m.view = 3;
+  strcpy(m.registrationId, "ABCD");
+  m.hatsMode = 1;
+  m.cfsGroupOn[1] = 1;
+
+  m.usbJoystickExtMode = 1;
+  m.usbJoystickIfMode = 2;
+  m.usbJoystickCircularCut = 1;
+
+  m.radioThemesDisabled = 1;
+  m.radioGFDisabled = 2;
+  m.radioTrainerDisabled = 1;
+  m.modelHeliDisabled = 2;
+  m.modelFMDisabled = 1;
+  m.modelCurvesDisabled = 2;
+  m.modelGVDisabled = 1;
+  m.modelLSDisabled = 2;
+  m.modelSFDisabled = 1;
+  m.modelCustomScriptsDisabled = 2;
+  m.modelTelemetryDisabled = 1;
+
+  return m;
+}
+
 class ModelYamlRoundTrip : public ::testing::Test
 {
  protected:
@@ -124,3 +397,56 @@ TEST_F(ModelYamlRoundTrip, OverlongNameTruncatesAndRoundTrips)
   ModelData m3 = roundTrip(m2, y2);
   EXPECT_EQ(m2.name.str(), m3.name.str());
 }
+
+// The streamed model YAML is byte for byte the one emitted from its node
+// tree: it is well formed and already in the emitter's own form.
+TEST_F(ModelYamlRoundTrip, StreamedYamlMatchesNodeTree)
+{
+  ModelData empty;
+  empty.clear();
+  EXPECT_EQ(nodeYaml(empty), streamedYaml(empty));
+
+  for (int seed = 0; seed < 8; seed++) {
+    ModelData m = makeModel(seed);
+    EXPECT_EQ(nodeYaml(m), streamedYaml(m)) << "model seed " << seed;
+  }
+
+  // on a radio without color LCD (telemetry screens, other sources)
+  Firmware::setCurrentVariant(Firmware::getFirmwareForFlavour("x9d+"));
+  ModelData m = makeModel(3);
+  EXPECT_EQ(nodeYaml(m), streamedYaml(m));
+}
+
+// Same with every field set, on radios covering the board specific parts
+// (telemetry screens and sources, top LCD, function switches).
+TEST_F(ModelYamlRoundTrip, StreamedYamlCoversEveryField)
+{
+  ModelData m = makeFullModel();
+  for (const char* flavour : { "tx16s", "x9d+", "x9e", "t15" }) {
+    Firmware::setCurrentVariant(Firmware::getFirmwareForFlavour(flavour));
+    EXPECT_EQ(nodeYaml(m), streamedYaml(m)) << "radio " << flavour;
+  }
+}
+
+// Not a pass/fail check: timings of the streamed writer over a large model
+// set. Opt-in: run with --gtest_also_run_disabled_tests
+TEST_F(ModelYamlRoundTrip, DISABLED_StreamedYamlBenchmark)
+{
+  constexpr int MODEL_COUNT = 500;
+  std::vector<ModelData> models;
+  for (int i = 0; i < MODEL_COUNT; i++)
+    models.push_back(makeModel(i));
+
+  size_t streamedBytes = 0;
+  QByteArray data;
+  QElapsedTimer timer;
+  timer.start();
+  for (const auto& m : models) {
+    writeModelToYaml(m, data);
+    streamedBytes += data.size();
+  }
+  qint64 streamedNs = timer.nsecsElapsed();
+
+  printf("%d models, %zu bytes: streamed %.1f ms\n", MODEL_COUNT,
+         streamedBytes, streamedNs / 1e6);
+}
@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "gtests.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+
+#include "firmwares/eeprominterface.h"
+#include "firmwares/edgetx/edgetxinterface.h"
+#include "storage/modelbatch.h"
+
+namespace {
+
+constexpr int MODEL_COUNT = 20;
+
+bool writeFile(const QString& path, const QByteArray& data)
+{
+  QFile file(path);
+  return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+QByteArray readFile(const QString& path)
+{
+  QFile file(path);
+  return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+class ModelBatchTest : public ::testing::Test
+{
+ protected:
+  QTemporaryDir dir;
+  QStringList files;
+  Firmware* tx16s = nullptr;
+
+  void SetUp() override
+  {
+    tx16s = Firmware::getFirmwareForFlavour("tx16s");
+    Firmware::setCurrentVariant(tx16s);
+    ASSERT_TRUE(dir.isValid());
+
+    for (int i = 0; i < MODEL_COUNT; i++) {
+      ModelData model;
+      model.clear();
+      model.used = true;
+      model.name = QString("Model%1").arg(i).toStdString();
+
+      QByteArray data;
+      ASSERT_TRUE(writeModelToYaml(model, data));
+      QString path = dir.filePath(QString("model%1.yml").arg(i, 2, 10, QChar('0')));
+      ASSERT_TRUE(writeFile(path, data));
+      files << path;
+    }
+  }
+};
+
+}  // namespace
+
+TEST_F(ModelBatchTest, ReexportInParallel)
+{
+  ModelBatch::Options options;
+  options.operation = ModelBatch::OP_REEXPORT;
+  options.outputDir = dir.filePath("out");
+  options.jobs = 4;
+
+  // reports are delivered one at a time
+  QStringList reported;
+  ModelBatch batch(options);
+  int errors = batch.run(files, [&](const ModelBatchReport& report) {
+    reported << report.file;
+    EXPECT_TRUE(report.ok) << report.file.toStdString() << ": "
+                           << report.errors.join(", ").toStdString();
+    EXPECT_FALSE(report.output.isEmpty());
+  });
+
+  EXPECT_EQ(0, errors);
+  reported.sort();
+  EXPECT_EQ(files, reported);
+  EXPECT_EQ(tx16s, getCurrentFirmware());
+
+  for (int i = 0; i < MODEL_COUNT; i++) {
+    ModelData model;
+    QByteArray data = readFile(dir.filePath("out/" + QFileInfo(files.at(i)).fileName()));
+    ASSERT_FALSE(data.isEmpty());
+    loadModelFromYaml(model, data);
+    EXPECT_EQ(QString("Model%1").arg(i).toStdString(), model.name.str());
+  }
+}
+
+TEST_F(ModelBatchTest, BrokenAndNewerModelsReported)
+{
+  ASSERT_TRUE(writeFile(files.at(3), "header: [ name: broken\n"));
+
+  // would prompt the user if decoded
+  QString newer = QString::fromUtf8(readFile(files.at(5)));
+  newer.replace(QRegularExpression("^semver:.*$", QRegularExpression::MultilineOption),
+                "semver: 99.0.0");
+  ASSERT_TRUE(writeFile(files.at(5), newer.toUtf8()));
+
+  QByteArray unchanged = readFile(files.at(0));
+
+  ModelBatch::Options options;
+  options.jobs = 4;
+  QStringList failed;
+  ModelBatch batch(options);
+  int errors = batch.run(files, [&](const ModelBatchReport& report) {
+    if (!report.ok)
+      failed << report.file;
+    EXPECT_TRUE(report.output.isEmpty());
+  });
+
+  EXPECT_EQ(2, errors);
+  failed.sort();
+  EXPECT_EQ(QStringList({files.at(3), files.at(5)}), failed);
+
+  // validating does not write anything
+  EXPECT_EQ(unchanged, readFile(files.at(0)));
+}
+
+TEST_F(ModelBatchTest, NewerVersionFoundPastHeader)
+{
+  // semver written after the rest of the model
+  QString newer = QString::fromUtf8(readFile(files.at(2)));
+  newer.remove(QRegularExpression("^semver:.*\\n", QRegularExpression::MultilineOption));
+  newer += "semver: 99.0.0\n";
+  ASSERT_GT(newer.size(), 256);
+  ASSERT_TRUE(writeFile(files.at(2), newer.toUtf8()));
+
+  EXPECT_TRUE(isNewerModelVersion(newer.toUtf8()));
+  EXPECT_FALSE(isNewerModelVersion(readFile(files.at(0))));
+
+  // nested keys are not the model version
+  EXPECT_FALSE(isNewerModelVersion("header:\n  semver: 99.0.0\n"));
+
+  ModelBatch::Options options;
+  options.jobs = 2;
+  ModelBatch batch(options);
+  EXPECT_EQ(1, batch.run(QStringList({files.at(0), files.at(2)})));
+}
+
+TEST_F(ModelBatchTest, ConvertToAnotherRadio)
+{
+  Firmware* x7 = Firmware::getFirmwareForFlavour("x7");
+  ASSERT_NE(tx16s, x7);
+
+  ModelBatch::Options options;
+  options.operation = ModelBatch::OP_CONVERT;
+  options.from = tx16s;
+  options.to = x7;
+  options.outputDir = dir.filePath("x7");
+  options.jobs = 3;
+
+  int done = 0;
+  ModelBatch batch(options);
+  int errors = batch.run(files, [&](const ModelBatchReport& report) {
+    EXPECT_TRUE(report.ok) << report.errors.join(", ").toStdString();
+    done++;
+  });
+
+  EXPECT_EQ(0, errors);
+  EXPECT_EQ(MODEL_COUNT, done);
+
+  // the previous firmware is restored
+  EXPECT_EQ(tx16s, getCurrentFirmware());
+
+  Firmware::setCurrentVariant(x7);
+  ModelData model;
+  loadModelFromYaml(model, readFile(dir.filePath("x7/model07.yml")));
+  EXPECT_EQ("Model7", model.name.str());
+  Firmware::setCurrentVariant(tx16s);
+}
+
+TEST_F(ModelBatchTest, BackgroundRun)
+{
+  ModelBatch::Options options;
+  options.jobs = 2;
+
+  ModelBatch batch(options);
+  int reports = 0;
+  int finishedErrors = -1;
+  QObject::connect(&batch, &ModelBatch::modelDone, [&](const ModelBatchReport&) {
+    reports++;
+  });
+  QObject::connect(&batch, &ModelBatch::finished, [&](int errors) {
+    finishedErrors = errors;
+  });
+
+  // no event loop here: the signals are delivered directly
+  ASSERT_TRUE(batch.start(files));
+  batch.waitForFinished();
+
+  EXPECT_FALSE(batch.isRunning());
+  EXPECT_EQ(MODEL_COUNT, reports);
+  EXPECT_EQ(0, finishedErrors);
+}
+
+TEST_F(ModelBatchTest, BackgroundRunKeepsFirmware)
+{
+  ModelBatch::Options options;
+  options.operation = ModelBatch::OP_CONVERT;
+  options.from = tx16s;
+  options.to = Firmware::getFirmwareForFlavour("x7");
+
+  ModelBatch batch(options);
+  EXPECT_FALSE(batch.start(files));
+  EXPECT_FALSE(batch.isRunning());
+  EXPECT_EQ(tx16s, getCurrentFirmware());
+}
+
+TEST_F(ModelBatchTest, SameNameInSeveralFolders)
+{
+  QStringList inputs;
+  for (int i = 1; i <= 2; i++) {
+    QString folder = dir.filePath(QString("radio%1/MODELS").arg(i));
+    ASSERT_TRUE(QDir().mkpath(folder));
+    QString path = folder + "/model01.yml";
+    ASSERT_TRUE(QFile::copy(files.at(i), path));
+    inputs << path;
+  }
+
+  ModelBatch::Options options;
+  options.operation = ModelBatch::OP_REEXPORT;
+  options.outputDir = dir.filePath("out");
+  options.jobs = 2;
+
+  ModelBatch batch(options);
+  EXPECT_EQ(0, batch.run(inputs));
+
+  ModelData model;
+  loadModelFromYaml(model, readFile(dir.filePath("out/radio1/MODELS/model01.yml")));
+  EXPECT_EQ("Model1", model.name.str());
+  loadModelFromYaml(model, readFile(dir.filePath("out/radio2/MODELS/model01.yml")));
+  EXPECT_EQ("Model2", model.name.str());
+}
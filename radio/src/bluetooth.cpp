@@ -142,6 +142,7 @@ void Bluetooth::processTrainerFrame(const uint8_t * buffer)
   }
 
   trainerResetTimer();
+  trainerStats.frames++;
 }
 
 void Bluetooth::appendTrainerByte(uint8_t data)
@@ -164,8 +165,6 @@ void Bluetooth::appendTrainerByte(uint8_t data)
 
 void Bluetooth::processTrainerByte(uint8_t data)
 {
-  static uint8_t dataState = STATE_DATA_IDLE;
-
   switch (dataState) {
     case STATE_DATA_START:
       if (data == START_STOP) {
@@ -234,6 +233,13 @@ void Bluetooth::processTrainerByte(uint8_t data)
   }
 }
 
+void Bluetooth::processTrainerBuffer(const uint8_t * data, uint32_t len)
+{
+  for (const uint8_t * end = data + len; data < end; data++) {
+    processTrainerByte(*data);
+  }
+}
+
 void Bluetooth::pushByte(uint8_t byte)
 {
   crc ^= byte;
@@ -246,23 +252,43 @@ void Bluetooth::pushByte(uint8_t byte)
 
 void Bluetooth::sendTrainer()
 {
+  tmr10ms_t now = get_tmr10ms();
+  bool sent = (trainerFrame[0] == TRAINER_FRAME);
+  if (sent && now - trainerSentTime < BLUETOOTH_TRAINER_PERIOD) {
+    return;
+  }
+
   int16_t PPM_range = g_model.extendedLimits ? 640*2 : 512*2;
 
   int firstCh = g_model.trainerData.channelsStart;
   int lastCh = firstCh + BLUETOOTH_TRAINER_CHANNELS;
 
-  uint8_t * cur = buffer;
+  uint8_t frame[sizeof(trainerFrame)];
+  uint8_t * cur = frame;
+  *cur++ = TRAINER_FRAME;
+  for (int channel=firstCh; channel<lastCh; channel+=2) {
+    uint16_t channelValue1 = PPM_CH_CENTER(channel) + limit((int16_t)-PPM_range, channelOutputs[channel], (int16_t)PPM_range) / 2;
+    uint16_t channelValue2 = PPM_CH_CENTER(channel+1) + limit((int16_t)-PPM_range, channelOutputs[channel+1], (int16_t)PPM_range) / 2;
+    *cur++ = channelValue1 & 0x00ff;
+    *cur++ = ((channelValue1 & 0x0f00) >> 4) + ((channelValue2 & 0x00f0) >> 4);
+    *cur++ = ((channelValue2 & 0x000f) << 4) + ((channelValue2 & 0x0f00) >> 8);
+  }
+
+  // unchanged channels are only sent to keep the link alive
+  if (sent && !memcmp(frame, trainerFrame, sizeof(frame)) &&
+      now - trainerSentTime < BLUETOOTH_TRAINER_KEEPALIVE) {
+    return;
+  }
+  memcpy(trainerFrame, frame, sizeof(frame));
+  trainerSentTime = now;
+  trainerStats.frames++;
+
   bufferIndex = 0;
   crc = 0x00;
 
   buffer[bufferIndex++] = START_STOP; // start byte
-  pushByte(TRAINER_FRAME);
-  for (int channel=firstCh; channel<lastCh; channel+=2, cur+=3) {
-    uint16_t channelValue1 = PPM_CH_CENTER(channel) + limit((int16_t)-PPM_range, channelOutputs[channel], (int16_t)PPM_range) / 2;
-    uint16_t channelValue2 = PPM_CH_CENTER(channel+1) + limit((int16_t)-PPM_range, channelOutputs[channel+1], (int16_t)PPM_range) / 2;
-    pushByte(channelValue1 & 0x00ff);
-    pushByte(((channelValue1 & 0x0f00) >> 4) + ((channelValue2 & 0x00f0) >> 4));
-    pushByte(((channelValue2 & 0x000f) << 4) + ((channelValue2 & 0x0f00) >> 8));
+  for (uint8_t i = 0; i < sizeof(frame); i++) {
+    pushByte(frame[i]);
   }
   pushByte(crc);
   buffer[bufferIndex++] = START_STOP; // end byte
@@ -307,26 +333,57 @@ void Bluetooth::forwardTelemetry(const uint8_t * packet)
   #endif
 }
 
-void Bluetooth::receiveTrainer()
+void Bluetooth::frameReceived()
 {
-  uint8_t byte;
+  rxFrameTime = timersGetUsTick();
+  rxFrameReady = true;
+}
 
-  while (true) {
-    if (!bluetoothRead(&byte)) {
-      return;
-    }
+static void bluetoothFrameReceived(void*)
+{
+  bluetooth.frameReceived();
+}
 
+void Bluetooth::receiveTrainer()
+{
+  bool frameEvent = rxFrameReady;
+  uint32_t frameTime = rxFrameTime;
+  uint32_t frames = trainerStats.frames;
+  rxFrameReady = false;
+
+  // all the buffered bytes, a chunk at a time
+  uint8_t data[BLUETOOTH_LINE_LENGTH];
+  int len;
+  while ((len = bluetoothReadBuffer(data, sizeof(data))) > 0) {
 #if defined(DEBUG_BLUETOOTH)
     static uint8_t lastb=0;
-    BLUETOOTH_TRACE("%02X ", byte);
-    if(byte == START_STOP && lastb != START_STOP) {
-      BLUETOOTH_TRACE(CRLF);
-      BLUETOOTH_TRACE_TIMESTAMP();
+    for (int i = 0; i < len; i++) {
+      BLUETOOTH_TRACE("%02X ", data[i]);
+      if (data[i] == START_STOP && lastb != START_STOP) {
+        BLUETOOTH_TRACE(CRLF);
+        BLUETOOTH_TRACE_TIMESTAMP();
+      }
+      lastb = data[i];
     }
-    lastb = byte;
 #endif
 
-    processTrainerByte(byte);
+    processTrainerBuffer(data, len);
+  }
+
+  if (frameEvent && trainerStats.frames != frames) {
+    uint32_t latency = timersGetUsTick() - frameTime;
+    trainerStats.lastLatency = latency;
+    trainerStats.maxLatency = max(trainerStats.maxLatency, latency);
+    trainerStats.totalLatency += latency;
+    trainerStats.measured++;
+#if defined(SIMU)
+    if ((trainerStats.measured & 0xFF) == 0) {
+      TRACE("BT trainer: %u frames, latency %u us (max %u us)",
+            trainerStats.frames,
+            (uint32_t)(trainerStats.totalLatency / trainerStats.measured),
+            trainerStats.maxLatency);
+    }
+#endif
   }
 }
 
@@ -344,6 +401,7 @@ void Bluetooth::wakeup(void)
     static tmr10ms_t waitEnd = 0;
     if (state != BLUETOOTH_STATE_IDLE) {
       if (state == BLUETOOTH_INIT) {
+        bluetoothSetIdleCb(bluetoothFrameReceived, nullptr);
         bluetoothInit(BLUETOOTH_DEFAULT_BAUDRATE, true);
         char command[32];
         char * cur = strAppend(command, BLUETOOTH_COMMAND_NAME);
@@ -399,6 +457,13 @@ void Bluetooth::wakeup()
 
   tmr10ms_t now = get_tmr10ms();
 
+  // trainer frames are handled as soon as they are received
+  if (state == BLUETOOTH_STATE_CONNECTED && rxFrameReady &&
+      g_eeGeneral.bluetoothMode == BLUETOOTH_TRAINER &&
+      g_model.trainerData.mode == TRAINER_MODE_MASTER_BLUETOOTH) {
+    receiveTrainer();
+  }
+
   if (now < wakeupTime)
     return;
 
@@ -428,6 +493,7 @@ void Bluetooth::wakeup()
     wakeupTime = now + 10; /* 100ms */
   }
   else if (state == BLUETOOTH_STATE_OFF) {
+    bluetoothSetIdleCb(bluetoothFrameReceived, nullptr);
     bluetoothInit(BLUETOOTH_FACTORY_BAUDRATE, true);
     state = BLUETOOTH_STATE_FACTORY_BAUDRATE_INIT;
   }
@@ -450,7 +516,7 @@ void Bluetooth::wakeup()
     else {
       if (g_eeGeneral.bluetoothMode == BLUETOOTH_TRAINER && g_model.trainerData.mode == TRAINER_MODE_SLAVE_BLUETOOTH) {
         sendTrainer();
-        wakeupTime = now + 2; /* 20ms */
+        wakeupTime = now + 1; /* 10ms, frames are only sent on changes */
       }
       readline(); // to deal with "ERROR"
     }
@@ -532,6 +598,7 @@ void Bluetooth::wakeup()
                (line != nullptr) && !strncmp(line, "Connected:", 10)) {
       strcpy(distantAddr, &line[10]); // TODO quick & dirty
       state = BLUETOOTH_STATE_CONNECTED;
+      rxFrameReady = false;
       if (g_model.trainerData.mode == TRAINER_MODE_SLAVE_BLUETOOTH) {
         wakeupTime += 500; // it seems a 5s delay is needed before sending the 1st frame
       }
@@ -57,6 +57,13 @@ enum BluetoothStates {
 #define BLUETOOTH_LINE_LENGTH           32
 #define BLUETOOTH_TRAINER_CHANNELS      8
 
+// Trainer frames (slave): sent when the channels change, at most every
+// BLUETOOTH_TRAINER_PERIOD, and at least every BLUETOOTH_TRAINER_KEEPALIVE
+#if !defined(BLUETOOTH_TRAINER_PERIOD)
+  #define BLUETOOTH_TRAINER_PERIOD      2   // 20ms
+#endif
+#define BLUETOOTH_TRAINER_KEEPALIVE     20  // 200ms
+
 #if defined(LOG_BLUETOOTH)
   #define BLUETOOTH_TRACE(...)  \
     f_printf(&g_bluetoothFile, __VA_ARGS__); \
@@ -77,6 +84,15 @@ enum BluetoothStates {
 #endif
 #endif
 
+struct BluetoothTrainerStats {
+  uint32_t frames;        // received (master) or sent (slave)
+  // master: from the end of a frame on the line to the trainer inputs (us)
+  uint32_t lastLatency;
+  uint32_t maxLatency;
+  uint64_t totalLatency;
+  uint32_t measured;
+};
+
 class Bluetooth
 {
   public:
@@ -88,16 +104,22 @@ class Bluetooth
     void wakeup();
     const char * flashFirmware(const char * filename, ProgressHandler progressHandler);
 
+    // Called from the serial IRQ when the line gets idle
+    void frameReceived();
+
     volatile uint8_t state;
     char localAddr[LEN_BLUETOOTH_ADDR+1];
     char distantAddr[LEN_BLUETOOTH_ADDR+1];
 
+    BluetoothTrainerStats trainerStats = {};
+
   protected:
     void pushByte(uint8_t byte);
     uint8_t read(uint8_t * data, uint8_t size, uint32_t timeout=1000/*ms*/);
     void appendTrainerByte(uint8_t data);
     void processTrainerFrame(const uint8_t * buffer);
     void processTrainerByte(uint8_t data);
+    void processTrainerBuffer(const uint8_t * data, uint32_t len);
     void sendTrainer();
     void receiveTrainer();
 
@@ -119,6 +141,14 @@ class Bluetooth
     uint8_t bufferIndex = 0;
     tmr10ms_t wakeupTime = 0;
     uint8_t crc;
+
+    uint8_t dataState = 0; // STATE_DATA_IDLE
+    volatile bool rxFrameReady = false;
+    volatile uint32_t rxFrameTime = 0;
+
+    // last trainer frame sent, without the CRC
+    uint8_t trainerFrame[BLUETOOTH_PACKET_SIZE - 1] = {};
+    tmr10ms_t trainerSentTime = 0;
 };
 
 extern Bluetooth bluetooth;
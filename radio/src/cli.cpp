@@ -43,8 +43,11 @@
 
 #include "tasks.h"
 #include "tasks/mixer_task.h"
+#include "tasks/storage_task.h"
+#include "storage/storage_bench.h"
 
 #include "cli.h"
+#include "cli_stream.h"
 
 #include <ctype.h>
 #include <malloc.h>
@@ -177,6 +180,30 @@ static void cliSerialCrlf()
   cliSerialPutc('\n');
 }
 
+// Send a whole buffer at once if the driver supports it (UART drivers
+// may send it by DMA): returns once 'data' may be modified again.
+// Returns false, without sending anything, if the driver would drop it.
+static bool cliSerialWrite(const uint8_t* data, uint32_t len)
+{
+  auto drv = cliSerialDriver;
+  auto ctx = cliSerialDriverCtx;
+
+  if (drv && drv->sendBuffer) {
+    // only the CLI task sends while streaming:
+    // the free space cannot shrink until the data is queued
+    if (drv->getTxFreeSpace && drv->getTxFreeSpace(ctx) < len) return false;
+    drv->sendBuffer(ctx, data, len);
+    if (drv->waitForTxCompleted) drv->waitForTxCompleted(ctx);
+    return true;
+  }
+
+  if (!cliSendCb) return false;
+  while (len--) {
+    cliSendCb(cliSendCtx, *data++);
+  }
+  return true;
+}
+
 static uint32_t cliGetBaudRate()
 {
   auto drv = cliSerialDriver;
@@ -628,6 +655,31 @@ int cliTestSD(const char ** argv)
   return 0;
 }
 
+static void cliStorageBenchResult(const StorageBenchResult& result, void*)
+{
+  char line[CLI_PRINT_BUFFER_SIZE];
+  storageBenchFormat(line, sizeof(line), result);
+  cliSerialPrint("%s", line);
+}
+
+int cliStorageBench(const char ** argv)
+{
+  const char* name = argv[1] && argv[1][0] ? argv[1] : "all";
+
+  cliSerialPrint("Running storage benchmark \"%s\"...", name);
+  FRESULT res = storageBenchRun(name, cliStorageBenchResult, nullptr);
+  if (res == FR_INVALID_PARAMETER) {
+    cliSerialPrintf("%s: Invalid workload \"%s\", use all", argv[0], name);
+    for (auto w = storageBenchWorkloads; *w; w++) cliSerialPrintf(", %s", *w);
+    cliSerialCrlf();
+  } else if (res == FR_EXIST) {
+    cliSerialPrint("%s: %s already exists", argv[0], BENCH_PATH);
+  } else if (res != FR_OK) {
+    cliSerialPrint("%s: setup failed (%d)", argv[0], res);
+  }
+  return 0;
+}
+
 int cliTestNew()
 {
   char * tmp = nullptr;
@@ -1022,6 +1074,48 @@ int cliTrace(const char ** argv)
   return 0;
 }
 
+int cliStream(const char ** argv)
+{
+  if (!argv[1]) {
+    cliSerialPrint("%s: missing argument", argv[0]);
+    return -1;
+  }
+
+  if (!strcmp(argv[1], "off")) {
+    cliStreamStop();
+    return 0;
+  }
+
+  int rate = 0;
+  if (toInt(argv, 1, &rate) <= 0 || rate <= 0) {
+    cliSerialPrint("%s: Invalid rate \"%s\"", argv[0], argv[1]);
+    return -1;
+  }
+
+  uint8_t content = 0;
+  for (int i = 2; i < CLI_COMMAND_MAX_ARGS && argv[i]; i++) {
+    if (!strcmp(argv[i], "channels"))
+      content |= CLI_STREAM_CHANNELS;
+    else if (!strcmp(argv[i], "switches"))
+      content |= CLI_STREAM_SWITCHES;
+    else if (!strcmp(argv[i], "telemetry"))
+      content |= CLI_STREAM_TELEMETRY;
+    else {
+      cliSerialPrint("%s: Invalid argument \"%s\"", argv[0], argv[i]);
+      return -1;
+    }
+  }
+  if (!content) content = CLI_STREAM_ALL;
+
+  if (rate > CLI_STREAM_MAX_RATE) rate = CLI_STREAM_MAX_RATE;
+  cliSerialPrint("Streaming at %d Hz, send any character to stop", rate);
+
+  // traces would corrupt the frames
+  cliDisableDbg();
+  cliStreamStart(rate, content);
+  return 0;
+}
+
 int cliStackInfo(const char ** argv)
 {
   cliSerialPrint("[MENUS] %d available / %d bytes",
@@ -1035,6 +1129,9 @@ int cliStackInfo(const char ** argv)
                  task_get_stack_usage(&audioTaskId) * 4,
                  task_get_stack_size(&audioTaskId));
 #endif
+  cliSerialPrint("[STORAGE] %d available / %d bytes",
+                 task_get_stack_usage(&storageTaskId) * 4,
+                 task_get_stack_size(&storageTaskId));
 #if defined(CLI)
   cliSerialPrint("[CLI] %d available / %d bytes",
                  task_get_stack_usage(&cliTaskId),
@@ -1043,6 +1140,29 @@ int cliStackInfo(const char ** argv)
   return 0;
 }
 
+int cliStorageInfo(const char ** argv)
+{
+  const auto& stats = storageTaskGetStats();
+  cliSerialPrint("queue depth: %d (max %d)", storageTaskQueueDepth(),
+                 stats.maxQueueDepth);
+  cliSerialPrint("writes: %d, coalesced: %d, errors: %d, failed: %d",
+                 stats.writes, stats.coalesced, stats.errors, stats.failed);
+  cliSerialPrint("save latency: %d ms (max %d ms)", stats.lastLatency,
+                 stats.maxLatency);
+  return 0;
+}
+
+int cliUiInfo(const char ** argv)
+{
+  const auto& stats = menusTaskGetStats();
+  cliSerialPrint("cycle time: %d ms (max %d ms)", stats.cycleTime,
+                 stats.maxCycleTime);
+  cliSerialPrint("frame time: %d ms (max %d ms)", stats.frameTime,
+                 stats.maxFrameTime);
+  cliSerialPrint("wakeups: %d/s", stats.wakeupsPerSecond);
+  return 0;
+}
+
 extern int _heap_start;
 extern int _heap_end;
 extern unsigned char *heap;
@@ -1851,12 +1971,14 @@ const CliCommand cliCommands[] = {
   { "read", cliRead, "<filename>" },
   { "readsd", cliReadSD, "<start sector> <sectors count> <read buffer size (sectors)>" },
   { "testsd", cliTestSD, "" },
+  { "storagebench", cliStorageBench, "[all | boot | model | log | wav]" },
   { "play", cliPlay, "<filename>" },
 #if defined(PDM_CLOCK)
   { "rec", cliRecord, "<filename> [<seconds>]" },
 #endif
   { "reboot", cliReboot, "[wdt]" },
   { "set", cliSet, "<what> <value>" },
+  { "stream", cliStream, "<rate in Hz> [channels] [switches] [telemetry] | off" },
 #if defined(ENABLE_SERIAL_PASSTHROUGH)
   { "serialpassthrough", cliSerialPassthrough, "<port type> [<port number>] [<baudrate>]"},
 #endif
@@ -1864,6 +1986,8 @@ const CliCommand cliCommands[] = {
   { "print", cliDisplay, "<address> [<size>] | <what>" },
   { "p", cliDisplay, "<address> [<size>] | <what>" },
   { "stackinfo", cliStackInfo, "" },
+  { "storageinfo", cliStorageInfo, "" },
+  { "uiinfo", cliUiInfo, "" },
   { "meminfo", cliMemoryInfo, "" },
   { "test", cliTest, "new | graphics | memspd" },
   { "trace", cliTrace, "on | off" },
@@ -1960,14 +2084,35 @@ static void cliTask()
     // TODO: implement block read instead
     //       of going byte-by-byte.
     
-    /* Block for max 100ms. */
-    const TickType_t xTimeout = 100 / portTICK_PERIOD_MS;
+    /* Block for max 100ms, or a tick while streaming. */
+    bool streaming = cliStreamRunning();
+    const TickType_t xTimeout = streaming ? 1 : 100 / portTICK_PERIOD_MS;
     size_t xReceivedBytes = xStreamBufferReceive(cliRxBuffer, &c, 1, xTimeout);
 
     if (!mixerTaskRunning()) {
       WDG_RESET();
     }
 
+    if (streaming) {
+      if (xReceivedBytes || !cliSendCb) {
+        // any character stops the stream
+        cliStreamStop();
+        if (cliTracesEnabled) cliEnableDbg();
+        cliSerialCrlf();
+        cliSerialPrint("Stream stopped (%u snapshots dropped)",
+                       (unsigned)cliStreamDroppedSnapshots());
+        cliPrompt();
+        continue;
+      }
+
+      uint32_t len;
+      const uint8_t* snapshot = cliStreamTakeSnapshot(&len);
+      if (snapshot) {
+        cliStreamReleaseSnapshot(cliSerialWrite(snapshot, len));
+      }
+      continue;
+    }
+
     if (!xReceivedBytes) {
       continue;
     }
@@ -2006,7 +2151,7 @@ static void cliTask()
       // TODO: check return value
       cliExecLine(line);
       pos = 0;
-      cliPrompt();
+      if (!cliStreamRunning()) cliPrompt();
       break;
 
     default:
@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "cli_stream.h"
+
+#include "edgetx.h"
+#include "crc.h"
+#include "timers_driver.h"
+
+#define CLI_STREAM_FRAME_OVERHEAD (CLI_STREAM_HEADER_SIZE + CLI_STREAM_CRC_SIZE)
+#define CLI_STREAM_TELEMETRY_ITEM 5
+
+#define CLI_STREAM_BUFFER_SIZE                                     \
+  (3 * CLI_STREAM_FRAME_OVERHEAD + MAX_OUTPUT_CHANNELS * 2 + 1 +   \
+   (MAX_LOGICAL_SWITCHES + 7) / 8 +                                \
+   CLI_STREAM_MAX_SENSORS * CLI_STREAM_TELEMETRY_ITEM)
+
+#define CLI_STREAM_NONE 0xFF
+
+// one snapshot is built by the mixer task while the
+// other one is sent by the CLI task
+static uint8_t _buffers[2][CLI_STREAM_BUFFER_SIZE] __DMA;
+static uint32_t _lengths[2];
+static uint8_t* _telemetryFrames[2];  // in the buffer, if any
+static volatile uint8_t _ready = CLI_STREAM_NONE;
+static volatile uint8_t _sending = CLI_STREAM_NONE;
+
+static volatile bool _running = false;
+static uint8_t _content;
+static uint32_t _period;  // us
+static uint32_t _nextSnapshot;
+static uint8_t _sequence;
+static uint32_t _dropped;      // by the mixer task
+static uint32_t _sendFailures; // by the CLI task
+
+// last value sent for each sensor, updated
+// by the CLI task once a snapshot has been sent
+static int32_t _sensorValues[MAX_TELEMETRY_SENSORS];
+static uint8_t _sensorSent[(MAX_TELEMETRY_SENSORS + 7) / 8];
+
+static inline void putU16(uint8_t* p, uint16_t value)
+{
+  p[0] = value;
+  p[1] = value >> 8;
+}
+
+static inline void putU32(uint8_t* p, uint32_t value)
+{
+  p[0] = value;
+  p[1] = value >> 8;
+  p[2] = value >> 16;
+  p[3] = value >> 24;
+}
+
+static inline uint32_t getU32(const uint8_t* p)
+{
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint8_t* beginFrame(uint8_t* p, uint8_t type, uint32_t timestamp)
+{
+  p[0] = CLI_STREAM_SYNC;
+  p[1] = type;
+  p[3] = _sequence;
+  putU32(p + 4, timestamp);
+  return p + CLI_STREAM_HEADER_SIZE;
+}
+
+// returns the end of the frame
+static uint8_t* endFrame(uint8_t* frame, uint8_t* end)
+{
+  uint8_t len = end - frame - CLI_STREAM_HEADER_SIZE;
+  frame[2] = len;
+  putU16(end, crc16(CRC_1021, frame + 1, CLI_STREAM_HEADER_SIZE - 1 + len));
+  return end + CLI_STREAM_CRC_SIZE;
+}
+
+static uint8_t* writeChannels(uint8_t* p, uint32_t timestamp)
+{
+  uint8_t* data = beginFrame(p, CLI_STREAM_FRAME_CHANNELS, timestamp);
+  for (uint8_t ch = 0; ch < MAX_OUTPUT_CHANNELS; ch++) {
+    putU16(data, channelOutputs[ch]);
+    data += 2;
+  }
+  return endFrame(p, data);
+}
+
+static uint8_t* writeSwitches(uint8_t* p, uint32_t timestamp)
+{
+  uint8_t* data = beginFrame(p, CLI_STREAM_FRAME_SWITCHES, timestamp);
+  *data++ = mixerCurrentFlightMode;
+
+  memset(data, 0, (MAX_LOGICAL_SWITCHES + 7) / 8);
+  for (uint8_t i = 0; i < MAX_LOGICAL_SWITCHES; i++) {
+    if (getSwitch(SWSRC_FIRST_LOGICAL_SWITCH + i))
+      data[i / 8] |= 1 << (i % 8);
+  }
+  data += (MAX_LOGICAL_SWITCHES + 7) / 8;
+
+  return endFrame(p, data);
+}
+
+// no frame at all if no sensor has changed
+static uint8_t* writeTelemetry(uint8_t* p, uint32_t timestamp)
+{
+  uint8_t* data = beginFrame(p, CLI_STREAM_FRAME_TELEMETRY, timestamp);
+  uint8_t count = 0;
+
+  for (uint8_t i = 0;
+       i < MAX_TELEMETRY_SENSORS && count < CLI_STREAM_MAX_SENSORS; i++) {
+    if (!g_model.telemetrySensors[i].isAvailable()) continue;
+    TelemetryItem& item = telemetryItems[i];
+    if (!item.isAvailable()) continue;
+
+    bool sent = _sensorSent[i / 8] & (1 << (i % 8));
+    if (sent && _sensorValues[i] == item.value) continue;
+
+    data[0] = i;
+    putU32(data + 1, item.value);
+    data += CLI_STREAM_TELEMETRY_ITEM;
+    count++;
+  }
+
+  if (!count) return p;
+  return endFrame(p, data);
+}
+
+// the values of a telemetry frame have been sent
+static void commitTelemetry(const uint8_t* frame)
+{
+  const uint8_t* item = frame + CLI_STREAM_HEADER_SIZE;
+  const uint8_t* end = item + frame[2];
+  for (; item < end; item += CLI_STREAM_TELEMETRY_ITEM) {
+    uint8_t i = item[0];
+    _sensorValues[i] = getU32(item + 1);
+    _sensorSent[i / 8] |= 1 << (i % 8);
+  }
+}
+
+void cliStreamStart(uint16_t rate, uint8_t content)
+{
+  _running = false;
+
+  if (rate > CLI_STREAM_MAX_RATE) rate = CLI_STREAM_MAX_RATE;
+  if (rate == 0) rate = 1;
+
+  _content = content;
+  _period = 1000000 / rate;
+  _nextSnapshot = timersGetUsTick();
+  _sequence = 0;
+  _dropped = 0;
+  _sendFailures = 0;
+  _ready = CLI_STREAM_NONE;
+  memset(_sensorSent, 0, sizeof(_sensorSent));
+
+  _running = true;
+}
+
+void cliStreamStop()
+{
+  _running = false;
+  _ready = CLI_STREAM_NONE;
+}
+
+bool cliStreamRunning()
+{
+  return _running;
+}
+
+void cliStreamMixerHook()
+{
+  if (!_running) return;
+
+  uint32_t now = timersGetUsTick();
+
+  // accept a snapshot up to half a period early, so that
+  // streaming at the mixer rate does not skip every other
+  // cycle because of the mixer jitter
+  if ((int32_t)(now - _nextSnapshot) < -(int32_t)(_period / 2)) return;
+
+  _nextSnapshot += _period;
+  if ((int32_t)(now - _nextSnapshot) >= 0) {
+    // the mixer is slower than the requested rate
+    _nextSnapshot = now + _period;
+  }
+
+  if (_ready != CLI_STREAM_NONE) {
+    _dropped++;
+    _sequence++;
+    return;
+  }
+
+  uint8_t index = _sending == 0 ? 1 : 0;
+  uint8_t* start = _buffers[index];
+  uint8_t* p = start;
+
+  if (_content & CLI_STREAM_CHANNELS) p = writeChannels(p, now);
+  if (_content & CLI_STREAM_SWITCHES) p = writeSwitches(p, now);
+  _telemetryFrames[index] = nullptr;
+  if (_content & CLI_STREAM_TELEMETRY) {
+    uint8_t* frame = p;
+    p = writeTelemetry(p, now);
+    if (p != frame) _telemetryFrames[index] = frame;
+  }
+
+  _sequence++;
+  if (p == start) return;
+
+  _lengths[index] = p - start;
+  _ready = index;
+}
+
+const uint8_t* cliStreamTakeSnapshot(uint32_t* len)
+{
+  uint8_t index = _ready;
+  if (index == CLI_STREAM_NONE) return nullptr;
+
+  // the mixer task does not touch a snapshot that is ready,
+  // and picks the other buffer as long as this one is sent
+  _sending = index;
+  _ready = CLI_STREAM_NONE;
+
+  *len = _lengths[index];
+  return _buffers[index];
+}
+
+void cliStreamReleaseSnapshot(bool sent)
+{
+  uint8_t index = _sending;
+  if (index == CLI_STREAM_NONE) return;
+
+  if (!sent) {
+    // the changed sensors are sent again with the next snapshot
+    _sendFailures++;
+  } else if (_telemetryFrames[index]) {
+    commitTelemetry(_telemetryFrames[index]);
+  }
+
+  _sending = CLI_STREAM_NONE;
+}
+
+uint32_t cliStreamDroppedSnapshots()
+{
+  return _dropped + _sendFailures;
+}
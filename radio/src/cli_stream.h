@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Binary streaming of the mixer state over the CLI port.
+//
+// The snapshots are taken by the mixer task right after the mixer
+// computations, and sent by the CLI task, so that neither the UI task
+// nor the mixer task ever waits on the serial port. Snapshots are
+// dropped (and the sequence counter reveals it) while the previous one
+// is still being sent, or when the port cannot take them.
+//
+// Each snapshot is made of one or more frames, all little-endian:
+//
+//   offset  size  field
+//   0       1     sync (0xA5)
+//   1       1     frame type (CLI_STREAM_FRAME_*)
+//   2       1     payload length (n)
+//   3       1     snapshot sequence (same for all frames of a snapshot)
+//   4       4     timestamp of the snapshot in us (wraps)
+//   8       n     payload
+//   8+n     2     CRC16 (CCITT 0x1021, start 0) of bytes 1 to 7+n
+//
+// Payloads:
+//
+//   CHANNELS   int16 channel outputs (-1024..1024), CH1 first;
+//              the channel count is n / 2
+//   SWITCHES   uint8 current flight mode, followed by the logical
+//              switch states, one bit per switch, L01 in bit 0
+//   TELEMETRY  { uint8 sensor index, int32 raw value } for each
+//              available sensor whose value changed since it was
+//              last sent (in a snapshot that was not dropped);
+//              n / 5 items, at most
+//              CLI_STREAM_MAX_SENSORS per snapshot
+//
+// Streaming is started with the "stream" CLI command, and stopped by
+// "stream off" or any byte received on the CLI port.
+
+#define CLI_STREAM_SYNC            0xA5
+#define CLI_STREAM_HEADER_SIZE     8
+#define CLI_STREAM_CRC_SIZE        2
+#define CLI_STREAM_MAX_SENSORS     40
+#define CLI_STREAM_MAX_RATE        1000  // Hz, limited by the mixer rate
+
+enum CliStreamFrameType {
+  CLI_STREAM_FRAME_CHANNELS = 1,
+  CLI_STREAM_FRAME_SWITCHES = 2,
+  CLI_STREAM_FRAME_TELEMETRY = 3,
+};
+
+// content flags
+#define CLI_STREAM_CHANNELS   (1 << 0)
+#define CLI_STREAM_SWITCHES   (1 << 1)
+#define CLI_STREAM_TELEMETRY  (1 << 2)
+#define CLI_STREAM_ALL \
+  (CLI_STREAM_CHANNELS | CLI_STREAM_SWITCHES | CLI_STREAM_TELEMETRY)
+
+void cliStreamStart(uint16_t rate, uint8_t content);
+void cliStreamStop();
+bool cliStreamRunning();
+
+// Called by the mixer task after each cycle
+void cliStreamMixerHook();
+
+// Returns the next snapshot to be sent, or nullptr if none is ready.
+// The buffer stays valid until cliStreamReleaseSnapshot() is called,
+// with whether it could be sent.
+const uint8_t* cliStreamTakeSnapshot(uint32_t* len);
+void cliStreamReleaseSnapshot(bool sent);
+
+// snapshots not taken because the previous one was still being sent,
+// or not sent because the port could not take them
+uint32_t cliStreamDroppedSnapshots();
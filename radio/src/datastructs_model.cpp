@@ -259,4 +259,28 @@ void ModelData::resetScreenData()
     _screenData[i] = nullptr;
   }
 }
+
+// Screen data is held outside of ModelData: it has to be copied
+// separately to take a complete snapshot of a model
+ModelScreenData* ModelData::saveScreenData()
+{
+  auto data = new ModelScreenData();
+  data->topbar = _topbarData;
+
+  for (int i = 0; i < MAX_CUSTOM_SCREENS; i += 1) {
+    if (_screenData[i]) data->screens[i] = new CustomScreenData(*_screenData[i]);
+  }
+
+  return data;
+}
+
+void ModelData::restoreScreenData(const ModelScreenData* data)
+{
+  resetScreenData();
+  _topbarData = data->topbar;
+
+  for (int i = 0; i < MAX_CUSTOM_SCREENS; i += 1) {
+    if (data->screens[i]) _screenData[i] = new CustomScreenData(*data->screens[i]);
+  }
+}
 #endif
@@ -846,6 +846,8 @@ PACK(struct ModelData {
   LayoutPersistentData* getScreenLayoutData(int screenNum);
   WidgetPersistentData* getWidgetData(int screenNum, int zoneNum);
   void removeScreenLayout(int idx);
+  ModelScreenData* saveScreenData();
+  void restoreScreenData(const ModelScreenData* data);
 #else
   uint8_t screensType SKIP; /* 2bits per screen (None/Gauges/Numbers/Script) */
   TelemetryScreenData screens[MAX_TELEMETRY_SCREENS];
@@ -50,6 +50,11 @@
  * translation context to minimize the amount of TT page updates, so that the write
  * amplification effect and wearing is minimized and improving the overall read/write
  * performance.
+ *
+ * New physical pages are picked among the free pages ahead of the write frontier:
+ * erased pages first, then the pages of the least erased blocks. The erase counts
+ * are saved in the MTT page, relative to the least erased block, each time it is
+ * programmed, and restored when the FTL is loaded.
  * 
  */
 
@@ -77,6 +82,9 @@
 // Will cap the buffer size to this when exceeded
 #define MAX_BUFFER_SIZE               64
 
+// Free pages considered for each physical page allocation
+#define ALLOCATION_WINDOW              16
+
 // Reserve pages to minimize the erase cycles when the FS is full,
 // should be at least 2 times of BUFFER_SIZE_MULTIPLIER
 #define RESERVED_PAGES_MULTIPLIER      16
@@ -109,15 +117,27 @@ typedef struct {
   uint16_t crc16;
 } TransTableHeader;
 
+#define WEAR_RECORDS                   1006
+#define WEAR_NOT_RECORDED              0xff
+
+// Erase counts of the first WEAR_RECORDS blocks (the whole flash up to 31MB),
+// in the MTT page only. 0xff bytes in the other TT pages and in the MTT
+// pages written before they were recorded.
 typedef struct {
-  union {
-    TransTableHeader header; // 16 bytes
-    uint8_t __padding[1024];                   // 1KB
-  };
+  uint16_t base;                          // least erased block, 0xffff if none
+  uint8_t delta[WEAR_RECORDS];            // above base, saturated to 0xfe
+} BlockWear;
+
+typedef struct {
+  TransTableHeader header;                     // 16 bytes
+  BlockWear wear;                              // 1008 bytes
   uint8_t sectStatus[TT_RECORDS_PER_PAGE];     // 1KB
   uint16_t physicalPageNo[TT_RECORDS_PER_PAGE]; // 2KB
 } TransTable;
 
+static_assert(sizeof(TransTableHeader) + sizeof(BlockWear) == 1024,
+              "TT page layout");
+
 typedef union {
   TransTable tt;           // 3KB + 16B
   uint8_t data[PAGE_SIZE]; // 4KB
@@ -171,6 +191,55 @@ static void setPhysicalPageState(FrFTL* ftl, uint16_t physicalPageNo,
       ((state & 0x3) << ((physicalPageNo & 0xf) * 2));
 }
 
+static inline uint16_t getBlockEraseCount(FrFTL* ftl, uint16_t physicalPageNo)
+{
+  return ftl->blockEraseCount[physicalPageNo / PAGES_PER_BLOCK];
+}
+
+static void countBlockErase(FrFTL* ftl, uint16_t physicalPageNo)
+{
+  uint16_t* count = &ftl->blockEraseCount[physicalPageNo / PAGES_PER_BLOCK];
+  if (*count < 0xffff) {
+    (*count)++;
+  }
+}
+
+static inline uint32_t getBlockCount(FrFTL* ftl)
+{
+  return (ftl->physicalPageCount + PAGES_PER_BLOCK - 1) / PAGES_PER_BLOCK;
+}
+
+static void saveBlockWear(FrFTL* ftl, BlockWear* wear)
+{
+  uint32_t blocks = getBlockCount(ftl);
+  if (blocks > WEAR_RECORDS) blocks = WEAR_RECORDS;
+
+  uint16_t base = 0xffff;
+  for (uint32_t i = 0; i < blocks; i++) {
+    if (ftl->blockEraseCount[i] < base) base = ftl->blockEraseCount[i];
+  }
+
+  wear->base = base;
+  for (uint32_t i = 0; i < blocks; i++) {
+    uint16_t delta = ftl->blockEraseCount[i] - base;
+    wear->delta[i] = delta < WEAR_NOT_RECORDED ? delta : WEAR_NOT_RECORDED - 1;
+  }
+}
+
+static void loadBlockWear(FrFTL* ftl, const BlockWear* wear)
+{
+  if (wear->base == 0xffff) return;
+
+  uint32_t blocks = getBlockCount(ftl);
+  if (blocks > WEAR_RECORDS) blocks = WEAR_RECORDS;
+
+  for (uint32_t i = 0; i < blocks; i++) {
+    if (wear->delta[i] != WEAR_NOT_RECORDED) {
+      ftl->blockEraseCount[i] = wear->base + wear->delta[i];
+    }
+  }
+}
+
 static const uint16_t crc16_ccitt_start = 0xFFFF;
 
 static inline uint16_t crc16_x25_ccitt(const void* buf, uint32_t len) {
@@ -527,19 +596,40 @@ static bool updatePageInfo(FrFTL* ftl, PageInfo* pageInfo,
 
 static uint16_t allocatePhysicalPage(FrFTL* ftl)
 {
-  uint16_t lookupCount = 0;
-  while (getPhysicalPageState(ftl, ftl->writeFrontier) == USED) {
-    ftl->writeFrontier++;
-    if (ftl->writeFrontier >= ftl->physicalPageCount) {
-      ftl->writeFrontier = 0;
+  uint16_t physicalPageNo = 0xffff;
+  uint32_t bestScore = 0xffffffff;
+  uint16_t candidates = 0;
+  uint16_t idx = ftl->writeFrontier;
+
+  for (uint16_t i = 0; i < ftl->physicalPageCount; i++) {
+    PhysicalPageState state = getPhysicalPageState(ftl, idx);
+    if (state != USED) {
+      // Erased pages first (no erase before programming),
+      // then the least erased blocks
+      uint32_t score = getBlockEraseCount(ftl, idx);
+      if (state != ERASED) {
+        score += 0x10000;
+      }
+      if (score < bestScore) {
+        bestScore = score;
+        physicalPageNo = idx;
+      }
+      if (++candidates >= ALLOCATION_WINDOW) {
+        break;
+      }
     }
-    lookupCount++;
-    if (lookupCount > ftl->physicalPageCount) {
-      return 0xffff;  // BUG
+    idx++;
+    if (idx >= ftl->physicalPageCount) {
+      idx = 0;
     }
   }
 
-  uint16_t physicalPageNo = ftl->writeFrontier++;
+  if (physicalPageNo == 0xffff) {
+    return 0xffff;  // BUG
+  }
+
+  // Free pages skipped here are considered again on the next round
+  ftl->writeFrontier = physicalPageNo + 1;
   if (ftl->writeFrontier >= ftl->physicalPageCount) {
     ftl->writeFrontier = 0;
   }
@@ -576,12 +666,14 @@ static bool quickErase(FrFTL* ftl, uint32_t addr)
         for (uint8_t i = 0; i < PAGES_PER_BLOCK; i++) {
           setPhysicalPageState(ftl, ppn + i, ERASED);
         }
+        countBlockErase(ftl, ppn);
       }
       return ret;
     }
   }
   if (cb->flashErase(addr)) {
     setPhysicalPageState(ftl, ppn, ERASED);
+    countBlockErase(ftl, ppn);
     return true;
   }
   return false;
@@ -658,8 +750,9 @@ static bool programPageInBuffer(FrFTL* ftl, PageBuffer* buffer)
 
       if (buffer->logicalPageNo < ftl->ttPageCount) {
         if (buffer->logicalPageNo == 0) {
-          // MTT need update physicalPageNo
+          // MTT need update physicalPageNo and erase counts
           buffer->page.tt.physicalPageNo[0] = buffer->physicalPageNo;
+          saveBlockWear(ftl, &buffer->page.tt.wear);
         }
 
         // TT page, need update serial and CRC
@@ -880,31 +973,94 @@ bool ftlWrite(FrFTL* ftl, uint32_t startSectorNo, uint32_t noOfSectors,
   return true;
 }
 
-bool ftlRead(FrFTL* ftl, uint32_t sectorNo, uint8_t* buffer)
+// Read 'count' sectors of a logical page from 'pageSectorNo'
+static bool readPageSectors(FrFTL* ftl, uint8_t* buffer, uint16_t logicalPageNo,
+                            const PageInfo* pageInfo, uint8_t pageSectorNo,
+                            uint8_t count)
 {
-  if (sectorNo >= ftl->usableSectorCount) {
-    return false;
+  // A page in buffer may hold changes not programmed yet
+  PageBuffer* pageBuffer = nullptr;
+  if (pageInfo->sectStatus != 0xff) {
+    pageBuffer = findPhysicalPageInBuffer(ftl, pageInfo->physicalPageNo);
   }
 
-  uint16_t logicalPageNo = sectorNo / SECTORS_PER_PAGE + ftl->ttPageCount;
-  uint8_t pageSectorNo = sectorNo % SECTORS_PER_PAGE;
+  uint8_t endSectorNo = pageSectorNo + count;
+  while (pageSectorNo < endSectorNo) {
+    // Run of sectors all written or all never written
+    bool written = (pageInfo->sectStatus & (1 << pageSectorNo)) == 0;
+    uint8_t runEnd = pageSectorNo + 1;
+    while (runEnd < endSectorNo &&
+           ((pageInfo->sectStatus & (1 << runEnd)) == 0) == written) {
+      runEnd++;
+    }
+    uint32_t len = (runEnd - pageSectorNo) * SECTOR_SIZE;
+
+    if (!written) {
+      // Sector never write, return init content
+      memset(buffer, 0xff, len);
+    } else if (pageBuffer) {
+      memcpy(buffer, pageBuffer->page.data + pageSectorNo * SECTOR_SIZE, len);
+    } else if (len == SECTOR_SIZE) {
+      // Single sectors (FAT, directories) are likely to be read again soon
+      if (!readPhysicalSector(ftl, buffer, logicalPageNo,
+                              pageInfo->physicalPageNo, pageSectorNo)) {
+        return false;
+      }
+    } else {
+      // Bulk data, read directly without evicting the buffered pages
+      const FrFTLOps* cb = ftl->callbacks;
+      uint32_t addr = pageInfo->physicalPageNo * PAGE_SIZE + pageSectorNo * SECTOR_SIZE;
+      if (!cb->flashRead(addr, buffer, len)) {
+        return false;
+      }
+    }
+
+    buffer += len;
+    pageSectorNo = runEnd;
+  }
+
+  return true;
+}
 
-  // Read page info
-  PageInfo pageInfo;
-  if (!readPageInfo(ftl, &pageInfo, logicalPageNo)) {
+bool ftlReadSectors(FrFTL* ftl, uint32_t startSectorNo, uint32_t noOfSectors,
+                    uint8_t* buffer)
+{
+  if (startSectorNo >= ftl->usableSectorCount ||
+      noOfSectors > ftl->usableSectorCount - startSectorNo) {
     return false;
   }
 
-  // Check if sector written before
-  uint8_t sectMask = 1 << pageSectorNo;
-  if ((pageInfo.sectStatus & sectMask) != 0) {
-    // Sector never write, return init content
-    memset(buffer, 0xff, SECTOR_SIZE);
-    return true;
+  uint32_t sectorNo = startSectorNo;
+  while (noOfSectors > 0) {
+    uint16_t logicalPageNo = sectorNo / SECTORS_PER_PAGE + ftl->ttPageCount;
+    uint8_t pageSectorNo = sectorNo % SECTORS_PER_PAGE;
+    uint8_t count = SECTORS_PER_PAGE - pageSectorNo;
+    if (count > noOfSectors) {
+      count = noOfSectors;
+    }
+
+    // Read page info, once for all the sectors of the page
+    PageInfo pageInfo;
+    if (!readPageInfo(ftl, &pageInfo, logicalPageNo)) {
+      return false;
+    }
+
+    if (!readPageSectors(ftl, buffer, logicalPageNo, &pageInfo, pageSectorNo,
+                         count)) {
+      return false;
+    }
+
+    noOfSectors -= count;
+    sectorNo += count;
+    buffer += count * SECTOR_SIZE;
   }
 
-  return readPhysicalSector(ftl, buffer, logicalPageNo,
-			    pageInfo.physicalPageNo, pageSectorNo);
+  return true;
+}
+
+bool ftlRead(FrFTL* ftl, uint32_t sectorNo, uint8_t* buffer)
+{
+  return ftlReadSectors(ftl, sectorNo, 1, buffer);
 }
 
 bool ftlTrim(FrFTL* ftl, uint32_t startSectorNo, uint32_t noOfSectors)
@@ -982,6 +1138,52 @@ bool ftlTrim(FrFTL* ftl, uint32_t startSectorNo, uint32_t noOfSectors)
   return true;
 }
 
+bool ftlReclaim(FrFTL* ftl)
+{
+  // Keep the free pages the next buffer flush will use erased
+  uint16_t lookahead = ftl->pageBufferSize;
+  uint16_t idx = ftl->writeFrontier;
+
+  for (uint16_t i = 0; i < ftl->physicalPageCount && lookahead > 0; i++) {
+    PhysicalPageState state = getPhysicalPageState(ftl, idx);
+    if (state == ERASE_REQUIRED) {
+      // Erase the whole block when possible
+      uint16_t blockPageNo = idx - idx % PAGES_PER_BLOCK;
+      bool blockErasable = true;
+      uint8_t count = 0;
+      for (uint8_t j = 0; j < PAGES_PER_BLOCK; j++) {
+        PhysicalPageState blockPageState = getPhysicalPageState(ftl, blockPageNo + j);
+        if (blockPageState == USED) {
+          blockErasable = false;
+          break;
+        }
+        if (blockPageState != ERASED) {
+          count++;
+        }
+      }
+      if (blockErasable && count >= USE_BLOCK_ERASE_THRESHOLD) {
+        return quickErase(ftl, blockPageNo * PAGE_SIZE);
+      }
+
+      if (!ftl->callbacks->flashErase(idx * PAGE_SIZE)) {
+        return false;
+      }
+      setPhysicalPageState(ftl, idx, ERASED);
+      countBlockErase(ftl, idx);
+      return true;
+    }
+    if (state != USED) {
+      lookahead--;
+    }
+    idx++;
+    if (idx >= ftl->physicalPageCount) {
+      idx = 0;
+    }
+  }
+
+  return false;
+}
+
 static void initPageBuffer(FrFTL* ftl)
 {
   // Init page buffer
@@ -1117,6 +1319,7 @@ static bool loadFTL(FrFTL* ftl)
     if (!mtt || mtt->page.tt.physicalPageNo[0] != currentPhysicalMTTPageNo) {
       return false;
     }
+    loadBlockWear(ftl, &mtt->page.tt.wear);
 
     PageBuffer* tt = mtt;
 
@@ -1192,6 +1395,9 @@ bool ftlInit(FrFTL* ftl, const FrFTLOps* cb, uint16_t flashSizeInMB)
   ftl->physicalPageState = (uint32_t*)calloc(stateSize, sizeof(uint32_t));
   ftl->physicalPageStateResolved = false;
   ftl->memoryUsed += stateSize * sizeof(uint32_t);
+  uint32_t blockCount = getBlockCount(ftl);
+  ftl->blockEraseCount = (uint16_t*)calloc(blockCount, sizeof(uint16_t));
+  ftl->memoryUsed += blockCount * sizeof(uint16_t);
   ftl->pageBufferSize = ftl->ttPageCount * BUFFER_SIZE_MULTIPLIER;
   if (ftl->pageBufferSize > MAX_BUFFER_SIZE) {
     ftl->pageBufferSize = MAX_BUFFER_SIZE;
@@ -1211,5 +1417,6 @@ void ftlDeInit(FrFTL* ftl)
 {
   free(ftl->pageBuffer);
   free(ftl->physicalPageState);
+  free(ftl->blockEraseCount);
   free(ftl->hashTable);
 }
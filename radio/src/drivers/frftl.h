@@ -61,6 +61,7 @@ typedef struct {
   uint16_t writeFrontier;
   uint32_t* physicalPageState;
   bool physicalPageStateResolved;
+  uint16_t* blockEraseCount;  // per erase block, saved in the MTT page
   uint16_t pageBufferSize;
   void *pageBuffer;
   void* bufferHead;  // LRU most used
@@ -74,10 +75,15 @@ void ftlDeInit(FrFTL* ftl);
 
 bool ftlWrite(FrFTL* ftl, uint32_t startSectorNo, uint32_t noOfSectors, const uint8_t* buf);
 bool ftlRead(FrFTL* ftl, uint32_t sectorNo, uint8_t* buffer);
+bool ftlReadSectors(FrFTL* ftl, uint32_t startSectorNo, uint32_t noOfSectors, uint8_t* buffer);
 
 bool ftlTrim(FrFTL* ftl, uint32_t startSectorNo, uint32_t noOfSectors);
 bool ftlSync(FrFTL* ftl);
 
+// Erase (at most one block) ahead of the write frontier, so that the next
+// writes find erased pages. Returns false if there was nothing to erase.
+bool ftlReclaim(FrFTL* ftl);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
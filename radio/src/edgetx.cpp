@@ -38,12 +38,14 @@
 #include "hal/usb_driver.h"
 #include "hal/audio_driver.h"
 #include "hal/rgbleds.h"
+#include "hal/rotary_encoder.h"
 
 #include "timers_driver.h"
 
 #include "switches.h"
 #include "inactivity_timer.h"
 #include "input_mapping.h"
+#include "name_table.h"
 #include "trainer.h"
 
 #include "tasks.h"
@@ -212,6 +214,7 @@ void per10ms()
   uint8_t keyActivity = keysPollingCycle();
   if (keyActivity & KEY_ACTIVITY_KEYS) {
     inactivityTimerReset(ActivitySource::Keys);
+    menusTaskWakeup();
   }
   if (keyActivity & KEY_ACTIVITY_TRIMS) {
     // Trims are controls, not keys, for backlight purposes
@@ -225,6 +228,15 @@ void per10ms()
 #if defined(ROTARY_ENCODER_NAVIGATION) && !defined(COLORLCD)
   if (rotaryEncoderPollingCycle()) {
     inactivityTimerReset(ActivitySource::Keys);
+    menusTaskWakeup();
+  }
+#elif defined(ROTARY_ENCODER_NAVIGATION)
+  // the rotary encoder is read by LVGL, only wake the UI task up
+  static rotenc_t rotaryPosition = 0;
+  rotenc_t pos = rotaryEncoderGetValue();
+  if (pos != rotaryPosition) {
+    rotaryPosition = pos;
+    menusTaskWakeup();
   }
 #endif
 
@@ -312,6 +324,7 @@ void generalDefaultSwitches()
 #endif
 #endif
   }
+  nameTableInvalidate();
 }
 
 void generalDefaultUILanguage()
@@ -324,6 +337,7 @@ void generalDefaultUILanguage()
 void generalDefault()
 {
   memclear(&g_eeGeneral, sizeof(g_eeGeneral));
+  globalFunctionsContext.invalidate();
 
 #if defined(COLORLCD)
   g_eeGeneral.blOffBright = 20;
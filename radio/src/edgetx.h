@@ -156,6 +156,15 @@ struct CustomFunctionsContext {
   MASK_CFN_TYPE  activeUISwitches;
   tmr10ms_t lastFunctionTime[MAX_SPECIAL_FUNCTIONS];
 
+  // indexes of the functions with a switch, split by the task
+  // evaluating them. Rebuilt on the next evaluation after invalidate().
+  uint8_t mixerFunctions[MAX_SPECIAL_FUNCTIONS];
+  uint8_t uiFunctions[MAX_SPECIAL_FUNCTIONS];
+  uint8_t mixerFunctionsCount;
+  uint8_t uiFunctionsCount;
+  bool    mixerFunctionsValid;
+  bool    uiFunctionsValid;
+
   inline bool isFunctionActive(uint8_t func)
   {
     return (activeFunctions | activeUIFunctions) & ((MASK_FUNC_TYPE)1 << func);
@@ -170,6 +179,13 @@ struct CustomFunctionsContext {
   {
     memclear(this, sizeof(*this));
   }
+
+  // to be called when the functions have been edited or loaded
+  void invalidate()
+  {
+    mixerFunctionsValid = false;
+    uiFunctionsValid = false;
+  }
 };
 
 #include "strhelpers.h"
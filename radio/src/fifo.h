@@ -22,6 +22,7 @@
 #pragma once
 
 #include <inttypes.h>
+#include <string.h>
 
 template <class T, int N>
 class Fifo
@@ -49,6 +50,23 @@ class Fifo
       }
     }
 
+    // Push n elements at once, at most two copies; nothing is pushed if
+    // they do not all fit
+    bool push(const T * elements, uint32_t n)
+    {
+      if (!hasSpace(n)) {
+        return false;
+      }
+
+      uint32_t w = widx;
+      uint32_t first = N - w;
+      if (first > n) first = n;
+      memcpy(&fifo[w], elements, first * sizeof(T));
+      memcpy(&fifo[0], elements + first, (n - first) * sizeof(T));
+      widx = (w + n) & (N - 1);
+      return true;
+    }
+
     void skip()
     {
       ridx = nextIndex(ridx);
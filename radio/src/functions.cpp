@@ -173,6 +173,28 @@ static bool isUIFunction(uint16_t f, int16_t p)
           || (f == FUNC_RESET && p == FUNC_RESET_FLIGHT);
 }
 
+// Collect the functions with a switch evaluated in one of the tasks
+static uint8_t compileFunctions(const CustomFunctionData * functions, uint8_t * list, bool ui)
+{
+  uint8_t count = 0;
+  for (uint8_t i=0; i<MAX_SPECIAL_FUNCTIONS; i++) {
+    const CustomFunctionData * cfn = &functions[i];
+    if (CFN_SWITCH(cfn) && isUIFunction(CFN_FUNC(cfn), CFN_PARAM(cfn)) == ui) {
+      list[count++] = i;
+    }
+  }
+  return count;
+}
+
+// Channels overridden / trims reused by the last evaluation:
+// only these need to be reset (all of them at boot)
+#if defined(OVERRIDE_CHANNEL_FUNCTION)
+static uint32_t overriddenChannels = (uint32_t)-1;
+#endif
+#if defined(GVARS)
+static uint16_t reusedTrims = (uint16_t)-1;
+#endif
+
 void evalFunctions(CustomFunctionData * functions, CustomFunctionsContext & functionsContext)
 {
   MASK_FUNC_TYPE newActiveFunctions = 0;
@@ -186,14 +208,14 @@ void evalFunctions(CustomFunctionData * functions, CustomFunctionsContext & func
   #define PLAY_INDEX   (i+playFirstIndex)
 
 #if defined(OVERRIDE_CHANNEL_FUNCTION)
-  for (uint8_t i=0; i<MAX_OUTPUT_CHANNELS; i++) {
-    safetyCh[i] = OVERRIDE_CHANNEL_UNDEFINED;
+  for (uint8_t i=0; overriddenChannels; i++, overriddenChannels >>= 1) {
+    if (overriddenChannels & 1) safetyCh[i] = OVERRIDE_CHANNEL_UNDEFINED;
   }
 #endif
 
 #if defined(GVARS)
-  for (uint8_t i=0; i<MAX_TRIMS; i++) {
-    trimGvar[i] = -1;
+  for (uint8_t i=0; reusedTrims; i++, reusedTrims >>= 1) {
+    if ((reusedTrims & 1) && i < MAX_TRIMS) trimGvar[i] = -1;
   }
 #endif
 
@@ -201,14 +223,17 @@ void evalFunctions(CustomFunctionData * functions, CustomFunctionsContext & func
   bool videoEnabled = false;
 #endif
 
-  for (uint8_t i=0; i<MAX_SPECIAL_FUNCTIONS; i++) {
+  if (!functionsContext.mixerFunctionsValid) {
+    functionsContext.mixerFunctionsCount = compileFunctions(functions, functionsContext.mixerFunctions, false);
+    functionsContext.mixerFunctionsValid = true;
+  }
+
+  for (uint8_t n=0; n<functionsContext.mixerFunctionsCount; n++) {
+    uint8_t i = functionsContext.mixerFunctions[n];
     CustomFunctionData * cfn = &functions[i];
-    // Skip functions evaluated in UI task
-    if (isUIFunction(CFN_FUNC(cfn), CFN_PARAM(cfn))) {
-      continue;
-    }
     swsrc_t swtch = CFN_SWITCH(cfn);
-    if (swtch) {
+    // the list may be outdated until invalidate() is called
+    if (swtch && !isUIFunction(CFN_FUNC(cfn), CFN_PARAM(cfn))) {
       bool active = getSwitch(swtch, IS_PLAY_FUNC(CFN_FUNC(cfn)) ? GETSWITCH_MIDPOS_DELAY : 0);
       // Handle case where function is disabled while active
       if (CFN_ACTIVE(cfn) == 0)
@@ -219,6 +244,7 @@ void evalFunctions(CustomFunctionData * functions, CustomFunctionsContext & func
 #if defined(OVERRIDE_CHANNEL_FUNCTION)
           case FUNC_OVERRIDE_CHANNEL:
             safetyCh[CFN_CH_INDEX(cfn)] = CFN_PARAM(cfn);
+            overriddenChannels |= 1u << CFN_CH_INDEX(cfn);
             break;
 #endif
 
@@ -318,6 +344,7 @@ void evalFunctions(CustomFunctionData * functions, CustomFunctionsContext & func
                        CFN_PARAM(cfn) <= MIXSRC_LAST_TRIM) {
               trimGvar[CFN_PARAM(cfn) - MIXSRC_FIRST_TRIM] =
                   CFN_GVAR_INDEX(cfn);
+              reusedTrims |= 1u << (CFN_PARAM(cfn) - MIXSRC_FIRST_TRIM);
             } else {
               if (CFN_GVAR_MODE(cfn) == FUNC_ADJUST_GVAR_SOURCE)
                 SET_GVAR(CFN_GVAR_INDEX(cfn),
@@ -472,14 +499,17 @@ void evalUIFunctions(CustomFunctionData * functions, CustomFunctionsContext & fu
   MASK_FUNC_TYPE newActiveFunctions = 0;
   MASK_CFN_TYPE  newActiveSwitches = 0;
 
-  for (uint8_t i=0; i<MAX_SPECIAL_FUNCTIONS; i++) {
+  if (!functionsContext.uiFunctionsValid) {
+    functionsContext.uiFunctionsCount = compileFunctions(functions, functionsContext.uiFunctions, true);
+    functionsContext.uiFunctionsValid = true;
+  }
+
+  for (uint8_t n=0; n<functionsContext.uiFunctionsCount; n++) {
+    uint8_t i = functionsContext.uiFunctions[n];
     CustomFunctionData * cfn = &functions[i];
-    // Skip functions evaluated in mixer task
-    if (!isUIFunction(CFN_FUNC(cfn), CFN_PARAM(cfn))) {
-      continue;
-    }
     swsrc_t swtch = CFN_SWITCH(cfn);
-    if (swtch) {
+    // the list may be outdated until invalidate() is called
+    if (swtch && isUIFunction(CFN_FUNC(cfn), CFN_PARAM(cfn))) {
 
       bool active = getSwitch(swtch, 0);
       // Handle case where function is disabled while active
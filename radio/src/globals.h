@@ -75,6 +75,7 @@ extern int16_t trims[MAX_TRIMS];
 extern int32_t chans[MAX_OUTPUT_CHANNELS];
 extern int16_t ex_chans[MAX_OUTPUT_CHANNELS]; // Outputs (before LIMITS) of the last perMain
 extern int16_t channelOutputs[MAX_OUTPUT_CHANNELS];
+extern uint32_t channelOutputsChanged; // bit per channel updated by the mixer, cleared by pulses
 
 typedef uint16_t BeepANACenter;
 extern BeepANACenter bpanaCenter;
@@ -34,6 +34,9 @@ constexpr coord_t MARKER_WIDTH      = 5;
 #define BITMAP_BUFFER_SIZE(w, h)      (2 + (w) * (((h)+7)/8))
 #define DISPLAY_BUFFER_SIZE           (LCD_W*((LCD_H+7)/8))
 
+// only the changed columns of each page are sent to the display
+#define LCD_CHANGED_PAGES_REFRESH
+
 #include "lcd_common.h"
 
 void drawTimerWithMode(coord_t x, coord_t y, uint8_t index, LcdFlags att);
@@ -44,7 +44,7 @@ enum SensorFields {
 constexpr coord_t SENSOR_2ND_COLUMN = 12 * FW;
 constexpr coord_t SENSOR_3RD_COLUMN = 17 * FW - 2;
 
-void menuModelSensor(event_t event)
+static void editSensor(event_t event)
 {
   TelemetrySensor * sensor = & g_model.telemetrySensors[s_currIdx];
 
@@ -340,3 +340,15 @@ void menuModelSensor(event_t event)
     }
   }
 }
+
+void menuModelSensor(event_t event)
+{
+  TelemetrySensor before = g_model.telemetrySensors[s_currIdx];
+
+  editSensor(event);
+
+  if (memcmp(&before, &g_model.telemetrySensors[s_currIdx],
+             sizeof(TelemetrySensor))) {
+    telemetrySensorEdited();
+  }
+}
@@ -92,6 +92,7 @@ void onSensorMenu(const char * result)
         TelemetryItem & sourceItem = telemetryItems[index];
         TelemetryItem & newItem = telemetryItems[newIndex];
         newItem = sourceItem;
+        telemetrySensorEdited();
         storageDirty(EE_MODEL);
       }
       else {
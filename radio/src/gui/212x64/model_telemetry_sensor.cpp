@@ -55,7 +55,7 @@ enum SensorFields {
 #define SENSOR_FILTER_ROWS     (sensor->isConfigurable() ? (uint8_t)0 : HIDDEN_ROW)
 #define SENSOR_PERSISTENT_ROWS (sensor->type == TELEM_TYPE_CALCULATED ? (uint8_t)0 : HIDDEN_ROW)
 
-void menuModelSensor(event_t event)
+static void editSensor(event_t event)
 {
   TelemetrySensor * sensor = &g_model.telemetrySensors[s_currIdx];
 
@@ -327,3 +327,15 @@ void menuModelSensor(event_t event)
     }
   }
 }
+
+void menuModelSensor(event_t event)
+{
+  TelemetrySensor before = g_model.telemetrySensors[s_currIdx];
+
+  editSensor(event);
+
+  if (memcmp(&before, &g_model.telemetrySensors[s_currIdx],
+             sizeof(TelemetrySensor))) {
+    telemetrySensorEdited();
+  }
+}
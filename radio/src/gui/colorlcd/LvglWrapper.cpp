@@ -384,6 +384,25 @@ void LvglWrapper::run()
   }
 }
 
+uint32_t LvglWrapper::runFrame()
+{
+  lv_indev_t* indev = nullptr;
+  while ((indev = lv_indev_get_next(indev)) != nullptr) {
+    lv_timer_ready(indev->driver->read_timer);
+  }
+
+  auto disp = lv_disp_get_default();
+  if (disp && disp->refr_timer) lv_timer_ready(disp->refr_timer);
+
+  return lv_timer_handler();
+}
+
+bool LvglWrapper::isInteracting()
+{
+  if (lv_anim_count_running() > 0) return true;
+  return touchDevice && touchDevice->proc.state == LV_INDEV_STATE_PRESSED;
+}
+
 void initLvgl()
 {
   LvglWrapper::instance();
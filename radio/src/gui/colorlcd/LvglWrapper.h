@@ -31,6 +31,15 @@ class LvglWrapper
   // Called from UI task: executes the LVGL timer handler 
   void run();
 
+  // Called from UI task between two main cycles: reads the input devices
+  // and refreshes the screen without waiting for their LVGL timers.
+  // Returns the time until the next LVGL timer is due (ms).
+  uint32_t runFrame();
+
+  // true while the touch panel is pressed or an animation
+  // (scrolling, transitions) is running
+  bool isInteracting();
+
  protected:
   static LvglWrapper *_instance;
 
@@ -24,6 +24,7 @@
 #include "menu.h"
 #include "menutoolbar.h"
 #include "edgetx.h"
+#include "name_table.h"
 
 class SourceChoiceMenuToolbar : public MenuToolbar
 {
@@ -93,6 +94,8 @@ class SourceChoiceMenuToolbar : public MenuToolbar
         choice->isValueAvailable(0))
       addButton(STR_SELECT_MENU_CLR, 0, 0, nullptr, nullptr, true);
 
+    addSearch(false);
+
     if (choice->canInvert) {
       invertBtn = new MenuToolbarButton(this, {0, 0, LV_PCT(100), 0},
                                         STR_SELECT_MENU_INV);
@@ -216,7 +219,7 @@ SourceChoice::SourceChoice(Window *parent, const rect_t &rect, int16_t vmin,
     if (isValueAvailable && !isValueAvailable(value))
       return std::to_string(0);  // we will fix this later
 
-    return std::string(getSourceString(value));
+    return std::string(sourceNameLookup(value));
   });
 
   setAvailableHandler([](int v) { return isSourceAvailable(v); });
@@ -23,6 +23,7 @@
 #include "menu.h"
 #include "menutoolbar.h"
 #include "edgetx.h"
+#include "name_table.h"
 
 class SwitchChoiceMenuToolbar : public MenuToolbar
 {
@@ -60,6 +61,8 @@ class SwitchChoiceMenuToolbar : public MenuToolbar
         choice->isValueAvailable(0))
       addButton(STR_SELECT_MENU_CLR, 0, 0, nullptr, nullptr, true);
 
+    addSearch(true);
+
     invertBtn = new MenuToolbarButton(this, {0, 0, LV_PCT(100), 0},
                                       STR_SELECT_MENU_INV);
     invertBtn->check(choice->inverted);
@@ -170,7 +173,7 @@ SwitchChoice::SwitchChoice(Window* parent, const rect_t& rect, int vmin,
     if (isValueAvailable && !isValueAvailable(value))
       return std::to_string(0);  // we will fix this later
 
-    return std::string(getSwitchPositionName(value));
+    return std::string(switchNameLookup(value));
   });
 
   setAvailableHandler(isSwitchAvailableInMixes);
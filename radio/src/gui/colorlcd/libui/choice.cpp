@@ -183,33 +183,40 @@ void Choice::onClicked()
     openMenu();
 }
 
+std::string Choice::getMenuText(int value)
+{
+  if (textHandler) return textHandler(value);
+  if (unsigned(value - vmin) < values.size()) return values[value - vmin];
+  return std::to_string(value);
+}
+
 void Choice::fillMenu(Menu* menu, const FilterFct& filter)
 {
   if (menu->count() > 0)
     menu->removeLines();
   auto value = getIntValue();
 
-  int count = 0;
+  // only the values are listed here, their text is fetched
+  // by the menu for the lines being shown
+  menuValues.clear();
   int selectedIx = -1;
   selectedIx0 = -1;
   for (int i = vmin; i <= vmax; ++i) {
     if (filter && !filter(i)) continue;
     if (isValueAvailable && !isValueAvailable(inverted ? -i : i)) continue;
-    if (textHandler) {
-      menu->addLineBuffered(textHandler(i), [=]() { setValue(i); });
-    } else if (unsigned(i - vmin) < values.size()) {
-      menu->addLineBuffered(values[i - vmin], [=]() { setValue(i); });
-    } else {
-      menu->addLineBuffered(std::to_string(i), [=]() { setValue(i); });
-    }
     if (value == i) {
-      selectedIx = count;
+      selectedIx = menuValues.size();
     }
     if (i == 0) {
-      selectedIx0 = count;
+      selectedIx0 = menuValues.size();
     }
-    ++count;
+    menuValues.push_back(i);
   }
+  menu->setVirtualLines(
+      menuValues.size(),
+      [=](int row) { return getMenuText(menuValues[row]); },
+      [=](int row) { setValue(menuValues[row]); });
+
   if (fillMenuHandler) {
     fillMenuHandler(menu, value, selectedIx);
   }
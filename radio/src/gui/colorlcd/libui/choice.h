@@ -170,10 +170,12 @@ class Choice : public ChoiceBase
   int selectedIx0 = 0;
 
   std::vector<std::string> values;
+  std::vector<int> menuValues;  // of the lines in the menu
   std::function<bool(int)> isValueAvailable;
   std::function<void(Menu *, int, int &)> fillMenuHandler;
 
   std::string getLabelText() override;
+  std::string getMenuText(int value);
 
   virtual void openMenu();
 };
@@ -74,6 +74,8 @@ class MenuBody : public TableField
     setLongPressHandler([=]() {
       getParentMenu()->handleLongPress();
     });
+
+    setScrollHandler([=](coord_t, coord_t) { showVirtualRows(); });
   }
 
   ~MenuBody()
@@ -87,7 +89,7 @@ class MenuBody : public TableField
 
   void setIndex(int index)
   {
-    if (index < (int)lines.size()) {
+    if (index < count()) {
       if (index == selectedIndex) return;
       selectedIndex = index;
 
@@ -127,7 +129,17 @@ class MenuBody : public TableField
 
   int selection() const { return selectedIndex; }
 
-  int count() const { return lines.size(); }
+  int count() const { return virtualCount + (int)lines.size(); }
+
+  void setVirtualLines(int count, std::function<std::string(int)> getText,
+                       std::function<void(int)> onPress,
+                       std::function<bool(int)> isChecked)
+  {
+    virtualCount = count;
+    virtualText = std::move(getText);
+    virtualPress = std::move(onPress);
+    virtualChecked = std::move(isChecked);
+  }
 
   void addLine(const MaskBitmap* icon_mask, const std::string& text,
                std::function<void()> onPress, std::function<bool()> isChecked,
@@ -146,17 +158,21 @@ class MenuBody : public TableField
     lines.push_back(l);
 
     if (update) {
-      auto idx = lines.size() - 1;
+      auto idx = count() - 1;
       lv_table_set_cell_value(lvobj, idx, 0, text.c_str());
     }
   }
 
   void updateLines()
   {
-    setRowCount(lines.size());
+    setRowCount(count());
     for (unsigned int idx = 0; idx < lines.size(); idx++) {
-      lv_table_set_cell_value(lvobj, idx, 0, lines[idx]->text.c_str());
+      lv_table_set_cell_value(lvobj, virtualCount + idx, 0,
+                              lines[idx]->text.c_str());
     }
+
+    shownFirst = shownLast = -1;
+    showVirtualRows();
   }
 
   void clearLines()
@@ -172,6 +188,8 @@ class MenuBody : public TableField
   void removeLines()
   {
     clearLines();
+    setVirtualLines(0, nullptr, nullptr, nullptr);
+    shownFirst = shownLast = -1;
     setRowCount(0);
     selectedIndex = 0;
 
@@ -182,29 +200,27 @@ class MenuBody : public TableField
   void onPress(uint16_t row, uint16_t col) override
   {
     Menu* menu = getParentMenu();
-    if (row < lines.size()) {
+    if (row < count()) {
       if (menu->isMultiple()) {
-        if (selectedIndex == (int)row)
-          lines[row]->onPress();
-        else {
-          setIndex(row);
-          lines[row]->onPress();
-        }
+        if (selectedIndex != (int)row) setIndex(row);
       } else {
         // delete menu first to avoid
         // focus issues with onPress()
         menu->deleteLater();
-        lines[row]->onPress();
       }
+      if (row < virtualCount)
+        virtualPress(row);
+      else
+        lines[row - virtualCount]->onPress();
     }
   }
 
   void onDrawBegin(uint16_t row, uint16_t col,
                    lv_obj_draw_part_dsc_t* dsc) override
   {
-    if (lines.size() == 0) return;
+    if (row < virtualCount || row >= count()) return;
 
-    lv_canvas_t* icon = (lv_canvas_t*)lines[row]->getIcon();
+    lv_canvas_t* icon = (lv_canvas_t*)lines[row - virtualCount]->getIcon();
     if (!icon) return;
 
     lv_img_t* img = &icon->img;
@@ -215,9 +231,18 @@ class MenuBody : public TableField
   void onDrawEnd(uint16_t row, uint16_t col,
                  lv_obj_draw_part_dsc_t* dsc) override
   {
-    if (row >= lines.size()) return;
+    if (row >= count()) return;
+
+    bool checked;
+    lv_obj_t* icon = nullptr;
+    if (row < virtualCount) {
+      checked = virtualChecked && virtualChecked(row);
+    } else {
+      auto line = lines[row - virtualCount];
+      checked = line->isChecked && line->isChecked();
+      icon = line->getIcon();
+    }
 
-    lv_obj_t* icon = lines[row]->getIcon();
     if (icon) {
       lv_draw_img_dsc_t img_dsc;
       lv_draw_img_dsc_init(&img_dsc);
@@ -236,7 +261,7 @@ class MenuBody : public TableField
       lv_draw_img(dsc->draw_ctx, &img_dsc, &coords, img);
     }
 
-    if (lines[row]->isChecked != nullptr && lines[row]->isChecked()) {
+    if (checked) {
       lv_area_t coords;
       lv_coord_t area_h = lv_area_get_height(dsc->draw_area);
       lv_coord_t cell_right = lv_obj_get_style_pad_right(lvobj, LV_PART_ITEMS);
@@ -256,6 +281,68 @@ class MenuBody : public TableField
   std::vector<MenuLine*> lines;
   int selectedIndex = 0;
 
+  // Virtual lines come first: only the rows around the visible
+  // ones have a text in the table, fetched from 'virtualText'
+  int virtualCount = 0;
+  int shownFirst = -1;
+  int shownLast = -1;
+  std::function<std::string(int)> virtualText;
+  std::function<void(int)> virtualPress;
+  std::function<bool(int)> virtualChecked;
+
+  void setVirtualRowText(int row, const char* text)
+  {
+    // cropped to one line: all virtual rows have the same height
+    // whether their text is set or not
+    lv_table_add_cell_ctrl(lvobj, row, 0, LV_TABLE_CELL_CTRL_TEXT_CROP);
+    lv_table_set_cell_value(lvobj, row, 0, text);
+  }
+
+  void clearVirtualRowText(int row)
+  {
+    // keeps the crop flag, so the row height does not change
+    lv_table_set_cell_value(lvobj, row, 0, "");
+  }
+
+  // virtual rows hold a single line of text (cropped)
+  lv_coord_t virtualRowHeight()
+  {
+    const lv_font_t* font = lv_obj_get_style_text_font(lvobj, LV_PART_ITEMS);
+    return lv_font_get_line_height(font) +
+           lv_obj_get_style_pad_top(lvobj, LV_PART_ITEMS) +
+           lv_obj_get_style_pad_bottom(lvobj, LV_PART_ITEMS);
+  }
+
+  void showVirtualRows()
+  {
+    if (virtualCount == 0 || lv_table_get_row_cnt(lvobj) < count()) return;
+
+    lv_obj_update_layout(lvobj);
+    lv_coord_t row_h = virtualRowHeight();
+    lv_coord_t h = lv_obj_get_height(lvobj);
+    if (row_h <= 0) return;
+    if (h <= 0) h = LCD_H;
+
+    // one screen ahead and behind, so that scrolling does not
+    // show empty rows before the scroll event is handled
+    int rows = h / row_h + 1;
+    int first = max(0, lv_obj_get_scroll_y(lvobj) / row_h - rows);
+    int last = min(virtualCount - 1, first + 3 * rows);
+    if (first == shownFirst && last == shownLast) return;
+
+    for (int row = shownFirst; row >= 0 && row <= shownLast; row++) {
+      if (row < first || row > last) clearVirtualRowText(row);
+    }
+    for (int row = first; row <= last; row++) {
+      if (row < shownFirst || row > shownLast)
+        setVirtualRowText(row, virtualText(row).c_str());
+    }
+
+    shownFirst = first;
+    shownLast = last;
+    lv_obj_invalidate(lvobj);
+  }
+
   Menu* getParentMenu() { return static_cast<Menu*>(getParent()->getParent()); }
 };
 
@@ -322,6 +409,13 @@ class MenuWindowContent : public NavWindow
 #endif
 
   void updateLines() { body->updateLines(); }
+  void setVirtualLines(int count, std::function<std::string(int)> getText,
+                       std::function<void(int)> onPress,
+                       std::function<bool(int)> isChecked)
+  {
+    body->setVirtualLines(count, std::move(getText), std::move(onPress),
+                          std::move(isChecked));
+  }
   void removeLines() { body->removeLines(); }
   int count() { return body->count(); }
   int selection() { return body->selection(); }
@@ -410,6 +504,15 @@ void Menu::addLineBuffered(const std::string &text, std::function<void()> onPres
   content->addLine(nullptr, text, std::move(onPress), std::move(isChecked), false);
 }
 
+void Menu::setVirtualLines(unsigned count,
+                           std::function<std::string(int)> getText,
+                           std::function<void(int)> onPress,
+                           std::function<bool(int)> isChecked)
+{
+  content->setVirtualLines(count, std::move(getText), std::move(onPress),
+                           std::move(isChecked));
+}
+
 void Menu::updateLines()
 {
   content->updateLines();
@@ -52,6 +52,13 @@ class Menu : public ModalWindow
   void addLineBuffered(const std::string &text, std::function<void()> onPress,
                        std::function<bool()> isChecked = nullptr);
 
+  // 'count' lines whose text is only fetched when they are about to be
+  // shown, for long lists. They come before the lines added otherwise
+  // and are shown on the next updateLines()
+  void setVirtualLines(unsigned count, std::function<std::string(int)> getText,
+                       std::function<void(int)> onPress,
+                       std::function<bool(int)> isChecked = nullptr);
+
   void updateLines();
 
   void removeLines();
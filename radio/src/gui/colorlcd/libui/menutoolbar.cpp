@@ -18,9 +18,13 @@
 
 #include "menutoolbar.h"
 
+#include <algorithm>
+
 #include "keys.h"
 #include "menu.h"
 #include "etx_lv_theme.h"
+#include "name_table.h"
+#include "textedit.h"
 #include "translations/translations.h"
 
 static const lv_obj_class_t menu_button_class = {
@@ -89,7 +93,11 @@ MenuToolbar::MenuToolbar(Choice* choice, Menu* menu, const int columns) :
   });
 }
 
-MenuToolbar::~MenuToolbar() { lv_group_del(group); }
+MenuToolbar::~MenuToolbar()
+{
+  lv_group_del(group);
+  delete nameSearch;
+}
 
 void MenuToolbar::resetFilter()
 {
@@ -192,3 +200,32 @@ void MenuToolbar::addButton(const char* picto, int16_t filtermin,
     lv_event_send(allBtn->getLvObj(), LV_EVENT_CLICKED, nullptr);
   }
 }
+
+void MenuToolbar::addSearch(bool switches)
+{
+  nameSearch = new NameSearch(switches);
+
+  rect_t r = getButtonRect(true);
+  searchEdit = new TextEdit(this, r, searchText, LEN_SEARCH_TEXT,
+                            [=]() { searchMenu(searchText); });
+  searchEdit->setTypingHandler([=](const char* text) { searchMenu(text); });
+}
+
+void MenuToolbar::searchMenu(const char* text)
+{
+  menu->setTitle(choice->getTitle());
+
+  if (!text[0]) {
+    filter = nullptr;
+    choice->fillMenu(menu);
+    return;
+  }
+
+  // the results are sorted, as the names are searched in order
+  std::vector<int16_t> results = nameSearch->search(text);
+  filter = [=](int16_t index) {
+    return index == 0 || std::binary_search(results.begin(), results.end(),
+                                            (int16_t)abs(index));
+  };
+  choice->fillMenu(menu, filter);
+}
@@ -24,6 +24,8 @@
 #include "messaging.h"
 
 class Menu;
+class NameSearch;
+class TextEdit;
 
 class MenuToolbarButton : public ButtonBase
 {
@@ -47,6 +49,7 @@ class MenuToolbar : public Window
   virtual void longPress() {}
 
   static LAYOUT_VAL_SCALED(MENUS_TOOLBAR_BUTTON_WIDTH, 36)
+  static constexpr uint8_t LEN_SEARCH_TEXT = 12;
 
  protected:
   Choice* choice;
@@ -57,6 +60,11 @@ class MenuToolbar : public Window
   MenuToolbarButton* allBtn = nullptr;
   Messaging changeFilterMsg;
 
+  // text search in the source or switch names
+  NameSearch* nameSearch = nullptr;
+  TextEdit* searchEdit = nullptr;
+  char searchText[LEN_SEARCH_TEXT + 1] = "";
+
   lv_group_t* group;
 
   void addButton(const char* picto, int16_t filtermin, int16_t filtermax,
@@ -65,5 +73,8 @@ class MenuToolbar : public Window
   bool filterMenu(MenuToolbarButton* btn, int16_t filtermin, int16_t filtermax,
                   const Choice::FilterFct& filterFunc, const char* title);
 
+  void addSearch(bool switches);
+  void searchMenu(const char* text);
+
   rect_t getButtonRect(bool wideButton);
 };
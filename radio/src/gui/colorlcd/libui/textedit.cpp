@@ -20,6 +20,7 @@
 
 #include "keyboard_text.h"
 #include "myeeprom.h"
+#include "name_table.h"
 #include "storage/storage.h"
 #include "etx_lv_theme.h"
 
@@ -165,6 +166,15 @@ void TextEdit::openEdit()
       lv_group_focus_obj(lvobj);
       edit->hide();
     });
+    if (typingHandler) {
+      lv_obj_add_event_cb(
+          edit->getLvObj(),
+          [](lv_event_t* e) {
+            auto te = (TextEdit*)lv_event_get_user_data(e);
+            te->typingHandler(lv_textarea_get_text(lv_event_get_target(e)));
+          },
+          LV_EVENT_VALUE_CHANGED, this);
+    }
   }
   edit->update();
   edit->show();
@@ -191,6 +201,7 @@ ModelTextEdit::ModelTextEdit(Window* parent, const rect_t& rect, char* value,
     TextEdit(parent, rect, value, length,
              [=]() {
                if (updateHandler) updateHandler();
+               nameTableInvalidate();
                storageDirty(EE_MODEL);
              })
 {
@@ -201,6 +212,7 @@ ModelStringEdit::ModelStringEdit(Window* parent, const rect_t& rect, std::string
     TextEdit(parent, rect, txt, MAX_STR_EDIT_LEN,
              [=]() {
                if (updateHandler) updateHandler(txt);
+               nameTableInvalidate();
                storageDirty(EE_MODEL);
              })
 {
@@ -211,6 +223,9 @@ ModelStringEdit::ModelStringEdit(Window* parent, const rect_t& rect, std::string
 RadioTextEdit::RadioTextEdit(Window* parent, const rect_t& rect, char* value,
                              uint8_t length) :
     TextEdit(parent, rect, value, length,
-             []() { storageDirty(EE_GENERAL); })
+             []() {
+               nameTableInvalidate();
+               storageDirty(EE_GENERAL);
+             })
 {
 }
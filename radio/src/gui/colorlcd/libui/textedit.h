@@ -36,8 +36,15 @@ class TextEdit : public TextButton
   void preview(bool edited, char* text, uint8_t length);
   void update();
 
+  // Called on each change while editing, with the text being typed
+  void setTypingHandler(std::function<void(const char*)> handler)
+  {
+    typingHandler = std::move(handler);
+  }
+
  protected:
   std::function<void(void)> updateHandler = nullptr;
+  std::function<void(const char*)> typingHandler = nullptr;
   TextArea* edit = nullptr;
   char* text;
   uint8_t length;
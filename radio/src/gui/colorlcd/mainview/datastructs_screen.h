@@ -26,6 +26,7 @@
 #include <string>
 #endif
 
+#include "dataconstants.h"
 #include "etx_lv_theme.h"
 
 struct WidgetOption;
@@ -213,3 +214,20 @@ struct TopBarPersistentData {
 };
 
 //-----------------------------------------------------------------------------
+
+// Copy of a model's screen and top bar settings (see ModelData::saveScreenData())
+struct ModelScreenData;
+
+#if !defined(YAML_GENERATOR)
+struct ModelScreenData {
+  TopBarPersistentData topbar;
+  CustomScreenData* screens[MAX_CUSTOM_SCREENS] = {};
+
+  ~ModelScreenData()
+  {
+    for (int i = 0; i < MAX_CUSTOM_SCREENS; i += 1) delete screens[i];
+  }
+};
+#endif
+
+//-----------------------------------------------------------------------------
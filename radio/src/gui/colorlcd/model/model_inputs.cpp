@@ -29,6 +29,7 @@
 #include "input_edit.h"
 #include "menu.h"
 #include "messaging.h"
+#include "name_table.h"
 #include "tasks/mixer_task.h"
 
 #define SET_DIRTY() storageDirty(EE_MODEL)
@@ -73,6 +74,7 @@ void deleteExpo(uint8_t idx)
   memclear(&g_model.expoData[MAX_EXPOS - 1], sizeof(ExpoData));
   if (!isInputAvailable(input)) {
     memclear(&g_model.inputNames[input], LEN_INPUT_NAME);
+    nameTableInvalidate();
   }
   mixerTaskStart();
   storageDirty(EE_MODEL);
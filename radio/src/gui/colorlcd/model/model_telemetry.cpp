@@ -364,6 +364,7 @@ class SensorEditWindow : public SubPage
   explicit SensorEditWindow(uint8_t index) :
       SubPage(ICON_MODEL_TELEMETRY, STR_MENUTELEMETRY, "", true), index(index)
   {
+    lastConfig = g_model.telemetrySensors[index];
     buildHeader(header);
     buildBody(body);
     enableRefresh();
@@ -373,6 +374,7 @@ class SensorEditWindow : public SubPage
   uint8_t index;
   uint32_t lastRefresh = 0;
   StaticText* headerValue = nullptr;
+  TelemetrySensor lastConfig;
 
   enum ParamTypes {
     P_FORMULA = 0,
@@ -415,6 +417,12 @@ class SensorEditWindow : public SubPage
 
   void checkEvents() override
   {
+    TelemetrySensor& sensor = g_model.telemetrySensors[index];
+    if (memcmp(&lastConfig, &sensor, sizeof(TelemetrySensor))) {
+      lastConfig = sensor;
+      telemetrySensorEdited();
+    }
+
     uint32_t now = lv_tick_get();
     TelemetryItem& telemetryItem = telemetryItems[index];
 
@@ -812,6 +820,7 @@ void ModelTelemetryPage::buildSensorList(int8_t focusSensorIndex)
             TelemetryItem& sourceItem = telemetryItems[idx];
             TelemetryItem& newItem = telemetryItems[newIndex];
             newItem = sourceItem;
+            telemetrySensorEdited();
             SET_DIRTY();
             buildSensorList(newIndex);
           } else {
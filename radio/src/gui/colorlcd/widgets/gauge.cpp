@@ -23,6 +23,7 @@
 
 #include "edgetx.h"
 #include "static.h"
+#include "telemetry/sensor_history.h"
 
 class GaugeWidget : public Widget
 {
@@ -52,6 +53,13 @@ class GaugeWidget : public Widget
     lv_obj_clear_flag(box, LV_OBJ_FLAG_CLICKABLE);
     etx_solid_bg(box, COLOR_THEME_PRIMARY2_INDEX);
 
+    // telemetry sensors, if enabled: range of the last minute behind the bar
+    range = lv_obj_create(box);
+    lv_obj_set_pos(range, 0, 0);
+    lv_obj_set_size(range, 0, GUAGE_H);
+    lv_obj_clear_flag(range, LV_OBJ_FLAG_CLICKABLE);
+    etx_obj_add_style(range, styles->bg_opacity_50, LV_PART_MAIN);
+
     bar = lv_obj_create(box);
     lv_obj_set_pos(bar, 0, 0);
     lv_obj_clear_flag(bar, LV_OBJ_FLAG_CLICKABLE);
@@ -63,13 +71,17 @@ class GaugeWidget : public Widget
   int16_t getGuageValue()
   {
     auto widgetData = getPersistentData();
-
     mixsrc_t index = widgetData->options[0].value.unsignedValue;
+    return toPercent(getValue(index));
+  }
+
+  int16_t toPercent(int32_t value)
+  {
+    auto widgetData = getPersistentData();
+
     int32_t min = widgetData->options[1].value.signedValue;
     int32_t max = widgetData->options[2].value.signedValue;
 
-    int32_t value = getValue(index);
-
     if (min > max) {
       SWAP(min, max);
       value = value - min - max;
@@ -95,6 +107,8 @@ class GaugeWidget : public Widget
       lv_obj_clear_state(valueText->getLvObj(), LV_STATE_USER_1);
 
     etx_bg_color_from_flags(bar, widgetData->options[3].value.unsignedValue);
+    etx_bg_color_from_flags(range, widgetData->options[3].value.unsignedValue);
+    rangeEnd = UINT32_MAX;
   }
 
   static const WidgetOption options[];
@@ -104,6 +118,8 @@ class GaugeWidget : public Widget
   StaticText* sourceText = nullptr;
   DynamicNumber<int16_t>* valueText = nullptr;
   lv_obj_t* bar = nullptr;
+  lv_obj_t* range = nullptr;
+  uint32_t rangeEnd = UINT32_MAX;
 
   void foreground() override
   {
@@ -116,6 +132,54 @@ class GaugeWidget : public Widget
       lv_coord_t w = (width() * lastValue) / 100;
       lv_obj_set_size(bar, w, GUAGE_H);
     }
+
+    updateRange();
+  }
+
+  // Min and max of the last minute, from the 1s sensor history. Only
+  // when enabled: there are few history slots, Lua scripts need some.
+  void updateRange()
+  {
+    auto widgetData = getPersistentData();
+    mixsrc_t index = widgetData->options[0].value.unsignedValue;
+
+    const SensorHistoryRing* ring = nullptr;
+    if (widgetData->options[4].value.boolValue &&
+        index >= MIXSRC_FIRST_TELEM && index <= MIXSRC_LAST_TELEM &&
+        (index - MIXSRC_FIRST_TELEM) % 3 == 0 && !IS_FAI_FORBIDDEN(index))
+      ring = sensorHistory((index - MIXSRC_FIRST_TELEM) / 3, SENSOR_HISTORY_1S);
+
+    if (!ring || ring->count() == 0) {
+      if (rangeEnd != 0) {
+        rangeEnd = 0;
+        lv_obj_set_size(range, 0, GUAGE_H);
+      }
+      return;
+    }
+
+    // only once per bucket
+    if (ring->end() == rangeEnd) return;
+    rangeEnd = ring->end();
+
+    int32_t lowest = INT32_MAX, highest = INT32_MIN;
+    uint32_t first = rangeEnd > 60 ? rangeEnd - 60 : 0;
+    for (uint32_t n = max(first, ring->first()); n < rangeEnd; n++) {
+      auto bucket = ring->get(n);
+      if (!bucket || bucket->isEmpty()) continue;
+      if (bucket->min < lowest) lowest = bucket->min;
+      if (bucket->max > highest) highest = bucket->max;
+    }
+
+    if (lowest > highest) {
+      lv_obj_set_size(range, 0, GUAGE_H);
+      return;
+    }
+
+    lv_coord_t x1 = (width() * toPercent(lowest)) / 100;
+    lv_coord_t x2 = (width() * toPercent(highest)) / 100;
+    if (x1 > x2) SWAP(x1, x2);
+    lv_obj_set_pos(range, x1, 0);
+    lv_obj_set_size(range, x2 - x1 + 1, GUAGE_H);
   }
 
   static LAYOUT_VAL_SCALED(GUAGE_H, 16)
@@ -129,6 +193,7 @@ const WidgetOption GaugeWidget::options[] = {
     {STR_MAX, WidgetOption::Integer, WIDGET_OPTION_VALUE_SIGNED(RESX),
      WIDGET_OPTION_VALUE_SIGNED(-RESX), WIDGET_OPTION_VALUE_SIGNED(RESX)},
     {STR_COLOR, WidgetOption::Color, COLOR2FLAGS(COLOR_THEME_WARNING_INDEX)},
+    {STR_GAUGE_RANGE, WidgetOption::Bool, false},
     {nullptr, WidgetOption::Bool}};
 
 BaseWidgetFactory<GaugeWidget> gaugeWidget("Gauge", GaugeWidget::options,
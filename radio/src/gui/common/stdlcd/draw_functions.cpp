@@ -24,6 +24,7 @@
 
 #include "hal/adc_driver.h"
 #include "analogs.h"
+#include "name_table.h"
 
 #if defined(MULTIMODULE)
 void lcdDrawMultiProtocolString(coord_t x, coord_t y, uint8_t moduleIdx, uint8_t protocol, LcdFlags flags)
@@ -245,6 +246,7 @@ void editName(coord_t x, coord_t y, char* name, uint8_t size, event_t event,
 
       if (c != v) {
         name[cur] = v;
+        nameTableInvalidate();
         storageDirty(isModelMenuDisplayed() ? EE_MODEL : EE_GENERAL);
       }
 
@@ -271,6 +273,7 @@ void editName(coord_t x, coord_t y, char* name, uint8_t size, event_t event,
       }
 
       if (modified) {
+        nameTableInvalidate();
         storageDirty(isModelMenuDisplayed() ? EE_MODEL : EE_GENERAL);
       }
     }
@@ -48,6 +48,52 @@ void lcdClear()
   memset(displayBuf, 0, DISPLAY_BUFFER_SIZE * sizeof(pixel_t));
 }
 
+#if defined(LCD_CHANGED_PAGES_REFRESH)
+// The display content, as last sent
+static pixel_t lcdSentBuf[DISPLAY_BUFFER_SIZE];
+static bool lcdSentValid = false;
+static uint16_t lcdFramesSinceFullRefresh = 0;
+
+LcdRefreshStats lcdRefreshStats;
+
+void lcdRefreshAll()
+{
+  lcdSentValid = false;
+}
+
+bool lcdGetChangedColumns(uint8_t page, coord_t& first, coord_t& last)
+{
+  const pixel_t* p = &displayBuf[page * LCD_W];
+  pixel_t* sent = &lcdSentBuf[page * LCD_W];
+
+  if (page == 0) {
+    lcdRefreshStats.frames++;
+    // resend everything once in a while, should the display RAM
+    // have been corrupted (ESD, glitch on the bus...)
+    if (++lcdFramesSinceFullRefresh >= LCD_FULL_REFRESH_FRAMES) {
+      lcdSentValid = false;
+    }
+  }
+
+  first = 0;
+  last = LCD_W - 1;
+  if (lcdSentValid) {
+    while (first < LCD_W && p[first] == sent[first]) first++;
+    if (first == LCD_W) return false;
+    while (p[last] == sent[last]) last--;
+  }
+
+  memcpy(&sent[first], &p[first], last - first + 1);
+  lcdRefreshStats.bytes += last - first + 1;
+
+  if (page == (LCD_H + 7) / 8 - 1 && !lcdSentValid) {
+    lcdSentValid = true;
+    lcdFramesSinceFullRefresh = 0;
+  }
+  return true;
+}
+#endif
+
 LcdFlags getCharPattern(PatternData * pattern, unsigned char c, LcdFlags flags)
 {
 #if !defined(BOOT)
@@ -112,6 +112,25 @@ struct PatternData
 
 void lcdClear();
 
+#if defined(LCD_CHANGED_PAGES_REFRESH)
+// The whole display is sent every LCD_FULL_REFRESH_FRAMES frames anyway
+#define LCD_FULL_REFRESH_FRAMES  200
+
+// Columns [first:last] of 'page' changed since it was last sent. The
+// page is then taken as sent. Returns false when nothing changed.
+bool lcdGetChangedColumns(uint8_t page, coord_t& first, coord_t& last);
+
+// The whole display is sent on the next refresh (display RAM lost)
+void lcdRefreshAll();
+
+struct LcdRefreshStats {
+  uint32_t frames;
+  uint32_t bytes;   // display data sent
+};
+
+extern LcdRefreshStats lcdRefreshStats;
+#endif
+
 void lcdDrawChar(coord_t x, coord_t y, uint8_t c);
 void lcdDrawChar(coord_t x, coord_t y, uint8_t c, LcdFlags flags);
 void lcdDrawCenteredText(coord_t y, const char * s, LcdFlags flags = 0);
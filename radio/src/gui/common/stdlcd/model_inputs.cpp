@@ -23,6 +23,7 @@
 #include "tasks/mixer_task.h"
 #include "hal/adc_driver.h"
 #include "input_mapping.h"
+#include "name_table.h"
 
 #define _STRING_MAX(x)                     "/" #x
 #define STRING_MAX(x)                     _STRING_MAX(x)
@@ -136,6 +137,7 @@ void deleteExpo(uint8_t idx)
   memclear(&g_model.expoData[MAX_EXPOS-1], sizeof(ExpoData));
   if (!isInputAvailable(input)) {
     memclear(&g_model.inputNames[input], LEN_INPUT_NAME);
+    nameTableInvalidate();
   }
   mixerTaskStart();
   storageDirty(EE_MODEL);
@@ -91,6 +91,22 @@ uint8_t fatfsGetLun(uint8_t pdrv)
   return _fatfs_drives[pdrv].lun;
 }
 
+void fatfsIdle()
+{
+  for (uint8_t i = 0; i < _fatfs_n_drives; i++) {
+    auto& drive = _fatfs_drives[i];
+    if (!drive.initialized || !drive.drv->idle) continue;
+#if FF_FS_REENTRANT != 0
+    // not while FatFs is using the volume
+    mutex_lock(&drive.mutex);
+#endif
+    drive.drv->idle(drive.lun);
+#if FF_FS_REENTRANT != 0
+    mutex_unlock(&drive.mutex);
+#endif
+  }
+}
+
 #if FF_FS_REENTRANT != 0
 
 int ff_mutex_create(int vol)
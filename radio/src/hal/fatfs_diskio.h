@@ -37,6 +37,10 @@ struct diskio_driver_t
   DRESULT (*write)(BYTE pdrv, const BYTE* buff, DWORD sector, UINT count);
 
   DRESULT (*ioctl)(BYTE pdrv, BYTE cmd, void* buff);
+
+  // optional: background maintenance (e.g. erasing freed flash pages),
+  // called with the volume locked while the storage is idle
+  void (*idle)(BYTE pdrv);
 };
 
 // returns 1 if successful, 0 otherwise
@@ -50,3 +54,6 @@ const diskio_driver_t* fatfsGetDriver(uint8_t pdrv);
 
 // returns a physical LUN or 0
 uint8_t fatfsGetLun(uint8_t pdrv);
+
+// runs the idle() maintenance of the initialized drivers
+void fatfsIdle();
@@ -79,6 +79,10 @@ typedef struct {
   // Send a buffer
   void (*sendBuffer)(void* ctx, const uint8_t* data, uint32_t size);
 
+  // Bytes sendBuffer() accepts right now (optional: drivers without it
+  // never drop data, they wait for the buffer to be sent)
+  uint32_t (*getTxFreeSpace)(void* ctx);
+
   // Is TX phase completed
   bool (*txCompleted)(void* ctx);
   
@@ -48,6 +48,7 @@
     .read = disk_cache_read,
     .write = disk_cache_write,
     .ioctl = _STORAGE_DRIVER.ioctl,
+    .idle = _STORAGE_DRIVER.idle,
   };
 #endif
 
@@ -80,6 +81,11 @@ void storagePreMountHook()
 #endif
 }
 
+void storageIdle()
+{
+  fatfsIdle();
+}
+
 bool storageIsPresent()
 {
   return (_STORAGE_DRIVER.status(0) & STA_NODISK) == 0;
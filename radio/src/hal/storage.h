@@ -31,6 +31,9 @@ void storageDeInit();
 // Called before the storage is mounted
 void storagePreMountHook();
 
+// Called by the storage task when it has nothing to write
+void storageIdle();
+
 bool storageIsPresent();
 
 #define SD_CARD_PRESENT() storageIsPresent()
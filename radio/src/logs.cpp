@@ -30,6 +30,7 @@
 
 #include "os/timer.h"
 #include "tasks/mixer_task.h"
+#include "tasks/storage_task.h"
 
 FIL g_oLogFile __DMA;
 uint8_t logDelay100ms;
@@ -41,6 +42,11 @@ static void loggingTimerCb(timer_handle_t* timer)
 {
   (void)timer;
   if (mixerTaskRunning()) {
+    // keep SD card latency out of the timer task
+    if (storageTaskRunning()) {
+      storageTaskPostLogs();
+      return;
+    }
     DEBUG_TIMER_START(debugTimerLoggingWakeup);
     logsWrite();
     DEBUG_TIMER_STOP(debugTimerLoggingWakeup);
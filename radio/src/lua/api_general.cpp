@@ -43,6 +43,7 @@
 #endif
 
 #include "telemetry/frsky.h"
+#include "telemetry/sensor_history.h"
 
 #if defined(MULTIMODULE)
   #include "telemetry/multi.h"
@@ -855,6 +856,133 @@ static int luaGetSourceValue(lua_State * L)
   return 3;
 }
 
+static void luaPushSensorValue(lua_State * L, const TelemetrySensor & sensor, int32_t value)
+{
+  if (sensor.prec > 0)
+    lua_pushnumber(L, float(value) / sensor.getPrecDivisor());
+  else
+    lua_pushinteger(L, value);
+}
+
+// upvalues: ring, sensor index, next bucket number, end, position
+static int luaSensorHistoryNext(lua_State * L)
+{
+  auto ring = (const SensorHistoryRing *)lua_touserdata(L, lua_upvalueindex(1));
+  int index = lua_tointeger(L, lua_upvalueindex(2));
+  uint32_t n = lua_tointeger(L, lua_upvalueindex(3));
+  uint32_t end = lua_tointeger(L, lua_upvalueindex(4));
+  int position = lua_tointeger(L, lua_upvalueindex(5));
+
+  // skip the buckets overwritten meanwhile
+  if (n < ring->first()) {
+    position += ring->first() - n;
+    n = ring->first();
+  }
+
+  const SensorHistoryBucket * bucket = (n < end ? ring->get(n) : nullptr);
+  if (!bucket) {
+    return 0;
+  }
+
+  lua_pushinteger(L, n + 1);
+  lua_replace(L, lua_upvalueindex(3));
+  lua_pushinteger(L, position + 1);
+  lua_replace(L, lua_upvalueindex(5));
+
+  lua_pushinteger(L, position + 1);
+  if (bucket->isEmpty()) {
+    return 1;
+  }
+
+  const TelemetrySensor & sensor = g_model.telemetrySensors[index];
+  luaPushSensorValue(L, sensor, bucket->avg);
+  luaPushSensorValue(L, sensor, bucket->min);
+  luaPushSensorValue(L, sensor, bucket->max);
+  return 4;
+}
+
+/*luadoc
+@function getSensorHistory(source [, tier])
+
+Iterates over the values recorded for a telemetry sensor, oldest first,
+without copying them into a table.
+
+Only a few sensors can have a history at the same time. The history of a
+sensor is recorded from the first time it is requested, and is dropped
+when not requested for 30 seconds and another sensor needs it.
+
+@param source can be an index (number) or a name (string) of a telemetry
+sensor, as for `getValue`
+
+@param tier (number) optional:
+ * 0 (default) each value received
+ * 1 one second buckets
+ * 2 ten seconds buckets
+
+@retval iterator function returning for each bucket its position (from 1),
+then its average, min and max values. Only the position is returned for the
+periods without any value received. The last incomplete bucket of tiers 1
+and 2 is not returned.
+
+@retval count (number) of buckets
+
+nil is returned if the source is not a telemetry sensor with numeric values,
+or if no history is available for it (yet: the history of a sensor starts
+being recorded shortly after its first request).
+
+@status current Introduced in 3.0
+
+### Example
+
+```lua
+  for i, avg, min, max in getSensorHistory("RxBt", 1) do
+    if avg then
+      drawPoint(i, avg)
+    end
+  end
+```
+*/
+static int luaGetSensorHistory(lua_State * L)
+{
+  int src = MIXSRC_NONE;
+  if (lua_isnumber(L, 1)) {
+    src = luaL_checkinteger(L, 1);
+  }
+  else {
+    LuaField field;
+    if (luaFindFieldByName(luaL_checkstring(L, 1), field)) {
+      src = field.id;
+    }
+  }
+  int tier = luaL_optinteger(L, 2, SENSOR_HISTORY_RAW);
+
+  if (src < MIXSRC_FIRST_TELEM || src > MIXSRC_LAST_TELEM || IS_FAI_FORBIDDEN(src) ||
+      tier < SENSOR_HISTORY_RAW || tier >= SENSOR_HISTORY_TIERS) {
+    return 0;
+  }
+
+  int index = (src - MIXSRC_FIRST_TELEM) / 3;
+  const TelemetrySensor & sensor = g_model.telemetrySensors[index];
+  if (!sensor.isAvailable() || sensor.unit == UNIT_GPS || sensor.unit == UNIT_DATETIME ||
+      sensor.unit == UNIT_TEXT) {
+    return 0;
+  }
+
+  const SensorHistoryRing * ring = sensorHistory(index, (SensorHistoryTier)tier);
+  if (!ring) {
+    return 0;
+  }
+
+  lua_pushlightuserdata(L, (void *)ring);
+  lua_pushinteger(L, index);
+  lua_pushinteger(L, ring->first());
+  lua_pushinteger(L, ring->end());
+  lua_pushinteger(L, 0);
+  lua_pushcclosure(L, luaSensorHistoryNext, 5);
+  lua_pushinteger(L, ring->count());
+  return 2;
+}
+
 /*luadoc
 @function getRotEncSpeed()
 
@@ -2039,6 +2167,7 @@ static int luaSetTelemetryValue(lua_State * L)
       telemetrySensor.subId = subId;
       telemetrySensor.instance = instance;
       telemetrySensor.init(name ? name: name_buf, unit, prec);
+      telemetrySensorEdited();
       
       storageDirty(EE_MODEL);
       
@@ -3125,6 +3254,7 @@ LROT_BEGIN(etxlib, NULL, 0)
   LROT_FUNCENTRY( getValue, luaGetValue )
   LROT_FUNCENTRY( getOutputValue, luaGetOutputValue )
   LROT_FUNCENTRY( getSourceValue, luaGetSourceValue )
+  LROT_FUNCENTRY( getSensorHistory, luaGetSensorHistory )
   LROT_FUNCENTRY( getTrainerStatus, luaGetTrainerStatus )
   LROT_FUNCENTRY( getRAS, luaGetRAS )
   LROT_FUNCENTRY( getTxGPS, luaGetTxGPS )
@@ -29,6 +29,7 @@
 #include "model_init.h"
 #include "gvars.h"
 #include "mixes.h"
+#include "name_table.h"
 
 #include "lua_states.h"
 
@@ -371,6 +372,7 @@ static int luaModelSetTimer(lua_State *L)
       else if (!strcmp(key, "name")) {
         const char * name = luaL_checkstring(L, -1);
         strncpy(timer.name, name, sizeof(timer.name));
+        nameTableInvalidate();
       }
       else if (!strcmp(key, "showElapsed")) {
         timer.showElapsed = lua_toboolean(L, -1);
@@ -551,6 +553,7 @@ static int luaModelSetFlightMode(lua_State * L)
     if (!strcmp(key, "name")) {
       const char * name = luaL_checkstring(L, -1);
       strncpy(fm->name, name, sizeof(fm->name));
+      nameTableInvalidate();
     }
     else if (!strcmp(key, "switch")) {
       fm->swtch = luaL_checkinteger(L, -1);
@@ -688,6 +691,7 @@ static int luaModelInsertInput(lua_State *L)
       else if (!strcmp(key, "inputName")) {
         const char * name = luaL_checkstring(L, -1);
         strncpy(g_model.inputNames[chn], name, LEN_INPUT_NAME);
+        nameTableInvalidate();
       }
       else if (!strcmp(key, "source")) {
         expo->srcRaw = luaL_checkinteger(L, -1);
@@ -1637,6 +1641,7 @@ static int luaModelSetOutput(lua_State *L)
   if (idx < MAX_OUTPUT_CHANNELS) {
     LimitData * limit = limitAddress(idx);
     memclear(limit, sizeof(LimitData));
+    nameTableInvalidate();
     luaL_checktype(L, -1, LUA_TTABLE);
     for (lua_pushnil(L); lua_next(L, -2); lua_pop(L, 1)) {
       luaL_checktype(L, -2, LUA_TSTRING); // key is string
@@ -1788,6 +1793,7 @@ static int luaModelSetGlobalVariableDetails(lua_State *L)
       if (!strcmp(key, "name")) {
         const char * name = luaL_checkstring(L, -1);
         strncpy(g_model.gvars[idx].name, name, sizeof(g_model.gvars[idx].name));
+        nameTableInvalidate();
       }
       if (!strcmp(key, "min")) {
         g_model.gvars[idx].min = luaL_checkinteger(L, -1) - GVAR_MIN;
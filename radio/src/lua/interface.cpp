@@ -34,8 +34,13 @@
 #include "sdcard.h"
 #include "api_filesystem.h"
 #include "switches.h"
+#include "name_table.h"
 #include "lib_file.h"
 
+#if defined(LUA_PACK)
+  #include "lua_pack.h"
+#endif
+
 #if defined(COLORLCD)
   #include "standalone_lua.h"
 #endif
@@ -230,6 +235,9 @@ void luaGetOutputs(ScriptInputsOutputs & sid)
     }
     lua_pop(lsScripts, 1);
   }
+
+  // outputs are named as sources
+  nameTableInvalidate();
 }
 #endif
 
@@ -411,6 +419,72 @@ static void luaDumpState(lua_State * L, const char * filename, const FILINFO * f
   } else
     TRACE_ERROR("luaDumpState(%s): Error: Could not open output file\n", filename);
 }
+
+#if defined(LUA_PACK)
+#define LUA_PACK_FILE SCRIPTS_PATH "/scripts.pak"
+
+// bytecode written by another build can not be loaded
+#define LUA_PACK_FORMAT                                           \
+  ((uint32_t)LUAC_VERSION << 24 | sizeof(size_t) << 16 |         \
+   sizeof(Instruction) << 8 | sizeof(lua_Number))
+
+static bool luaPackLoaded = false;
+
+struct LuaPackDump {
+  uint8_t* data;
+  uint32_t len;
+  uint32_t size;
+};
+
+/// callback for luaU_dump() to RAM
+static int luaPackWriter(lua_State * L, const void* p, size_t size, void* u)
+{
+  UNUSED(L);
+  auto dump = (LuaPackDump *)u;
+  if (dump->len + size > dump->size) {
+    uint32_t newSize = max<uint32_t>(dump->size * 2, dump->len + size);
+    auto data = (uint8_t *)realloc(dump->data, newSize);
+    if (!data) return 1;
+    dump->data = data;
+    dump->size = newSize;
+  }
+  memcpy(dump->data + dump->len, p, size);
+  dump->len += size;
+  return 0;
+}
+
+static const uint8_t * luaPackLookup(const char * filename, const FILINFO * finfo, uint32_t * len)
+{
+  if (!luaPackLoaded) {
+    luaPackOpen(LUA_PACK_FILE, LUA_PACK_FORMAT);
+    luaPackLoaded = true;
+  }
+  return luaPackFind(filename, finfo->fsize, (finfo->fdate << 16) | finfo->ftime, len);
+}
+
+// Add the stripped bytecode on top of the stack to the pack
+static bool luaPackState(lua_State * L, const char * filename, const FILINFO * finfo)
+{
+  LuaPackDump dump = {nullptr, 0, 0};
+  lua_lock(L);
+  int result = luaU_dump(L, getproto(L->top - 1), luaPackWriter, &dump, 1);
+  lua_unlock(L);
+
+  bool packed = result == 0 &&
+      luaPackAdd(filename, finfo->fsize, (finfo->fdate << 16) | finfo->ftime, dump.data, dump.len);
+  free(dump.data);
+  TRACE("luaPackState(%s): %s", filename, packed ? "packed" : "failed");
+  return packed;
+}
+
+// Write the pack if scripts have been added since
+static void luaPackFlush()
+{
+  if (luaPackDirty()) {
+    luaPackWrite(LUA_PACK_FILE, LUA_PACK_FILE ".tmp");
+  }
+}
+#endif  // LUA_PACK
 #endif  // LUA_COMPILER
 
 /**
@@ -477,13 +551,33 @@ int luaLoadScriptFileToState(lua_State * L, const char * filename, const char *
   }
   strncat(filenameFull, filename, fnamelen);
 
+  // check if text version exists
+  strcpy(filenameFull + fnamelen, SCRIPT_EXT);
+  frLuaS = f_stat(filenameFull, &fnoLuaS);
+
+#if defined(LUA_PACK)
+  // the pack holds the stripped bytecode of unchanged sources: on a hit,
+  // the source is the only file looked up
+  bool usePack = frLuaS == FR_OK && strchr(lmode, 'b') && !strpbrk(lmode, "cd");
+  if (usePack) {
+    uint32_t len;
+    const uint8_t * data = luaPackLookup(filenameFull, &fnoLuaS, &len);
+    if (data) {
+      int t = lua_gettop(L);
+      if (luaL_loadbufferx(L, (const char *)data, len, filenameFull, "b") == LUA_OK) {
+        TRACE("luaLoadScriptFileToState(%s, %s): loaded from pack", filename, lmode);
+        return SCRIPT_OK;
+      }
+      lua_settop(L, t);
+      luaPackRemove(filenameFull);
+    }
+  }
+#endif
+
   // check if binary version exists
   strcpy(filenameFull + fnamelen, SCRIPT_BIN_EXT);
   frLuaC = f_stat(filenameFull, &fnoLuaC);
-
-  // check if text version exists
   strcpy(filenameFull + fnamelen, SCRIPT_EXT);
-  frLuaS = f_stat(filenameFull, &fnoLuaS);
 
   // decide which version to load, text or binary
   if (frLuaC != FR_OK && frLuaS == FR_OK) {
@@ -557,6 +651,14 @@ int luaLoadScriptFileToState(lua_State * L, const char * filename, const char *
     lstatus = luaL_loadfilex(L, filenameFull, nullptr);
   }
   if (lstatus == LUA_OK) {
+#if defined(LUA_PACK)
+    // packing replaces the .luac file
+    if (usePack && !strchr(lmode, 'x')) {
+      strcpy(filenameFull + fnamelen, SCRIPT_EXT);
+      if (luaPackState(L, filenameFull, &fnoLuaS))
+        scriptNeedsCompile = false;
+    }
+#endif
     if (scriptNeedsCompile && loadFileType == 1) {
       strcpy(filenameFull + fnamelen, SCRIPT_BIN_EXT);
       luaDumpState(L, filenameFull, &fnoLuaS, (strchr(lmode, 'd') ? 0 : 1));
@@ -1285,6 +1387,10 @@ bool luaTask(bool allowLcdUsage)
       }
       else luaDisable();
       UNPROTECT_LUA();
+#if defined(LUA_PACK)
+      if (luaState != INTERPRETER_LOADING)
+        luaPackFlush();
+#endif
       break;
    
     case INTERPRETER_START_RUNNING:
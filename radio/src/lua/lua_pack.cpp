@@ -0,0 +1,321 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "edgetx.h"
+#include "lua_pack.h"
+
+#include <ctype.h>
+
+PACK(struct LuaPackHeader {
+  char magic[4];
+  uint16_t version;
+  uint16_t count;
+  uint32_t format;
+  uint32_t size;      // whole file
+});
+
+PACK(struct LuaPackIndex {
+  uint32_t hash;      // of the source path
+  uint32_t size;      // of the source file
+  uint32_t time;      // of the source file (FAT date << 16 | time)
+  uint32_t offset;    // of the source path in the file
+  uint32_t length;    // of the bytecode, following the path
+  uint16_t pathLen;
+  uint16_t reserved;
+});
+
+struct LuaPackEntry {
+  LuaPackIndex index;
+  const char* path;   // not NUL terminated
+  const uint8_t* data;
+  uint8_t* owned;     // path + data, if added after the pack was opened
+  bool used;          // looked up or added since the pack was opened
+};
+
+static const char _magic[4] = {'E', 'T', 'X', 'L'};
+
+// entries point into the image while the pack is not modified
+static uint8_t _image[LUA_PACK_MAX_SIZE] __SDRAM;
+static LuaPackEntry _entries[LUA_PACK_MAX_ENTRIES] __SDRAM;
+static uint16_t _count = 0;
+static uint32_t _format = 0;
+static uint32_t _fileSize = 0;
+static bool _dirty = false;
+
+static uint32_t _hash(const char* path, uint16_t len)
+{
+  // FNV-1a, case insensitive like FAT file names
+  uint32_t hash = 2166136261u;
+  for (uint16_t i = 0; i < len; i++) {
+    hash ^= (uint8_t)tolower(path[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static uint32_t _entrySize(const LuaPackEntry& entry)
+{
+  return sizeof(LuaPackIndex) + entry.index.pathLen + entry.index.length;
+}
+
+static int _findEntry(const char* source, uint16_t len, uint32_t hash)
+{
+  for (int i = 0; i < _count; i++) {
+    const auto& entry = _entries[i];
+    if (entry.index.hash == hash && entry.index.pathLen == len &&
+        !strncasecmp(entry.path, source, len))
+      return i;
+  }
+  return -1;
+}
+
+static void _removeEntry(int i)
+{
+  _fileSize -= _entrySize(_entries[i]);
+  free(_entries[i].owned);
+  _entries[i] = _entries[--_count];
+  _dirty = true;
+}
+
+// make room for 'size' more bytes by dropping the entries
+// of scripts that have not been used since boot
+static bool _reserve(uint32_t size)
+{
+  for (int i = _count - 1; i >= 0; i--) {
+    if (_count < LUA_PACK_MAX_ENTRIES && _fileSize + size <= LUA_PACK_MAX_SIZE)
+      break;
+    if (!_entries[i].used) _removeEntry(i);
+  }
+  return _count < LUA_PACK_MAX_ENTRIES && _fileSize + size <= LUA_PACK_MAX_SIZE;
+}
+
+static bool _loadImage(uint32_t size)
+{
+  auto header = (const LuaPackHeader*)_image;
+  if (size < sizeof(LuaPackHeader) || memcmp(header->magic, _magic, 4) ||
+      header->version != LUA_PACK_VERSION || header->format != _format ||
+      header->size != size || header->count > LUA_PACK_MAX_ENTRIES)
+    return false;
+
+  uint32_t dataStart =
+      sizeof(LuaPackHeader) + header->count * sizeof(LuaPackIndex);
+  if (dataStart > size) return false;
+
+  auto index = (const LuaPackIndex*)(_image + sizeof(LuaPackHeader));
+  for (uint16_t i = 0; i < header->count; i++) {
+    const auto& idx = index[i];
+    if (idx.offset < dataStart || idx.offset > size ||
+        idx.pathLen + idx.length > size - idx.offset)
+      return false;
+
+    auto& entry = _entries[i];
+    entry.index = idx;
+    entry.path = (const char*)_image + idx.offset;
+    entry.data = _image + idx.offset + idx.pathLen;
+    entry.owned = nullptr;
+    entry.used = false;
+  }
+
+  _count = header->count;
+  _fileSize = size;
+  return true;
+}
+
+bool luaPackOpen(const char* path, uint32_t format)
+{
+  luaPackClose();
+  _format = format;
+
+  FIL file;
+  if (f_open(&file, path, FA_OPEN_EXISTING | FA_READ) != FR_OK) return false;
+
+  UINT size = f_size(&file);
+  UINT read = 0;
+  bool result = size <= LUA_PACK_MAX_SIZE &&
+                f_read(&file, _image, size, &read) == FR_OK && read == size;
+  f_close(&file);
+
+  if (result) result = _loadImage(size);
+  if (!result) {
+    TRACE("luaPackOpen(%s): invalid pack", path);
+    luaPackClose();
+    _format = format;
+  } else {
+    TRACE("luaPackOpen(%s): %u scripts", path, _count);
+  }
+
+  return result;
+}
+
+void luaPackClose()
+{
+  for (int i = 0; i < _count; i++) {
+    free(_entries[i].owned);
+  }
+  _count = 0;
+  _fileSize = sizeof(LuaPackHeader);
+  _dirty = false;
+}
+
+const uint8_t* luaPackFind(const char* source, uint32_t size, uint32_t time,
+                           uint32_t* len)
+{
+  uint16_t pathLen = strlen(source);
+  int i = _findEntry(source, pathLen, _hash(source, pathLen));
+  if (i < 0) return nullptr;
+
+  auto& entry = _entries[i];
+  entry.used = true;
+  if (entry.index.size != size || entry.index.time != time) return nullptr;
+
+  *len = entry.index.length;
+  return entry.data;
+}
+
+bool luaPackAdd(const char* source, uint32_t size, uint32_t time,
+                const uint8_t* data, uint32_t len)
+{
+  uint16_t pathLen = strlen(source);
+  uint32_t hash = _hash(source, pathLen);
+
+  int i = _findEntry(source, pathLen, hash);
+  if (i >= 0) _removeEntry(i);
+
+  uint32_t entrySize = sizeof(LuaPackIndex) + pathLen + len;
+  if (!_reserve(entrySize)) return false;
+
+  auto owned = (uint8_t*)malloc(pathLen + len);
+  if (!owned) return false;
+  memcpy(owned, source, pathLen);
+  memcpy(owned + pathLen, data, len);
+
+  auto& entry = _entries[_count++];
+  memset(&entry.index, 0, sizeof(entry.index));
+  entry.index.hash = hash;
+  entry.index.size = size;
+  entry.index.time = time;
+  entry.index.length = len;
+  entry.index.pathLen = pathLen;
+  entry.path = (const char*)owned;
+  entry.data = owned + pathLen;
+  entry.owned = owned;
+  entry.used = true;
+
+  _fileSize += entrySize;
+  _dirty = true;
+  return true;
+}
+
+void luaPackRemove(const char* source)
+{
+  uint16_t pathLen = strlen(source);
+  int i = _findEntry(source, pathLen, _hash(source, pathLen));
+  if (i >= 0) _removeEntry(i);
+}
+
+bool luaPackDirty()
+{
+  return _dirty;
+}
+
+// the pack is written through a small buffer, so that it never
+// needs a second copy in RAM
+static FIL _file __DMA;
+static uint8_t _chunk[LUA_PACK_CHUNK_SIZE] __DMA;
+static uint32_t _chunkLen = 0;
+
+static FRESULT _flushChunk()
+{
+  UINT written;
+  FRESULT result = f_write(&_file, _chunk, _chunkLen, &written);
+  if (result == FR_OK && written != _chunkLen) result = FR_DENIED;
+  _chunkLen = 0;
+  return result;
+}
+
+static FRESULT _writeChunked(const void* data, uint32_t len)
+{
+  auto src = (const uint8_t*)data;
+  while (len > 0) {
+    uint32_t n = min<uint32_t>(len, LUA_PACK_CHUNK_SIZE - _chunkLen);
+    memcpy(_chunk + _chunkLen, src, n);
+    _chunkLen += n;
+    src += n;
+    len -= n;
+    if (_chunkLen == LUA_PACK_CHUNK_SIZE) {
+      FRESULT result = _flushChunk();
+      if (result != FR_OK) return result;
+    }
+  }
+  return FR_OK;
+}
+
+static FRESULT _writeImage()
+{
+  LuaPackHeader header;
+  memcpy(header.magic, _magic, 4);
+  header.version = LUA_PACK_VERSION;
+  header.count = _count;
+  header.format = _format;
+  header.size = _fileSize;
+  FRESULT result = _writeChunked(&header, sizeof(header));
+
+  uint32_t offset = sizeof(LuaPackHeader) + _count * sizeof(LuaPackIndex);
+  for (int i = 0; i < _count && result == FR_OK; i++) {
+    LuaPackIndex index = _entries[i].index;
+    index.offset = offset;
+    offset += index.pathLen + index.length;
+    result = _writeChunked(&index, sizeof(index));
+  }
+
+  for (int i = 0; i < _count && result == FR_OK; i++) {
+    const auto& entry = _entries[i];
+    result = _writeChunked(entry.path, entry.index.pathLen);
+    if (result == FR_OK)
+      result = _writeChunked(entry.data, entry.index.length);
+  }
+
+  if (result == FR_OK && _chunkLen > 0) result = _flushChunk();
+  return result;
+}
+
+bool luaPackWrite(const char* path, const char* tmpPath)
+{
+  FRESULT result = f_open(&_file, tmpPath, FA_CREATE_ALWAYS | FA_WRITE);
+  if (result == FR_OK) {
+    _chunkLen = 0;
+    result = _writeImage();
+    FRESULT close_result = f_close(&_file);
+    if (result == FR_OK) result = close_result;
+  }
+
+  if (result == FR_OK) {
+    f_unlink(path);
+    result = f_rename(tmpPath, path);
+  }
+
+  if (result != FR_OK) {
+    TRACE("luaPackWrite(%s): error %d", path, result);
+    return false;
+  }
+
+  _dirty = false;
+  return true;
+}
+
+uint16_t luaPackCount()
+{
+  return _count;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Pack of compiled Lua scripts.
+//
+// A single file holds the stripped bytecode of the scripts loaded so far,
+// indexed by source path. Each entry records the size and modification
+// time of the source it was compiled from: a script whose source changed
+// no longer matches its entry, and is loaded (and packed again) from its
+// own file. The pack is read at once into a buffer kept in SDRAM.
+//
+// File layout (native endianness, the pack never leaves the radio):
+//
+//   LuaPackHeader
+//   LuaPackIndex[count]
+//   for each entry: source path (pathLen bytes), bytecode (length bytes)
+
+#define LUA_PACK_VERSION      1
+#define LUA_PACK_MAX_ENTRIES  128
+#define LUA_PACK_MAX_SIZE     (256 * 1024)
+#define LUA_PACK_CHUNK_SIZE   512
+
+// Load the pack from 'path'. 'format' identifies the bytecode format:
+// a pack written with another format is ignored. Returns false if no
+// valid pack was found (the pack is then empty).
+bool luaPackOpen(const char* path, uint32_t format);
+
+// Drop all entries
+void luaPackClose();
+
+// Returns the bytecode of 'source' if it was packed from a source file
+// of the same size and time, nullptr otherwise.
+const uint8_t* luaPackFind(const char* source, uint32_t size, uint32_t time,
+                           uint32_t* len);
+
+// Add or replace the bytecode of 'source'. 'data' is copied.
+bool luaPackAdd(const char* source, uint32_t size, uint32_t time,
+                const uint8_t* data, uint32_t len);
+
+// Forget 'source' (e.g. its bytecode could not be loaded)
+void luaPackRemove(const char* source);
+
+// true if entries have changed since the pack was opened or serialized
+bool luaPackDirty();
+
+// Write the pack to 'tmpPath', then rename it to 'path'. The file is
+// streamed in LUA_PACK_CHUNK_SIZE chunks. Returns false on SD card error
+// (the pack then stays dirty).
+bool luaPackWrite(const char* path, const char* tmpPath);
+
+uint16_t luaPackCount();
@@ -55,6 +55,8 @@ uint8_t mixWarning;
 
 int16_t calibratedAnalogs[MAX_ANALOG_INPUTS];
 int16_t channelOutputs[MAX_OUTPUT_CHANNELS] = {0};
+uint32_t channelOutputsChanged = 0;
+static_assert(MAX_OUTPUT_CHANNELS <= 32, "channelOutputsChanged holds one bit per channel");
 int16_t ex_chans[MAX_OUTPUT_CHANNELS] = {0}; // Outputs (before LIMITS) of the last perMain;
 
 #if defined(HELI)
@@ -1243,7 +1245,10 @@ void evalMixes(uint8_t tick10ms)
 
     int16_t value = applyLimits(i, q);  // applyLimits will remove the 256 100% basis
 
-    channelOutputs[i] = value;  // copy consistent word to int-level
+    if (channelOutputs[i] != value) {
+      channelOutputs[i] = value;  // copy consistent word to int-level
+      channelOutputsChanged |= (1u << i);
+    }
   }
 
   if (tick10ms && flightModesFade) {
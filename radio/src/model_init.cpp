@@ -23,6 +23,7 @@
 #include "hal/adc_driver.h"
 #include "input_mapping.h"
 #include "mixes.h"
+#include "name_table.h"
 
 #if defined(COLORLCD)
 #include "layout.h"
@@ -46,6 +47,7 @@ void setDefaultInputs()
     expo->mode = 3; // TODO constant
     strncpy(g_model.inputNames[i], getMainControlLabel(stick_index), LEN_INPUT_NAME);
   }
+  nameTableInvalidate();
 
   storageDirty(EE_MODEL);
 }
@@ -130,6 +132,7 @@ void initCustomSwitches()
 #endif
     }
   }
+  nameTableInvalidate();
   g_model.cfsSetGroupAlwaysOn(1, true);
 }
 #endif
@@ -180,6 +183,7 @@ void applyDefaultTemplate()
 void setModelDefaults(uint8_t id)
 {
   memset(&g_model, 0, sizeof(g_model));
+  modelFunctionsContext.invalidate();
   applyDefaultTemplate();
   
   setVendorSpecificModelDefaults(id);
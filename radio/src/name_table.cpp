@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "name_table.h"
+
+#include <algorithm>
+
+#include "edgetx.h"
+
+#if defined(COLORLCD)
+  #define NAME_TABLE_SIZE  8192
+#else
+  #define NAME_TABLE_SIZE  2048
+#endif
+
+// All the names, NUL terminated, one after the other.
+// Entries are 1 + the offset of the name, 0 when not built yet
+static char _names[NAME_TABLE_SIZE];
+static uint16_t _namesUsed = 0;
+static uint16_t _sourceNames[MIXSRC_LAST_TELEM + 1];
+static uint16_t _switchNames[SWSRC_COUNT];
+
+// Invalidation may come from any task: the table
+// is only reset by the next lookup
+static volatile bool _invalid = true;
+static uint32_t _generation = 0;
+
+static char _nameBuffer[32];
+
+void nameTableInvalidate()
+{
+  _invalid = true;
+}
+
+static void _checkTable()
+{
+  if (_invalid) {
+    _invalid = false;
+    memclear(_sourceNames, sizeof(_sourceNames));
+    memclear(_switchNames, sizeof(_switchNames));
+    _namesUsed = 0;
+    _generation++;
+  }
+}
+
+static const char* _intern(uint16_t& entry, const char* name)
+{
+  size_t len = strlen(name) + 1;
+  if (_namesUsed + len > NAME_TABLE_SIZE) {
+    // table full: the name is built on each lookup until the next reset
+    return name;
+  }
+
+  memcpy(&_names[_namesUsed], name, len);
+  entry = _namesUsed + 1;
+  _namesUsed += len;
+  return &_names[entry - 1];
+}
+
+const char* sourceNameLookup(mixsrc_t idx)
+{
+  if (idx < 0) {
+    _nameBuffer[0] = '-';
+    strncpy(&_nameBuffer[1], sourceNameLookup(-idx), sizeof(_nameBuffer) - 2);
+    _nameBuffer[sizeof(_nameBuffer) - 1] = '\0';
+    return _nameBuffer;
+  }
+
+  if (idx > MIXSRC_LAST_TELEM) return getSourceString(idx);
+
+  _checkTable();
+  uint16_t& entry = _sourceNames[idx];
+  if (entry) return &_names[entry - 1];
+  return _intern(entry, getSourceString(idx));
+}
+
+const char* switchNameLookup(swsrc_t idx)
+{
+  if (idx < 0) {
+    _nameBuffer[0] = '!';
+    strncpy(&_nameBuffer[1], switchNameLookup(-idx), sizeof(_nameBuffer) - 2);
+    _nameBuffer[sizeof(_nameBuffer) - 1] = '\0';
+    return _nameBuffer;
+  }
+
+  if (idx >= SWSRC_COUNT) return getSwitchPositionName(idx);
+
+  _checkTable();
+  uint16_t& entry = _switchNames[idx];
+  if (entry) return &_names[entry - 1];
+  return _intern(entry, getSwitchPositionName(idx));
+}
+
+bool NameSearch::matchName(int16_t idx) const
+{
+  const char* name = switches ? switchNameLookup(idx) : sourceNameLookup(idx);
+
+  // names starting with CHAR_xxx symbols are matched without them
+  if (name[0] == '\302' && name[1] != '\0') name += 2;
+
+  if (prefixOnly) return !strncasecmp(name, text.c_str(), text.size());
+
+  do {
+    if (!strncasecmp(name, text.c_str(), text.size())) return true;
+  } while (*name++);
+  return false;
+}
+
+const std::vector<int16_t>& NameSearch::search(const char* newText)
+{
+  _checkTable();
+
+  bool refine = valid && generation == _generation &&
+                !strncmp(newText, text.c_str(), text.size());
+  text = newText;
+
+  if (refine) {
+    // typed on: the matches can only be among the previous ones
+    auto it = std::remove_if(matches.begin(), matches.end(),
+                             [=](int16_t idx) { return !matchName(idx); });
+    matches.erase(it, matches.end());
+  } else {
+    matches.clear();
+    int16_t first = switches ? SWSRC_NONE + 1 : MIXSRC_NONE + 1;
+    int16_t last = switches ? SWSRC_COUNT - 1 : MIXSRC_LAST_TELEM;
+    for (int16_t idx = first; idx <= last; idx++) {
+      if (matchName(idx)) matches.push_back(idx);
+    }
+    valid = true;
+    generation = _generation;
+  }
+
+  return matches;
+}
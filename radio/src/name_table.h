@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "edgetx_types.h"
+
+// Display names of the sources and switches, as returned by
+// getSourceString() and getSwitchPositionName() with the custom names.
+//
+// Names are built once, when first looked up, and kept until a name may
+// have changed: model or radio settings load, model scripts load, and the
+// name and sensor editors (nameTableInvalidate()). A returned name stays
+// valid until the next lookup following such a change: copy it to keep it
+// longer.
+
+void nameTableInvalidate();
+
+const char* sourceNameLookup(mixsrc_t idx);
+const char* switchNameLookup(swsrc_t idx);
+
+// Case insensitive search of a text in the source (or switch) names,
+// the symbol some names start with is ignored. When the text is typed
+// on, only the previous results are searched again.
+class NameSearch
+{
+ public:
+  explicit NameSearch(bool switches = false, bool prefixOnly = false) :
+      switches(switches), prefixOnly(prefixOnly)
+  {
+  }
+
+  // Returns the indexes (mixsrc_t or swsrc_t) of the matching names
+  const std::vector<int16_t>& search(const char* text);
+
+  const std::vector<int16_t>& results() const { return matches; }
+
+ protected:
+  bool switches;
+  bool prefixOnly;
+  bool valid = false;
+  uint32_t generation = 0;
+  std::string text;
+  std::vector<int16_t> matches;
+
+  bool matchName(int16_t idx) const;
+};
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 
 // OS specific implementation
 #if defined(NATIVE_THREADS)
@@ -40,6 +41,14 @@ unsigned task_get_stack_size(task_handle_t* h);
 
 bool scheduler_is_running();
 
+// Wake up 'h' if it is waiting in task_wait_notify(), or make its
+// next call return immediately.
+void task_notify(task_handle_t* h);
+
+// Block the calling task 'h' until task_notify() is called or
+// 'timeout_ms' has elapsed. Returns true if it has been notified.
+bool task_wait_notify(task_handle_t* h, uint32_t timeout_ms);
+
 void mutex_create(mutex_handle_t* h);
 bool mutex_lock(mutex_handle_t* h);
 void mutex_unlock(mutex_handle_t* h);
@@ -54,6 +54,17 @@ bool scheduler_is_running()
   return false;
 }
 
+void task_notify(task_handle_t* h)
+{
+  if (h->_rtos_handle) xTaskNotifyGive(h->_rtos_handle);
+}
+
+bool task_wait_notify(task_handle_t* h, uint32_t timeout_ms)
+{
+  (void)h;
+  return ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms)) > 0;
+}
+
 void mutex_create(mutex_handle_t* h)
 {
   h->_rtos_handle = xSemaphoreCreateMutexStatic(&h->_mutex_struct);
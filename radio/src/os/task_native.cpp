@@ -135,6 +135,25 @@ bool scheduler_is_running()
   return true;
 }
 
+void task_notify(task_handle_t* h)
+{
+  {
+    std::lock_guard lock(h->_notify_m);
+    h->_notified = true;
+  }
+  h->_notify_cv.notify_one();
+}
+
+bool task_wait_notify(task_handle_t* h, uint32_t timeout_ms)
+{
+  std::unique_lock<std::mutex> lk(h->_notify_m);
+  h->_notify_cv.wait_for(lk, std::chrono::milliseconds(timeout_ms),
+                         [=]() { return h->_notified || _stop_tasks; });
+  bool notified = h->_notified;
+  h->_notified = false;
+  return notified;
+}
+
 void mutex_create(mutex_handle_t* h)
 {
   (void)h;
@@ -25,6 +25,7 @@
 
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <memory>
 
 #define TASK_DEFINE_STACK(name, size) void* name
@@ -34,6 +35,10 @@ using _thread_ptr_t = std::unique_ptr<std::thread>;
 struct task_handle_t {
   _thread_ptr_t _thread_handle;
   uint32_t      _stack_size;
+
+  std::mutex              _notify_m;
+  std::condition_variable _notify_cv;
+  bool                    _notified = false;
 };
 
 typedef std::mutex mutex_handle_t;
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+// Channel encoding of the serial protocols.
+//
+// A channel value in the mixer range ([-1024:+1024] for [-100%:+100%],
+// PPM center offset already applied) is scaled by 'scaleNum / scaleDen',
+// moved to 'center' and clamped to [min:max]. Encoded channels are
+// packed LSB first, 'bits' bits per channel, with no padding between them.
+
+struct ChannelsPacking {
+  uint8_t bits;
+  int16_t scaleNum;
+  int16_t scaleDen;
+  int16_t center;
+  uint16_t min;
+  uint16_t max;
+
+  // 'centerOffset' is added after scaling (per channel center of CRSF)
+  constexpr uint16_t encode(int value, int centerOffset = 0) const
+  {
+    int result = value * scaleNum / scaleDen + center + centerOffset;
+    return result < min ? min : (result > max ? max : result);
+  }
+
+  constexpr unsigned packedSize(unsigned count) const
+  {
+    return (count * bits + 7) / 8;
+  }
+};
+
+constexpr ChannelsPacking MULTI_CHANNELS_PACKING = {11, 4, 5, 1024, 0, 2047};
+constexpr ChannelsPacking SBUS_CHANNELS_PACKING = {11, 4, 5, 992, 0, 2047};
+constexpr ChannelsPacking CROSSFIRE_CHANNELS_PACKING = {11, 4, 5, 0x3E0, 0, 2 * 0x3E0};
+
+// PXX: 0 and 2047 are reserved for failsafe "no pulses" and "hold",
+// channels 9-16 of PXX1 are sent as 2048 + value in the upper range
+constexpr ChannelsPacking PXX_CHANNELS_PACKING = {12, 512, 682, 1024, 1, 2046};
+constexpr ChannelsPacking PXX_UPPER_CHANNELS_PACKING = {12, 512, 682, 3072, 2049, 4094};
+
+// Pack 'count' encoded channels at 'data', which must have room for
+// packedSize(count) bytes. Bits left in the last byte are cleared.
+inline void packChannels(const ChannelsPacking& packing, uint8_t* data,
+                         const uint16_t* values, uint8_t count)
+{
+  const uint32_t mask = (1u << packing.bits) - 1;
+  uint64_t bits = 0;
+  uint8_t bitsAvailable = 0;
+
+  for (uint8_t i = 0; i < count; i++) {
+    bits |= (uint64_t)(values[i] & mask) << bitsAvailable;
+    bitsAvailable += packing.bits;
+    if (bitsAvailable >= 32) {
+      // word sized writes, the byte order is the one of the frames
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+      uint32_t word = bits;
+      memcpy(data, &word, sizeof(word));
+      data += sizeof(word);
+#else
+      for (uint8_t b = 0; b < 4; b++) *data++ = bits >> (8 * b);
+#endif
+      bits >>= 32;
+      bitsAvailable -= 32;
+    }
+  }
+
+  while (bitsAvailable > 0) {
+    *data++ = bits;
+    bits >>= 8;
+    bitsAvailable = bitsAvailable > 8 ? bitsAvailable - 8 : 0;
+  }
+}
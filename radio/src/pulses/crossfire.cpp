@@ -30,10 +30,9 @@
 #include "hal/module_port.h"
 
 #include "crossfire.h"
+#include "channels_packing.h"
 #include "telemetry/crossfire.h"
 
-#define CROSSFIRE_CH_BITS           11
-#define CROSSFIRE_CENTER            0x3E0
 #if defined(PPM_CENTER_ADJUSTABLE)
   #define CROSSFIRE_CENTER_CH_OFFSET(ch)            ((2 * limitAddress(ch)->ppmCenter) + 1)  // + 1 is for rouding
 #else
@@ -41,6 +40,7 @@
 #endif
 
 #define MIN_FRAME_LEN 3
+#define CROSSFIRE_CHANNELS_FRAME_MAXLEN 27   // addr + len + type + 22 (channels) + armed + crc
 
 #define MODULE_ALIVE_TIMEOUT  50                      // if the module has sent a valid frame within 500ms it is declared alive
 static tmr10ms_t lastAlive[NUM_MODULES];              // last time stamp module sent CRSF frames
@@ -92,6 +92,17 @@ uint8_t createCrossfireModelIDFrame(uint8_t moduleIdx, uint8_t * frame)
   return buf - frame;
 }
 
+static inline uint16_t _crossfireChannelValue(uint8_t ch, int16_t pulse)
+{
+  return CROSSFIRE_CHANNELS_PACKING.encode(pulse, (CROSSFIRE_CENTER_CH_OFFSET(ch) * 4) / 5);
+}
+
+static inline uint8_t _crossfireArmedStatus(const ModuleData* md)
+{
+  swsrc_t sw = md->crsf.crsfArmingTrigger;
+  return (sw != SWSRC_NONE) && getSwitch(sw, 0);
+}
+
 // Range for pulses (channels output) is [-1024:+1024]
 uint8_t createCrossfireChannelsFrame(uint8_t moduleIdx, uint8_t * frame, int16_t * pulses)
 {
@@ -110,29 +121,65 @@ uint8_t createCrossfireChannelsFrame(uint8_t moduleIdx, uint8_t * frame, int16_t
   *buf++ = 24 + lenAdjust;      // 1(ID) + 22(channel data) + (+1 extra byte if Switch mode) + 1(CRC)
   uint8_t * crc_start = buf;
   *buf++ = CHANNELS_ID;
-  uint32_t bits = 0;
-  uint8_t bitsavailable = 0;
+  uint16_t values[CROSSFIRE_CHANNELS_COUNT];
   for (int i=0; i<CROSSFIRE_CHANNELS_COUNT; i++) {
-    uint32_t val = limit(0, CROSSFIRE_CENTER + (CROSSFIRE_CENTER_CH_OFFSET(i) * 4) / 5 + (pulses[i] * 4) / 5, 2 * CROSSFIRE_CENTER);
-    bits |= val << bitsavailable;
-    bitsavailable += CROSSFIRE_CH_BITS;
-    while (bitsavailable >= 8) {
-      *buf++ = bits;
-      bits >>= 8;
-      bitsavailable -= 8;
-    }
+    values[i] = _crossfireChannelValue(i, pulses[i]);
   }
+  packChannels(CROSSFIRE_CHANNELS_PACKING, buf, values, CROSSFIRE_CHANNELS_COUNT);
+  buf += CROSSFIRE_CHANNELS_PACKING.packedSize(CROSSFIRE_CHANNELS_COUNT);
   
   if (armingMode == ARMING_MODE_SWITCH) {
-    swsrc_t sw =  md->crsf.crsfArmingTrigger;
-
-    *buf++ = (sw != SWSRC_NONE) && getSwitch(sw, 0);  // commanded armed status in Switch mode
+    *buf++ = _crossfireArmedStatus(md);  // commanded armed status in Switch mode
   }
   
   *buf++ = crc8(crc_start, 23 + lenAdjust);
   return buf - frame;
 }
 
+// Last channels frame sent to each module. Channels that did not move since
+// then keep their packed bits, so that at a steady state the frame is only
+// copied and its CRC is not computed again.
+static uint8_t _channelsFrame[NUM_MODULES][CROSSFIRE_CHANNELS_FRAME_MAXLEN];
+static uint8_t _channelsFrameLen[NUM_MODULES];
+
+static uint8_t updateCrossfireChannelsFrame(uint8_t moduleIdx, uint8_t * frame, int16_t * pulses)
+{
+  ModuleData *md = &g_model.moduleData[moduleIdx];
+  uint8_t * cached = _channelsFrame[moduleIdx];
+  uint8_t armingMode = md->crsf.crsfArmingMode;
+  uint8_t frameLen = (armingMode == ARMING_MODE_SWITCH) ? 27 : 26;
+  uint32_t changed = pulsesGetChangedChannels(moduleIdx);
+
+  if (changed == PULSES_ALL_CHANNELS_CHANGED || _channelsFrameLen[moduleIdx] != frameLen) {
+    _channelsFrameLen[moduleIdx] = createCrossfireChannelsFrame(moduleIdx, cached, pulses);
+  } else {
+    bool dirty = false;
+
+    changed &= (1 << CROSSFIRE_CHANNELS_COUNT) - 1;
+    while (changed) {
+      uint8_t ch = __builtin_ctz(changed);
+      patchChannel11Bits(cached + 3, ch, _crossfireChannelValue(ch, pulses[ch]));
+      changed &= changed - 1;
+      dirty = true;
+    }
+
+    if (armingMode == ARMING_MODE_SWITCH) {
+      uint8_t armed = _crossfireArmedStatus(md);
+      if (cached[25] != armed) {
+        cached[25] = armed;
+        dirty = true;
+      }
+    }
+
+    if (dirty) {
+      cached[frameLen - 1] = crc8(cached + 2, frameLen - 3);
+    }
+  }
+
+  memcpy(frame, cached, frameLen);
+  return frameLen;
+}
+
 static void setupPulsesCrossfire(uint8_t module, uint8_t*& p_buf,
                                  uint8_t endpoint, int16_t* channels,
                                  uint8_t nChannels)
@@ -184,7 +231,7 @@ static void setupPulsesCrossfire(uint8_t module, uint8_t*& p_buf,
       moduleState[module].mode = MODULE_MODE_NORMAL;
     } else {
       /* TODO: nChannels */
-      p_buf += createCrossfireChannelsFrame(module, p_buf, channels);
+      p_buf += updateCrossfireChannelsFrame(module, p_buf, channels);
     }
   }
 }
@@ -199,7 +246,7 @@ static void crossfireSetupMixerScheduler(uint8_t module)
   }
 }
 
-static bool _checkFrameCRC(uint8_t* rxBuffer)
+static bool _checkFrameCRC(const uint8_t* rxBuffer)
 {
   uint8_t len = rxBuffer[1];
   uint8_t crc = crc8(&rxBuffer[2], len - 1);
@@ -232,14 +279,31 @@ static bool _lenIsSane(uint32_t len)
   return (len > 2 && len < TELEMETRY_RX_PACKET_SIZE - 1);
 }
 
-static bool _validHdr(uint8_t* buf)
+static bool _validHdr(const uint8_t* buf)
 {
   return buf[0] == RADIO_ADDRESS || buf[0] == UART_SYNC;
 }
 
-static uint8_t* _processFrames(void* ctx, uint8_t* buf, uint8_t& len)
+// Hand a complete frame to all consumers. The frame is not copied: BT mirror,
+// Lua queues and the sensor decoder all read from the same buffer.
+static void _dispatchFrame(void* ctx, const uint8_t* frame, uint32_t pkt_len)
+{
+#if defined(BLUETOOTH)
+  // TODO: generic telemetry mirror to BT
+  if (g_eeGeneral.bluetoothMode == BLUETOOTH_TELEMETRY &&
+      bluetooth.state == BLUETOOTH_STATE_CONNECTED) {
+    bluetooth.write(frame, pkt_len);
+  }
+#endif
+  auto mod_st = (etx_module_state_t*)ctx;
+  auto module = modulePortGetModule(mod_st);
+  lastAlive[module] = get_tmr10ms();                              // valid frame received, note timestamp
+  processCrossfireTelemetryFrame(module, frame, pkt_len);
+}
+
+static const uint8_t* _processFrames(void* ctx, const uint8_t* buf, uint8_t& len)
 {
-  uint8_t* p_buf = buf;
+  const uint8_t* p_buf = buf;
   while (len >= MIN_FRAME_LEN) {
 
     if (!_validHdr(p_buf)) {
@@ -250,9 +314,11 @@ static uint8_t* _processFrames(void* ctx, uint8_t* buf, uint8_t& len)
 
     uint32_t pkt_len = p_buf[1] + 2;
     if (!_lenIsSane(pkt_len)) {
+      // not a frame start: resync on the next sync / address byte
       TRACE("[XF] pkt len error (%d)", pkt_len);
-      len = 0;
-      break;
+      p_buf++;
+      len--;
+      continue;
     }
 
     if (pkt_len > (uint32_t)len) {
@@ -263,17 +329,7 @@ static uint8_t* _processFrames(void* ctx, uint8_t* buf, uint8_t& len)
     if (!_checkFrameCRC(p_buf)) {
       TRACE("[XF] CRC error ");
     } else {
-#if defined(BLUETOOTH)
-      // TODO: generic telemetry mirror to BT
-      if (g_eeGeneral.bluetoothMode == BLUETOOTH_TELEMETRY &&
-          bluetooth.state == BLUETOOTH_STATE_CONNECTED) {
-        bluetooth.write(p_buf, pkt_len);
-      }
-#endif
-      auto mod_st = (etx_module_state_t*)ctx;
-      auto module = modulePortGetModule(mod_st);
-      lastAlive[module] = get_tmr10ms();                              // valid frame received, note timestamp
-      processCrossfireTelemetryFrame(module, p_buf, pkt_len);
+      _dispatchFrame(ctx, p_buf, pkt_len);
     }
 
     p_buf += pkt_len;
@@ -283,47 +339,89 @@ static uint8_t* _processFrames(void* ctx, uint8_t* buf, uint8_t& len)
   return p_buf;
 }
 
-static void crossfireProcessFrame(void* ctx, uint8_t* frame, uint8_t frame_len,
-                                  uint8_t* buf, uint8_t* p_len)
+// Complete the frame pending in 'buf' with as few bytes as possible from
+// 'frame'. Returns the number of bytes consumed from 'frame': either all of
+// them (the frame is still pending), or the pending buffer is empty.
+static int _completePendingFrame(void* ctx, const uint8_t* frame,
+                                 uint8_t frame_len, uint8_t* buf, uint8_t& len)
 {
-  uint8_t& len = *p_len;
+  int consumed = 0;
 
-  if (len == 0) {
-    if (frame_len == 0) return;
-
-    if (!_validHdr(frame)) {
-      TRACE("[XF] invalid frame start");
-      return;
+  while (len > 0) {
+    if (!_validHdr(buf)) {
+      // not a frame start: resync on the next sync / address byte
+      memmove(buf, buf + 1, --len);
+      continue;
     }
 
-    if (frame_len < MIN_FRAME_LEN) {
-      // Too short to process, but valid header: save for reassembly
-      memcpy(buf, frame, frame_len);
-      len = frame_len;
-      return;
+    // the length byte is needed first
+    if (len < 2) {
+      if (consumed == frame_len) break;
+      buf[len++] = frame[consumed++];
     }
 
-    // process frames directly out of RX buffer
-    uint8_t* p_buf = _processFrames(ctx, frame, frame_len);
-    if (frame_len > 0) {
-      memcpy(buf, p_buf, frame_len);
-      len = frame_len;
-    }
-  } else {
-    uint32_t defrag_len = (uint32_t)len + (uint32_t)frame_len;
-    if (defrag_len > TELEMETRY_RX_PACKET_SIZE) {
-      TRACE("[XF] overflow (%d > %d)", defrag_len, TELEMETRY_RX_PACKET_SIZE);
-      frame_len = TELEMETRY_RX_PACKET_SIZE - len;
-      defrag_len = (uint32_t)len + (uint32_t)frame_len;
+    uint32_t pkt_len = buf[1] + 2;
+    if (!_lenIsSane(pkt_len)) {
+      TRACE("[XF] pkt len error (%d)", pkt_len);
+      memmove(buf, buf + 1, --len);
+      continue;
     }
 
-    memcpy(buf + len, frame, frame_len);
-    len = (uint8_t)defrag_len;
+    uint32_t missing = pkt_len - len;
+    uint32_t available = frame_len - consumed;
+    if (missing > available) missing = available;
+
+    memcpy(buf + len, frame + consumed, missing);
+    len += missing;
+    consumed += missing;
+    if (len < pkt_len) break;
 
-    uint8_t* p_buf = _processFrames(ctx, buf, len);
-    if ((len > 0) && (p_buf != buf)) {
-      memmove(buf, p_buf, len);
+    if (!_checkFrameCRC(buf)) {
+      TRACE("[XF] CRC error ");
+    } else {
+      _dispatchFrame(ctx, buf, pkt_len);
     }
+    len = 0;
+  }
+
+  return consumed;
+}
+
+static void crossfireProcessFrame(void* ctx, uint8_t* frame, uint8_t frame_len,
+                                  uint8_t* buf, uint8_t* p_len)
+{
+  uint8_t& len = *p_len;
+
+  if (frame_len == 0) return;
+
+  if (len > 0) {
+    // only the tail of a frame split across two reads is copied,
+    // complete frames are decoded straight from the input
+    int consumed = _completePendingFrame(ctx, frame, frame_len, buf, len);
+    if (len > 0) return;
+
+    frame += consumed;
+    frame_len -= consumed;
+  }
+
+  if (frame_len > 0 && !_validHdr(frame)) {
+    TRACE("[XF] invalid frame start");
+    do { frame++; frame_len--; } while (frame_len > 0 && !_validHdr(frame));
+  }
+  if (frame_len == 0) return;
+
+  if (frame_len < MIN_FRAME_LEN) {
+    // Too short to process, but valid header: save for reassembly
+    memcpy(buf, frame, frame_len);
+    len = frame_len;
+    return;
+  }
+
+  // process frames directly out of RX buffer
+  const uint8_t* p_buf = _processFrames(ctx, frame, frame_len);
+  if (frame_len > 0) {
+    memcpy(buf, p_buf, frame_len);
+    len = frame_len;
   }
 }
 
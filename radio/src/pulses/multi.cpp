@@ -26,6 +26,7 @@
 #include "telemetry/multi.h"
 #include "mixer_scheduler.h"
 #include "hal/abnormal_reboot.h"
+#include "channels_packing.h"
 
 // for the  MULTI protocol definition
 // see https://github.com/pascallanger/DIY-Multiprotocol-TX-Module
@@ -36,7 +37,6 @@
 #define MULTI_SEND_AUTOBIND                 (1 << 6)
 
 #define MULTI_CHANS                         16
-#define MULTI_CHAN_BITS                     11
 
 #define MULTI_NORMAL   0x00
 #define MULTI_FAILSAFE 0x01
@@ -82,35 +82,28 @@ static void updateMultiSync(uint8_t module)
 
 static void sendFailsafeChannels(uint8_t*& p_buf, uint8_t module)
 {
-  uint32_t bits = 0;
-  uint8_t bitsavailable = 0;
+  uint16_t values[MULTI_CHANS];
 
   for (int i = 0; i < MULTI_CHANS; i++) {
     int16_t failsafeValue = g_model.failsafeChannels[i];
-    int pulseValue;
 
     if (g_model.moduleData[module].failsafeMode == FAILSAFE_HOLD ||
         failsafeValue == FAILSAFE_CHANNEL_HOLD) {
-      pulseValue = 2047;
+      values[i] = 2047;
     } else if (g_model.moduleData[module].failsafeMode ==
                    FAILSAFE_NOPULSES ||
                failsafeValue == FAILSAFE_CHANNEL_NOPULSE) {
-      pulseValue = 0;
+      values[i] = 0;
     } else {
       failsafeValue +=
           2 * PPM_CH_CENTER(g_model.moduleData[module].channelsStart + i) -
           2 * PPM_CENTER;
-      pulseValue = limit(1, (failsafeValue * 800 / 1000) + 1024, 2046);
-    }
-
-    bits |= pulseValue << bitsavailable;
-    bitsavailable += MULTI_CHAN_BITS;
-    while (bitsavailable >= 8) {
-      sendMulti(p_buf, (uint8_t) (bits & 0xff));
-      bits >>= 8;
-      bitsavailable -= 8;
+      values[i] = limit<uint16_t>(1, MULTI_CHANNELS_PACKING.encode(failsafeValue), 2046);
     }
   }
+
+  packChannels(MULTI_CHANNELS_PACKING, p_buf, values, MULTI_CHANS);
+  p_buf += MULTI_CHANNELS_PACKING.packedSize(MULTI_CHANS);
 }
 
 static void setupPulsesMulti(uint8_t*& p_buf, uint8_t module)
@@ -291,30 +284,41 @@ const etx_proto_driver_t MultiDriver = {
   .txCompleted = modulePortSerialTxCompleted,
 };
 
+static inline uint16_t getMultiChannelValue(uint8_t module, int i)
+{
+  int channel = g_model.moduleData[module].channelsStart + i;
+  int value = channelOutputs[channel] + 2 * PPM_CH_CENTER(channel) - 2 * PPM_CENTER;
+  return MULTI_CHANNELS_PACKING.encode(value);
+}
+
+// Packed channels of the last frame, only changed channels are re-packed
+static uint8_t multiChannels[NUM_MODULES][MULTI_CHANNELS_PACKING.packedSize(MULTI_CHANS)];
+
 static void sendChannels(uint8_t*& p_buf, uint8_t module)
 {
-  uint32_t bits = 0;
-  uint8_t bitsavailable = 0;
+  uint8_t* packed = multiChannels[module];
+  uint32_t changed = pulsesGetChangedChannels(module);
 
   // byte 4-25, channels 0..2047
   // Range for pulses (channelsOutputs) is [-1024:+1024] for [-100%;100%]
   // Multi uses [204;1843] as [-100%;100%]
-  for (int i = 0; i < MULTI_CHANS; i++) {
-    int channel = g_model.moduleData[module].channelsStart + i;
-    int value = channelOutputs[channel] + 2 * PPM_CH_CENTER(channel) - 2 * PPM_CENTER;
-
-    // Scale to 80%
-    value = value * 800 / 1000 + 1024;
-    value = limit(0, value, 2047);
-
-    bits |= value << bitsavailable;
-    bitsavailable += MULTI_CHAN_BITS;
-    while (bitsavailable >= 8) {
-      sendMulti(p_buf, (uint8_t) (bits & 0xff));
-      bits >>= 8;
-      bitsavailable -= 8;
+  if (changed == PULSES_ALL_CHANNELS_CHANGED) {
+    uint16_t values[MULTI_CHANS];
+    for (int i = 0; i < MULTI_CHANS; i++) {
+      values[i] = getMultiChannelValue(module, i);
+    }
+    packChannels(MULTI_CHANNELS_PACKING, packed, values, MULTI_CHANS);
+  } else {
+    changed &= (1 << MULTI_CHANS) - 1;
+    while (changed) {
+      uint8_t ch = __builtin_ctz(changed);
+      patchChannel11Bits(packed, ch, getMultiChannelValue(module, ch));
+      changed &= changed - 1;
     }
   }
+
+  memcpy(p_buf, packed, sizeof(multiChannels[module]));
+  p_buf += sizeof(multiChannels[module]);
 }
 
 void sendFrameProtocolHeader(uint8_t*& p_buf, uint8_t module, bool failsafe)
@@ -76,6 +76,10 @@
 static module_pulse_driver _module_drivers[MAX_MODULES];
 static module_pulse_buffer _module_buffers[MAX_MODULES] __DMA_NO_CACHE;
 
+// channels changed since each module last packed its channel data
+static uint32_t _changed_channels[MAX_MODULES];
+static volatile bool _channels_invalidated = false;
+
 void pulsesInit()
 {
   memset(_module_drivers, 0, sizeof(_module_drivers));
@@ -131,6 +135,7 @@ void pulsesRestartModuleUnsafe(uint8_t module)
   auto drv = mod_drv->drv;
   drv->deinit(mod_drv->ctx);
   mod_drv->ctx = drv->init(module);
+  _changed_channels[module] = PULSES_ALL_CHANNELS_CHANGED;
 }
 
 static volatile bool _module_restart_queued[NUM_MODULES] = {false};
@@ -424,6 +429,7 @@ static void _deinit_module(uint8_t module)
 static void pulsesEnableModule(uint8_t module, uint8_t protocol)
 {
   _deinit_module(module);
+  _changed_channels[module] = PULSES_ALL_CHANNELS_CHANGED;
 
   switch (protocol) {
 #if defined(PXX1)
@@ -562,6 +568,7 @@ void pulsesSendNextFrame(uint8_t module)
     if (state.settings_updated) {
       if (drv->onConfigChange) drv->onConfigChange(ctx);
       state.settings_updated = 0;
+      _changed_channels[module] = PULSES_ALL_CHANNELS_CHANGED;
     }
 
     // if previous frame not completed, skip this one
@@ -576,9 +583,32 @@ void pulsesSendNextFrame(uint8_t module)
   }
 }
 
+uint32_t pulsesGetChangedChannels(uint8_t module)
+{
+  uint32_t changed = _changed_channels[module];
+  _changed_channels[module] = 0;
+
+  if (changed == PULSES_ALL_CHANNELS_CHANGED) return changed;
+  return changed >> g_model.moduleData[module].channelsStart;
+}
+
+void pulsesInvalidateChannels()
+{
+  _channels_invalidated = true;
+}
+
 void pulsesSendChannels()
 {
+  uint32_t changed = channelOutputsChanged;
+  channelOutputsChanged = 0;
+
+  if (_channels_invalidated) {
+    _channels_invalidated = false;
+    changed = PULSES_ALL_CHANNELS_CHANGED;
+  }
+
   for (uint8_t i = 0; i < MAX_MODULES; i++) {
+    _changed_channels[i] |= changed;
     pulsesSendNextFrame(i);
   }
 }
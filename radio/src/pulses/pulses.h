@@ -168,6 +168,18 @@ void pulsesStopModule(uint8_t module);
 void pulsesSendNextFrame(uint8_t module);
 void pulsesSendChannels();
 
+// Returned by pulsesGetChangedChannels() when every channel must be encoded
+#define PULSES_ALL_CHANNELS_CHANGED 0xFFFFFFFFu
+
+// Channels (relative to the module's first channel) whose output changed
+// since the previous call for this module. Encoders call this when they
+// pack channel data and may then patch only these slots of their last frame.
+uint32_t pulsesGetChangedChannels(uint8_t module);
+
+// Force every module to re-encode all channels on its next frame: a new
+// model was loaded, or the model (module settings, outputs) was edited.
+void pulsesInvalidateChannels();
+
 typedef void (*module_init_cb_t)(uint8_t, const etx_proto_driver_t*);
 typedef void (*module_deinit_cb_t)(uint8_t, const etx_proto_driver_t*);
 
@@ -52,6 +52,22 @@ enum ModuleSettingsMode
 ModuleSettingsMode getModuleMode(int moduleIndex);
 void setModuleMode(int moduleIndex, ModuleSettingsMode mode);
 
+// Overwrite slot 'idx' of a LSB first array of 11 bit channel values
+// (CRSF / SBUS / Multi layout) without touching the neighbouring slots
+inline void patchChannel11Bits(uint8_t* data, uint8_t idx, uint16_t value)
+{
+  uint16_t bit = idx * 11;
+  uint8_t* p = data + (bit >> 3);
+  uint8_t shift = bit & 7;
+  uint32_t mask = 0x7FFul << shift;
+  uint32_t word = p[0] | (p[1] << 8) | (shift > 5 ? (uint32_t)p[2] << 16 : 0);
+
+  word = (word & ~mask) | ((uint32_t)(value & 0x7FF) << shift);
+  p[0] = word;
+  p[1] = word >> 8;
+  if (shift > 5) p[2] = word >> 16;
+}
+
 template <class T, int SIZE>
 class DataBuffer {
   public:
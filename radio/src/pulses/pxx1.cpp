@@ -26,6 +26,7 @@
 
 #include "pxx1_transport.h"
 #include "pxx1.h"
+#include "channels_packing.h"
 
 #include "edgetx.h"
 
@@ -91,42 +92,41 @@ void Pxx1Pulses<PxxTransport>::addExtraFlags(uint8_t module)
 template <class PxxTransport>
 void Pxx1Pulses<PxxTransport>::addChannels(uint8_t moduleIdx, uint8_t sendFailsafe, uint8_t sendUpperChannels)
 {
-  uint16_t pulseValue = 0;
-  uint16_t pulseValueLow = 0;
+  uint16_t values[8];
 
   for (uint8_t i = 0; i < 8; i++) {
     if (sendFailsafe) {
       if (g_model.moduleData[moduleIdx].failsafeMode == FAILSAFE_HOLD) {
-        pulseValue = (i < sendUpperChannels ? 4095 : 2047);
+        values[i] = (i < sendUpperChannels ? 4095 : 2047);
       }
       else if (g_model.moduleData[moduleIdx].failsafeMode == FAILSAFE_NOPULSES) {
-        pulseValue = (i < sendUpperChannels ? 2048 : 0);
+        values[i] = (i < sendUpperChannels ? 2048 : 0);
       }
       else {
         if (i < sendUpperChannels) {
           int16_t failsafeValue = g_model.failsafeChannels[8+i];
           if (failsafeValue == FAILSAFE_CHANNEL_HOLD) {
-            pulseValue = 4095;
+            values[i] = 4095;
           }
           else if (failsafeValue == FAILSAFE_CHANNEL_NOPULSE) {
-            pulseValue = 2048;
+            values[i] = 2048;
           }
           else {
             failsafeValue += 2*PPM_CH_CENTER(8+g_model.moduleData[moduleIdx].channelsStart+i) - 2*PPM_CENTER;
-            pulseValue = limit(2049, (failsafeValue * 512 / 682) + 3072, 4094);
+            values[i] = PXX_UPPER_CHANNELS_PACKING.encode(failsafeValue);
           }
         }
         else {
           int16_t failsafeValue = g_model.failsafeChannels[i];
           if (failsafeValue == FAILSAFE_CHANNEL_HOLD) {
-            pulseValue = 2047;
+            values[i] = 2047;
           }
           else if (failsafeValue == FAILSAFE_CHANNEL_NOPULSE) {
-            pulseValue = 0;
+            values[i] = 0;
           }
           else {
             failsafeValue += 2*PPM_CH_CENTER(g_model.moduleData[moduleIdx].channelsStart+i) - 2*PPM_CENTER;
-            pulseValue = limit(1, (failsafeValue * 512 / 682) + 1024, 2046);
+            values[i] = PXX_CHANNELS_PACKING.encode(failsafeValue);
           }
         }
       }
@@ -135,26 +135,23 @@ void Pxx1Pulses<PxxTransport>::addChannels(uint8_t moduleIdx, uint8_t sendFailsa
       if (i < sendUpperChannels) {
         int channel = 8 + g_model.moduleData[moduleIdx].channelsStart + i;
         int value = channelOutputs[channel] + 2*PPM_CH_CENTER(channel) - 2*PPM_CENTER;
-        pulseValue = limit(2049, (value * 512 / 682) + 3072, 4094);
+        values[i] = PXX_UPPER_CHANNELS_PACKING.encode(value);
       }
       else if (i < sentModulePXXChannels(moduleIdx)) {
         int channel = g_model.moduleData[moduleIdx].channelsStart + i;
         int value = channelOutputs[channel] + 2*PPM_CH_CENTER(channel) - 2*PPM_CENTER;
-        pulseValue = limit(1, (value * 512 / 682) + 1024, 2046);
+        values[i] = PXX_CHANNELS_PACKING.encode(value);
       }
       else {
-        pulseValue = 1024;
+        values[i] = 1024;
       }
     }
+  }
 
-    if (i & 1) {
-      PxxTransport::addByte(pulseValueLow); // Low byte of channel
-      PxxTransport::addByte(((pulseValueLow >> 8) & 0x0F) | (pulseValue << 4));  // 4 bits each from 2 channels
-      PxxTransport::addByte(pulseValue >> 4);  // High byte of channel
-    }
-    else {
-      pulseValueLow = pulseValue;
-    }
+  uint8_t packed[PXX_CHANNELS_PACKING.packedSize(8)];
+  packChannels(PXX_CHANNELS_PACKING, packed, values, 8);
+  for (uint8_t i = 0; i < sizeof(packed); i++) {
+    PxxTransport::addByte(packed[i]);
   }
 }
 
@@ -29,6 +29,7 @@
 
 #include "pxx2.h"
 #include "pxx2_transport.h"
+#include "channels_packing.h"
 
 static const etx_serial_init pxx2SerialInitParams = {
     .baudrate = PXX2_HIGHSPEED_BAUDRATE,
@@ -267,70 +268,68 @@ void Pxx2Pulses::addFlag1(uint8_t module)
   Pxx2Transport::addByte(flag1);
 }
 
-void Pxx2Pulses::addPulsesValues(uint16_t low, uint16_t high)
+// Channels go by pairs: the last one of an odd count is not sent
+void Pxx2Pulses::addChannelsValues(const uint16_t* values, uint8_t count)
 {
-  Pxx2Transport::addByte(low); // Low byte of channel
-  Pxx2Transport::addByte(((low >> 8u) & 0x0Fu) | (high << 4u));  // 4 bits each from 2 channels
-  Pxx2Transport::addByte(high >> 4u);  // High byte of channel
+  uint8_t packed[PXX_CHANNELS_PACKING.packedSize(MAX_OUTPUT_CHANNELS)];
+  count &= ~1;
+  packChannels(PXX_CHANNELS_PACKING, packed, values, count);
+  for (uint8_t i = 0; i < PXX_CHANNELS_PACKING.packedSize(count); i++) {
+    Pxx2Transport::addByte(packed[i]);
+  }
 }
 
 void Pxx2Pulses::addChannels(uint8_t module, int16_t* channels, uint8_t nChannels)
 {
-  uint16_t pulseValue = 0;
-  uint16_t pulseValueLow = 0;
+  uint16_t values[MAX_OUTPUT_CHANNELS];
 
   uint8_t channel = g_model.moduleData[module].channelsStart;
   uint8_t count = sentModuleChannels(module);
 
   for (int8_t i = 0; i < count; i++, channel++) {
     int value = channels[i] + 2*PPM_CH_CENTER(channel) - 2*PPM_CENTER;
-    pulseValue = limit(1, (value * 512 / 682) + 1024, 2046);
+    values[i] = PXX_CHANNELS_PACKING.encode(value);
 #if defined(DEBUG_LATENCY_RF_ONLY)
     if (latencyToggleSwitch)
-      pulseValue = 1;
+      values[i] = 1;
     else
-      pulseValue = 2046;
+      values[i] = 2046;
 #endif
-    if (i & 1)
-      addPulsesValues(pulseValueLow, pulseValue);
-    else
-      pulseValueLow = pulseValue;
   }
+
+  addChannelsValues(values, count);
 }
 
 void Pxx2Pulses::addFailsafe(uint8_t module)
 {
-  uint16_t pulseValue = 0;
-  uint16_t pulseValueLow = 0;
+  uint16_t values[MAX_OUTPUT_CHANNELS];
 
   uint8_t channel = g_model.moduleData[module].channelsStart;
   uint8_t count = sentModuleChannels(module);
 
   for (int8_t i = 0; i < count; i++, channel++) {
     if (g_model.moduleData[module].failsafeMode == FAILSAFE_HOLD) {
-      pulseValue = 2047;
+      values[i] = 2047;
     }
     else if (g_model.moduleData[module].failsafeMode == FAILSAFE_NOPULSES) {
-      pulseValue = 0;
+      values[i] = 0;
     }
     else {
       int16_t failsafeValue = g_model.failsafeChannels[channel];
       if (failsafeValue == FAILSAFE_CHANNEL_HOLD) {
-        pulseValue = 2047;
+        values[i] = 2047;
       }
       else if (failsafeValue == FAILSAFE_CHANNEL_NOPULSE) {
-        pulseValue = 0;
+        values[i] = 0;
       }
       else {
         failsafeValue += 2*PPM_CH_CENTER(channel) - 2*PPM_CENTER;
-        pulseValue = limit(1, (failsafeValue * 512 / 682) + 1024, 2046);
+        values[i] = PXX_CHANNELS_PACKING.encode(failsafeValue);
       }
     }
-    if (i & 1)
-      addPulsesValues(pulseValueLow, pulseValue);
-    else
-      pulseValueLow = pulseValue;
   }
+
+  addChannelsValues(values, count);
 }
 
 void Pxx2Pulses::setupChannelsFrame(uint8_t module, int16_t* channels, uint8_t nChannels)
@@ -131,7 +131,7 @@ class Pxx2Pulses: public Pxx2Transport {
 
     void addFlag1(uint8_t module);
 
-    void addPulsesValues(uint16_t low, uint16_t high);
+    void addChannelsValues(const uint16_t* values, uint8_t count);
 
     void addChannels(uint8_t module, int16_t* channels, uint8_t nChannels);
 
@@ -23,11 +23,11 @@
 #include "hal/module_port.h"
 #include "hal/serial_driver.h"
 #include "mixer_scheduler.h"
+#include "channels_packing.h"
 
 #include "edgetx.h"
 
 #define SBUS_NORMAL_CHANS 16
-#define SBUS_CHAN_BITS    11
 
 /* Definitions from CleanFlight/BetaFlight */
 
@@ -36,8 +36,8 @@
 #define SBUS_FLAG_SIGNAL_LOSS       (1 << 2)
 #define SBUS_FLAG_FAILSAFE_ACTIVE   (1 << 3)
 #define SBUS_FRAME_BEGIN_BYTE       0x0F
-
-#define SBUS_CHAN_CENTER            992
+#define SBUS_FLAGS_IDX              23
+#define SBUS_FRAME_SIZE             25
 
 static inline void sendByte(uint8_t*& p_buf, uint8_t b)
 {
@@ -52,6 +52,21 @@ static inline int getChannelValue(uint8_t port, int channel)
   return channelOutputs[ch] + 2 * PPM_CH_CENTER(ch) - 2 * PPM_CENTER;
 }
 
+static inline uint16_t getSbusChannelValue(uint8_t port, int channel)
+{
+  return SBUS_CHANNELS_PACKING.encode(getChannelValue(port, channel));
+}
+
+static inline uint8_t getSbusFlags(uint8_t port)
+{
+  uint8_t flags=0;
+  if (getChannelValue(port, 16) > 0)
+    flags |= SBUS_FLAG_CHANNEL_17;
+  if (getChannelValue(port, 17) > 0)
+    flags |= SBUS_FLAG_CHANNEL_18;
+  return flags;
+}
+
 static void setupPulsesSbus(uint8_t module, uint8_t*& p_buf)
 {
   // extmodulePulsesData.dsm2.index = 0;
@@ -60,36 +75,35 @@ static void setupPulsesSbus(uint8_t module, uint8_t*& p_buf)
   // Sync Byte
   sendByte(p_buf, SBUS_FRAME_BEGIN_BYTE);
 
-  uint32_t bits = 0;
-  uint8_t bitsavailable = 0;
-
   // byte 1-22, channels 0..2047, limits not really clear (B
+  uint16_t values[SBUS_NORMAL_CHANS];
   for (int i=0; i<SBUS_NORMAL_CHANS; i++) {
-    int value = getChannelValue(module, i);
-
-    value =  value*8/10 + SBUS_CHAN_CENTER;
-    bits |= limit(0, value, 2047) << bitsavailable;
-    bitsavailable += SBUS_CHAN_BITS;
-    while (bitsavailable >= 8) {
-      sendByte(p_buf, (uint8_t) (bits & 0xff));
-      bits >>= 8;
-      bitsavailable -= 8;
-    }
+    values[i] = getSbusChannelValue(module, i);
   }
+  packChannels(SBUS_CHANNELS_PACKING, p_buf, values, SBUS_NORMAL_CHANS);
+  p_buf += SBUS_CHANNELS_PACKING.packedSize(SBUS_NORMAL_CHANS);
 
   // flags
-  uint8_t flags=0;
-  if (getChannelValue(module, 16) > 0)
-    flags |= SBUS_FLAG_CHANNEL_17;
-  if (getChannelValue(module, 17) > 0)
-    flags |= SBUS_FLAG_CHANNEL_18;
-
-  sendByte(p_buf, flags);
+  sendByte(p_buf, getSbusFlags(module));
 
   // last byte, always 0x0
   sendByte(p_buf, 0x00);
 }
 
+// The module buffer still holds the previous frame: only re-pack the
+// channels that changed since then.
+static void updatePulsesSbus(uint8_t module, uint8_t* frame, uint32_t changed)
+{
+  changed &= (1 << SBUS_NORMAL_CHANS) - 1;
+  while (changed) {
+    uint8_t ch = __builtin_ctz(changed);
+    patchChannel11Bits(frame + 1, ch, getSbusChannelValue(module, ch));
+    changed &= changed - 1;
+  }
+
+  frame[SBUS_FLAGS_IDX] = getSbusFlags(module);
+}
+
 
 #define SBUS_BAUDRATE 100000
 
@@ -170,7 +184,13 @@ static void sbusSendPulses(void* ctx, uint8_t* buffer, int16_t* channels, uint8_
   auto module = modulePortGetModule(mod_st);
 
   auto p_data = buffer;
-  setupPulsesSbus(module, p_data);
+  uint32_t changed = pulsesGetChangedChannels(module);
+  if (changed == PULSES_ALL_CHANNELS_CHANGED) {
+    setupPulsesSbus(module, p_data);
+  } else {
+    updatePulsesSbus(module, buffer, changed);
+    p_data += SBUS_FRAME_SIZE;
+  }
 
   auto drv = modulePortGetSerialDrv(mod_st->tx);
   auto drv_ctx = modulePortGetCtx(mod_st->tx);
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "edgetx.h"
+#include "model_cache.h"
+#include "modelslist.h"
+
+struct ModelCacheEntry {
+  char filename[LEN_MODEL_FILENAME + 1];
+  char hash[FILE_HASH_LENGTH + 1];
+  uint32_t lastUse;
+#if defined(COLORLCD)
+  ModelScreenData* screens;
+#endif
+};
+
+// book-keeping lives in normal RAM so that it is zeroed on boot,
+// the model images themselves are stored in SDRAM
+static ModelCacheEntry _entries[MODEL_CACHE_ENTRIES];
+static ModelData _models[MODEL_CACHE_ENTRIES] __SDRAM;
+static uint32_t _useCounter = 0;
+static ModelCacheStats _stats;
+
+static ModelCacheEntry* _findEntry(const char* filename)
+{
+  for (int i = 0; i < MODEL_CACHE_ENTRIES; i++) {
+    auto entry = &_entries[i];
+    if (entry->filename[0] &&
+        !strncmp(entry->filename, filename, LEN_MODEL_FILENAME))
+      return entry;
+  }
+  return nullptr;
+}
+
+static void _freeEntry(ModelCacheEntry* entry)
+{
+#if defined(COLORLCD)
+  delete entry->screens;
+  entry->screens = nullptr;
+#endif
+  entry->filename[0] = '\0';
+}
+
+bool modelCacheRestore(const char* filename, const char* hash)
+{
+  auto entry = _findEntry(filename);
+  if (!entry || strcmp(entry->hash, hash) != 0) {
+    if (entry) _freeEntry(entry);
+    _stats.misses++;
+    return false;
+  }
+
+  memcpy(&g_model, &_models[entry - _entries], sizeof(g_model));
+#if defined(COLORLCD)
+  g_model.restoreScreenData(entry->screens);
+#endif
+
+  entry->lastUse = ++_useCounter;
+  _stats.hits++;
+  TRACE("model cache: %s restored", filename);
+  return true;
+}
+
+void modelCacheStore(const char* filename, const char* hash)
+{
+  auto entry = _findEntry(filename);
+
+  if (!entry) {
+    // take a free slot, or the least recently used one
+    entry = &_entries[0];
+    for (int i = 0; i < MODEL_CACHE_ENTRIES; i++) {
+      if (!_entries[i].filename[0]) {
+        entry = &_entries[i];
+        break;
+      }
+      if (_entries[i].lastUse < entry->lastUse) entry = &_entries[i];
+    }
+  }
+
+  _freeEntry(entry);
+
+  memcpy(&_models[entry - _entries], &g_model, sizeof(g_model));
+#if defined(COLORLCD)
+  entry->screens = g_model.saveScreenData();
+#endif
+
+  strncpy(entry->hash, hash, FILE_HASH_LENGTH);
+  entry->hash[FILE_HASH_LENGTH] = '\0';
+  entry->lastUse = ++_useCounter;
+
+  // written last: marks the entry as valid
+  strncpy(entry->filename, filename, LEN_MODEL_FILENAME);
+  entry->filename[LEN_MODEL_FILENAME] = '\0';
+}
+
+void modelCacheInvalidate(const char* filename)
+{
+  auto entry = _findEntry(filename);
+  if (entry) _freeEntry(entry);
+}
+
+void modelCacheClear()
+{
+  for (int i = 0; i < MODEL_CACHE_ENTRIES; i++) {
+    _freeEntry(&_entries[i]);
+  }
+}
+
+const ModelCacheStats& modelCacheGetStats()
+{
+  return _stats;
+}
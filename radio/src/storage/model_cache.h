@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Most recently used models, kept decoded so that switching back to one
+// of them does not require parsing its YAML file again.
+//
+// Entries are keyed by file name and validated against the size and
+// modification time of the YAML file (see FILInfoToHexStr()): any change
+// to the file makes the next load fall back to the YAML decoder.
+
+#define MODEL_CACHE_ENTRIES 4
+
+// Restore g_model from the cache if 'filename' has not changed since it
+// was decoded. Returns false if the model must be read from the YAML file.
+bool modelCacheRestore(const char* filename, const char* hash);
+
+// Store g_model as freshly decoded from 'filename'
+void modelCacheStore(const char* filename, const char* hash);
+
+// Drop the entry for 'filename' (file written by the radio)
+void modelCacheInvalidate(const char* filename);
+
+// Drop all entries (SD card content may have changed)
+void modelCacheClear();
+
+struct ModelCacheStats {
+  uint32_t hits;
+  uint32_t misses;
+};
+
+const ModelCacheStats& modelCacheGetStats();
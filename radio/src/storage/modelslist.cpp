@@ -27,6 +27,7 @@ using std::list;
 
 #include "edgetx.h"
 #include "storage/sdcard_yaml.h"
+#include "storage/model_cache.h"
 #include "yaml/yaml_datastructs.h"
 #include "yaml/yaml_labelslist.h"
 #include "yaml/yaml_modelslist.h"
@@ -80,6 +81,8 @@ void ModelCell::setModelName(char *name)
     tmp = (char *)memchr(modelName, '.', LEN_MODEL_NAME);
     if (tmp != nullptr) *tmp = 0;
   }
+
+  modelslabels.updateSortKey(this);
 }
 
 void ModelCell::setModelName(char *name, uint8_t len)
@@ -95,6 +98,8 @@ void ModelCell::setModelName(char *name, uint8_t len)
     tmp = (char *)memchr(modelName, '.', LEN_MODEL_NAME);
     if (tmp != nullptr) *tmp = 0;
   }
+
+  modelslabels.updateSortKey(this);
 }
 
 void ModelCell::setModelId(uint8_t moduleIdx, uint8_t id)
@@ -134,13 +139,8 @@ void ModelCell::setRfModuleData(uint8_t moduleIdx, ModuleData *modData)
 
 ModelsVector ModelMap::getUnlabeledModels()
 {
-  ModelsVector unlabeledModels;
-  for (auto model : modelslist) {
-    if (modelslabels.getLabelsByModel(model).size() == 0)
-      unlabeledModels.emplace_back(model);
-  }
-  sortModelsBy(unlabeledModels, _sortOrder);
-  return unlabeledModels;
+  buildIndex();
+  return getModelsIn(unlabeledModels);
 }
 
 /**
@@ -149,8 +149,8 @@ ModelsVector ModelMap::getUnlabeledModels()
 
 ModelsVector ModelMap::getAllModels()
 {
-  ModelsVector all = modelslist;
-  sortModelsBy(all, _sortOrder);
+  ModelsVector all;
+  for (auto pos : getSortedModels()) all.push_back(indexModels[pos]);
   return all;
 }
 
@@ -164,18 +164,15 @@ ModelsVector ModelMap::getAllModels()
 
 ModelsVector ModelMap::getModelsByLabel(const std::string &lbl)
 {
-  int index = getIndexByLabel(lbl);
-  if (index < 0) return ModelsVector();
-  ModelsVector rv;
-  for (auto it = begin(); it != end(); ++it) {
-    if (it->first == index) rv.push_back(it->second);
-  }
-  sortModelsBy(rv, _sortOrder);
-  return rv;
+  auto models = getLabelModels(lbl);
+  if (!models) return ModelsVector();
+  return getModelsIn(*models);
 }
 
 /**
  * @brief Returns all models that are in multiple labels (OR function)
+ * @details A model in several of the labels is listed once. It used to be
+ *          listed once per label.
  *
  * @param lbls Labels to search
  * @return ModelsVector aka vector<ModelCell*> of all models belonging to a
@@ -184,29 +181,15 @@ ModelsVector ModelMap::getModelsByLabel(const std::string &lbl)
 
 ModelsVector ModelMap::getModelsByLabels(const LabelsVector &lbls)
 {
-  bool addunlabeled = false;
-  // Build a list of the requested indexes
-  std::vector<int> idxvect;
+  buildIndex();
+  ModelsBitset rv;
+  rv.resize(indexModels.size());
   for (const auto &lbl : lbls) {
-    if (lbl == STR_UNLABELEDMODEL) addunlabeled = true;
-    int index = getIndexByLabel(lbl);
-    if (index >= 0) idxvect.push_back(index);
-  }
-
-  ModelsVector rv;
-  for (auto it = begin(); it != end(); ++it) {
-    for (auto idx : idxvect) {
-      if (it->first == idx) rv.push_back(it->second);
-    }
+    if (lbl == STR_UNLABELEDMODEL) rv |= unlabeledModels;
+    auto models = getLabelModels(lbl);
+    if (models) rv |= *models;
   }
-
-  if (addunlabeled) {
-    ModelsVector unlabeled = getUnlabeledModels();
-    rv.insert(rv.end(), unlabeled.begin(), unlabeled.end());
-  }
-
-  sortModelsBy(rv, _sortOrder);
-  return rv;
+  return getModelsIn(rv);
 }
 
 /**
@@ -225,45 +208,40 @@ ModelsVector ModelMap::getModelsInLabels(const LabelsVector &lbls)
   if (lbls.size() == 1 && lbls.at(0) == STR_UNLABELEDMODEL)
     return getUnlabeledModels();
 
-  ModelsVector rv;
+  buildIndex();
+  size_t count = indexModels.size();
+  ModelsBitset hasAllLabels, hasAnyLabels, hasFavLabel, none;
+  hasAllLabels.resize(count, true);
+  hasAnyLabels.resize(count);
+  none.resize(count);
+  bool favLabelIncluded = false;
 
-  for (const auto &mdl : modelslist) {
-    bool hasAllLabels = true;
-    bool hasAnyLabels = false;
-    bool favLabelIncluded = false;
-    bool hasFavLabel = false;
-    LabelsVector mdllables = getLabelsByModel(mdl);
-    for (const auto &lbl : lbls) {
-      if (lbl == STR_UNLABELEDMODEL)  // If requesting unlabeled model ignore it
-        break;
-      bool hasLabel = std::find(mdllables.begin(), mdllables.end(), lbl) != mdllables.end();
-      if (lbl == STR_FAVORITE_LABEL) {
-        favLabelIncluded = true;
-        hasFavLabel = hasLabel;
-      } else {
-        if (hasLabel) {
-          hasAnyLabels = true;
-        } else {
-          hasAllLabels = false;
-        }
-      }
+  for (const auto &lbl : lbls) {
+    if (lbl == STR_UNLABELEDMODEL)  // If requesting unlabeled model ignore it
+      break;
+    auto models = getLabelModels(lbl);
+    if (!models) models = &none;
+    if (lbl == STR_FAVORITE_LABEL) {
+      favLabelIncluded = true;
+      hasFavLabel = *models;
+    } else {
+      hasAnyLabels |= *models;
+      hasAllLabels &= *models;
     }
-    if (favLabelIncluded) {
-      if (g_eeGeneral.favMultiMode == 0) {
-        hasAnyLabels = hasAnyLabels && hasFavLabel;
-        hasAllLabels = hasAllLabels && hasFavLabel;
-      } else if (g_eeGeneral.favMultiMode == 1) {
-        hasAnyLabels = hasAnyLabels || hasFavLabel;
-        hasAllLabels = hasAllLabels && hasFavLabel;
-      }
+  }
+  if (favLabelIncluded) {
+    if (g_eeGeneral.favMultiMode == 0) {
+      hasAnyLabels &= hasFavLabel;
+      hasAllLabels &= hasFavLabel;
+    } else if (g_eeGeneral.favMultiMode == 1) {
+      hasAnyLabels |= hasFavLabel;
+      hasAllLabels &= hasFavLabel;
     }
-    if (((g_eeGeneral.labelMultiMode == 0) && hasAllLabels) ||
-        ((g_eeGeneral.labelMultiMode == 1) && hasAnyLabels))
-      rv.push_back(mdl);
   }
 
-  sortModelsBy(rv, _sortOrder);
-  return rv;
+  if (g_eeGeneral.labelMultiMode == 0) return getModelsIn(hasAllLabels);
+  if (g_eeGeneral.labelMultiMode == 1) return getModelsIn(hasAnyLabels);
+  return ModelsVector();
 }
 
 /**
@@ -398,6 +376,7 @@ bool ModelMap::addLabelToModel(const std::string &lbl, ModelCell *cell,
   setDirty();
   int labelindex = addLabel(lbl);
   insert(std::pair<int, ModelCell *>(labelindex, cell));
+  invalidateIndex();
 
   if (update) updateModelFile(cell);  // Write labels into model
 
@@ -550,6 +529,7 @@ bool ModelMap::removeLabelFromModel(const std::string &label, ModelCell *cell,
     setDirty();
     rv = false;
   }
+  invalidateIndex();
 
   if (update) updateModelFile(cell);  // Write labels into model
 
@@ -799,6 +779,7 @@ bool ModelMap::removeModels(ModelCell *cell)
   for (ModelMap::const_iterator itr = cbegin(); itr != cend();) {
     if (itr->second == cell) {
       itr = erase(itr);
+      invalidateIndex();
       setDirty();
       rv = false;
     } else {
@@ -859,33 +840,151 @@ bool ModelMap::updateModelFile(ModelCell *cell)
 }
 
 /**
- * @brief Sorts a ModelsVector by sortby
+ * @brief Rebuilds the labels index if it was invalidated
+ * @details Each label gets the set of its models, so that filtering on
+ *          labels only combines these sets.
+ */
+
+void ModelMap::buildIndex()
+{
+  if (indexValid) return;
+
+  indexModels = modelslist;
+  size_t count = indexModels.size();
+
+  // Positions looked up by model address
+  std::vector<std::pair<ModelCell *, uint16_t>> positions;
+  positions.reserve(count);
+  for (size_t i = 0; i < count; i++) positions.emplace_back(indexModels[i], i);
+  std::sort(positions.begin(), positions.end());
+
+  labelModels.resize(labels.size());
+  for (auto &models : labelModels) models.resize(count);
+  unlabeledModels.resize(count, true);
+
+  for (auto it = begin(); it != end(); ++it) {
+    auto pos = std::lower_bound(positions.begin(), positions.end(),
+                                std::make_pair(it->second, (uint16_t)0));
+    if (pos == positions.end() || pos->first != it->second) continue;
+    if (it->first < labelModels.size()) labelModels[it->first].set(pos->second);
+    unlabeledModels.reset(pos->second);
+  }
+
+  sortedBy = SORT_COUNT;
+  indexValid = true;
+}
+
+/**
+ * @brief Set of the models having a label
  *
- * @param mv ModelsVector to sort
- * @param sortby NO_SORT, NAME_ASC, NAME_DES, DATE_ASC, DATE_DES,
+ * @param lbl Label to search
+ * @return nullptr if the label doesn't exist
+ */
+
+const ModelsBitset *ModelMap::getLabelModels(const std::string &lbl)
+{
+  buildIndex();
+  int index = getIndexByLabel(lbl);
+  if (index < 0 || index >= (int)labelModels.size()) return nullptr;
+  return &labelModels[index];
+}
+
+/**
+ * @brief Returns the models of a set, in the sort order
  */
 
-void ModelMap::sortModelsBy(ModelsVector &mv, ModelsSortBy sortby)
+ModelsVector ModelMap::getModelsIn(const ModelsBitset &models)
+{
+  ModelsVector rv;
+  for (auto pos : getSortedModels()) {
+    if (models.test(pos)) rv.push_back(indexModels[pos]);
+  }
+  return rv;
+}
+
+static bool isSortedBefore(ModelsSortBy sortby, const ModelCell *a,
+                           const ModelCell *b)
 {
-  if (sortby == DATE_DES) {
-    std::sort(mv.begin(), mv.end(), [](ModelCell *a, ModelCell *b) -> bool {
+  switch (sortby) {
+    case DATE_DES:
       return a->lastOpened > b->lastOpened;
-    });
-  } else if (sortby == DATE_ASC) {
-    std::sort(mv.begin(), mv.end(), [](ModelCell *a, ModelCell *b) -> bool {
+    case DATE_ASC:
       return a->lastOpened < b->lastOpened;
-    });
-  } else if (sortby == NAME_ASC) {
-    std::sort(mv.begin(), mv.end(), [](ModelCell *a, ModelCell *b) -> bool {
+    case NAME_ASC:
       return strcasecmp(a->modelName, b->modelName) < 0;
-    });
-  } else if (sortby == NAME_DES) {
-    std::sort(mv.begin(), mv.end(), [](ModelCell *a, ModelCell *b) -> bool {
+    case NAME_DES:
       return strcasecmp(a->modelName, b->modelName) > 0;
-    });
+    default:
+      return false;
   }
 }
 
+/**
+ * @brief Positions of the models, sorted by the current sort order
+ * @details Only sorted again when the sort order or the models changed, the
+ *          names being lowered once per model rather than on each compare.
+ */
+
+const std::vector<uint16_t> &ModelMap::getSortedModels()
+{
+  buildIndex();
+  if (sortedBy == _sortOrder) return sortedModels;
+
+  size_t count = indexModels.size();
+  sortedModels.resize(count);
+  for (size_t i = 0; i < count; i++) sortedModels[i] = i;
+
+  if (_sortOrder == NAME_ASC || _sortOrder == NAME_DES) {
+    std::vector<std::string> keys(count);
+    for (size_t i = 0; i < count; i++) {
+      for (const char *c = indexModels[i]->modelName; *c; c++)
+        keys[i] += tolower((unsigned char)*c);
+    }
+    bool desc = (_sortOrder == NAME_DES);
+    std::stable_sort(sortedModels.begin(), sortedModels.end(),
+                     [&](uint16_t a, uint16_t b) -> bool {
+                       return desc ? keys[b] < keys[a] : keys[a] < keys[b];
+                     });
+  } else if (_sortOrder != NO_SORT) {
+    ModelsSortBy sortby = _sortOrder;
+    std::stable_sort(sortedModels.begin(), sortedModels.end(),
+                     [&](uint16_t a, uint16_t b) -> bool {
+                       return isSortedBefore(sortby, indexModels[a],
+                                             indexModels[b]);
+                     });
+  }
+
+  sortedBy = _sortOrder;
+  return sortedModels;
+}
+
+/**
+ * @brief Moves a model to its place in the sorted models
+ * @details Called once its name or last opened time changed, instead of
+ *          sorting all the models again.
+ *
+ * @param cell Model changed
+ */
+
+void ModelMap::updateSortKey(ModelCell *cell)
+{
+  if (!indexValid || sortedBy == SORT_COUNT || sortedBy == NO_SORT) return;
+
+  auto model = std::find(indexModels.begin(), indexModels.end(), cell);
+  if (model == indexModels.end()) return;
+  uint16_t pos = model - indexModels.begin();
+
+  sortedModels.erase(
+      std::find(sortedModels.begin(), sortedModels.end(), pos));
+  ModelsSortBy sortby = sortedBy;
+  auto place = std::upper_bound(
+      sortedModels.begin(), sortedModels.end(), pos,
+      [&](uint16_t a, uint16_t b) -> bool {
+        return isSortedBefore(sortby, indexModels[a], indexModels[b]);
+      });
+  sortedModels.insert(place, pos);
+}
+
 /**
  * @brief Sets the ModelMap to dirty.
  * @details Causes labels.yml to be written after a delay in
@@ -917,6 +1016,7 @@ void ModelsList::clear()
     delete(mdl);
   }
   std::vector<ModelCell *>::clear();
+  modelslabels.invalidateIndex();
   init();
 }
 
@@ -937,6 +1037,7 @@ void ModelMap::updateModelCell(ModelCell *cell)
   }
 
   TRACE("Labels: Updating model %s", cell->modelFilename);
+  invalidateIndex();
   readModelYaml(cell->modelFilename, (uint8_t *)model, sizeof(ModelData));
   strncpy(cell->modelName, model->header.name, LEN_MODEL_NAME);
   cell->modelName[LEN_MODEL_NAME] = '\0';
@@ -1187,6 +1288,7 @@ bool ModelsList::loadYaml()
     modelslabels.addLabel(STR_FAVORITE_LABEL);
   }
 
+  modelslabels.invalidateIndex();
   return true;
 }
 
@@ -1310,6 +1412,7 @@ void ModelsList::setCurrentModel(ModelCell *cell)
   struct gtm t;
   gettime(&t);
   cell->lastOpened = gmktime(&t);
+  modelslabels.updateSortKey(cell);
   modelslabels.setDirty();
 
 #if defined(USBJ_EX) && defined(STM32) && !defined(SIMU)
@@ -1361,6 +1464,7 @@ ModelCell *ModelsList::addModel(const char *fileName, bool save, ModelCell *copy
 
   // Add to the ModelsList
   push_back(result);
+  modelslabels.invalidateIndex();
 
   // Force save to labels.yml
   if (save) this->save();
@@ -1382,6 +1486,7 @@ bool ModelsList::removeModel(ModelCell *model)
 {
   erase(std::remove(begin(), end(), model), end());
   modelslabels.removeModels(model);
+  modelslabels.invalidateIndex();
 
   // Create deleted folder if it doesn't exist
   DIR deletedFolder;
@@ -1397,6 +1502,9 @@ bool ModelsList::removeModel(ModelCell *model)
   // Move model into deleted folder. If not moved will be re-added on next
   // reboot
   TRACE_LABELS("Deleting Model %s", model->modelFilename);
+#if defined(MODEL_CACHE)
+  modelCacheInvalidate(model->modelFilename);
+#endif
   const char *warning = sdMoveFile(model->modelFilename, MODELS_PATH, model->modelFilename, DELETED_MODELS_PATH);
   if (warning) {
     TRACE("Labels: Unable to move file");
@@ -1430,6 +1538,7 @@ bool ModelsList::moveModelTo(unsigned curindex, unsigned toindex)
                 begin() + toindex + 1);
   }
 
+  modelslabels.invalidateIndex();
   modelslabels.setDirty();
   return false;
 }
@@ -59,6 +59,8 @@ typedef struct PACKED {
 
 #define FILE_HASH_LENGTH (sizeof(FInfoH) * 2)  // Hex string output
 
+char *FILInfoToHexStr(char buffer[17], FILINFO *finfo);
+
 class ModelCell
 {
  public:
@@ -104,6 +106,38 @@ typedef enum {
   SORT_COUNT
 } ModelsSortBy;
 
+/**
+ * @brief Set of models, by their position in the ModelMap index
+ */
+
+class ModelsBitset
+{
+ public:
+  void resize(size_t count, bool value = false)
+  {
+    bits.assign((count + 31) / 32, value ? 0xFFFFFFFF : 0);
+  }
+
+  void set(size_t n) { bits[n / 32] |= 1u << (n % 32); }
+  void reset(size_t n) { bits[n / 32] &= ~(1u << (n % 32)); }
+  bool test(size_t n) const { return bits[n / 32] & (1u << (n % 32)); }
+
+  ModelsBitset &operator&=(const ModelsBitset &other)
+  {
+    for (size_t i = 0; i < bits.size(); i++) bits[i] &= other.bits[i];
+    return *this;
+  }
+
+  ModelsBitset &operator|=(const ModelsBitset &other)
+  {
+    for (size_t i = 0; i < bits.size(); i++) bits[i] |= other.bits[i];
+    return *this;
+  }
+
+ private:
+  std::vector<uint32_t> bits;
+};
+
 /**
  * @brief ModelMap is a multimap of all models and their cooresponding
  *        labels. Lables are referenced by index, stored in var labels
@@ -169,11 +203,17 @@ class ModelMap : protected std::multimap<uint16_t, ModelCell *>
     _isDirty = true;
     labels.clear();
     std::multimap<uint16_t, ModelCell *>::clear();
+    invalidateIndex();
   }
 
   void updateModelCell(ModelCell *);
   bool removeModels(ModelCell *);
 
+  // Models added, removed or moved in modelslist
+  void invalidateIndex() { indexValid = false; }
+  // Name or last opened time changed
+  void updateSortKey(ModelCell *);
+
  protected:
   ModelsSortBy _sortOrder = DEFAULT_MODEL_SORT;
   bool _isDirty = true;
@@ -181,7 +221,11 @@ class ModelMap : protected std::multimap<uint16_t, ModelCell *>
   std::string currentlabel = "";
 
   bool updateModelFile(ModelCell *);
-  void sortModelsBy(ModelsVector &mv, ModelsSortBy sortby);
+
+  void buildIndex();
+  const std::vector<uint16_t> &getSortedModels();
+  const ModelsBitset *getLabelModels(const std::string &lbl);
+  ModelsVector getModelsIn(const ModelsBitset &models);
 
   int getIndexByLabel(const std::string &str)
   {
@@ -199,6 +243,18 @@ class ModelMap : protected std::multimap<uint16_t, ModelCell *>
 
  private:
   LabelsVector labels;  // Storage space for discovered labels
+
+  // Index of the models labels, rebuilt on the next use once invalid.
+  // Models are referenced by their position in indexModels.
+  bool indexValid = false;
+  ModelsVector indexModels;
+  std::vector<ModelsBitset> labelModels;  // by label index
+  ModelsBitset unlabeledModels;
+
+  // Positions sorted by sortedBy, kept in order as models are opened or
+  // renamed rather than sorted again
+  std::vector<uint16_t> sortedModels;
+  ModelsSortBy sortedBy = SORT_COUNT;
 };
 
 class ModelsList : public ModelsVector
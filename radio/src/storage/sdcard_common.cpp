@@ -23,7 +23,9 @@
 #include "storage.h"
 #include "sdcard_common.h"
 #include "modelslist.h"
+#include "model_cache.h"
 #include "model_init.h"
+#include "tasks/storage_task.h"
 
 #include "hal/abnormal_reboot.h"
 
@@ -82,24 +84,59 @@ static void storageEraseAll()
   forceSave();
 }
 
+static constexpr uint8_t retryLimit = 10;
+static uint8_t retryRadioCount = 0;
+static uint8_t retryModelCount = 0;
+
+// Outcome of a write queued to the storage task by a previous call:
+// a failed one is handled like a failed synchronous write
+static StorageWriteResult takeQueuedWriteResult(StorageWriteSlot slot,
+                                                uint8_t mask,
+                                                uint8_t& retryCount)
+{
+  auto result = storageTaskTakeResult(slot);
+  if (result == STORAGE_WRITE_DONE) {
+    retryCount = 0;
+  } else if (result == STORAGE_WRITE_FAILED) {
+    TRACE("storage: queued write failed (slot %d)", slot);
+    storageDirtyMsk |= mask;
+    retryCount += 1;
+  }
+  return result;
+}
+
 void storageCheck(bool immediately)
 {
   // Don't write anything to SD card if in EM
   if (UNEXPECTED_SHUTDOWN()) return;
 
-  static constexpr uint8_t retryLimit = 10;
+  // Deferred saves are serialized here and written by the storage task,
+  // immediate ones are written synchronously once the queue is empty
+  if (immediately) storageTaskFlush();
+
+  takeQueuedWriteResult(STORAGE_SLOT_RADIO, EE_GENERAL, retryRadioCount);
+  if (takeQueuedWriteResult(STORAGE_SLOT_MODEL, EE_MODEL, retryModelCount) ==
+      STORAGE_WRITE_DONE) {
+#if defined(STORAGE_MODELSLIST)
+    modelslist.updateCurrentModelCell();
+#endif
+  }
 
-  static uint8_t retryRadioCount = 0;
   if (storageDirtyMsk & EE_GENERAL) {
     if (retryRadioCount < retryLimit) {
       TRACE("SD card write radio settings");
-      const char * error = writeGeneralSettings();
-      if (error) {
+      const char * error = nullptr;
+      auto post = immediately ? STORAGE_POST_FAILED : queueGeneralSettingsWrite();
+      bool queued = post == STORAGE_POST_QUEUED;
+      if (post == STORAGE_POST_FAILED) error = writeGeneralSettings();
+      if (post == STORAGE_POST_BUSY) {
+        // still dirty, posted again on the next check
+      } else if (error) {
         TRACE("writeGeneralSettings error=%s", error);
         retryRadioCount += 1;
       } else {
         storageDirtyMsk &= ~EE_GENERAL;
-        retryRadioCount = 0;
+        if (!queued) retryRadioCount = 0;
       }
     } else {
       // Reset timeout to next check
@@ -109,9 +146,40 @@ void storageCheck(bool immediately)
     }
   }
 
+  if (storageDirtyMsk & EE_MODEL) {
+    if (retryModelCount < retryLimit) {
+      TRACE("SD card write model settings");
+      const char * error = nullptr;
+      auto post = immediately ? STORAGE_POST_FAILED : queueModelWrite();
+      bool queued = post == STORAGE_POST_QUEUED;
+      if (post == STORAGE_POST_FAILED) error = writeModel();
+      if (post == STORAGE_POST_BUSY) {
+        // the previous model is still being written: posted again
+        // on the next check, without waiting for it
+      } else if (error) {
+        TRACE("writeModel error=%s", error);
+        retryModelCount += 1;
+      } else {
+        storageDirtyMsk &= ~EE_MODEL;
+        if (!queued) {
+          retryModelCount = 0;
 #if defined(STORAGE_MODELSLIST)
+          modelslist.updateCurrentModelCell();
+#endif
+        }
+      }
+    } else {
+      // Reset timeout to next check
+      storageDirtyTime10ms = get_tmr10ms();
+      retryModelCount = retryLimit / 2; // Retry again after timeout; but fewer times
+      // TODO: provide some mechanism to alert user that SD card has serious error
+    }
+  }
+
+#if defined(STORAGE_MODELSLIST)
+  // labels.yml describes the model files: written once they are
   static uint8_t retryLabelsCount = 0;
-  if (storageDirtyMsk & EE_LABELS) {
+  if ((storageDirtyMsk & EE_LABELS) && !storageTaskPending(STORAGE_SLOT_MODEL)) {
     if (retryLabelsCount < retryLimit) {
       TRACE("SD card write labels");
       const char * error = modelslist.save();
@@ -130,29 +198,6 @@ void storageCheck(bool immediately)
     }
   }
 #endif
-
-  static uint8_t retryModelCount = 0;
-  if (storageDirtyMsk & EE_MODEL) {
-    if (retryModelCount < retryLimit) {
-      TRACE("SD card write model settings");
-      const char * error = writeModel();
-#if defined(STORAGE_MODELSLIST)
-      modelslist.updateCurrentModelCell();
-#endif
-      if (error) {
-        TRACE("writeModel error=%s", error);
-        retryModelCount += 1;
-      } else {
-        storageDirtyMsk &= ~EE_MODEL;
-        retryModelCount = 0;
-      }
-    } else {
-      // Reset timeout to next check
-      storageDirtyTime10ms = get_tmr10ms();
-      retryModelCount = retryLimit / 2; // Retry again after timeout; but fewer times
-      // TODO: provide some mechanism to alert user that SD card has serious error
-    }
-  }
 }
 
 #if defined(STORAGE_MODELSLIST)
@@ -177,11 +222,41 @@ const char * createModel()
 }
 #endif
 
+#if defined(MODEL_CACHE)
+// Decode the model from the cache if its file has not changed,
+// from the YAML file otherwise
+static const char* readModelCached(const char* filename, const char* filePath)
+{
+  char path[256];
+  char hash[FILE_HASH_LENGTH + 1] = "";
+  FILINFO finfo;
+
+  bool cacheable = !strcmp(filePath, MODELS_PATH);
+  if (cacheable) {
+    getModelPath(path, filename, filePath);
+    if (f_stat(path, &finfo) == FR_OK) {
+      FILInfoToHexStr(hash, &finfo);
+      if (modelCacheRestore(filename, hash)) return nullptr;
+    } else {
+      cacheable = false;
+    }
+  }
+
+  const char* error = readModel(filename, (uint8_t*)&g_model, sizeof(g_model), filePath);
+  if (!error && cacheable) modelCacheStore(filename, hash);
+  return error;
+}
+#endif
+
 const char* loadModel(const char* filename, bool alarms, const char* filePath)
 {
   preModelLoad();
 
+#if defined(MODEL_CACHE)
+  const char* error = readModelCached(filename, filePath);
+#else
   const char* error = readModel(filename, (uint8_t*)&g_model, sizeof(g_model), filePath);
+#endif
   if (error) {
     TRACE("loadModel error=%s", error);
 
@@ -209,6 +284,10 @@ void storageReadAll()
   modelslist.clear();
 #endif
 
+#if defined(MODEL_CACHE)
+  modelCacheClear();
+#endif
+
   // Some radio defaults overriden by config loading:
   // - screens disabled by default:
   g_eeGeneral.modelCustomScriptsDisabled = true;
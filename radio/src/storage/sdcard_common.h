@@ -23,6 +23,7 @@
 
 #include "ff.h"
 #include "sdcard.h"
+#include "storage/write_queue.h"
 
 #define MODEL_FILENAME_PREFIX    "model"
 #define MODEL_FILENAME_SUFFIX    ".yml"
@@ -40,6 +41,9 @@ const char * loadModel(const char * filename, bool alarms = true, const char* fi
 const char * createModel();
 const char * writeModel();
 
+// serialize the current model and queue it to the storage task
+StoragePostResult queueModelWrite();
+
 #if !defined(STORAGE_MODELSLIST)
 
 extern ModelHeader modelHeaders[MAX_MODELS];
@@ -61,5 +65,6 @@ bool storageReadRadioSettings(bool checks);
 
 const char * loadRadioSettings();
 const char * writeGeneralSettings();
+StoragePostResult queueGeneralSettingsWrite();
 
 void checkModelIdUnique(uint8_t index, uint8_t module);
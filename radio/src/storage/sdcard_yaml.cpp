@@ -27,6 +27,8 @@
 #include "sdcard_common.h"
 #include "sdcard_yaml.h"
 #include "modelslist.h"
+#include "model_cache.h"
+#include "tasks/storage_task.h"
 
 #include "yaml/yaml_tree_walker.h"
 #include "yaml/yaml_parser.h"
@@ -289,6 +291,85 @@ const char* writeFileYaml(const char* path, const YamlNode* root_node, uint8_t*
     return NULL;
 }
 
+struct yaml_buffer_ctx {
+    char*    buffer;  // nullptr: only measure the output
+    uint32_t size;
+    uint32_t len;
+};
+
+static bool yaml_buffer_writer(void* opaque, const char* str, size_t len)
+{
+    yaml_buffer_ctx* ctx = (yaml_buffer_ctx*)opaque;
+
+    if (ctx->buffer) {
+      // data changed since it was measured
+      if (ctx->len + len > ctx->size) return false;
+      memcpy(ctx->buffer + ctx->len, str, len);
+    }
+    ctx->len += len;
+    return true;
+}
+
+// Same output as writeFileYaml(), but into a malloc'ed buffer that can be
+// handed over to the storage task. The first pass only measures the output.
+// Returns nullptr if the buffer could not be allocated.
+static char* writeBufferYaml(const YamlNode* root_node, uint8_t* data, uint16_t checksum, uint32_t* len)
+{
+    yaml_buffer_ctx ctx = { nullptr, 0, 0 };
+
+    const char* p_out = nullptr;
+    if (checksum != 0) {
+      p_out = yaml_unsigned2str((int)checksum);
+      ctx.len = strlen(YAMLFILE_CHECKSUM_TAG_NAME) + 2 + strlen(p_out) + 2;
+    }
+
+    YamlTreeWalker tree;
+    tree.reset(root_node, data);
+    tree.generate(yaml_buffer_writer, &ctx);
+
+    uint32_t size = ctx.len;
+    char* buffer = (char*)malloc(size);
+    if (!buffer) return nullptr;
+
+    ctx.buffer = buffer;
+    ctx.size = size;
+    ctx.len = 0;
+
+    if (checksum != 0) {
+      yaml_buffer_writer(&ctx, YAMLFILE_CHECKSUM_TAG_NAME, strlen(YAMLFILE_CHECKSUM_TAG_NAME));
+      yaml_buffer_writer(&ctx, ": ", 2);
+      yaml_buffer_writer(&ctx, p_out, strlen(p_out));
+      yaml_buffer_writer(&ctx, "\r\n", 2);
+    }
+
+    tree.reset(root_node, data);
+    if (!tree.generate(yaml_buffer_writer, &ctx) || ctx.len != size) {
+      free(buffer);
+      return nullptr;
+    }
+
+    *len = size;
+    return buffer;
+}
+
+StoragePostResult queueGeneralSettingsWrite()
+{
+    if (!storageTaskRunning()) return STORAGE_POST_FAILED;
+    if (!storageTaskAccepts(STORAGE_SLOT_RADIO, RADIO_SETTINGS_YAML_PATH))
+      return STORAGE_POST_BUSY;
+
+    uint16_t file_checksum = 0;
+    YamlFileChecksum(get_radiodata_nodes(), (uint8_t*)&g_eeGeneral, &file_checksum);
+    g_eeGeneral.manuallyEdited = false;
+
+    uint32_t len;
+    char* buffer = writeBufferYaml(get_radiodata_nodes(), (uint8_t*)&g_eeGeneral, file_checksum, &len);
+    if (!buffer) return STORAGE_POST_FAILED;
+
+    return storageTaskPostWrite(STORAGE_SLOT_RADIO, RADIO_SETTINGS_YAML_PATH,
+                                RADIO_SETTINGS_TMPFILE_YAML_PATH, buffer, len);
+}
+
 const char * writeGeneralSettings()
 {
     TRACE("YAML radio settings writer");
@@ -390,6 +471,9 @@ const char * writeModelYaml(const char* filename)
     TRACE("YAML model writer");
     char path[256];
     getModelPath(path, filename);
+#if defined(MODEL_CACHE)
+    modelCacheInvalidate(filename);
+#endif
     return writeFileYaml(path, get_modeldata_nodes(), (uint8_t*)&g_model,0 );
 }
 
@@ -406,16 +490,42 @@ void getModelNumberStr(uint8_t idx, char* model_idx)
 }
 #endif
 
-const char * writeModel()
-{
 #if defined(STORAGE_MODELSLIST)
-  return writeModelYaml(g_eeGeneral.currModelFilename);
+  #define CURRENT_MODEL_FILENAME(fname) \
+    const char* fname = g_eeGeneral.currModelFilename
 #else
-  char fname[MODELIDX_STRLEN + sizeof(YAML_EXT)];
-  getModelNumberStr(g_eeGeneral.currModel, fname);
-  strcat(fname, YAML_EXT);
+  #define CURRENT_MODEL_FILENAME(fname)                   \
+    char fname[MODELIDX_STRLEN + sizeof(YAML_EXT)];       \
+    getModelNumberStr(g_eeGeneral.currModel, fname);      \
+    strcat(fname, YAML_EXT)
+#endif
+
+const char * writeModel()
+{
+  CURRENT_MODEL_FILENAME(fname);
   return writeModelYaml(fname);
+}
+
+StoragePostResult queueModelWrite()
+{
+  if (!storageTaskRunning()) return STORAGE_POST_FAILED;
+
+  CURRENT_MODEL_FILENAME(fname);
+  char path[256];
+  getModelPath(path, fname);
+
+  // the previous model is still being saved: nothing is serialized
+  // until the slot is free
+  if (!storageTaskAccepts(STORAGE_SLOT_MODEL, path)) return STORAGE_POST_BUSY;
+
+  uint32_t len;
+  char* buffer = writeBufferYaml(get_modeldata_nodes(), (uint8_t*)&g_model, 0, &len);
+  if (!buffer) return STORAGE_POST_FAILED;
+
+#if defined(MODEL_CACHE)
+  modelCacheInvalidate(fname);
 #endif
+  return storageTaskPostWrite(STORAGE_SLOT_MODEL, path, nullptr, buffer, len);
 }
 
 #if !defined(STORAGE_MODELSLIST)
@@ -612,5 +722,6 @@ const char * restoreModel(uint8_t idx, char *model_name)
 bool storageReadRadioSettings(bool checks)
 {
   if (!sdMounted()) sdInit();
+  globalFunctionsContext.invalidate();
   return loadRadioSettingsYaml(checks) == nullptr;
 }
@@ -0,0 +1,480 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "storage_bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "timers_driver.h"
+
+#if defined(DISK_CACHE)
+#include "disk_cache.h"
+#endif
+
+#define BENCH_MODELS_PATH     BENCH_PATH "/MODELS"
+#define BENCH_IMAGES_PATH     BENCH_PATH "/IMAGES"
+#define BENCH_WAV_FILE        BENCH_PATH "/sound.wav"
+#define BENCH_LOG_FILE        BENCH_PATH "/log.csv"
+#define BENCH_TMP_FILE        BENCH_PATH "/model.tmp"
+
+#define BENCH_BUFFER_SIZE     4096
+#define BENCH_PATH_LEN        64
+
+// boot scan / model load & save
+#define BENCH_MODELS          30
+#define BENCH_MODEL_SIZE      3000   // typical YAML model
+#define BENCH_MODEL_HEADER    256    // read by the models list scan
+#define BENCH_MODEL_CHUNK     512
+#define BENCH_MODEL_CYCLES    20
+
+// 10 Hz logging for one minute
+#define BENCH_LOG_ROWS        600
+
+// WAV streaming while images are loaded
+#define BENCH_WAV_SIZE        (256 * 1024)
+#define BENCH_WAV_HEADER      44
+#define BENCH_WAV_CHUNK       1024
+#define BENCH_IMAGES          4
+#define BENCH_IMAGE_SIZE      (16 * 1024)
+#define BENCH_IMAGE_CHUNK     1024
+#define BENCH_IMAGE_INTERVAL  4      // WAV chunks per image chunk
+
+// latency histogram: 4 buckets per power of 2
+#define BENCH_BUCKETS         128
+
+const char* const storageBenchWorkloads[] = {
+  "boot", "model", "log", "wav", nullptr,
+};
+
+struct BenchPhase {
+  const char* name;
+  FRESULT result;
+  uint32_t start;
+  uint32_t ops;
+  uint32_t bytes;
+  uint32_t max;
+  uint16_t histogram[BENCH_BUCKETS];
+
+  void begin(const char* phaseName)
+  {
+    memset(this, 0, sizeof(BenchPhase));
+    name = phaseName;
+    start = timersGetUsTick();
+  }
+
+  void add(uint32_t opStart, uint32_t len);
+  uint32_t percentile(uint8_t percent) const;
+  void report(StorageBenchCallback cb, void* ctx) const;
+};
+
+// shared by all workloads: kept off the (CLI) task stack
+static BenchPhase _phases[2];
+static uint8_t* _buffer;
+
+static uint8_t bucketOf(uint32_t us)
+{
+  if (us < 4) return us;
+  uint8_t msb = 31 - __builtin_clz(us);
+  return (msb - 1) * 4 + ((us >> (msb - 2)) & 3);
+}
+
+// upper bound of a bucket
+static uint32_t bucketMax(uint8_t bucket)
+{
+  if (bucket < 4) return bucket;
+  uint8_t msb = bucket / 4 + 1;
+  uint32_t low = (4u + bucket % 4) << (msb - 2);
+  return low + (1u << (msb - 2)) - 1;
+}
+
+void BenchPhase::add(uint32_t opStart, uint32_t len)
+{
+  uint32_t latency = timersGetUsTick() - opStart;
+  uint16_t& count = histogram[bucketOf(latency)];
+  if (count < UINT16_MAX) count++;
+  if (latency > max) max = latency;
+  ops++;
+  bytes += len;
+}
+
+uint32_t BenchPhase::percentile(uint8_t percent) const
+{
+  uint32_t target = (ops * percent + 99) / 100;
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < BENCH_BUCKETS; i++) {
+    total += histogram[i];
+    if (total >= target && total > 0) {
+      uint32_t value = bucketMax(i);
+      return value < max ? value : max;
+    }
+  }
+  return max;
+}
+
+void BenchPhase::report(StorageBenchCallback cb, void* ctx) const
+{
+  StorageBenchResult r;
+  memset(&r, 0, sizeof(r));
+  r.name = name;
+  r.result = result;
+  r.ops = ops;
+  r.bytes = bytes;
+  r.duration = timersGetUsTick() - start;
+  r.p50 = percentile(50);
+  r.p90 = percentile(90);
+  r.p99 = percentile(99);
+  r.max = max;
+#if defined(DISK_CACHE)
+  const DiskCacheStats& stats = diskCache.getStats();
+  r.cacheHits = stats.noHits;
+  r.cacheMisses = stats.noMisses;
+  r.cacheWrites = stats.noWrites;
+#endif
+  cb(r, ctx);
+}
+
+static void modelPath(char* path, uint8_t index)
+{
+  snprintf(path, BENCH_PATH_LEN, BENCH_MODELS_PATH "/model%02u.yml", index);
+}
+
+static void imagePath(char* path, uint8_t index)
+{
+  snprintf(path, BENCH_PATH_LEN, BENCH_IMAGES_PATH "/image%u.png", index);
+}
+
+// deterministic content, different for each file
+static void fillBuffer(uint32_t seed)
+{
+  uint32_t value = seed * 2654435761u + 1;
+  for (uint32_t i = 0; i < BENCH_BUFFER_SIZE; i++) {
+    value = value * 1103515245u + 12345u;
+    _buffer[i] = ' ' + (value >> 16) % 95;
+  }
+}
+
+static FRESULT writeFile(const char* path, uint32_t size, uint32_t seed)
+{
+  FIL file;
+  FRESULT res = f_open(&file, path, FA_CREATE_ALWAYS | FA_WRITE);
+  if (res != FR_OK) return res;
+
+  fillBuffer(seed);
+  while (size > 0 && res == FR_OK) {
+    UINT len = size < BENCH_BUFFER_SIZE ? size : BENCH_BUFFER_SIZE;
+    UINT written;
+    res = f_write(&file, _buffer, len, &written);
+    if (res == FR_OK && written != len) res = FR_DENIED;
+    size -= len;
+  }
+
+  FRESULT closeRes = f_close(&file);
+  return res == FR_OK ? closeRes : res;
+}
+
+static FRESULT benchSetup()
+{
+  char path[BENCH_PATH_LEN];
+
+  FRESULT res = f_mkdir(BENCH_MODELS_PATH);
+  if (res == FR_OK) res = f_mkdir(BENCH_IMAGES_PATH);
+
+  for (uint8_t i = 0; i < BENCH_MODELS && res == FR_OK; i++) {
+    modelPath(path, i);
+    res = writeFile(path, BENCH_MODEL_SIZE, i);
+  }
+
+  for (uint8_t i = 0; i < BENCH_IMAGES && res == FR_OK; i++) {
+    imagePath(path, i);
+    res = writeFile(path, BENCH_IMAGE_SIZE, 100 + i);
+  }
+
+  if (res == FR_OK) res = writeFile(BENCH_WAV_FILE, BENCH_WAV_SIZE, 200);
+  return res;
+}
+
+// only the files the benchmark creates: anything else
+// keeps its folder, which is then left in place
+static void benchCleanup()
+{
+  char path[BENCH_PATH_LEN];
+
+  for (uint8_t i = 0; i < BENCH_MODELS; i++) {
+    modelPath(path, i);
+    f_unlink(path);
+  }
+  for (uint8_t i = 0; i < BENCH_IMAGES; i++) {
+    imagePath(path, i);
+    f_unlink(path);
+  }
+  f_unlink(BENCH_WAV_FILE);
+  f_unlink(BENCH_LOG_FILE);
+  f_unlink(BENCH_TMP_FILE);
+
+  f_unlink(BENCH_MODELS_PATH);
+  f_unlink(BENCH_IMAGES_PATH);
+  f_unlink(BENCH_PATH);
+}
+
+// list the models and read the beginning of each of them,
+// like the models list does on boot
+static void benchBoot(StorageBenchCallback cb, void* ctx)
+{
+  BenchPhase& scan = _phases[0];
+  scan.begin("boot-scan");
+
+  DIR dir;
+  FILINFO fno;
+  char path[BENCH_PATH_LEN];
+
+  scan.result = f_opendir(&dir, BENCH_MODELS_PATH);
+  if (scan.result == FR_OK) {
+    while (true) {
+      uint32_t t0 = timersGetUsTick();
+      // end of the directory: the simulator returns FR_NO_FILE
+      if (f_readdir(&dir, &fno) != FR_OK || !fno.fname[0]) break;
+      if (fno.fattrib & AM_DIR) continue;
+
+      snprintf(path, sizeof(path), BENCH_MODELS_PATH "/%s", fno.fname);
+      FIL file;
+      UINT read = 0;
+      scan.result = f_open(&file, path, FA_OPEN_EXISTING | FA_READ);
+      if (scan.result != FR_OK) break;
+      scan.result = f_read(&file, _buffer, BENCH_MODEL_HEADER, &read);
+      f_close(&file);
+      scan.add(t0, read);
+      if (scan.result != FR_OK) break;
+    }
+    f_closedir(&dir);
+  }
+
+  scan.report(cb, ctx);
+}
+
+// load models, and save them the way the storage task does
+static void benchModel(StorageBenchCallback cb, void* ctx)
+{
+  BenchPhase& load = _phases[0];
+  BenchPhase& save = _phases[1];
+  char path[BENCH_PATH_LEN];
+
+  load.begin("model-load");
+  for (uint8_t i = 0; i < BENCH_MODEL_CYCLES && load.result == FR_OK; i++) {
+    modelPath(path, (i * 7) % BENCH_MODELS);
+
+    uint32_t t0 = timersGetUsTick();
+    FIL file;
+    load.result = f_open(&file, path, FA_OPEN_EXISTING | FA_READ);
+    if (load.result != FR_OK) break;
+
+    uint32_t total = 0;
+    UINT read;
+    do {
+      load.result = f_read(&file, _buffer, BENCH_MODEL_CHUNK, &read);
+      total += read;
+    } while (load.result == FR_OK && read == BENCH_MODEL_CHUNK);
+    f_close(&file);
+    load.add(t0, total);
+  }
+  load.report(cb, ctx);
+
+  save.begin("model-save");
+  fillBuffer(300);
+  for (uint8_t i = 0; i < BENCH_MODEL_CYCLES && save.result == FR_OK; i++) {
+    modelPath(path, (i * 7) % BENCH_MODELS);
+
+    uint32_t t0 = timersGetUsTick();
+    FIL file;
+    save.result = f_open(&file, BENCH_TMP_FILE, FA_CREATE_ALWAYS | FA_WRITE);
+    if (save.result != FR_OK) break;
+
+    UINT written;
+    save.result = f_write(&file, _buffer, BENCH_MODEL_SIZE, &written);
+    FRESULT closeRes = f_close(&file);
+    if (save.result == FR_OK) save.result = closeRes;
+    if (save.result != FR_OK) break;
+
+    f_unlink(path);
+    save.result = f_rename(BENCH_TMP_FILE, path);
+    save.add(t0, written);
+  }
+  save.report(cb, ctx);
+}
+
+// append one row at a time to a log file
+static void benchLog(StorageBenchCallback cb, void* ctx)
+{
+  BenchPhase& log = _phases[0];
+  log.begin("log-append");
+
+  FIL file;
+  log.result = f_open(&file, BENCH_LOG_FILE,
+                      FA_OPEN_ALWAYS | FA_WRITE | FA_OPEN_APPEND);
+
+  for (uint16_t row = 0; row < BENCH_LOG_ROWS && log.result == FR_OK; row++) {
+    char line[128];
+    int len = snprintf(line, sizeof(line),
+                       "2024-01-01,12:%02u:%02u.%u00,%d,%d,%d,%d,%u,%u,%u,"
+                       "%d,%d,%d,%d,-1,0,1,0,-1,1,0x%08X\n",
+                       row / 600, (row / 10) % 60, row % 10, -100 + row % 200,
+                       row % 100, 50 - row % 100, row % 7, 11 + row % 4,
+                       400 + row % 20, 1500 + row, row % 1024, -(row % 1024),
+                       row % 512, row % 256, row * 2654435761u);
+
+    uint32_t t0 = timersGetUsTick();
+    UINT written;
+    log.result = f_write(&file, line, len, &written);
+    log.add(t0, written);
+  }
+
+  FRESULT closeRes = f_close(&file);
+  if (log.result == FR_OK) log.result = closeRes;
+  log.report(cb, ctx);
+}
+
+// stream a WAV file while images are being loaded
+static void benchWav(StorageBenchCallback cb, void* ctx)
+{
+  BenchPhase& wav = _phases[0];
+  BenchPhase& image = _phases[1];
+  wav.begin("wav-stream");
+  image.begin("image-load");
+
+  FIL wavFile, imageFile;
+  bool imageOpen = false;
+  uint8_t imageIndex = 0;
+  uint32_t imageRead = 0;
+  char path[BENCH_PATH_LEN];
+  UINT read;
+
+  uint32_t t0 = timersGetUsTick();
+  wav.result = f_open(&wavFile, BENCH_WAV_FILE, FA_OPEN_EXISTING | FA_READ);
+  if (wav.result == FR_OK)
+    wav.result = f_read(&wavFile, _buffer, BENCH_WAV_HEADER, &read);
+  if (wav.result == FR_OK) wav.add(t0, read);
+
+  for (uint32_t chunk = 0; wav.result == FR_OK && image.result == FR_OK;
+       chunk++) {
+    t0 = timersGetUsTick();
+    wav.result = f_read(&wavFile, _buffer, BENCH_WAV_CHUNK, &read);
+    if (wav.result != FR_OK || read == 0) break;
+    wav.add(t0, read);
+
+    if (chunk % BENCH_IMAGE_INTERVAL) continue;
+
+    t0 = timersGetUsTick();
+    if (!imageOpen) {
+      imagePath(path, imageIndex);
+      imageIndex = (imageIndex + 1) % BENCH_IMAGES;
+      image.result = f_open(&imageFile, path, FA_OPEN_EXISTING | FA_READ);
+      if (image.result != FR_OK) break;
+      imageOpen = true;
+      imageRead = 0;
+    }
+
+    image.result = f_read(&imageFile, _buffer + BENCH_WAV_CHUNK,
+                          BENCH_IMAGE_CHUNK, &read);
+    imageRead += read;
+    if (read < BENCH_IMAGE_CHUNK || imageRead >= BENCH_IMAGE_SIZE) {
+      f_close(&imageFile);
+      imageOpen = false;
+    }
+    image.add(t0, read);
+  }
+
+  if (imageOpen) f_close(&imageFile);
+  f_close(&wavFile);
+
+  wav.report(cb, ctx);
+  image.report(cb, ctx);
+}
+
+static const struct {
+  const char* name;
+  void (*run)(StorageBenchCallback cb, void* ctx);
+} _workloads[] = {
+  {"boot", benchBoot},
+  {"model", benchModel},
+  {"log", benchLog},
+  {"wav", benchWav},
+};
+
+FRESULT storageBenchRun(const char* name, StorageBenchCallback cb, void* ctx)
+{
+  bool all = !strcmp(name, "all");
+  bool found = all;
+  for (const auto& workload : _workloads) {
+    if (!strcmp(workload.name, name)) found = true;
+  }
+  if (!found) return FR_INVALID_PARAMETER;
+
+  // never touch a folder the benchmark has not created
+  FRESULT res = f_mkdir(BENCH_PATH);
+  if (res != FR_OK) return res;
+
+  _buffer = (uint8_t*)malloc(BENCH_BUFFER_SIZE + BENCH_IMAGE_CHUNK);
+  if (!_buffer) {
+    f_unlink(BENCH_PATH);
+    return FR_NOT_ENOUGH_CORE;
+  }
+
+  res = benchSetup();
+
+  for (const auto& workload : _workloads) {
+    if (res != FR_OK) break;
+    if (!all && strcmp(workload.name, name)) continue;
+
+#if defined(DISK_CACHE)
+    // cold cache, and per workload stats
+    diskCache.clear();
+#endif
+    workload.run(cb, ctx);
+  }
+
+  benchCleanup();
+  free(_buffer);
+  _buffer = nullptr;
+
+  return res;
+}
+
+void storageBenchFormat(char* buf, size_t len, const StorageBenchResult& r)
+{
+  uint32_t duration = r.duration ? r.duration : 1;
+  uint32_t iops = (uint64_t)r.ops * 1000000 / duration;
+  uint32_t kbps = (uint64_t)r.bytes * 1000000 / 1024 / duration;
+
+  int pos = snprintf(buf, len,
+                     "%-11s ops:%u iops:%u kB/s:%u p50:%uus p90:%uus "
+                     "p99:%uus max:%uus",
+                     r.name, (unsigned)r.ops, (unsigned)iops, (unsigned)kbps,
+                     (unsigned)r.p50, (unsigned)r.p90, (unsigned)r.p99,
+                     (unsigned)r.max);
+
+  uint32_t reads = r.cacheHits + r.cacheMisses;
+  if (pos > 0 && (size_t)pos < len && (reads || r.cacheWrites)) {
+    uint32_t rate = reads ? r.cacheHits * 1000 / reads : 0;
+    pos += snprintf(buf + pos, len - pos, " cache:%u.%u%% (h:%u m:%u w:%u)",
+                    (unsigned)(rate / 10), (unsigned)(rate % 10),
+                    (unsigned)r.cacheHits, (unsigned)r.cacheMisses,
+                    (unsigned)r.cacheWrites);
+  }
+
+  if (pos > 0 && (size_t)pos < len && r.result != FR_OK) {
+    snprintf(buf + pos, len - pos, " error:%d", r.result);
+  }
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ff.h"
+
+// Storage benchmark: replays fixed workloads modelled on what the
+// firmware does with the SD card, through the regular FatFs API.
+//
+// The workloads run on files generated in BENCH_PATH, which is created
+// before and removed after each run, so that the results depend neither
+// on the card content nor on previous runs. The benchmark refuses to run
+// (FR_EXIST) if BENCH_PATH already exists, and only deletes the files it
+// has created. The disk cache (if any) is cleared before each workload.
+//
+// Available on the radio with the "storagebench" CLI command, and on
+// the host with the "--storage-bench" option of the simulator (against
+// the host file system, or the simulated disk image with SIMU_DISKIO).
+
+#define BENCH_PATH "/BENCH"
+
+struct StorageBenchResult {
+  const char* name;
+  FRESULT result;
+  uint32_t ops;
+  uint32_t bytes;
+  uint32_t duration;     // us, wall time of the workload
+  uint32_t p50;          // us, operation latency percentiles
+  uint32_t p90;
+  uint32_t p99;
+  uint32_t max;
+  uint32_t cacheHits;    // disk cache
+  uint32_t cacheMisses;
+  uint32_t cacheWrites;
+};
+
+typedef void (*StorageBenchCallback)(const StorageBenchResult& result,
+                                     void* ctx);
+
+// Names of the available workloads, nullptr terminated
+extern const char* const storageBenchWorkloads[];
+
+// Run the workload called 'name' ("all" runs all of them in order).
+// 'cb' is called once per measured operation type.
+FRESULT storageBenchRun(const char* name, StorageBenchCallback cb, void* ctx);
+
+// One line summary of 'result'
+void storageBenchFormat(char* buf, size_t len, const StorageBenchResult& result);
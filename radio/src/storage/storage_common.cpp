@@ -25,6 +25,7 @@
 #include "tasks/mixer_task.h"
 #include "mixes.h"
 #include "switches.h"
+#include "name_table.h"
 
 #if defined(FUNCTION_SWITCHES_RGB_LEDS)
 #include "hal/rgbleds.h"
@@ -58,6 +59,13 @@ void storageDirty(uint8_t msk)
   storageDirtyMsk |= msk;
   storageDirtyTime10ms = get_tmr10ms();
 
+  // special functions, module settings or outputs may have been edited
+  if (msk & EE_MODEL) {
+    modelFunctionsContext.invalidate();
+    pulsesInvalidateChannels();
+  }
+  if (msk & EE_GENERAL) globalFunctionsContext.invalidate();
+
 #if defined(RTC_BACKUP_RAM)
   rambackupDirtyMsk = storageDirtyMsk;
   rambackupDirtyTime10ms = storageDirtyTime10ms;
@@ -89,6 +97,9 @@ void preModelLoad()
 
 void postRadioSettingsLoad()
 {
+  // stick, pot and switch names may differ
+  nameTableInvalidate();
+
 #if LCD_W == 128
   // Prevent GVARS to be off when imported or manually modified yaml
   // Since there is no way to have those back
@@ -172,6 +183,11 @@ static void sanitizeMixerLines()
 
 void postModelLoad(bool alarms)
 {
+  modelFunctionsContext.invalidate();
+  nameTableInvalidate();
+  calculatedSensorsInvalidate();
+  pulsesInvalidateChannels();
+
 #if defined(COLORLCD)
   if (!g_model.hasScreenData(0))
     LayoutFactory::loadDefaultLayout();
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "write_queue.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "debug.h"
+
+StorageWriteQueue::StorageWriteQueue(Writer writer, Clock clock) :
+    _writer(writer), _clock(clock)
+{
+}
+
+void StorageWriteQueue::init()
+{
+  mutex_create(&_mutex);
+}
+
+uint8_t StorageWriteQueue::_depth() const
+{
+  uint8_t depth = 0;
+  for (const auto& slot : _slots) {
+    if (slot.data) depth++;
+  }
+  return depth;
+}
+
+bool StorageWriteQueue::accepts(StorageWriteSlot slot, const char* path)
+{
+  mutex_lock(&_mutex);
+  const auto& s = _slots[slot];
+  bool result = !s.data || strcmp(s.path, path) == 0;
+  mutex_unlock(&_mutex);
+  return result;
+}
+
+bool StorageWriteQueue::post(StorageWriteSlot slot, const char* path,
+                             const char* tmpPath, char* data, uint32_t len)
+{
+  mutex_lock(&_mutex);
+  auto& s = _slots[slot];
+  if (s.data && strcmp(s.path, path) != 0) {
+    // never drop a snapshot of another file
+    mutex_unlock(&_mutex);
+    return false;
+  }
+
+  if (s.data) {
+    // keep the original post time of a coalesced write:
+    // latency is measured from the first unsaved change
+    free(s.data);
+    _stats.coalesced++;
+  } else {
+    s.postTime = _clock();
+  }
+  s.data = data;
+  s.len = len;
+  s.retryTime = s.postTime;
+  s.attempts = 0;
+  s.tmpPath = tmpPath;
+  strncpy(s.path, path, STORAGE_WRITE_PATH_LEN - 1);
+  s.path[STORAGE_WRITE_PATH_LEN - 1] = '\0';
+
+  uint8_t depth = _depth();
+  if (depth > _stats.maxQueueDepth) _stats.maxQueueDepth = depth;
+  mutex_unlock(&_mutex);
+
+  return true;
+}
+
+void StorageWriteQueue::process()
+{
+  while (true) {
+    uint32_t now = _clock();
+
+    mutex_lock(&_mutex);
+    int index = -1;
+    for (int i = 0; i < STORAGE_SLOT_COUNT; i++) {
+      const auto& s = _slots[i];
+      if (s.data && (int32_t)(now - s.retryTime) >= 0) {
+        index = i;
+        break;
+      }
+    }
+    if (index < 0) {
+      mutex_unlock(&_mutex);
+      return;
+    }
+
+    // take the snapshot out of the slot: a newer one
+    // may be posted while this one is being written
+    Write& slot = _slots[index];
+    Write job = slot;
+    slot.data = nullptr;
+    _inProgress = index;
+    mutex_unlock(&_mutex);
+
+    FRESULT result = _writer(job.path, job.tmpPath, job.data, job.len);
+    now = _clock();
+
+    mutex_lock(&_mutex);
+    _inProgress = -1;
+    if (result == FR_OK) {
+      free(job.data);
+      _results[index] = STORAGE_WRITE_DONE;
+      _stats.writes++;
+      _stats.lastLatency = now - job.postTime;
+      if (_stats.lastLatency > _stats.maxLatency)
+        _stats.maxLatency = _stats.lastLatency;
+      TRACE("storage: %s written (%u bytes, %u ms)", job.path, job.len,
+            _stats.lastLatency);
+    } else {
+      _stats.errors++;
+      TRACE("storage: %s write error=%d", job.path, result);
+      if (slot.data) {
+        // a newer snapshot has been posted meanwhile
+        free(job.data);
+      } else if (++job.attempts <= STORAGE_WRITE_RETRIES) {
+        job.retryTime = now + STORAGE_WRITE_RETRY_DELAY;
+        slot = job;
+      } else {
+        free(job.data);
+        _results[index] = STORAGE_WRITE_FAILED;
+        _stats.failed++;
+        TRACE("storage: %s given up", job.path);
+      }
+    }
+    mutex_unlock(&_mutex);
+
+    if (result != FR_OK) return;
+  }
+}
+
+bool StorageWriteQueue::pending(StorageWriteSlot slot)
+{
+  mutex_lock(&_mutex);
+  bool result = _slots[slot].data || _inProgress == slot;
+  mutex_unlock(&_mutex);
+  return result;
+}
+
+bool StorageWriteQueue::pending()
+{
+  mutex_lock(&_mutex);
+  bool result = _inProgress >= 0 || _depth() > 0;
+  mutex_unlock(&_mutex);
+  return result;
+}
+
+StorageWriteResult StorageWriteQueue::takeResult(StorageWriteSlot slot)
+{
+  mutex_lock(&_mutex);
+  auto result = _results[slot];
+  _results[slot] = STORAGE_WRITE_NONE;
+  mutex_unlock(&_mutex);
+  return result;
+}
+
+uint8_t StorageWriteQueue::depth()
+{
+  mutex_lock(&_mutex);
+  uint8_t result = _depth();
+  mutex_unlock(&_mutex);
+  return result;
+}
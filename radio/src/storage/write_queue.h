@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "ff.h"
+#include "os/task.h"
+
+// Pending file writes of the storage task (see tasks/storage_task.h).
+//
+// Each slot holds at most one pending write: posting a newer snapshot
+// for a slot drops the older one that has not been written yet. A failed
+// write is retried STORAGE_WRITE_RETRIES times, then dropped and reported
+// as failed to the owner of the slot.
+
+#define STORAGE_WRITE_PATH_LEN     48
+#define STORAGE_WRITE_RETRIES      3
+#define STORAGE_WRITE_RETRY_DELAY  1000  // ms
+
+enum StorageWriteSlot {
+  STORAGE_SLOT_RADIO = 0,
+  STORAGE_SLOT_MODEL,
+  STORAGE_SLOT_COUNT
+};
+
+enum StoragePostResult {
+  STORAGE_POST_QUEUED = 0,  // the storage task will write it
+  STORAGE_POST_BUSY,        // another file is pending in the slot: retry later
+  STORAGE_POST_FAILED,      // can not be queued, write it synchronously
+};
+
+enum StorageWriteResult {
+  STORAGE_WRITE_NONE = 0,  // nothing written since the last call
+  STORAGE_WRITE_DONE,      // the last snapshot posted was written
+  STORAGE_WRITE_FAILED,    // a snapshot was given up
+};
+
+struct StorageWriteStats {
+  uint32_t writes;       // files written
+  uint32_t coalesced;    // snapshots replaced before being written
+  uint32_t errors;       // failed attempts
+  uint32_t failed;       // snapshots given up after all retries
+  uint32_t lastLatency;  // ms from post to completion of the last write
+  uint32_t maxLatency;
+  uint8_t maxQueueDepth;
+};
+
+class StorageWriteQueue
+{
+ public:
+  typedef FRESULT (*Writer)(const char* path, const char* tmpPath,
+                            const char* data, uint32_t len);
+  typedef uint32_t (*Clock)();
+
+  StorageWriteQueue(Writer writer, Clock clock);
+
+  // to be called once, before any other method (creates the mutex)
+  void init();
+
+  // A write of 'path' can be posted to 'slot' now: the slot is free,
+  // or holds an older snapshot of the same file
+  bool accepts(StorageWriteSlot slot, const char* path);
+
+  // Takes ownership of 'data' (malloc'ed). Returns false, without taking
+  // it, if the slot still holds a write to another file: the caller must
+  // post again once it has been written.
+  bool post(StorageWriteSlot slot, const char* path, const char* tmpPath,
+            char* data, uint32_t len);
+
+  // Write the slots that are due, radio settings first. Returns when
+  // none is left, or after a failed attempt.
+  void process();
+
+  // A write is queued or in progress (for 'slot', or for any slot)
+  bool pending(StorageWriteSlot slot);
+  bool pending();
+
+  // Outcome of the writes of 'slot' since the previous call
+  StorageWriteResult takeResult(StorageWriteSlot slot);
+
+  uint8_t depth();
+  const StorageWriteStats& stats() const { return _stats; }
+
+ protected:
+  struct Write {
+    char* data;
+    uint32_t len;
+    uint32_t postTime;
+    uint32_t retryTime;
+    uint8_t attempts;
+    const char* tmpPath;
+    char path[STORAGE_WRITE_PATH_LEN];
+  };
+
+  Writer _writer;
+  Clock _clock;
+
+  // protects everything below
+  mutex_handle_t _mutex;
+  Write _slots[STORAGE_SLOT_COUNT] = {};
+  StorageWriteResult _results[STORAGE_SLOT_COUNT] = {};
+  int8_t _inProgress = -1;
+  StorageWriteStats _stats = {};
+
+  uint8_t _depth() const;
+};
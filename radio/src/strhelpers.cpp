@@ -29,6 +29,7 @@
 #include "hal/switch_driver.h"
 #include "edgetx.h"
 #include "switches.h"
+#include "name_table.h"
 
 static char _static_str_buffer[32];
 static const char s_charTab[] = "_-.,";
@@ -550,8 +551,7 @@ int getSwitchIndex(const char* name, bool all)
         if (!strcasecmp(s, name))
           return negate ? -idx : idx;
       }
-      s = getSwitchPositionName(idx);
-      if (!strcasecmp(s, name))
+      if (!strcasecmp(switchNameLookup(idx), name))
         return negate ? -idx : idx;
     }
   }
@@ -838,7 +838,8 @@ bool sourceCanHaveCustomName(mixsrc_t idx)
 
 bool matchSource(const char* name, mixsrc_t idx, bool defaultOnly)
 {
-  char *s = getSourceString(idx, defaultOnly);
+  const char *s =
+      defaultOnly ? getSourceString(idx, true) : sourceNameLookup(idx);
   if (strcasecmp(s, name) == 0)
     return true;
   // Check for names starting with CHAR_xxx symbol strings
@@ -53,6 +53,10 @@ volatile uint8_t btChipPresent = 0;
 
 void* _bt_usart_ctx = nullptr;
 
+// kept over re-inits (baudrate changes)
+static void (*_bt_idle_cb)(void*) = nullptr;
+static void* _bt_idle_ctx = nullptr;
+
 void bluetoothInit(uint32_t baudrate, bool enable)
 {
 #if defined(BT_EN_GPIO)
@@ -76,6 +80,10 @@ void bluetoothInit(uint32_t baudrate, bool enable)
     STM32SerialDriver.setBaudrate(_bt_usart_ctx, baudrate);
   }
 
+  if (_bt_idle_cb) {
+    STM32SerialDriver.setIdleCb(_bt_usart_ctx, _bt_idle_cb, _bt_idle_ctx);
+  }
+
 #if defined(BT_EN_GPIO)
   gpio_write(BT_EN_GPIO, !enable);
 #endif
@@ -111,6 +119,25 @@ int bluetoothRead(uint8_t* data)
   return STM32SerialDriver.getByte(_bt_usart_ctx, data);
 }
 
+// Returns the number of bytes read (0 if none)
+int bluetoothReadBuffer(uint8_t* buffer, uint32_t len)
+{
+  if (!_bt_usart_ctx) return 0;
+  int result = STM32SerialDriver.copyRxBuffer(_bt_usart_ctx, buffer, len);
+  return result > 0 ? result : 0;
+}
+
+// 'on_idle' is called from the USART IRQ when the line
+// gets idle after some bytes have been received
+void bluetoothSetIdleCb(void (*on_idle)(void*), void* ctx)
+{
+  _bt_idle_cb = on_idle;
+  _bt_idle_ctx = ctx;
+  if (_bt_usart_ctx) {
+    STM32SerialDriver.setIdleCb(_bt_usart_ctx, on_idle, ctx);
+  }
+}
+
 uint8_t bluetoothIsWriting(void)
 {
   if (!_bt_usart_ctx)
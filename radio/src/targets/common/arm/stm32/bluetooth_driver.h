@@ -37,6 +37,8 @@
 void bluetoothInit(uint32_t baudrate, bool enable);
 void bluetoothWrite(const void* buffer, uint32_t length);
 int bluetoothRead(uint8_t* data);
+int bluetoothReadBuffer(uint8_t* buffer, uint32_t len);
+void bluetoothSetIdleCb(void (*on_idle)(void*), void* ctx);
 uint8_t bluetoothIsWriting();
 void bluetoothDisable();
 
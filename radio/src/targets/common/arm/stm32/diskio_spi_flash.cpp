@@ -119,15 +119,8 @@ static DSTATUS spi_flash_status (BYTE lun)
 static DRESULT spi_flash_read(BYTE lun, BYTE * buff, DWORD sector, UINT count)
 {
 #if defined(USE_FLASH_FTL)
-  while(frftlInitDone && count) {
-
-    if(!ftlRead(&_frftl, sector, (uint8_t*)buff)) {
-      return RES_ERROR;
-    }
- 
-    buff += 512;
-    sector++;
-    count --;
+  if (frftlInitDone && !ftlReadSectors(&_frftl, sector, count, (uint8_t*)buff)) {
+    return RES_ERROR;
   }
 #else
   flashSpiRead((uint32_t)sector * 512, buff, count * 512);
@@ -203,6 +196,17 @@ static DRESULT spi_flash_ioctl(BYTE lun, BYTE ctrl, void *buff)
   return res;
 }
 
+// erase the pages freed so far ahead of the next writes,
+// one block at a time, while nothing else uses the flash
+static void spi_flash_idle(BYTE lun)
+{
+#if defined(USE_FLASH_FTL)
+  if (frftlInitDone) {
+    ftlReclaim(&_frftl);
+  }
+#endif
+}
+
 void spiFlashDiskEraseAll()
 {
 #if defined(USE_FLASH_FTL)
@@ -220,4 +224,5 @@ const diskio_driver_t spi_flash_diskio_driver = {
   .read = spi_flash_read,
   .write = spi_flash_write,
   .ioctl = spi_flash_ioctl,
+  .idle = spi_flash_idle,
 };
@@ -24,6 +24,7 @@ extern "C" {
 /* Includes ------------------------------------------------------------------*/
 #include "usb_conf.h"
 #include "usbd_cdc.h"
+#include <string.h>
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -338,6 +339,28 @@ void usbSerialPutc(void*, uint8_t c)
   if (!prim) __enable_irq();
 }
 
+// Queue a whole buffer at once: the data is either queued
+// completely or dropped, so that framed binary data is never cut.
+// Check getTxFreeSpace() first to know whether it will be dropped.
+void usbSerialSendBuffer(void*, const uint8_t* data, uint32_t size)
+{
+  if (!cdcConnected) return;
+
+  uint32_t prim = __get_PRIMASK();
+  __disable_irq();
+
+  if (usbSerialFreeSpace() >= size) {
+    uint32_t in = APP_Tx_ptr_in;
+    uint32_t chunk = APP_TX_DATA_SIZE - in;
+    if (chunk > size) chunk = size;
+    memcpy(&UserTxBufferFS[in], data, chunk);
+    memcpy(UserTxBufferFS, data + chunk, size - chunk);
+    APP_Tx_ptr_in = (in + size) % APP_TX_DATA_SIZE;
+  }
+
+  if (!prim) __enable_irq();
+}
+
 /**
   * @brief  Data received over USB OUT endpoint are sent over CDC interface
   *         through this function.
@@ -391,6 +414,12 @@ void usbSerialSetBaudRateCb(void*, void (*cb)(uint32_t))
 //   ctrlLineStateCb = cb;
 // }
 
+static uint32_t usbSerialTxFreeSpace(void*)
+{
+  // anything sent while disconnected is dropped
+  return cdcConnected ? usbSerialFreeSpace() : 0;
+}
+
 static void* usbSerialInit(void*, const etx_serial_init*)
 {
   // always succeeds
@@ -401,7 +430,8 @@ static const etx_serial_driver_t usbSerialDriver = {
   .init = usbSerialInit,
   .deinit = nullptr,
   .sendByte = usbSerialPutc,
-  .sendBuffer = nullptr,
+  .sendBuffer = usbSerialSendBuffer,
+  .getTxFreeSpace = usbSerialTxFreeSpace,
   .waitForTxCompleted = nullptr,
   .getByte = nullptr,
   .clearRxBuffer = nullptr,
@@ -24,6 +24,9 @@ bool ArgumentParser::parse(int argc, char *argv[]) {
     } else if (arg == "--settings") {
       if (!getNextArg(argc, argv, i, settings_path, "settings"))
         return false;
+    } else if (arg == "--storage-bench") {
+      if (!getNextArg(argc, argv, i, storage_bench, "storage-bench"))
+        return false;
     } else if (arg == "-h" || arg == "--help") {
       help_requested = true;
       return true;
@@ -38,7 +41,7 @@ bool ArgumentParser::parse(int argc, char *argv[]) {
 
 void ArgumentParser::printUsage() const {
   printf("usage: %s [--width width] [--height height] [--storage path] "
-         "[--settings path] [-h | --help]\n",
+         "[--settings path] [--storage-bench workload] [-h | --help]\n",
          program_name.c_str());
 }
 
@@ -49,6 +52,9 @@ void ArgumentParser::printHelp() const {
   printf("  --height height    Set the height (integer)\n");
   printf("  --storage path     Set the storage path\n");
   printf("  --settings path    Set the settings path\n");
+  printf("  --storage-bench workload\n");
+  printf("                     Run a storage benchmark workload (boot, model,\n");
+  printf("                     log, wav or all) on the storage and exit\n");
   printf("  -h, --help         Show this help message\n");
 }
 
@@ -66,6 +72,10 @@ const std::string &ArgumentParser::getSettingsPath() const {
   return settings_path;
 }
 
+const std::string &ArgumentParser::getStorageBench() const {
+  return storage_bench;
+}
+
 bool ArgumentParser::hasWidth() const { return width != -1; }
 
 bool ArgumentParser::hasHeight() const { return height != -1; }
@@ -74,6 +84,8 @@ bool ArgumentParser::hasStoragePath() const { return !storage_path.empty(); }
 
 bool ArgumentParser::hasSettingsPath() const { return !settings_path.empty(); }
 
+bool ArgumentParser::hasStorageBench() const { return !storage_bench.empty(); }
+
 bool ArgumentParser::getNextArg(int argc, char *argv[], int &i,
                                 std::string &value,
                                 const std::string &option_name) {
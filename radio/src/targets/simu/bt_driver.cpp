@@ -19,12 +19,82 @@
  * GNU General Public License for more details.
  */
 
-#include "fifo.h"
+#include "bluetooth_driver.h"
+#include "simulib.h"
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+
+// The module is bridged to the host serial port SIMU_BT_SERIAL_PORT.
+// Each buffer received from the host is handled as one burst of the
+// module, followed by an idle line.
+
+static std::mutex _rxMutex;
+static std::deque<uint8_t> _rxQueue;
+static bool _enabled = false;
+
+static void (*_idleCb)(void*) = nullptr;
+static void* _idleCtx = nullptr;
+static void (*_sendCb)(const uint8_t*, uint32_t) = nullptr;
+
+void bluetoothInit(unsigned int, bool) { _enabled = true; }
+
+void bluetoothWrite(const void* buffer, uint32_t len)
+{
+  if (!_enabled) return;
+#if defined(__wasm__)
+  simuAuxSerialSendBuffer(SIMU_BT_SERIAL_PORT, (const uint8_t*)buffer, len);
+#endif
+  if (_sendCb) _sendCb((const uint8_t*)buffer, len);
+}
+
+int bluetoothRead(uint8_t* data)
+{
+  std::lock_guard<std::mutex> lock(_rxMutex);
+  if (_rxQueue.empty()) return 0;
+  *data = _rxQueue.front();
+  _rxQueue.pop_front();
+  return 1;
+}
+
+int bluetoothReadBuffer(uint8_t* buffer, uint32_t len)
+{
+  std::lock_guard<std::mutex> lock(_rxMutex);
+  uint32_t count = std::min<uint32_t>(len, _rxQueue.size());
+  std::copy_n(_rxQueue.begin(), count, buffer);
+  _rxQueue.erase(_rxQueue.begin(), _rxQueue.begin() + count);
+  return count;
+}
+
+void bluetoothSetIdleCb(void (*on_idle)(void*), void* ctx)
+{
+  _idleCb = on_idle;
+  _idleCtx = ctx;
+}
+
+void bluetoothDisable()
+{
+  _enabled = false;
+  std::lock_guard<std::mutex> lock(_rxMutex);
+  _rxQueue.clear();
+}
 
-void bluetoothInit(unsigned int, bool) {}
-void bluetoothWrite(const void*, uint32_t) {}
-int bluetoothRead(uint8_t*) { return 0; }
-void bluetoothDisable() {}
 uint8_t bluetoothIsWriting() { return false; }
 volatile uint8_t btChipPresent;
 
+void simuBluetoothReceive(const uint8_t* data, uint32_t len)
+{
+  if (!_enabled) return;
+  {
+    std::lock_guard<std::mutex> lock(_rxMutex);
+    _rxQueue.insert(_rxQueue.end(), data, data + len);
+  }
+  if (_idleCb) _idleCb(_idleCtx);
+}
+
+void simuBluetoothSetSendCb(void (*cb)(const uint8_t* data, uint32_t len))
+{
+  _sendCb = cb;
+}
+
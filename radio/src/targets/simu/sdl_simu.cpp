@@ -77,6 +77,7 @@
 #include "edgetx.h"
 
 #include "arg_parser.h"
+#include "storage/storage_bench.h"
 
 #define TIMER_INTERVAL 10 // 10ms
 
@@ -683,6 +684,34 @@ int find_input_mode()
   return default_input_mode();
 }
 
+static void printStorageBenchResult(const StorageBenchResult& result, void*)
+{
+  char line[160];
+  storageBenchFormat(line, sizeof(line), result);
+  printf("%s\n", line);
+}
+
+static int runStorageBench(const ArgumentParser& args)
+{
+  simuInit();
+  simuFatfsSetPaths(args.getStoragePath().c_str(),
+                    args.getSettingsPath().c_str());
+  sdInit();
+
+  FRESULT res = storageBenchRun(args.getStorageBench().c_str(),
+                                printStorageBenchResult, nullptr);
+  if (res == FR_INVALID_PARAMETER) {
+    printf("Unknown workload: %s\n", args.getStorageBench().c_str());
+  } else if (res == FR_EXIST) {
+    printf("%s already exists, not running the benchmark\n", BENCH_PATH);
+  } else if (res != FR_OK) {
+    printf("Storage benchmark setup failed: %d\n", res);
+  }
+
+  sdDone();
+  return res == FR_OK ? 0 : 1;
+}
+
 int main(int argc, char* argv[])
 {
   auto progname = std::filesystem::path(argv[0]).filename();
@@ -697,6 +726,10 @@ int main(int argc, char* argv[])
     return 0;
   }
 
+  if (args.hasStorageBench()) {
+    return runStorageBench(args);
+  }
+
   int window_height = 600;
   if (args.hasHeight()) {
     window_height = args.getHeight();
@@ -638,6 +638,7 @@ FRESULT f_getfree(const TCHAR* path, DWORD* nclst, FATFS** fatfs)
 void storageInit() {}
 void storageDeInit() {}
 void storagePreMountHook() {}
+void storageIdle() {}
 bool storageIsPresent() { return true; }
 
 #endif  // #if defined(SIMU_USE_SDCARD)
@@ -23,11 +23,64 @@
 #include "simulcd.h"
 #include "simulib.h"
 #include "rtos.h"
+#include "debug.h"
 #include <string.h>
+#include <algorithm>
+#include <mutex>
 #include <utility>
 
 bool simuLcdRefresh = false;
 
+// written by the UI task, consumed by the host
+static std::mutex _dirtyMutex;
+static rect_t _dirtyRects[SIMU_LCD_MAX_DIRTY_RECTS];
+static uint32_t _dirtyCount = 0;
+
+static void _addToBoundingBox(rect_t& box, const rect_t& rect)
+{
+  coord_t x2 = std::max(box.x + box.w, rect.x + rect.w);
+  coord_t y2 = std::max(box.y + box.h, rect.y + rect.h);
+  box.x = std::min(box.x, rect.x);
+  box.y = std::min(box.y, rect.y);
+  box.w = x2 - box.x;
+  box.h = y2 - box.y;
+}
+
+static void _mergeDirtyRects(rect_t* rects, uint32_t& count)
+{
+  for (uint32_t i = 1; i < count; i++) {
+    _addToBoundingBox(rects[0], rects[i]);
+  }
+  if (count > 1) count = 1;
+}
+
+void simuLcdMarkDirty(const rect_t& rect)
+{
+  if (rect.w <= 0 || rect.h <= 0) return;
+
+  std::lock_guard<std::mutex> lock(_dirtyMutex);
+  if (_dirtyCount == SIMU_LCD_MAX_DIRTY_RECTS) {
+    _mergeDirtyRects(_dirtyRects, _dirtyCount);
+    _addToBoundingBox(_dirtyRects[0], rect);
+    return;
+  }
+  _dirtyRects[_dirtyCount++] = rect;
+}
+
+uint32_t simuLcdTakeDirtyRects(rect_t* rects, uint32_t maxRects)
+{
+  if (maxRects == 0) return 0;
+
+  std::lock_guard<std::mutex> lock(_dirtyMutex);
+  uint32_t count = _dirtyCount;
+  if (count > maxRects) {
+    _mergeDirtyRects(_dirtyRects, count);
+  }
+  memcpy(rects, _dirtyRects, count * sizeof(rect_t));
+  _dirtyCount = 0;
+  return count;
+}
+
 void toplcdOff() {}
 
 #if !defined(lcdOff)
@@ -42,9 +95,30 @@ void lcdInit() {}
 
 void lcdRefresh()
 {
+#if defined(LCD_CHANGED_PAGES_REFRESH)
+  // Same transfers as the radio: only the changed columns of each page
+  bool changed = false;
+  for (coord_t page = 0; page < LCD_H / 8; page++) {
+    coord_t first, last;
+    if (!lcdGetChangedColumns(page, first, last)) continue;
+    memcpy(&simuLcdBuf[page * LCD_W + first], &displayBuf[page * LCD_W + first],
+           (last - first + 1) * sizeof(pixel_t));
+    simuLcdMarkDirty({first, page * 8, last - first + 1, 8});
+    changed = true;
+  }
+
+  if (lcdRefreshStats.frames && (lcdRefreshStats.frames & 0x3FF) == 0) {
+    TRACE("LCD: %u bytes/frame",
+          lcdRefreshStats.bytes / lcdRefreshStats.frames);
+  }
+
+  if (!changed) return;
+#else
   memcpy(simuLcdBuf, displayBuf, DISPLAY_BUFFER_SIZE * sizeof(pixel_t));
 
   // Mark screen dirty and notify host for async refresh
+  simuLcdMarkDirty({0, 0, LCD_W, LCD_H});
+#endif
   simuLcdRefresh = true;
   simuLcdNotify();
 }
@@ -96,6 +170,19 @@ static void _copy_area(uint16_t* dst, uint16_t* src, const rect_t& copy_area)
 pixel_t* simuLcdBuf = nullptr;
 #endif
 
+// Report the areas LVGL has redrawn in this frame
+static void _markRefreshedAreas()
+{
+  lv_disp_t* disp = _lv_refr_get_disp_refreshing();
+  for (int i = 0; i < disp->inv_p; i++) {
+    if (disp->inv_area_joined[i]) continue;
+
+    const lv_area_t& area = disp->inv_areas[i];
+    simuLcdMarkDirty({area.x1, area.y1, area.x2 - area.x1 + 1,
+                      area.y2 - area.y1 + 1});
+  }
+}
+
 static void simuRefreshLcd(lv_disp_drv_t * disp_drv, uint16_t *buffer, const rect_t& copy_area)
 {
 #if !LCD_VERTICAL_INVERT // rename into "Use direct mode" ???
@@ -105,6 +192,7 @@ static void simuRefreshLcd(lv_disp_drv_t * disp_drv, uint16_t *buffer, const rec
   simuLcdBuf = buffer;
 
   // Trigger async refresh and notify host
+  _markRefreshedAreas();
   simuLcdRefresh = true;
   simuLcdNotify();
 
@@ -122,6 +210,7 @@ static void simuRefreshLcd(lv_disp_drv_t * disp_drv, uint16_t *buffer, const rec
     }
 
     // Trigger async refresh and notify host
+    _markRefreshedAreas();
     simuLcdRefresh = true;
     simuLcdNotify();
 
@@ -27,6 +27,14 @@
 extern int g_snapshot_idx;
 extern bool simuLcdRefresh;
 
+// Areas of simuLcdBuf changed since the host last copied it
+#define SIMU_LCD_MAX_DIRTY_RECTS 16
+
+void simuLcdMarkDirty(const rect_t& rect);
+// Moves up to 'maxRects' dirty areas to 'rects' (merged into their
+// bounding box if there are more) and returns their number.
+uint32_t simuLcdTakeDirtyRects(rect_t* rects, uint32_t maxRects);
+
 #if defined(COLORLCD)
 extern pixel_t* simuLcdBuf;
 #else
@@ -44,6 +44,7 @@
 #if defined(LUA)
 #include "lua/lua_api.h"
 #endif
+#include "tasks/mixer_task.h"
 
 #include <assert.h>
 #include <clocale>
@@ -291,6 +292,26 @@ uint32_t simuLcdGetHeight()
   return LCD_H;
 }
 
+uint8_t* simuLcdGetBuffer()
+{
+  return (uint8_t*)simuLcdBuf;
+}
+
+uint32_t simuLcdGetDirtyRects(uint16_t* rects, uint32_t maxRects)
+{
+  rect_t dirty[SIMU_LCD_MAX_DIRTY_RECTS];
+  if (maxRects > SIMU_LCD_MAX_DIRTY_RECTS) maxRects = SIMU_LCD_MAX_DIRTY_RECTS;
+
+  uint32_t count = simuLcdTakeDirtyRects(dirty, maxRects);
+  for (uint32_t i = 0; i < count; i++) {
+    *rects++ = dirty[i].x;
+    *rects++ = dirty[i].y;
+    *rects++ = dirty[i].w;
+    *rects++ = dirty[i].h;
+  }
+  return count;
+}
+
 uint32_t simuLcdGetDepth()
 {
 #if defined(COLORLCD)
@@ -576,6 +597,12 @@ const etx_serial_driver_t host_drv = {
 
 void simuAuxSerialReceive(uint8_t port_nr, const uint8_t* data, uint32_t len)
 {
+#if defined(BLUETOOTH)
+  if (port_nr == SIMU_BT_SERIAL_PORT && data != nullptr) {
+    simuBluetoothReceive(data, len);
+    return;
+  }
+#endif
   if (port_nr >= MAX_AUX_SERIAL || data == nullptr || len == 0) return;
   auto& port = hostSerialPorts[port_nr];
   mutex_lock(&port.rxMutex);
@@ -834,6 +861,11 @@ uint8_t simuGetMixCount()
   return getMixCount();
 }
 
+uint32_t simuGetMixerCycles()
+{
+  return mixerTaskCycles();
+}
+
 uint8_t simuGetNumLogicalSwitches()
 {
   return MAX_LOGICAL_SWITCHES;
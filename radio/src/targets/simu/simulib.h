@@ -77,6 +77,15 @@ uint32_t WASM_EXPORT(simuLcdGetWidth)();
 uint32_t WASM_EXPORT(simuLcdGetHeight)();
 uint32_t WASM_EXPORT(simuLcdGetDepth)();
 
+// Dirty-region transfer: instead of simuLcdCopy(), the host may read the
+// framebuffer in place (simuLcdGetBuffer() returns its address, valid
+// until simuLcdFlushed()) and copy only the areas reported by
+// simuLcdGetDirtyRects(). Each area is 4 uint16_t (x, y, w, h); areas
+// not yet read are merged into their bounding box when more than
+// maxRects are pending. Returns the number of areas, 0 if nothing changed.
+uint8_t* WASM_EXPORT(simuLcdGetBuffer)();
+uint32_t WASM_EXPORT(simuLcdGetDirtyRects)(uint16_t* rects, uint32_t maxRects);
+
 // Rotary encoder: positive steps = clockwise. The firmware handles
 // mode inversion and key translation internally.
 void WASM_EXPORT(simuRotaryEncoderEvent)(int32_t steps);
@@ -132,6 +141,9 @@ bool     WASM_EXPORT(simuIsChannelUsed)(uint8_t channel);
 int      WASM_EXPORT(simuGetChannelsUsed)();
 uint8_t  WASM_EXPORT(simuGetMixCount)();
 
+// Number of mixer computations since boot (host-side benchmarks).
+uint32_t WASM_EXPORT(simuGetMixerCycles)();
+
 // Bulk copy logical switch states into buf (uint8_t[], 0 or 1). Returns count.
 uint8_t  WASM_EXPORT(simuGetNumLogicalSwitches)();
 uint8_t  WASM_EXPORT(simuCopyLogicalSwitches)(uint8_t* buf, uint8_t maxCount);
@@ -150,7 +162,8 @@ uint8_t  WASM_EXPORT(simuGetNumFlightModes)();
 int32_t  WASM_EXPORT(simuGetGVar)(uint8_t gv, uint8_t fm);
 
 // Aux serial: push bytes received from a host serial port into the firmware's
-// rx queue for the matching aux port (port_nr is 0 for AUX1, 1 for AUX2).
+// rx queue for the matching aux port (port_nr is 0 for AUX1, 1 for AUX2,
+// SIMU_BT_SERIAL_PORT for the Bluetooth module).
 void WASM_EXPORT(simuAuxSerialReceive)(uint8_t port_nr, const uint8_t* data,
                                        uint32_t len);
 
@@ -193,6 +206,14 @@ void WASM_IMPORT(simuAuxSerialSendBuffer)(uint8_t port_nr, const uint8_t* data,
 
 // -- Internal (not exported) --
 
+// Host serial bridge port of the Bluetooth module (after AUX1 and AUX2)
+#define SIMU_BT_SERIAL_PORT  2
+
+// Bluetooth module bridge: bytes received from the host, and sent by
+// the firmware (a callback for the native builds, where there is no host)
+void simuBluetoothReceive(const uint8_t* data, uint32_t len);
+void simuBluetoothSetSendCb(void (*cb)(const uint8_t* data, uint32_t len));
+
 // Use instead of localtime()/mktime(): applies simuStart()'s utcOffset on WASM.
 bool simuLocalTime(time_t t, struct tm* result);
 time_t simuLocalTimeToEpoch(struct tm* tm);
@@ -21,7 +21,15 @@
 
 #include "timers_driver.h"
 
+#include <chrono>
+
 void watchdogSuspend(unsigned int) {}
 uint32_t timersGetMsTick() { return 0; }
-uint32_t timersGetUsTick() { return 0; }
+uint32_t timersGetUsTick()
+{
+  static auto _start = std::chrono::steady_clock::now();
+  auto now = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(now - _start)
+      .count();
+}
 
@@ -54,6 +54,17 @@
 #define LCD_RST_HIGH()  gpio_set(LCD_RST_GPIO)
 #define LCD_RST_LOW()   gpio_clear(LCD_RST_GPIO)
 
+// First display RAM column of the screen
+#if defined(SSD1309_LCD)
+  #define LCD_FIRST_COLUMN               0
+#elif !LCD_VERTICAL_INVERT
+  #define LCD_FIRST_COLUMN               4
+#elif defined(LCD_W_OFFSET)
+  #define LCD_FIRST_COLUMN               LCD_W_OFFSET
+#else
+  #define LCD_FIRST_COLUMN               0
+#endif
+
 bool lcdInitFinished = false;
 void lcdInitFinish();
 
@@ -270,20 +281,21 @@ void lcdRefresh(bool wait)
   }
 
 #if LCD_W == 128
-  uint8_t * p = displayBuf;
-#if defined(LCD_W_OFFSET)
-  lcdWriteCommand(LCD_W_OFFSET);
-#endif
-  for (uint8_t y=0; y < 8; y++, p+=LCD_W) {
+  for (uint8_t y=0; y < 8; y++) {
+    // only the columns changed since the last refresh
+    coord_t first, last;
+    if (!lcdGetChangedColumns(y, first, last)) {
+      continue;
+    }
+
 #if defined(SSD1309_LCD)
     lcdPageSet(y);
-    lcdColumnSet(0);
+    lcdColumnSet(first);
 #else
-    lcdWriteCommand(0x10); // Column addr 0
+    uint8_t column = LCD_FIRST_COLUMN + first;
+    lcdWriteCommand(0x10 | (column >> 4)); // Column addr MSB
     lcdWriteCommand(0xB0 | y); // Page addr y
-#if !LCD_VERTICAL_INVERT
-    lcdWriteCommand(0x04);
-#endif
+    lcdWriteCommand(column & 0x0F); // Column addr LSB
 #endif
 
     LCD_NCS_LOW();
@@ -292,7 +304,8 @@ void lcdRefresh(bool wait)
     lcd_busy = true;
     LCD_DMA_Stream->CR &= ~DMA_SxCR_EN; // Disable DMA
     LCD_DMA->HIFCR = LCD_DMA_FLAGS; // Write ones to clear bits
-    LCD_DMA_Stream->M0AR = (uint32_t)p;
+    LCD_DMA_Stream->M0AR = (uint32_t)&displayBuf[y * LCD_W + first];
+    LCD_DMA_Stream->NDTR = last - first + 1;
     LCD_DMA_Stream->CR |= DMA_SxCR_EN | DMA_SxCR_TCIE; // Enable DMA & TC interrupts
     LCD_SPI->CR2 |= SPI_CR2_TXDMAEN;
 
@@ -427,6 +440,10 @@ void lcdInitFinish()
   lcdStart();
   lcdWriteCommand(0xAF); // dc2=1, IC into exit SLEEP MODE, dc3=1 gray=ON, dc4=1 Green Enhanc mode disabled
   delay_ms(20); // needed for internal DC-DC converter startup
+
+#if LCD_W == 128
+  lcdRefreshAll();
+#endif
 }
 
 void lcdSetRefVolt(uint8_t val)
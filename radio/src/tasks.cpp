@@ -27,14 +27,21 @@
 #include "os/timer.h"
 #include "timers_driver.h"
 #include "hal/abnormal_reboot.h"
+#include "hal/usb_driver.h"
 #include "hal/watchdog_driver.h"
 #include "pdm_wav_recorder.h"
 
 #include "tasks.h"
 #include "tasks/mixer_task.h"
+#include "tasks/storage_task.h"
 
 #if defined(COLORLCD)
 #include "startup_shutdown.h"
+#include "LvglWrapper.h"
+#endif
+
+#if defined(LUA)
+#include "lua/lua_api.h"
 #endif
 
 task_handle_t menusTaskId;
@@ -47,17 +54,109 @@ TASK_DEFINE_STACK(audioStack, AUDIO_STACK_SIZE);
 
 mutex_handle_t audioMutex;
 
-#define MENU_TASK_PERIOD (50)  // 50ms
+#define MENU_TASK_PERIOD       (50)   // 50ms
+#define MENU_TASK_IDLE_PERIOD  (100)  // backlight off, no Lua scripts
+#define MENU_TASK_FRAME_PERIOD (10)   // minimum interval between input frames
 
 #if defined(COLORLCD) && defined(CLI)
 bool perMainEnabled = true;
 #endif
 
+static MenusTaskStats _menusStats;
+static uint32_t _wakeupsCount = 0;
+static uint32_t _wakeupsStart = 0;
+
+static void _countWakeup()
+{
+  uint32_t now = time_get_ms();
+  _wakeupsCount++;
+  if (now - _wakeupsStart >= 1000) {
+    _menusStats.wakeupsPerSecond = _wakeupsCount * 1000 / (now - _wakeupsStart);
+    _wakeupsCount = 0;
+    _wakeupsStart = now;
+  }
+}
+
+void menusTaskWakeup()
+{
+  task_notify(&menusTaskId);
+}
+
+const MenusTaskStats& menusTaskGetStats()
+{
+  return _menusStats;
+}
+
+// Only input wakes the UI task up early. The other work done by
+// perMain() is left on the cycle cadence:
+// - telemetry is decoded, and its alarms raised, by the telemetry timer:
+//   the UI only displays the values
+// - Lua scripts are run once per main cycle (their run() interval is part
+//   of the Lua API), hence the 50 ms period while scripts are loaded
+// - deferred storage writes are due seconds after the change
+//   (WRITE_DELAY_10MS) and are checked on every cycle
+static uint32_t menusTaskPeriod()
+{
+  if (isBacklightEnabled() || usbPlugged()) return MENU_TASK_PERIOD;
+#if defined(LUA)
+  if (luaScriptsCount > 0) return MENU_TASK_PERIOD;
+#endif
+  return MENU_TASK_IDLE_PERIOD;
+}
+
+// Wait for the next main cycle. Input wakes the task up earlier: colour
+// screens then run LVGL frames as long as the user interacts, others start
+// the next cycle right away so that the event is processed without delay.
+static void menusTaskWait(uint32_t cycle_start, uint32_t period)
+{
+#if defined(COLORLCD)
+  uint32_t next_frame = MENU_TASK_FRAME_PERIOD;
+#endif
+
+  while (true) {
+    uint32_t elapsed = time_get_ms() - cycle_start;
+    if (elapsed >= period) return;
+    uint32_t timeout = period - elapsed;
+
+#if defined(COLORLCD)
+    bool interacting = LvglWrapper::instance()->isInteracting();
+    if (interacting) timeout = std::min(timeout, next_frame);
+
+    bool notified = task_wait_notify(&menusTaskId, timeout);
+    if (!notified && !interacting) continue;
+
+#if defined(CLI)
+    if (!perMainEnabled) continue;
+#endif
+
+    uint32_t frame_start = time_get_ms();
+    if (frame_start - cycle_start >= period) return;
+
+    _countWakeup();
+    next_frame = LvglWrapper::instance()->runFrame();
+    next_frame = std::max<uint32_t>(next_frame, MENU_TASK_FRAME_PERIOD);
+
+    uint16_t frame_time = time_get_ms() - frame_start;
+    _menusStats.frameTime = frame_time;
+    if (frame_time > _menusStats.maxFrameTime)
+      _menusStats.maxFrameTime = frame_time;
+#else
+    if (task_wait_notify(&menusTaskId, timeout)) {
+      elapsed = time_get_ms() - cycle_start;
+      if (elapsed < MENU_TASK_FRAME_PERIOD)
+        sleep_ms(MENU_TASK_FRAME_PERIOD - elapsed);
+      return;
+    }
+#endif
+  }
+}
+
 static void menusTask()
 {
   edgeTxInit();
 
   mixerTaskInit();
+  storageTaskInit();
 
 #if defined(COLORLCD) && defined(RTC_BACKUP_RAM)
   if (UNEXPECTED_SHUTDOWN())
@@ -76,7 +175,8 @@ static void menusTask()
 #else
   while (pwrCheck() != e_power_off) {
 #endif
-    time_point_t next_tick = time_point_now();
+    uint32_t cycle_start = time_get_ms();
+    _countWakeup();
     DEBUG_TIMER_START(debugTimerPerMain);
 #if defined(COLORLCD) && defined(CLI)
     if (perMainEnabled) {
@@ -87,7 +187,12 @@ static void menusTask()
 #endif
     DEBUG_TIMER_STOP(debugTimerPerMain);
 
-    sleep_until(&next_tick, MENU_TASK_PERIOD);
+    uint16_t cycle_time = time_get_ms() - cycle_start;
+    _menusStats.cycleTime = cycle_time;
+    if (cycle_time > _menusStats.maxCycleTime)
+      _menusStats.maxCycleTime = cycle_time;
+
+    menusTaskWait(cycle_start, menusTaskPeriod());
     resetForcePowerOffRequest();
   }
 
@@ -39,17 +39,20 @@
 #endif
 
 #define CLI_STACK_SIZE         1024  // only consumed with CLI build option
+#define STORAGE_STACK_SIZE     1536  // FatFs LFN buffer lives on the stack
 
 #if defined(FREE_RTOS)
 #define MIXER_TASK_PRIO        (tskIDLE_PRIORITY + 4)
 #define AUDIO_TASK_PRIO        (tskIDLE_PRIORITY + 3) // Note: FreeRTOSConfig.h defines software timers as priority 2
 #define MENUS_TASK_PRIO        (tskIDLE_PRIORITY + 1)
 #define CLI_TASK_PRIO          (tskIDLE_PRIORITY + 1)
+#define STORAGE_TASK_PRIO      (tskIDLE_PRIORITY + 1)
 #else
 #define MIXER_TASK_PRIO        (4)
 #define AUDIO_TASK_PRIO        (2)
 #define MENUS_TASK_PRIO        (1)
 #define CLI_TASK_PRIO          (1)
+#define STORAGE_TASK_PRIO      (1)
 #endif
 
 
@@ -65,6 +68,20 @@ extern task_handle_t cliTaskId;
 
 void tasksStart();
 
+// Wake the UI task up before its next cycle (input events only, see
+// menusTaskPeriod() for the work left on the cycle cadence)
+void menusTaskWakeup();
+
+struct MenusTaskStats {
+  uint16_t cycleTime;         // duration of the last main cycle (ms)
+  uint16_t maxCycleTime;
+  uint16_t frameTime;         // duration of the last input frame (ms)
+  uint16_t maxFrameTime;
+  uint16_t wakeupsPerSecond;
+};
+
+const MenusTaskStats& menusTaskGetStats();
+
 extern volatile uint16_t timeForcePowerOffPressed;
 inline void resetForcePowerOffRequest()
 {
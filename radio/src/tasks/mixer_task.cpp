@@ -40,6 +40,10 @@
   #include "flysky_gimbal_driver.h"
 #endif
 
+#if defined(CLI)
+  #include "cli_stream.h"
+#endif
+
 task_handle_t mixerTaskId;
 TASK_DEFINE_STACK(mixerStack, MIXER_STACK_SIZE);
 
@@ -53,6 +57,9 @@ static mutex_handle_t mixerMutex;
 static bool _mixer_started = false;
 static bool _mixer_running = false;
 
+// number of mixer computations since boot
+static volatile uint32_t _mixer_cycles = 0;
+
 void mixerTaskLock()
 {
   mutex_lock(&mixerMutex);
@@ -101,6 +108,11 @@ bool mixerTaskRunning()
   return _mixer_running;
 }
 
+uint32_t mixerTaskCycles()
+{
+  return _mixer_cycles;
+}
+
 volatile uint16_t timeForcePowerOffPressed = 0;
 
 bool isForcePowerOffRequested()
@@ -188,6 +200,10 @@ void mixerTask()
       DEBUG_TIMER_START(debugTimerMixerCalcToUsage);
       DEBUG_TIMER_SAMPLE(debugTimerMixerIterval);
 
+      _mixer_cycles = _mixer_cycles + 1;
+#if defined(CLI)
+      cliStreamMixerHook();
+#endif
       mixerTaskUnlock();
       DEBUG_TIMER_STOP(debugTimerMixer);
 
@@ -60,6 +60,9 @@ void mixerTaskStop();
 //
 bool mixerTaskRunning();
 
+// number of mixer computations since boot
+uint32_t mixerTaskCycles();
+
 //
 // Lock / unlock functions: use with care!
 //
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "tasks.h"
+#include "storage_task.h"
+
+#include "os/sleep.h"
+#include "os/task.h"
+#include "os/time.h"
+
+#include "edgetx.h"
+#include "ff.h"
+#include "hal/storage.h"
+
+#define STORAGE_TASK_PERIOD   10    // ms
+
+task_handle_t storageTaskId;
+TASK_DEFINE_STACK(storageStack, STORAGE_STACK_SIZE);
+
+static bool _storage_running = false;
+static volatile bool _logs_requested = false;
+
+// only used by the storage task
+static FIL _file __DMA;
+
+static FRESULT _writeFile(const char* path, const char* tmpPath,
+                          const char* data, uint32_t len)
+{
+  FRESULT result = f_open(&_file, tmpPath ? tmpPath : path,
+                          FA_CREATE_ALWAYS | FA_WRITE);
+  if (result != FR_OK) return result;
+
+  UINT written;
+  result = f_write(&_file, data, len, &written);
+  if (result == FR_OK && written != len) result = FR_DENIED;
+
+  FRESULT close_result = f_close(&_file);
+  if (result == FR_OK) result = close_result;
+  if (result != FR_OK || !tmpPath) return result;
+
+  f_unlink(path);
+  return f_rename(tmpPath, path);
+}
+
+static StorageWriteQueue _queue(_writeFile, time_get_ms);
+
+static void storageTask()
+{
+  while (task_running()) {
+    if (_logs_requested) {
+      _logs_requested = false;
+      DEBUG_TIMER_START(debugTimerLoggingWakeup);
+      logsWrite();
+      DEBUG_TIMER_STOP(debugTimerLoggingWakeup);
+    }
+
+    _queue.process();
+    if (!_queue.pending() && sdMounted()) storageIdle();
+    sleep_ms(STORAGE_TASK_PERIOD);
+  }
+}
+
+void storageTaskInit()
+{
+  _queue.init();
+  task_create(&storageTaskId, storageTask, "storage", storageStack,
+              STORAGE_STACK_SIZE, STORAGE_TASK_PRIO);
+  _storage_running = true;
+}
+
+bool storageTaskRunning()
+{
+  return _storage_running;
+}
+
+StoragePostResult storageTaskPostWrite(StorageWriteSlot slot,
+                                       const char* path, const char* tmpPath,
+                                       char* data, uint32_t len)
+{
+  if (!_storage_running || strlen(path) >= STORAGE_WRITE_PATH_LEN) {
+    free(data);
+    return STORAGE_POST_FAILED;
+  }
+
+  if (!_queue.post(slot, path, tmpPath, data, len)) {
+    free(data);
+    return STORAGE_POST_BUSY;
+  }
+
+  return STORAGE_POST_QUEUED;
+}
+
+bool storageTaskAccepts(StorageWriteSlot slot, const char* path)
+{
+  return _storage_running && _queue.accepts(slot, path);
+}
+
+void storageTaskPostLogs()
+{
+  _logs_requested = true;
+}
+
+bool storageTaskFlush(uint32_t timeout_ms)
+{
+  if (!_storage_running) return true;
+
+  uint32_t start = time_get_ms();
+  while (_queue.pending()) {
+    if (time_get_ms() - start >= timeout_ms) {
+      TRACE("storage: flush timeout");
+      return false;
+    }
+    sleep_ms(1);
+  }
+
+  return true;
+}
+
+bool storageTaskPending(StorageWriteSlot slot)
+{
+  return _storage_running && _queue.pending(slot);
+}
+
+StorageWriteResult storageTaskTakeResult(StorageWriteSlot slot)
+{
+  if (!_storage_running) return STORAGE_WRITE_NONE;
+  return _queue.takeResult(slot);
+}
+
+uint8_t storageTaskQueueDepth()
+{
+  if (!_storage_running) return 0;
+  return _queue.depth();
+}
+
+const StorageWriteStats& storageTaskGetStats()
+{
+  return _queue.stats();
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "os/task.h"
+#include "storage/write_queue.h"
+
+// The storage task owns the deferred SD card writes: the UI task
+// serializes radio / model settings into a RAM buffer and hands it
+// over, so that it never waits on FatFs for a periodic save.
+//
+// The pending writes are kept in a StorageWriteQueue: one per slot,
+// retried a few times on error, see storage/write_queue.h.
+
+extern task_handle_t storageTaskId;
+
+// init, create and start the OS task itself
+void storageTaskInit();
+
+// returns true once the task accepts writes
+bool storageTaskRunning();
+
+// Queue 'len' bytes at 'data' to be written to 'path'.
+//
+// 'data' must have been allocated with malloc() and is owned (and freed)
+// by the storage task from now on. If 'tmpPath' is given, the data is
+// written to 'tmpPath' first and then renamed to 'path'.
+//
+// Never waits: a pending write of the same file is replaced, while a
+// pending write of another file in this slot is reported as
+// STORAGE_POST_BUSY. 'data' is freed if it is not queued.
+StoragePostResult storageTaskPostWrite(StorageWriteSlot slot,
+                                       const char* path, const char* tmpPath,
+                                       char* data, uint32_t len);
+
+// storageTaskPostWrite() would queue a write of 'path' to 'slot'
+bool storageTaskAccepts(StorageWriteSlot slot, const char* path);
+
+// Ask the storage task to append a row to the log file
+void storageTaskPostLogs();
+
+// Wait until all pending writes have reached the SD card.
+// Returns false on timeout (SD card errors).
+bool storageTaskFlush(uint32_t timeout_ms = 5000);
+
+// A write for 'slot' is queued or in progress
+bool storageTaskPending(StorageWriteSlot slot);
+
+// Outcome of the writes of 'slot' since the previous call: a write given
+// up after its retries is reported once as STORAGE_WRITE_FAILED.
+StorageWriteResult storageTaskTakeResult(StorageWriteSlot slot);
+
+// number of writes waiting in the queue
+uint8_t storageTaskQueueDepth();
+
+const StorageWriteStats& storageTaskGetStats();
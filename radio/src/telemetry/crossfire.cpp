@@ -133,10 +133,10 @@ void processCrossfireTelemetryValue(uint8_t index, int32_t value)
 
 template <int N>
 bool getCrossfireTelemetryValue(uint8_t index, int32_t& value,
-                                uint8_t* rxBuffer)
+                                const uint8_t* rxBuffer)
 {
   bool result = false;
-  uint8_t * byte = &rxBuffer[index];
+  const uint8_t * byte = &rxBuffer[index];
   value = (*byte & 0x80) ? -1 : 0;
   for (uint8_t i=0; i<N; i++) {
     value <<= 8;
@@ -148,7 +148,7 @@ bool getCrossfireTelemetryValue(uint8_t index, int32_t& value,
   return result;
 }
 
-void processCrossfireTelemetryFrame(uint8_t module, uint8_t* rxBuffer,
+void processCrossfireTelemetryFrame(uint8_t module, const uint8_t* rxBuffer,
                                     uint8_t rxBufferCount)
 {
   if (telemetryState == TELEMETRY_INIT &&
@@ -389,10 +389,13 @@ void processCrossfireTelemetryFrame(uint8_t module, uint8_t* rxBuffer,
     case FLIGHT_MODE_ID:
     {
       const CrossfireSensor & sensor = crossfireSensors[FLIGHT_MODE_INDEX];
-      auto textLength = min<int>(16, rxBuffer[1]);
-      rxBuffer[textLength] = '\0';
+      auto textLength = min<int>(16, rxBuffer[1]) - 3;
+      char text[16];
+      if (textLength < 0) textLength = 0;
+      memcpy(text, rxBuffer + 3, textLength);
+      text[textLength] = '\0';
       setTelemetryText(PROTOCOL_TELEMETRY_CROSSFIRE, sensor.id, 0, sensor.subId,
-                       (const char *)rxBuffer + 3);
+                       text);
       break;
     }
 
@@ -119,7 +119,9 @@ struct CrossfireModuleStatus
 
 extern CrossfireModuleStatus crossfireModuleStatus[2];
 
-void processCrossfireTelemetryFrame(uint8_t module, uint8_t* rxBuffer,
+// Decode a complete, CRC checked frame. The frame is only read, so that
+// the same buffer can be handed to every telemetry consumer.
+void processCrossfireTelemetryFrame(uint8_t module, const uint8_t* rxBuffer,
                                     uint8_t rxBufferCount);
 void crossfireSetDefault(int index, uint16_t id, uint8_t subId);
 
@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "sensor_history.h"
+#include "edgetx.h"
+
+static const uint16_t tierPeriods[SENSOR_HISTORY_TIERS] = {0, 100, 1000};
+
+// Bucket of a tier being filled
+struct SensorHistoryPending {
+  int32_t min;
+  int32_t max;
+  int64_t sum;
+  uint16_t count;
+  tmr10ms_t start;
+};
+
+struct SensorHistorySlot {
+  uint8_t sensor;  // index + 1, 0 if free
+  tmr10ms_t lastRead;
+  SensorHistoryRing rings[SENSOR_HISTORY_TIERS];
+  SensorHistoryPending pending[SENSOR_HISTORY_TIERS];  // none for raw values
+};
+
+static SensorHistorySlot slots[SENSOR_HISTORY_SLOTS];
+
+// slots requested by the readers, claimed by sensorHistoryWakeup()
+static volatile bool claimRequests[MAX_TELEMETRY_SENSORS];
+static volatile bool claimRequested = false;
+
+static const SensorHistoryBucket emptyBucket = {INT32_MAX, INT32_MIN, 0};
+
+uint16_t sensorHistoryPeriod(SensorHistoryTier tier)
+{
+  return tierPeriods[tier];
+}
+
+static void restartSlot(SensorHistorySlot& slot, tmr10ms_t now)
+{
+  for (auto& ring : slot.rings) {
+    ring.total = 0;
+  }
+  for (auto& pending : slot.pending) {
+    pending.count = 0;
+    pending.start = now;
+  }
+}
+
+static void addToTier(SensorHistorySlot& slot, uint8_t tier,
+                      const SensorHistoryBucket& in, tmr10ms_t time);
+
+// Brings the tier up to "time": the pending bucket is pushed if its period
+// is over, followed by an empty bucket for each period without any value.
+static void advanceTier(SensorHistorySlot& slot, uint8_t tier, tmr10ms_t time)
+{
+  auto& pending = slot.pending[tier];
+  auto& ring = slot.rings[tier];
+  uint16_t period = tierPeriods[tier];
+
+  tmr10ms_t elapsed = time - pending.start;
+  if (elapsed < period) return;
+
+  uint32_t periods = elapsed / period;
+  uint32_t empty = periods;
+
+  if (pending.count > 0) {
+    SensorHistoryBucket bucket = {pending.min, pending.max,
+                                  int32_t(pending.sum / pending.count)};
+    ring.push(bucket);
+    if (tier + 1 < SENSOR_HISTORY_TIERS)
+      addToTier(slot, tier + 1, bucket, pending.start);
+    empty--;
+  }
+
+  if (empty > SENSOR_HISTORY_LENGTH) empty = SENSOR_HISTORY_LENGTH;
+  while (empty--) {
+    ring.push(emptyBucket);
+  }
+
+  pending.start += periods * period;
+  pending.count = 0;
+}
+
+// Adds a bucket (a single value for the 1s tier) started at "time"
+static void addToTier(SensorHistorySlot& slot, uint8_t tier,
+                      const SensorHistoryBucket& in, tmr10ms_t time)
+{
+  advanceTier(slot, tier, time);
+
+  auto& pending = slot.pending[tier];
+  if (pending.count == 0) {
+    pending.min = in.min;
+    pending.max = in.max;
+    pending.sum = 0;
+  } else {
+    if (in.min < pending.min) pending.min = in.min;
+    if (in.max > pending.max) pending.max = in.max;
+  }
+  pending.sum += in.avg;
+  pending.count++;
+}
+
+const SensorHistoryRing* sensorHistory(uint8_t index, SensorHistoryTier tier)
+{
+  for (auto& slot : slots) {
+    if (slot.sensor == index + 1) {
+      slot.lastRead = get_tmr10ms();
+      return &slot.rings[tier];
+    }
+  }
+
+  if (index < MAX_TELEMETRY_SENSORS) {
+    claimRequests[index] = true;
+    claimRequested = true;
+  }
+  return nullptr;
+}
+
+// A request that finds no slot available is dropped: the next read of the
+// sensor history requests it again.
+static void claimSlots(tmr10ms_t now)
+{
+  claimRequested = false;
+
+  for (uint8_t index = 0; index < MAX_TELEMETRY_SENSORS; index++) {
+    if (!claimRequests[index]) continue;
+    claimRequests[index] = false;
+
+    SensorHistorySlot* available = nullptr;
+    for (auto& slot : slots) {
+      if (slot.sensor == index + 1) {
+        available = nullptr;
+        break;
+      }
+      if (!available &&
+          (!slot.sensor ||
+           (tmr10ms_t)(now - slot.lastRead) >= SENSOR_HISTORY_IDLE))
+        available = &slot;
+    }
+    if (!available) continue;
+
+    // the slot is given to its new sensor once ready
+    available->sensor = 0;
+    restartSlot(*available, now);
+    available->lastRead = now;
+    available->sensor = index + 1;
+  }
+}
+
+void sensorHistoryAdd(uint8_t index, int32_t value, bool restart)
+{
+  for (auto& slot : slots) {
+    if (slot.sensor != index + 1) continue;
+
+    tmr10ms_t now = get_tmr10ms();
+    if (restart) restartSlot(slot, now);
+
+    SensorHistoryBucket bucket = {value, value, value};
+    slot.rings[SENSOR_HISTORY_RAW].push(bucket);
+    addToTier(slot, SENSOR_HISTORY_1S, bucket, now);
+    return;
+  }
+}
+
+void sensorHistoryWakeup()
+{
+  tmr10ms_t now = get_tmr10ms();
+  if (claimRequested) claimSlots(now);
+
+  for (auto& slot : slots) {
+    if (!slot.sensor) continue;
+    for (uint8_t tier = SENSOR_HISTORY_1S; tier < SENSOR_HISTORY_TIERS; tier++) {
+      advanceTier(slot, tier, now);
+    }
+  }
+}
+
+void sensorHistoryReset()
+{
+  memclear(slots, sizeof(slots));
+  memclear((void*)claimRequests, sizeof(claimRequests));
+  claimRequested = false;
+}
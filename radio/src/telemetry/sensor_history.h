@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// History of telemetry sensor values, for the widgets and Lua scripts
+// drawing graphs. Only a few sensors have one: the first read of a sensor
+// history requests a slot, claimed by the next sensorHistoryWakeup(), and
+// given to another sensor once it has not been read for SENSOR_HISTORY_IDLE.
+// Each slot holds one ring per tier, filled by TelemetryItem::setValue().
+// The tiers follow the time, values received or not: sensorHistoryWakeup()
+// pushes the buckets that are over.
+//
+// The slots and rings are only written by the telemetry task, and read by
+// the UI task without lock: a bucket being overwritten may be read torn,
+// which only matters to a graph for one refresh.
+
+enum SensorHistoryTier {
+  SENSOR_HISTORY_RAW,  // each value received
+  SENSOR_HISTORY_1S,
+  SENSOR_HISTORY_10S,
+  SENSOR_HISTORY_TIERS
+};
+
+#if defined(COLORLCD)
+constexpr uint8_t SENSOR_HISTORY_SLOTS = 4;
+constexpr uint8_t SENSOR_HISTORY_LENGTH = 120;
+#else
+constexpr uint8_t SENSOR_HISTORY_SLOTS = 2;
+constexpr uint8_t SENSOR_HISTORY_LENGTH = 32;
+#endif
+
+constexpr uint16_t SENSOR_HISTORY_IDLE = 3000;  // * 10ms = 30s
+
+struct SensorHistoryBucket {
+  int32_t min;
+  int32_t max;
+  int32_t avg;
+
+  // no value received during the bucket period
+  bool isEmpty() const { return min > max; }
+};
+
+// Buckets are numbered from the first one pushed: a reader keeps a number
+// rather than a position, and get() tells whether it was overwritten since.
+struct SensorHistoryRing {
+  SensorHistoryBucket buckets[SENSOR_HISTORY_LENGTH];
+  uint32_t total;  // buckets pushed
+
+  uint32_t first() const
+  {
+    return total > SENSOR_HISTORY_LENGTH ? total - SENSOR_HISTORY_LENGTH : 0;
+  }
+
+  uint32_t end() const { return total; }
+
+  uint8_t count() const { return total - first(); }
+
+  // nullptr once overwritten, or not pushed yet
+  const SensorHistoryBucket* get(uint32_t n) const
+  {
+    if (n < first() || n >= total) return nullptr;
+    return &buckets[n % SENSOR_HISTORY_LENGTH];
+  }
+
+  void push(const SensorHistoryBucket& bucket)
+  {
+    buckets[total % SENSOR_HISTORY_LENGTH] = bucket;
+    total++;
+  }
+};
+
+// Period of the tier buckets, in 10ms (0 for the raw values)
+uint16_t sensorHistoryPeriod(SensorHistoryTier tier);
+
+// nullptr until a slot has been claimed for the sensor (requested if needed)
+const SensorHistoryRing* sensorHistory(uint8_t index, SensorHistoryTier tier);
+
+// From TelemetryItem::setValue(): restart when the item was cleared
+void sensorHistoryAdd(uint8_t index, int32_t value, bool restart);
+
+// From telemetryWakeup(), the task claiming the slots and filling the rings
+void sensorHistoryWakeup();
+
+void sensorHistoryReset();
@@ -29,6 +29,7 @@
 #include "io/multi_protolist.h"
 #include "hal/module_port.h"
 #include "sensor_names.h"
+#include "sensor_history.h"
 
 #include <list>
 
@@ -302,12 +303,8 @@ void telemetryWakeup()
   }
   _telemetryIsPolling = false;
 
-  for (int i = 0; i < MAX_TELEMETRY_SENSORS; i++) {
-    const TelemetrySensor& sensor = g_model.telemetrySensors[i];
-    if (sensor.type == TELEM_TYPE_CALCULATED) {
-      telemetryItems[i].eval(sensor);
-    }
-  }
+  evalCalculatedSensors();
+  sensorHistoryWakeup();
 
 #if defined(VARIO)
   if (TELEMETRY_STREAMING() && !IS_FAI_ENABLED()) {
@@ -425,6 +422,7 @@ void telemetryReset()
   for (auto & telemetryItem : telemetryItems) {
     telemetryItem.clear();
   }
+  sensorHistoryReset();
 
   telemetryStreaming = 0; // reset counter only if valid telemetry packets are being detected
   telemetryState = TELEMETRY_INIT;
@@ -470,16 +468,14 @@ void deregisterTelemetryQueue(TelemetryQueue* queue)
 }
 #endif
 
-static void pushDataToQueue(TelemetryQueue* queue, uint8_t* data, int length)
+static void pushDataToQueue(TelemetryQueue* queue, const uint8_t* data, int length)
 {
   if (queue && queue->hasSpace(length)) {
-    for (uint8_t i = 0; i < length; i += 1) {
-      queue->push(data[i]);
-    }
+    queue->push(data, length);
   }
 }
 
-void pushTelemetryDataToQueues(uint8_t* data, int length)
+void pushTelemetryDataToQueues(const uint8_t* data, int length)
 {
 #if defined(COLORLCD)
   for (auto it = telemetryQueues.cbegin(); it != telemetryQueues.cend(); ++it)
@@ -118,6 +118,8 @@ PACK(struct CellValue
 int setTelemetryValue(TelemetryProtocol protocol, uint16_t id, uint8_t subId, uint8_t instance, int32_t value, uint32_t unit, uint32_t prec);
 int setTelemetryText(TelemetryProtocol protocol, uint16_t id, uint8_t subId, uint8_t instance, const char * text);
 void delTelemetryIndex(uint8_t index);
+// To be called when a sensor was added, copied, removed or edited
+void telemetrySensorEdited();
 int availableTelemetryIndex();
 int lastUsedTelemetryIndex();
 
@@ -239,7 +241,7 @@ typedef Fifo<uint8_t, LUA_TELEMETRY_INPUT_FIFO_SIZE> TelemetryQueue;
 extern TelemetryQueue* luaInputTelemetryFifo;
 void registerTelemetryQueue(TelemetryQueue*);
 void deregisterTelemetryQueue(TelemetryQueue*);
-void pushTelemetryDataToQueues(uint8_t* data, int length);
+void pushTelemetryDataToQueues(const uint8_t* data, int length);
 #endif
 
 void processPXX2Frame(uint8_t idx, const uint8_t* frame,
@@ -24,6 +24,8 @@
 #include <math.h>
 
 #include "spektrum.h"
+#include "sensor_history.h"
+#include "name_table.h"
 
 #if defined(CROSSFIRE)
   #include "crossfire.h"
@@ -58,6 +60,164 @@
 TelemetryItem telemetryItems[MAX_TELEMETRY_SENSORS];
 bool allowNewSensors;
 
+// The calculated sensors are evaluated in dependency order, and only once
+// an item they use has changed (value received, or lost). The dependencies
+// are built again on the next evaluation after the model was changed.
+//
+// Items may change from the 10ms interrupt: a dirty flag is cleared before
+// the sensor is evaluated, and is a byte so that setting it is atomic.
+static uint8_t calculatedOrder[MAX_TELEMETRY_SENSORS];
+static uint8_t calculatedCount = 0;
+static uint16_t dependentsStart[MAX_TELEMETRY_SENSORS + 1];
+static uint8_t dependents[MAX_TELEMETRY_SENSORS * 4];
+static volatile uint8_t calculatedDirty[MAX_TELEMETRY_SENSORS];
+static volatile bool calculatedInvalid = true;
+
+// Items used by eval(): totalize and consumption sensors use none, they are
+// updated from setValue() and per10ms()
+static uint8_t getCalculatedSources(const TelemetrySensor & sensor, uint8_t * sources)
+{
+  uint8_t count = 0;
+
+  auto add = [&](int source) {
+    if (source > 0 && source <= MAX_TELEMETRY_SENSORS)
+      sources[count++] = source - 1;
+  };
+
+  switch (sensor.formula) {
+    case TELEM_FORMULA_CELL:
+      add(sensor.cell.source);
+      break;
+
+    case TELEM_FORMULA_DIST:
+      add(sensor.dist.gps);
+      add(sensor.dist.alt);
+      break;
+
+    case TELEM_FORMULA_ADD:
+    case TELEM_FORMULA_AVERAGE:
+    case TELEM_FORMULA_MIN:
+    case TELEM_FORMULA_MAX:
+    case TELEM_FORMULA_MULTIPLY:
+    {
+      int maxitems = (sensor.formula == TELEM_FORMULA_MULTIPLY ? 2 : 4);
+      for (int i=0; i<maxitems; i++) {
+        add(abs(sensor.calc.sources[i]));
+      }
+      break;
+    }
+
+    default:
+      break;
+  }
+
+  return count;
+}
+
+static bool isCalculatedSensor(int index)
+{
+  return g_model.telemetrySensors[index].type == TELEM_TYPE_CALCULATED;
+}
+
+static void buildCalculatedSensors()
+{
+  static uint8_t counts[MAX_TELEMETRY_SENSORS];
+  static bool placed[MAX_TELEMETRY_SENSORS];
+  uint8_t sources[4];
+
+  // sensors using each item
+  memclear(counts, sizeof(counts));
+  for (int i=0; i<MAX_TELEMETRY_SENSORS; i++) {
+    if (isCalculatedSensor(i)) {
+      uint8_t count = getCalculatedSources(g_model.telemetrySensors[i], sources);
+      for (uint8_t j=0; j<count; j++) {
+        counts[sources[j]]++;
+      }
+    }
+  }
+  dependentsStart[0] = 0;
+  for (int i=0; i<MAX_TELEMETRY_SENSORS; i++) {
+    dependentsStart[i+1] = dependentsStart[i] + counts[i];
+    counts[i] = 0;
+  }
+  for (int i=0; i<MAX_TELEMETRY_SENSORS; i++) {
+    if (isCalculatedSensor(i)) {
+      uint8_t count = getCalculatedSources(g_model.telemetrySensors[i], sources);
+      for (uint8_t j=0; j<count; j++) {
+        dependents[dependentsStart[sources[j]] + counts[sources[j]]++] = i;
+      }
+    }
+  }
+
+  // each sensor after the calculated sensors it uses
+  memclear(placed, sizeof(placed));
+  calculatedCount = 0;
+  bool progress = true;
+  while (progress) {
+    progress = false;
+    for (int i=0; i<MAX_TELEMETRY_SENSORS; i++) {
+      if (!isCalculatedSensor(i) || placed[i])
+        continue;
+      uint8_t count = getCalculatedSources(g_model.telemetrySensors[i], sources);
+      bool ready = true;
+      for (uint8_t j=0; j<count; j++) {
+        if (isCalculatedSensor(sources[j]) && !placed[sources[j]]) {
+          ready = false;
+          break;
+        }
+      }
+      if (ready) {
+        placed[i] = true;
+        calculatedOrder[calculatedCount++] = i;
+        progress = true;
+      }
+    }
+  }
+
+  // circular dependencies: evaluated on each pass, as they keep each other dirty
+  for (int i=0; i<MAX_TELEMETRY_SENSORS; i++) {
+    if (isCalculatedSensor(i) && !placed[i]) {
+      calculatedOrder[calculatedCount++] = i;
+    }
+  }
+
+  for (int i=0; i<MAX_TELEMETRY_SENSORS; i++) {
+    calculatedDirty[i] = 1;
+  }
+}
+
+void calculatedSensorsInvalidate()
+{
+  calculatedInvalid = true;
+}
+
+void telemetryItemChanged(const TelemetryItem * item)
+{
+  int index = item - telemetryItems;
+  if (index < 0 || index >= MAX_TELEMETRY_SENSORS)
+    return;
+
+  for (uint16_t i=dependentsStart[index]; i<dependentsStart[index+1]; i++) {
+    calculatedDirty[dependents[i]] = 1;
+  }
+}
+
+void evalCalculatedSensors()
+{
+  if (calculatedInvalid) {
+    calculatedInvalid = false;
+    buildCalculatedSensors();
+  }
+
+  for (uint8_t i=0; i<calculatedCount; i++) {
+    uint8_t index = calculatedOrder[i];
+    if (calculatedDirty[index]) {
+      calculatedDirty[index] = 0;
+      telemetryItems[index].eval(g_model.telemetrySensors[index]);
+    }
+  }
+}
+
 bool isFaiForbidden(source_t idx)
 {
   if (idx < MIXSRC_FIRST_TELEM) return false;
@@ -118,6 +278,7 @@ void TelemetryItem::setValue(const TelemetrySensor &sensor, int32_t val,
       cells.count = cellsCount;
     }
     cells.values[cellIndex].set(cellValue);
+    telemetryItemChanged(this);
     if (cellIndex+1 == cells.count) {
       newVal = 0;
       for (int i=0; i<cellsCount; i++) {
@@ -273,6 +434,11 @@ void TelemetryItem::setValue(const TelemetrySensor &sensor, int32_t val,
     }
   }
 
+  int index = this - telemetryItems;
+  if (index >= 0 && index < MAX_TELEMETRY_SENSORS) {
+    sensorHistoryAdd(index, newVal, !isAvailable());
+  }
+
   value = newVal;
   setFresh();
 }
@@ -473,10 +639,18 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
   }
 }
 
+void telemetrySensorEdited()
+{
+  // sensor labels are source and switch names
+  nameTableInvalidate();
+  calculatedSensorsInvalidate();
+}
+
 void delTelemetryIndex(uint8_t index)
 {
   memclear(&g_model.telemetrySensors[index], sizeof(TelemetrySensor));
   telemetryItems[index].clear();
+  telemetrySensorEdited();
   storageDirty(EE_MODEL);
 }
 
@@ -599,6 +773,7 @@ int setTelemetryValue(TelemetryProtocol protocol, uint16_t id, uint8_t subId,
       default:
         return index;
     }
+    telemetrySensorEdited();
     telemetryItems[index].setValue(g_model.telemetrySensors[index], value, unit, prec);
     return index;
   }
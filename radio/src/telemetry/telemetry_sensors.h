@@ -28,6 +28,11 @@ constexpr int8_t TELEMETRY_SENSOR_TIMEOUT_OLD = -1;
 constexpr int8_t TELEMETRY_SENSOR_TIMEOUT_START = 125; // * 160ms = 20s
 constexpr uint8_t TELEMETRY_SENSOR_TEXT_LENGTH = 16;
 
+class TelemetryItem;
+
+// Marks the calculated sensors using this item to be evaluated again
+void telemetryItemChanged(const TelemetryItem * item);
+
 class TelemetryItem
 {
   public:
@@ -121,14 +126,25 @@ class TelemetryItem
     inline void setFresh()
     {
       timeout = TELEMETRY_SENSOR_TIMEOUT_START;
+      telemetryItemChanged(this);
     }
 
     inline void setOld()
     {
-      timeout = TELEMETRY_SENSOR_TIMEOUT_OLD;
+      if (timeout != TELEMETRY_SENSOR_TIMEOUT_OLD) {
+        timeout = TELEMETRY_SENSOR_TIMEOUT_OLD;
+        telemetryItemChanged(this);
+      }
     }
 };
 
 extern TelemetryItem telemetryItems[MAX_TELEMETRY_SENSORS];
 extern bool allowNewSensors;
+
+// Evaluates the calculated sensors whose sources have changed
+void evalCalculatedSensors();
+// To be called when the sensors configuration may have changed
+// (telemetrySensorEdited() and model load do it)
+void calculatedSensorsInvalidate();
+
 bool isFaiForbidden(source_t idx);
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <vector>
+
+#include "gtests.h"
+
+#if defined(BLUETOOTH) && !defined(PCBX9E)
+
+#include "bluetooth_driver.h"
+#include "targets/simu/simulib.h"
+
+static std::vector<uint8_t> _btSent;
+
+static void btSend(const uint8_t* data, uint32_t len)
+{
+  _btSent.insert(_btSent.end(), data, data + len);
+}
+
+class BluetoothSlave : public Bluetooth
+{
+ public:
+  using Bluetooth::sendTrainer;
+};
+
+class BluetoothTest : public EdgeTxTest
+{
+ protected:
+  tmr10ms_t savedTmr10ms;
+
+  void SetUp() override
+  {
+    EdgeTxTest::SetUp();
+    _btSent.clear();
+    simuBluetoothSetSendCb(btSend);
+    bluetoothInit(BLUETOOTH_DEFAULT_BAUDRATE, true);
+    g_eeGeneral.bluetoothMode = BLUETOOTH_TRAINER;
+    savedTmr10ms = g_tmr10ms;
+    g_tmr10ms = 1000;
+  }
+
+  void TearDown() override
+  {
+    g_tmr10ms = savedTmr10ms;
+    bluetoothDisable();
+    simuBluetoothSetSendCb(nullptr);
+  }
+};
+
+TEST_F(BluetoothTest, trainerSentOnChange)
+{
+  BluetoothSlave slave;
+  g_model.trainerData.mode = TRAINER_MODE_SLAVE_BLUETOOTH;
+  channelOutputs[0] = 200;
+
+  slave.sendTrainer();
+  EXPECT_EQ(1u, slave.trainerStats.frames);
+  EXPECT_FALSE(_btSent.empty());
+
+  // not more often than the trainer period
+  channelOutputs[0] = 300;
+  slave.sendTrainer();
+  EXPECT_EQ(1u, slave.trainerStats.frames);
+
+  // changed channels
+  g_tmr10ms += BLUETOOTH_TRAINER_PERIOD;
+  slave.sendTrainer();
+  EXPECT_EQ(2u, slave.trainerStats.frames);
+
+  // unchanged channels: only sent to keep the link alive
+  g_tmr10ms += BLUETOOTH_TRAINER_PERIOD;
+  slave.sendTrainer();
+  EXPECT_EQ(2u, slave.trainerStats.frames);
+  g_tmr10ms += BLUETOOTH_TRAINER_KEEPALIVE;
+  slave.sendTrainer();
+  EXPECT_EQ(3u, slave.trainerStats.frames);
+}
+
+TEST_F(BluetoothTest, trainerFramesReceived)
+{
+  // frames from a slave
+  BluetoothSlave slave;
+  g_model.trainerData.mode = TRAINER_MODE_SLAVE_BLUETOOTH;
+  channelOutputs[0] = 200;
+  channelOutputs[3] = -500;
+  channelOutputs[7] = 1024;
+  slave.sendTrainer();
+  std::vector<uint8_t> frame = _btSent;
+  ASSERT_FALSE(frame.empty());
+
+  // to the master, through the host serial bridge
+  g_model.trainerData.mode = TRAINER_MODE_MASTER_BLUETOOTH;
+  bluetooth.state = BLUETOOTH_STATE_OFF;
+  bluetooth.wakeup();  // module init
+  bluetooth.state = BLUETOOTH_STATE_CONNECTED;
+  memclear(trainerInput, sizeof(trainerInput));
+
+  // split over 2 bursts, after some text
+  const char text[] = "OK+\r\n";
+  simuBluetoothReceive((const uint8_t*)text, sizeof(text) - 1);
+  simuBluetoothReceive(frame.data(), 5);
+  bluetooth.wakeup();
+  EXPECT_EQ(0, trainerInput[0]);
+
+  uint32_t frames = bluetooth.trainerStats.frames;
+  simuBluetoothReceive(frame.data() + 5, frame.size() - 5);
+  bluetooth.wakeup();
+  EXPECT_EQ(frames + 1, bluetooth.trainerStats.frames);
+  EXPECT_EQ(100, trainerInput[0]);
+  EXPECT_EQ(-250, trainerInput[3]);
+  EXPECT_EQ(512, trainerInput[7]);
+
+  // several frames at once
+  simuBluetoothReceive(frame.data(), frame.size());
+  simuBluetoothReceive(frame.data(), frame.size());
+  bluetooth.wakeup();
+  EXPECT_EQ(frames + 3, bluetooth.trainerStats.frames);
+  EXPECT_GT(bluetooth.trainerStats.measured, 0u);
+  EXPECT_LE(bluetooth.trainerStats.lastLatency,
+            bluetooth.trainerStats.maxLatency);
+
+  bluetooth.state = BLUETOOTH_STATE_OFF;
+}
+
+#endif
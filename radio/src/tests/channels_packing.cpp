@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <chrono>
+#include <random>
+
+#include "gtests.h"
+#include "pulses/channels_packing.h"
+
+// Channel values of the golden frames: out of range, limits, center...
+static const int16_t goldenInput[] = {
+  -1500, -1024, -512, -100, 0, 1, 100, 512, 1024, 1500, -768, 768,
+  -256, 256, -1, 300, -900, 900, 50, -50, 1100, -1100, 640, -640,
+};
+
+// Frames as packed by the per protocol encoders before ChannelsPacking
+static const uint8_t goldenMulti[] = {
+  0x00, 0x68, 0xC6, 0x99, 0x60, 0x07, 0x40, 0x00, 0x42, 0x31, 0xB3,
+  0x33, 0xFF, 0xBF, 0x66, 0xCC, 0x4C, 0x33, 0x66, 0x02, 0x10, 0x9E,
+};
+
+static const uint8_t goldenSbus[] = {
+  0x00, 0x68, 0xC5, 0x91, 0x20, 0x07, 0x3E, 0xF0, 0xC1, 0x30, 0xAF,
+  0x13, 0xFF, 0xBF, 0x5E, 0x8C, 0x4C, 0x31, 0x56, 0x82, 0x0F, 0x9A,
+};
+
+static const uint8_t goldenCrossfire[] = {
+  0x00, 0x68, 0xC5, 0x91, 0x20, 0x07, 0x3E, 0xF0, 0xC1, 0x30, 0xAF,
+  0x13, 0x07, 0xBE, 0x5E, 0x8C, 0x4C, 0x31, 0x56, 0x82, 0x0F, 0x9A,
+};
+
+static const uint8_t goldenPxx[] = {
+  0x01, 0x00, 0x10, 0x80, 0x52, 0x3B, 0x00, 0x04, 0x40, 0x4B, 0x04, 0x58,
+  0x00, 0xE7, 0x7F, 0xC0, 0x01, 0x64, 0x40, 0x03, 0x4C, 0x00, 0x14, 0x4E,
+  0x5D, 0x31, 0x6A, 0x25, 0xB4, 0x3D, 0x39, 0x77, 0x0C, 0xE0, 0x05, 0x22,
+};
+
+static const uint8_t goldenPxxUpper[] = {
+  0x01, 0x08, 0x90, 0x80, 0x5A, 0xBB, 0x00, 0x0C, 0xC0, 0x4B, 0x0C, 0xD8,
+};
+
+static const struct {
+  const char* name;
+  const ChannelsPacking& packing;
+  uint8_t count;
+  const uint8_t* frame;
+  unsigned size;
+} goldenFrames[] = {
+  {"multi", MULTI_CHANNELS_PACKING, 16, goldenMulti, sizeof(goldenMulti)},
+  {"sbus", SBUS_CHANNELS_PACKING, 16, goldenSbus, sizeof(goldenSbus)},
+  {"crossfire", CROSSFIRE_CHANNELS_PACKING, 16, goldenCrossfire,
+   sizeof(goldenCrossfire)},
+  {"pxx", PXX_CHANNELS_PACKING, 24, goldenPxx, sizeof(goldenPxx)},
+  {"pxx upper", PXX_UPPER_CHANNELS_PACKING, 8, goldenPxxUpper,
+   sizeof(goldenPxxUpper)},
+};
+
+// The bit accumulator the protocols used to pack their channels with
+static unsigned referencePack(uint8_t bits, uint8_t* data,
+                              const uint16_t* values, uint8_t count)
+{
+  uint8_t* p = data;
+  uint32_t acc = 0;
+  uint8_t available = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    acc |= (uint32_t)(values[i] & ((1 << bits) - 1)) << available;
+    available += bits;
+    while (available >= 8) {
+      *p++ = acc;
+      acc >>= 8;
+      available -= 8;
+    }
+  }
+  if (available) *p++ = acc;
+  return p - data;
+}
+
+TEST(ChannelsPacking, encode)
+{
+  EXPECT_EQ(1024, MULTI_CHANNELS_PACKING.encode(0));
+  EXPECT_EQ(1843, MULTI_CHANNELS_PACKING.encode(1024));
+  EXPECT_EQ(205, MULTI_CHANNELS_PACKING.encode(-1024));
+  EXPECT_EQ(2047, MULTI_CHANNELS_PACKING.encode(2000));
+  EXPECT_EQ(0, MULTI_CHANNELS_PACKING.encode(-2000));
+
+  EXPECT_EQ(992, SBUS_CHANNELS_PACKING.encode(0));
+  EXPECT_EQ(0x3E0 + 4, CROSSFIRE_CHANNELS_PACKING.encode(0, 4));
+  EXPECT_EQ(2 * 0x3E0, CROSSFIRE_CHANNELS_PACKING.encode(1500));
+
+  // 0 and 2047 stay reserved for the failsafe
+  EXPECT_EQ(1, PXX_CHANNELS_PACKING.encode(-2000));
+  EXPECT_EQ(2046, PXX_CHANNELS_PACKING.encode(2000));
+  EXPECT_EQ(2049, PXX_UPPER_CHANNELS_PACKING.encode(-2000));
+  EXPECT_EQ(4094, PXX_UPPER_CHANNELS_PACKING.encode(2000));
+}
+
+TEST(ChannelsPacking, goldenFrames)
+{
+  for (const auto& golden : goldenFrames) {
+    uint16_t values[DIM(goldenInput)];
+    for (uint8_t i = 0; i < golden.count; i++) {
+      values[i] = golden.packing.encode(goldenInput[i]);
+    }
+
+    uint8_t frame[64];
+    memset(frame, 0xA5, sizeof(frame));
+    packChannels(golden.packing, frame, values, golden.count);
+
+    ASSERT_EQ(golden.size, golden.packing.packedSize(golden.count))
+        << golden.name;
+    EXPECT_EQ(0, memcmp(golden.frame, frame, golden.size)) << golden.name;
+    EXPECT_EQ(0xA5, frame[golden.size]) << golden.name << ": overflow";
+  }
+}
+
+TEST(ChannelsPacking, matchesReference)
+{
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> value(0, 4095);
+
+  for (uint8_t bits : {8, 10, 11, 12, 16}) {
+    for (uint8_t count = 0; count <= 32; count++) {
+      ChannelsPacking packing = {bits, 1, 1, 0, 0, 0xFFFF};
+      uint16_t values[32];
+      for (auto& v : values) v = value(gen);
+
+      uint8_t expected[64], frame[64];
+      unsigned len = referencePack(bits, expected, values, count);
+      ASSERT_EQ(len, packing.packedSize(count));
+
+      packChannels(packing, frame, values, count);
+      EXPECT_EQ(0, memcmp(expected, frame, len))
+          << (int)bits << " bits, " << (int)count << " channels";
+    }
+  }
+}
+
+TEST(ChannelsPacking, patchMatchesPacking)
+{
+  uint16_t values[16];
+  for (uint8_t i = 0; i < 16; i++) {
+    values[i] = MULTI_CHANNELS_PACKING.encode(goldenInput[i]);
+  }
+
+  uint8_t patched[22], expected[22];
+  memcpy(patched, goldenMulti, sizeof(patched));
+  for (uint8_t i = 0; i < 16; i++) {
+    values[i] = 2047 - values[i];
+    patchChannel11Bits(patched, i, values[i]);
+  }
+
+  packChannels(MULTI_CHANNELS_PACKING, expected, values, 16);
+  EXPECT_EQ(0, memcmp(expected, patched, sizeof(expected)));
+}
+
+// Not a pass / fail test: prints the packing time of each protocol frame
+// next to the one of the byte by byte accumulator it replaces.
+// Opt-in: run with --gtest_also_run_disabled_tests
+TEST(ChannelsPacking, DISABLED_benchmark)
+{
+  const unsigned loops = 20000;
+
+  for (const auto& golden : goldenFrames) {
+    uint16_t values[DIM(goldenInput)];
+    for (uint8_t i = 0; i < golden.count; i++) {
+      values[i] = golden.packing.encode(goldenInput[i]);
+    }
+
+    volatile uint8_t sink = 0;
+    uint8_t frame[64];
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < loops; i++) {
+      values[0] = i & 0x7FF;
+      referencePack(golden.packing.bits, frame, values, golden.count);
+      sink = sink + frame[0];
+    }
+    auto reference = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < loops; i++) {
+      values[0] = i & 0x7FF;
+      packChannels(golden.packing, frame, values, golden.count);
+      sink = sink + frame[0];
+    }
+    auto packed = std::chrono::steady_clock::now() - start;
+
+    auto ns = [&](std::chrono::steady_clock::duration d) {
+      return (unsigned)(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(d).count() /
+          loops);
+    };
+    printf("%-10s %2u channels: %4u ns/frame (byte by byte: %4u ns)\n",
+           golden.name, golden.count, ns(packed), ns(reference));
+  }
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "gtests.h"
+#include "cli_stream.h"
+
+// CRC16 CCITT (0x1021, start 0), computed bit by bit
+static uint16_t refCrc(const uint8_t* data, uint32_t len)
+{
+  uint16_t crc = 0;
+  while (len--) {
+    crc ^= *data++ << 8;
+    for (int bit = 0; bit < 8; bit++)
+      crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
+
+struct StreamFrame {
+  uint8_t type;
+  uint8_t sequence;
+  std::vector<uint8_t> payload;
+};
+
+class CliStreamTest : public EdgeTxTest
+{
+ protected:
+  void TearDown() override
+  {
+    cliStreamStop();
+    EdgeTxTest::TearDown();
+  }
+
+  // next snapshot from the mixer hook, split into frames
+  std::vector<StreamFrame> snapshot(bool sent = true)
+  {
+    // the hook takes at most one snapshot per period
+    std::this_thread::sleep_for(std::chrono::microseconds(
+        1000000 / CLI_STREAM_MAX_RATE));
+    cliStreamMixerHook();
+
+    std::vector<StreamFrame> frames;
+    uint32_t len;
+    const uint8_t* p = cliStreamTakeSnapshot(&len);
+    if (!p) return frames;
+
+    const uint8_t* end = p + len;
+    while (p < end) {
+      EXPECT_EQ(CLI_STREAM_SYNC, p[0]);
+      uint8_t n = p[2];
+      EXPECT_LE(p + CLI_STREAM_HEADER_SIZE + n + CLI_STREAM_CRC_SIZE, end);
+      const uint8_t* crc = p + CLI_STREAM_HEADER_SIZE + n;
+      EXPECT_EQ(refCrc(p + 1, CLI_STREAM_HEADER_SIZE - 1 + n),
+                crc[0] | (crc[1] << 8));
+      frames.push_back(
+          {p[1], p[3], std::vector<uint8_t>(p + CLI_STREAM_HEADER_SIZE, crc)});
+      p = crc + CLI_STREAM_CRC_SIZE;
+    }
+
+    cliStreamReleaseSnapshot(sent);
+    return frames;
+  }
+
+  static void setSensor(uint8_t index, int32_t value)
+  {
+    strncpy(g_model.telemetrySensors[index].label, "Tst",
+            TELEM_LABEL_LEN);
+    telemetryItems[index].value = value;
+    telemetryItems[index].timeout = TELEMETRY_SENSOR_TIMEOUT_START;
+  }
+
+  // sensor indexes of a telemetry payload
+  static std::vector<uint8_t> sensors(const StreamFrame& frame)
+  {
+    std::vector<uint8_t> result;
+    for (size_t i = 0; i < frame.payload.size(); i += 5)
+      result.push_back(frame.payload[i]);
+    return result;
+  }
+};
+
+TEST_F(CliStreamTest, channelsFrame)
+{
+  channelOutputs[0] = -1024;
+  channelOutputs[1] = 512;
+  channelOutputs[MAX_OUTPUT_CHANNELS - 1] = 1;
+
+  cliStreamStart(CLI_STREAM_MAX_RATE, CLI_STREAM_CHANNELS);
+  auto frames = snapshot();
+  ASSERT_EQ(1u, frames.size());
+  EXPECT_EQ(CLI_STREAM_FRAME_CHANNELS, frames[0].type);
+  EXPECT_EQ(0, frames[0].sequence);
+
+  const auto& payload = frames[0].payload;
+  ASSERT_EQ(MAX_OUTPUT_CHANNELS * 2u, payload.size());
+  EXPECT_EQ(-1024, (int16_t)(payload[0] | (payload[1] << 8)));
+  EXPECT_EQ(512, (int16_t)(payload[2] | (payload[3] << 8)));
+  EXPECT_EQ(1, payload[payload.size() - 2]);
+  EXPECT_EQ(0, payload[payload.size() - 1]);
+
+  frames = snapshot();
+  ASSERT_EQ(1u, frames.size());
+  EXPECT_EQ(1, frames[0].sequence);
+}
+
+TEST_F(CliStreamTest, allFramesShareTheSequence)
+{
+  setSensor(0, 1234);
+
+  cliStreamStart(CLI_STREAM_MAX_RATE, CLI_STREAM_ALL);
+  auto frames = snapshot();
+  ASSERT_EQ(3u, frames.size());
+  EXPECT_EQ(CLI_STREAM_FRAME_CHANNELS, frames[0].type);
+  EXPECT_EQ(CLI_STREAM_FRAME_SWITCHES, frames[1].type);
+  EXPECT_EQ(CLI_STREAM_FRAME_TELEMETRY, frames[2].type);
+  for (const auto& frame : frames) EXPECT_EQ(0, frame.sequence);
+
+  EXPECT_EQ(1 + (MAX_LOGICAL_SWITCHES + 7) / 8u, frames[1].payload.size());
+
+  const auto& item = frames[2].payload;
+  ASSERT_EQ(5u, item.size());
+  EXPECT_EQ(0, item[0]);
+  EXPECT_EQ(1234, item[1] | (item[2] << 8) | (item[3] << 16) | (item[4] << 24));
+}
+
+TEST_F(CliStreamTest, telemetrySentOnlyWhenChanged)
+{
+  setSensor(0, 10);
+  setSensor(2, 20);
+
+  cliStreamStart(CLI_STREAM_MAX_RATE, CLI_STREAM_TELEMETRY);
+  auto frames = snapshot();
+  ASSERT_EQ(1u, frames.size());
+  EXPECT_EQ(std::vector<uint8_t>({0, 2}), sensors(frames[0]));
+
+  // nothing changed: no frame at all
+  EXPECT_TRUE(snapshot().empty());
+
+  telemetryItems[2].value = 21;
+  frames = snapshot();
+  ASSERT_EQ(1u, frames.size());
+  EXPECT_EQ(std::vector<uint8_t>({2}), sensors(frames[0]));
+}
+
+TEST_F(CliStreamTest, telemetryResentAfterFailedSend)
+{
+  setSensor(1, 10);
+
+  cliStreamStart(CLI_STREAM_MAX_RATE, CLI_STREAM_TELEMETRY);
+  EXPECT_EQ(1u, snapshot(false).size());
+  EXPECT_EQ(1u, cliStreamDroppedSnapshots());
+
+  // not sent: still pending
+  auto frames = snapshot();
+  ASSERT_EQ(1u, frames.size());
+  EXPECT_EQ(std::vector<uint8_t>({1}), sensors(frames[0]));
+  EXPECT_EQ(1, frames[0].sequence);
+
+  EXPECT_TRUE(snapshot().empty());
+  EXPECT_EQ(1u, cliStreamDroppedSnapshots());
+}
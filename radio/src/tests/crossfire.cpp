@@ -22,6 +22,7 @@
 #include "gtest/gtest.h"
 #include "gtests.h"
 #include "telemetry/telemetry.h"
+#include <vector>
 
 #if defined(CROSSFIRE)
 
@@ -41,6 +42,31 @@ TEST(Crossfire, createCrossfireChannelsFrame)
   // TODO check
 }
 
+TEST(Crossfire, patchChannels)
+{
+  int16_t pulses[CROSSFIRE_CHANNELS_COUNT];
+  uint8_t patched[CROSSFIRE_FRAME_MAXLEN];
+  uint8_t expected[CROSSFIRE_FRAME_MAXLEN];
+
+  for (int i=0; i<CROSSFIRE_CHANNELS_COUNT; i++) {
+    pulses[i] = -1024 + 128 * i;
+  }
+  uint8_t len = createCrossfireChannelsFrame(EXTERNAL_MODULE, patched, pulses);
+
+  // re-packing a single slot must not disturb its neighbours
+  for (int i=0; i<CROSSFIRE_CHANNELS_COUNT; i++) {
+    pulses[i] = 1024 - 96 * i;
+    createCrossfireChannelsFrame(EXTERNAL_MODULE, expected, pulses);
+
+    // CROSSFIRE_CENTER + pulse * 4/5, as packed by the encoder
+    patchChannel11Bits(patched + 3, i, 0x3E0 + (pulses[i] * 4) / 5);
+    EXPECT_EQ(0, memcmp(patched + 3, expected + 3, 22)) << "channel " << i;
+  }
+
+  patched[len - 1] = crc8(patched + 2, len - 3);
+  EXPECT_EQ(0, memcmp(patched, expected, len));
+}
+
 TEST(Crossfire, crc8)
 {
   uint8_t frame[] = { 0x00, 0x0C, 0x14, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x01, 0x03, 0x00, 0x00, 0x00, 0xF4 };
@@ -73,6 +99,20 @@ struct crsf_frame_test {
     CrossfireDriver.processFrame(ctx, frame, Len, buffer, &len);    
   }
 
+  void process(uint8_t* data, uint8_t n) {
+    CrossfireDriver.processFrame(ctx, data, n, buffer, &len);
+  }
+
+  std::vector<uint8_t> luaData() {
+    uint8_t* data = luaInputTelemetryFifo->buffer();
+    return std::vector<uint8_t>(data, data + luaInputTelemetryFifo->size());
+  }
+
+  void reset() {
+    len = 0;
+    luaInputTelemetryFifo->clear();
+  }
+
   ~crsf_frame_test()
   {
     if (ctx != nullptr) {
@@ -187,6 +227,34 @@ TEST(Crossfire, frameParser_length)
   }
 }
 
+TEST(Crossfire, frameParser_resyncAfterLengthError)
+{
+  crsf_frame_test ft;
+  if (!ft.ctx) return;
+
+  // a sync byte pending from the previous read, followed by a bad length:
+  // only the sync byte is dropped, not the frame received after it
+  uint8_t first[] = {0xEA};
+  ft.process(first);
+  EXPECT_EQ(ft.len, 1);
+
+  uint8_t next[1 + sizeof(length_error3) - 15];
+  next[0] = 0xFE;
+  memcpy(next + 1, length_error3 + 15, sizeof(length_error3) - 15);
+  ft.process(next);
+  EXPECT_EQ(ft.len, 0);
+  ASSERT_EQ(luaInputTelemetryFifo->size(), (size_t)0x09);
+  EXPECT_EQ(luaInputTelemetryFifo->buffer()[0x09 - 1], 0x01);
+
+  // a bad length split across reads, the next frame in the same read
+  ft.reset();
+  uint8_t head[] = {0xEA, 0xFE};
+  ft.process(head);
+  ft.process(length_error3 + 15, sizeof(length_error3) - 15);
+  EXPECT_EQ(ft.len, 0);
+  EXPECT_EQ(luaInputTelemetryFifo->size(), (size_t)0x09);
+}
+
 static uint8_t invalid_frames[] = {
     // first frame
     0xEA, 0x14, 0xFF, 0x11, 0xFD, 0x05, 0x00, 0x00, 0x13, 0x01, 0x01,
@@ -276,6 +344,60 @@ TEST(Crossfire, frameParser_multipleJumboFrames)
   EXPECT_EQ(lua_buffer[offset], 0x3D);
   EXPECT_EQ(lua_buffer[offset + 0x3D - 1], 0xF0);
 }
+
+// 3 valid frames and one with a bad CRC, back to back
+static std::vector<uint8_t> reassemblyStream()
+{
+  std::vector<uint8_t> stream(incomplete_frame, incomplete_frame + 22 + 35);
+  const uint8_t badCrc[] = {0xEA, 0x02, 0x00, 0x01};
+  stream.insert(stream.end(), badCrc, badCrc + sizeof(badCrc));
+  const uint8_t* third = invalid_frames + sizeof(invalid_frames) - 33;
+  stream.insert(stream.end(), third, third + 33);
+  return stream;
+}
+
+TEST(Crossfire, frameParser_splitFrames)
+{
+  crsf_frame_test ft;
+  if (!ft.ctx) return;
+
+  std::vector<uint8_t> stream = reassemblyStream();
+  uint8_t n = stream.size();
+
+  // all the frames merged in a single read
+  ft.process(stream.data(), n);
+  EXPECT_EQ(ft.len, 0);
+  std::vector<uint8_t> expected = ft.luaData();
+  ASSERT_EQ(expected.size(), (size_t)(0x14 + 0x21 + 0x1F));
+
+  // split in 2 reads anywhere, including after the sync byte only
+  for (uint8_t i = 1; i < n; i++) {
+    ft.reset();
+    ft.process(stream.data(), i);
+    ft.process(stream.data() + i, n - i);
+    EXPECT_EQ(ft.len, 0) << "split at " << (int)i;
+    EXPECT_EQ(expected, ft.luaData()) << "split at " << (int)i;
+  }
+
+  // split in 3 reads, the middle one possibly inside a single frame
+  for (uint8_t i = 1; i < n - 1; i++) {
+    for (uint8_t j = i + 1; j < n; j++) {
+      ft.reset();
+      ft.process(stream.data(), i);
+      ft.process(stream.data() + i, j - i);
+      ft.process(stream.data() + j, n - j);
+      ASSERT_EQ(expected, ft.luaData()) << "split at " << (int)i << ", " << (int)j;
+    }
+  }
+
+  // one byte per read
+  ft.reset();
+  for (uint8_t i = 0; i < n; i++) {
+    ft.process(stream.data() + i, 1);
+  }
+  EXPECT_EQ(ft.len, 0);
+  EXPECT_EQ(expected, ft.luaData());
+}
 #endif // HARDWARE_EXTERNAL_MODULE
 #endif
 
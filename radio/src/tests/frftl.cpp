@@ -0,0 +1,340 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "gtests.h"
+#include "drivers/frftl.h"
+
+#define FLASH_SIZE_MB   4
+#define FLASH_SIZE      (FLASH_SIZE_MB * 1024 * 1024)
+#define FLASH_PAGE      4096
+#define FLASH_BLOCK     32768
+#define SECTOR          512
+
+// NOR flash in RAM: programming only clears bits, erasing sets them
+struct FlashSimulator {
+  std::vector<uint8_t> data;
+  std::vector<uint32_t> pageErases;
+  uint32_t reads = 0;
+  uint64_t readBytes = 0;
+  uint64_t programBytes = 0;
+  uint32_t erases = 0;
+
+  FlashSimulator() : data(FLASH_SIZE, 0xFF), pageErases(FLASH_SIZE / FLASH_PAGE) {}
+
+  void resetCounters()
+  {
+    reads = 0;
+    readBytes = 0;
+    programBytes = 0;
+    erases = 0;
+  }
+};
+
+static FlashSimulator* _flash = nullptr;
+
+static bool simFlashRead(uint32_t addr, uint8_t* buf, uint32_t len)
+{
+  if (addr + len > FLASH_SIZE) return false;
+  memcpy(buf, &_flash->data[addr], len);
+  _flash->reads++;
+  _flash->readBytes += len;
+  return true;
+}
+
+static bool simFlashProgram(uint32_t addr, const uint8_t* buf, uint32_t len)
+{
+  if (addr + len > FLASH_SIZE) return false;
+  for (uint32_t i = 0; i < len; i++) _flash->data[addr + i] &= buf[i];
+  _flash->programBytes += len;
+  return true;
+}
+
+static bool simFlashErase(uint32_t addr)
+{
+  addr &= ~(FLASH_PAGE - 1);
+  memset(&_flash->data[addr], 0xFF, FLASH_PAGE);
+  _flash->pageErases[addr / FLASH_PAGE]++;
+  _flash->erases++;
+  return true;
+}
+
+static bool simFlashBlockErase(uint32_t addr)
+{
+  addr &= ~(FLASH_BLOCK - 1);
+  memset(&_flash->data[addr], 0xFF, FLASH_BLOCK);
+  for (uint32_t i = 0; i < FLASH_BLOCK / FLASH_PAGE; i++)
+    _flash->pageErases[addr / FLASH_PAGE + i]++;
+  _flash->erases++;
+  return true;
+}
+
+static bool simIsFlashErased(uint32_t addr)
+{
+  const uint8_t* p = &_flash->data[addr & ~(FLASH_PAGE - 1)];
+  return std::all_of(p, p + FLASH_PAGE, [](uint8_t b) { return b == 0xFF; });
+}
+
+static const FrFTLOps simFlashOps = {
+  .flashRead = simFlashRead,
+  .flashProgram = simFlashProgram,
+  .flashErase = simFlashErase,
+  .flashBlockErase = simFlashBlockErase,
+  .isFlashErased = simIsFlashErased,
+};
+
+class FrFTLTest : public testing::Test
+{
+ protected:
+  FlashSimulator flash;
+  FrFTL ftl;
+  std::vector<uint8_t> mirror;  // expected disk content
+  std::mt19937 gen{1234};
+
+  void SetUp() override
+  {
+    _flash = &flash;
+    ASSERT_TRUE(ftlInit(&ftl, &simFlashOps, FLASH_SIZE_MB));
+    mirror.assign(ftl.usableSectorCount * SECTOR, 0xFF);
+  }
+
+  void TearDown() override
+  {
+    ftlDeInit(&ftl);
+    _flash = nullptr;
+  }
+
+  void writeSectors(uint32_t sector, uint32_t count)
+  {
+    std::vector<uint8_t> buf(count * SECTOR);
+    for (auto& b : buf) b = gen();
+    ASSERT_TRUE(ftlWrite(&ftl, sector, count, buf.data()));
+    memcpy(&mirror[sector * SECTOR], buf.data(), buf.size());
+  }
+
+  void workload(bool report);
+
+  void trimSectors(uint32_t sector, uint32_t count)
+  {
+    ASSERT_TRUE(ftlTrim(&ftl, sector, count));
+    memset(&mirror[sector * SECTOR], 0xFF, count * SECTOR);
+  }
+
+  ::testing::AssertionResult readMatches(uint32_t sector, uint32_t count)
+  {
+    std::vector<uint8_t> buf(count * SECTOR);
+    if (!ftlReadSectors(&ftl, sector, count, buf.data()))
+      return ::testing::AssertionFailure() << "read error at " << sector;
+    for (uint32_t i = 0; i < count; i++) {
+      if (memcmp(&buf[i * SECTOR], &mirror[(sector + i) * SECTOR], SECTOR))
+        return ::testing::AssertionFailure() << "sector " << sector + i;
+    }
+    return ::testing::AssertionSuccess();
+  }
+};
+
+TEST_F(FrFTLTest, readSectors)
+{
+  // pages fully written, partially written, trimmed and never written
+  writeSectors(0, 256);
+  writeSectors(300, 3);
+  writeSectors(305, 1);
+  trimSectors(16, 4);
+  trimSectors(40, 8);
+
+  // from the page buffers (not programmed yet) and from the flash
+  EXPECT_TRUE(readMatches(0, 320));
+  ASSERT_TRUE(ftlSync(&ftl));
+  EXPECT_TRUE(readMatches(0, 320));
+
+  std::uniform_int_distribution<uint32_t> start(0, 400);
+  std::uniform_int_distribution<uint32_t> length(1, 40);
+  for (int i = 0; i < 200; i++) {
+    uint32_t sector = start(gen);
+    EXPECT_TRUE(readMatches(sector, length(gen)));
+  }
+
+  // single sector reads are the same
+  for (uint32_t sector = 0; sector < 320; sector++) {
+    uint8_t buf[SECTOR];
+    ASSERT_TRUE(ftlRead(&ftl, sector, buf));
+    EXPECT_EQ(0, memcmp(buf, &mirror[sector * SECTOR], SECTOR)) << sector;
+  }
+
+  // out of range
+  uint8_t buf[2 * SECTOR];
+  EXPECT_FALSE(ftlReadSectors(&ftl, ftl.usableSectorCount - 1, 2, buf));
+  EXPECT_FALSE(ftlReadSectors(&ftl, ftl.usableSectorCount, 1, buf));
+}
+
+TEST_F(FrFTLTest, reload)
+{
+  writeSectors(0, 64);
+  writeSectors(1000, 100);
+  writeSectors(8, 8);  // rewrite: relocated pages
+  trimSectors(1050, 16);
+  ASSERT_TRUE(ftlSync(&ftl));
+  while (ftlReclaim(&ftl));
+
+  ftlDeInit(&ftl);
+  ASSERT_TRUE(ftlInit(&ftl, &simFlashOps, FLASH_SIZE_MB));
+  EXPECT_TRUE(readMatches(0, 64));
+  EXPECT_TRUE(readMatches(1000, 100));
+}
+
+TEST_F(FrFTLTest, reloadEraseCounts)
+{
+  for (int i = 0; i < 20; i++) {
+    writeSectors(0, 64);
+    ASSERT_TRUE(ftlSync(&ftl));
+    while (ftlReclaim(&ftl));
+  }
+  // the counts are saved when the MTT page is programmed
+  writeSectors(64, 8);
+  ASSERT_TRUE(ftlSync(&ftl));
+
+  const uint32_t blocks = FLASH_SIZE / FLASH_BLOCK;
+  std::vector<uint16_t> counts(ftl.blockEraseCount,
+                               ftl.blockEraseCount + blocks);
+  EXPECT_GT(*std::max_element(counts.begin(), counts.end()), 0);
+
+  ftlDeInit(&ftl);
+  ASSERT_TRUE(ftlInit(&ftl, &simFlashOps, FLASH_SIZE_MB));
+
+  // but for the erases done after the MTT page was last programmed
+  uint32_t total = 0, restored = 0;
+  for (uint32_t i = 0; i < blocks; i++) {
+    EXPECT_LE(ftl.blockEraseCount[i], counts[i]) << "block " << i;
+    total += counts[i];
+    restored += ftl.blockEraseCount[i];
+  }
+  EXPECT_GE(restored * 10, total * 9);
+  EXPECT_TRUE(readMatches(0, 72));
+}
+
+TEST_F(FrFTLTest, reclaim)
+{
+  writeSectors(0, 512);
+  ASSERT_TRUE(ftlSync(&ftl));
+  trimSectors(0, 512);
+  ASSERT_TRUE(ftlSync(&ftl));
+
+  // rewriting after reclaim does not need any erase
+  while (ftlReclaim(&ftl));
+  flash.resetCounters();
+  writeSectors(0, 64);
+  ASSERT_TRUE(ftlSync(&ftl));
+  EXPECT_EQ(0u, flash.erases);
+  EXPECT_TRUE(readMatches(0, 64));
+}
+
+// Workload modelled on the radio: a large cold area and small files
+// rewritten again and again (settings, logs). Checks that multi sector
+// reads need fewer flash reads and that the wear is spread; with
+// 'report', also prints the read throughput and write amplification.
+void FrFTLTest::workload(bool report)
+{
+  // cold data, half of the disk
+  const uint32_t coldSectors = ftl.usableSectorCount / 2;
+  for (uint32_t sector = 0; sector < coldSectors; sector += 64) {
+    writeSectors(sector, 64);
+  }
+  ASSERT_TRUE(ftlSync(&ftl));
+
+  // sequential reads: multi sector vs sector by sector
+  std::vector<uint8_t> buf(64 * SECTOR);
+  flash.resetCounters();
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t sector = 0; sector + 64 <= coldSectors; sector += 64) {
+    ASSERT_TRUE(ftlReadSectors(&ftl, sector, 64, buf.data()));
+  }
+  auto vectored = std::chrono::steady_clock::now() - start;
+  uint32_t vectoredReads = flash.reads;
+
+  flash.resetCounters();
+  start = std::chrono::steady_clock::now();
+  for (uint32_t sector = 0; sector + 64 <= coldSectors; sector += 64) {
+    for (uint32_t i = 0; i < 64; i++) {
+      ASSERT_TRUE(ftlRead(&ftl, sector + i, &buf[i * SECTOR]));
+    }
+  }
+  auto single = std::chrono::steady_clock::now() - start;
+  uint32_t singleReads = flash.reads;
+
+  EXPECT_LE(vectoredReads, singleReads);
+
+  auto mbps = [&](std::chrono::steady_clock::duration d) {
+    double s = std::chrono::duration<double>(d).count();
+    return s > 0 ? coldSectors * SECTOR / s / (1024 * 1024) : 0.0;
+  };
+  if (report) {
+    printf("read: %u flash reads (%.0f MB/s), sector by sector: %u (%.0f MB/s)\n",
+           vectoredReads, mbps(vectored), singleReads, mbps(single));
+  }
+
+  // hot data: small files rewritten and synced
+  flash.resetCounters();
+  uint64_t hostBytes = 0;
+  std::uniform_int_distribution<uint32_t> hot(0, 31);
+  for (int i = 0; i < 3000; i++) {
+    uint32_t sector = coldSectors + hot(gen) * 8;
+    writeSectors(sector, 8);
+    hostBytes += 8 * SECTOR;
+    ASSERT_TRUE(ftlSync(&ftl));
+    ftlReclaim(&ftl);
+  }
+
+  EXPECT_TRUE(readMatches(0, 256));
+  EXPECT_TRUE(readMatches(coldSectors, 32 * 8));
+
+  uint32_t maxErases = 0;
+  uint32_t minErases = UINT32_MAX;
+  uint32_t erasedPages = 0;
+  uint64_t totalErases = 0;
+  for (auto e : flash.pageErases) {
+    if (e == 0) continue;
+    erasedPages++;
+    totalErases += e;
+    maxErases = std::max(maxErases, e);
+    minErases = std::min(minErases, e);
+  }
+
+  uint32_t meanErases = totalErases / std::max(erasedPages, 1u);
+  if (report) {
+    printf("write amplification: %.2f, %u pages erased %u-%u times (mean %u)\n",
+           (double)flash.programBytes / hostBytes, erasedPages, minErases,
+           maxErases, meanErases);
+  }
+
+  // the rewrites are spread over all the free pages, not only
+  // over the ones next to the write frontier
+  EXPECT_GE(erasedPages, (uint32_t)(FLASH_SIZE / FLASH_PAGE / 3));
+  EXPECT_LE(maxErases, 3 * meanErases);
+}
+
+TEST_F(FrFTLTest, workload)
+{
+  workload(false);
+}
+
+// Opt-in: run with --gtest_also_run_disabled_tests
+TEST_F(FrFTLTest, DISABLED_workloadReport)
+{
+  workload(true);
+}
@@ -366,6 +366,7 @@ TEST(FrSkySPORT, frskySetCellVoltageTwoSensors)
   g_model.telemetrySensors[2].prec = 1;
   g_model.telemetrySensors[2].calc.sources[0] = 1;
   g_model.telemetrySensors[2].calc.sources[1] = 2;
+  calculatedSensorsInvalidate();
 
   telemetryWakeup();
 
@@ -514,3 +515,58 @@ TEST(FrSkySPORT, frskyCurrent)
   EXPECT_EQ(telemetryItems[0].valueMax, 505);
 }
 
+TEST(Telemetry, calculatedSensorsEvaluatedOnChange)
+{
+  MODEL_RESET();
+  TELEMETRY_RESET();
+  telemetryStreaming = TELEMETRY_TIMEOUT10ms;
+
+  TelemetrySensor & source = g_model.telemetrySensors[0];
+  source.init("Src", UNIT_VOLTS, 1);
+
+  // "Tot" uses "Dbl", evaluated first although after it
+  TelemetrySensor & total = g_model.telemetrySensors[1];
+  total.init("Tot", UNIT_VOLTS, 1);
+  total.type = TELEM_TYPE_CALCULATED;
+  total.formula = TELEM_FORMULA_ADD;
+  total.calc.sources[0] = 3;
+
+  TelemetrySensor & twice = g_model.telemetrySensors[2];
+  twice.init("Dbl", UNIT_VOLTS, 1);
+  twice.type = TELEM_TYPE_CALCULATED;
+  twice.formula = TELEM_FORMULA_ADD;
+  twice.calc.sources[0] = 1;
+  twice.calc.sources[1] = 1;
+  calculatedSensorsInvalidate();
+
+  telemetryItems[0].setValue(source, 50, UNIT_VOLTS, 1);
+  telemetryWakeup();
+  EXPECT_EQ(100, telemetryItems[2].value);
+  EXPECT_EQ(100, telemetryItems[1].value);
+
+  // not evaluated again while the source is unchanged
+  telemetryItems[1].value = 0;
+  telemetryWakeup();
+  EXPECT_EQ(0, telemetryItems[1].value);
+
+  telemetryItems[0].setValue(source, 60, UNIT_VOLTS, 1);
+  telemetryWakeup();
+  EXPECT_EQ(120, telemetryItems[1].value);
+
+  // lost sources
+  telemetryItems[0].setOld();
+  telemetryWakeup();
+  EXPECT_TRUE(telemetryItems[2].isOld());
+  EXPECT_TRUE(telemetryItems[1].isOld());
+
+  // sources edited in the sensor page
+  TelemetrySensor & other = g_model.telemetrySensors[3];
+  other.init("Src2", UNIT_VOLTS, 1);
+  twice.calc.sources[0] = 4;
+  twice.calc.sources[1] = 0;
+  telemetrySensorEdited();
+  telemetryItems[3].setValue(other, 30, UNIT_VOLTS, 1);
+  telemetryWakeup();
+  EXPECT_EQ(30, telemetryItems[2].value);
+  EXPECT_EQ(30, telemetryItems[1].value);
+}
@@ -28,6 +28,7 @@
 #include "simulib.h"
 #include "model_init.h"
 #include "switches.h"
+#include "name_table.h"
 #include "hal/switch_driver.h"
 
 #define CHANNEL_MAX (1024*256)
@@ -87,6 +88,8 @@ inline void MODEL_RESET()
   s_mixer_first_run_done = false;
   evalMixes(1);  // this is needed to reset fp_act
   lastFlightMode = 255;
+  nameTableInvalidate();
+  calculatedSensorsInvalidate();
 }
 
 inline void MIXER_RESET()
@@ -541,4 +541,64 @@ TEST(Lcd, lcdDrawLine)
   EXPECT_TRUE(checkScreenshot("lcdDrawLine"));
 }
 #endif
+
+#if defined(LCD_CHANGED_PAGES_REFRESH)
+TEST(Lcd, changedColumns)
+{
+  coord_t first, last;
+
+  // first refresh: the whole screen
+  lcdClear();
+  lcdRefreshAll();
+  for (uint8_t page = 0; page < LCD_H / 8; page++) {
+    EXPECT_TRUE(lcdGetChangedColumns(page, first, last));
+    EXPECT_EQ(0, first);
+    EXPECT_EQ(LCD_W - 1, last);
+  }
+
+  // nothing changed
+  for (uint8_t page = 0; page < LCD_H / 8; page++) {
+    EXPECT_FALSE(lcdGetChangedColumns(page, first, last));
+  }
+
+  // only the columns of the text
+  lcdDrawText(20, 2 * FH, "Hi");
+  for (uint8_t page = 0; page < LCD_H / 8; page++) {
+    if (page == 2) {
+      EXPECT_TRUE(lcdGetChangedColumns(page, first, last));
+      EXPECT_GE(first, 20);
+      EXPECT_LT(last, 20 + 2 * FW);
+    } else {
+      EXPECT_FALSE(lcdGetChangedColumns(page, first, last));
+    }
+  }
+}
+
+TEST(Lcd, periodicFullRefresh)
+{
+  coord_t first, last;
+
+  lcdClear();
+  lcdRefreshAll();
+  for (uint8_t page = 0; page < LCD_H / 8; page++) {
+    lcdGetChangedColumns(page, first, last);
+  }
+
+  for (int frame = 1; frame < LCD_FULL_REFRESH_FRAMES; frame++) {
+    for (uint8_t page = 0; page < LCD_H / 8; page++) {
+      EXPECT_FALSE(lcdGetChangedColumns(page, first, last));
+    }
+  }
+
+  // nothing changed, but the whole screen is sent again
+  for (uint8_t page = 0; page < LCD_H / 8; page++) {
+    EXPECT_TRUE(lcdGetChangedColumns(page, first, last));
+    EXPECT_EQ(0, first);
+    EXPECT_EQ(LCD_W - 1, last);
+  }
+  for (uint8_t page = 0; page < LCD_H / 8; page++) {
+    EXPECT_FALSE(lcdGetChangedColumns(page, first, last));
+  }
+}
+#endif
 #endif
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "gtests.h"
+
+#if defined(LUA)
+
+#include "location.h"
+#include "lua/lua_pack.h"
+
+#define PACK_FILE "/lua_pack_test.pak"
+#define PACK_FORMAT 0x52080408
+
+static const uint8_t code1[] = {0x1B, 'L', 'u', 'a', 1, 2, 3};
+static const uint8_t code2[] = {0x1B, 'L', 'u', 'a', 4, 5, 6, 7, 8};
+
+class LuaPackTest : public testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    simuFatfsSetPaths(TESTS_BUILD_PATH, nullptr);
+    luaPackClose();
+  }
+
+  void TearDown() override
+  {
+    luaPackClose();
+    f_unlink(PACK_FILE);
+    simuFatfsSetPaths(TESTS_PATH, nullptr);
+  }
+
+  void writePack()
+  {
+    ASSERT_TRUE(luaPackWrite(PACK_FILE, PACK_FILE ".tmp"));
+  }
+};
+
+TEST_F(LuaPackTest, FindMatchesSourceStamp)
+{
+  EXPECT_TRUE(luaPackAdd("/SCRIPTS/MIXES/a.lua", 100, 0x1234, code1,
+                         sizeof(code1)));
+  EXPECT_TRUE(luaPackDirty());
+
+  uint32_t len = 0;
+  auto data = luaPackFind("/SCRIPTS/MIXES/a.lua", 100, 0x1234, &len);
+  ASSERT_NE(nullptr, data);
+  EXPECT_EQ(sizeof(code1), len);
+  EXPECT_EQ(0, memcmp(code1, data, len));
+
+  // FAT paths are case insensitive
+  EXPECT_NE(nullptr, luaPackFind("/scripts/mixes/A.LUA", 100, 0x1234, &len));
+
+  // source changed
+  EXPECT_EQ(nullptr, luaPackFind("/SCRIPTS/MIXES/a.lua", 101, 0x1234, &len));
+  EXPECT_EQ(nullptr, luaPackFind("/SCRIPTS/MIXES/a.lua", 100, 0x1235, &len));
+  EXPECT_EQ(nullptr, luaPackFind("/SCRIPTS/MIXES/b.lua", 100, 0x1234, &len));
+
+  // replaced
+  EXPECT_TRUE(luaPackAdd("/SCRIPTS/MIXES/a.lua", 120, 0x1240, code2,
+                         sizeof(code2)));
+  EXPECT_EQ(1, luaPackCount());
+  data = luaPackFind("/SCRIPTS/MIXES/a.lua", 120, 0x1240, &len);
+  ASSERT_NE(nullptr, data);
+  EXPECT_EQ(sizeof(code2), len);
+
+  luaPackRemove("/SCRIPTS/MIXES/a.lua");
+  EXPECT_EQ(0, luaPackCount());
+}
+
+TEST_F(LuaPackTest, Roundtrip)
+{
+  luaPackOpen(PACK_FILE, PACK_FORMAT);
+  EXPECT_TRUE(luaPackAdd("/SCRIPTS/MIXES/a.lua", 100, 0x1234, code1,
+                         sizeof(code1)));
+  EXPECT_TRUE(luaPackAdd("/SCRIPTS/FUNCTIONS/b.lua", 200, 0x5678, code2,
+                         sizeof(code2)));
+  writePack();
+  EXPECT_FALSE(luaPackDirty());
+
+  ASSERT_TRUE(luaPackOpen(PACK_FILE, PACK_FORMAT));
+  EXPECT_EQ(2, luaPackCount());
+  EXPECT_FALSE(luaPackDirty());
+
+  uint32_t len = 0;
+  auto data = luaPackFind("/SCRIPTS/FUNCTIONS/b.lua", 200, 0x5678, &len);
+  ASSERT_NE(nullptr, data);
+  EXPECT_EQ(sizeof(code2), len);
+  EXPECT_EQ(0, memcmp(code2, data, len));
+
+  data = luaPackFind("/SCRIPTS/MIXES/a.lua", 100, 0x1234, &len);
+  ASSERT_NE(nullptr, data);
+  EXPECT_EQ(sizeof(code1), len);
+  EXPECT_EQ(0, memcmp(code1, data, len));
+
+  // entries loaded from the file and added later are written together
+  EXPECT_TRUE(luaPackAdd("/SCRIPTS/TELEMETRY/c.lua", 300, 0x9ABC, code1,
+                         sizeof(code1)));
+  writePack();
+  ASSERT_TRUE(luaPackOpen(PACK_FILE, PACK_FORMAT));
+  EXPECT_EQ(3, luaPackCount());
+  EXPECT_NE(nullptr, luaPackFind("/SCRIPTS/MIXES/a.lua", 100, 0x1234, &len));
+}
+
+TEST_F(LuaPackTest, RejectsOtherFormat)
+{
+  luaPackOpen(PACK_FILE, PACK_FORMAT);
+  EXPECT_TRUE(luaPackAdd("/SCRIPTS/MIXES/a.lua", 100, 0x1234, code1,
+                         sizeof(code1)));
+  writePack();
+
+  EXPECT_FALSE(luaPackOpen(PACK_FILE, PACK_FORMAT + 1));
+  EXPECT_EQ(0, luaPackCount());
+}
+
+TEST_F(LuaPackTest, RejectsTruncatedFile)
+{
+  luaPackOpen(PACK_FILE, PACK_FORMAT);
+  EXPECT_TRUE(luaPackAdd("/SCRIPTS/MIXES/a.lua", 100, 0x1234, code1,
+                         sizeof(code1)));
+  writePack();
+
+  FIL file;
+  ASSERT_EQ(FR_OK, f_open(&file, PACK_FILE, FA_OPEN_EXISTING | FA_WRITE));
+  f_lseek(&file, f_size(&file) - 1);
+  EXPECT_EQ(FR_OK, f_truncate(&file));
+  f_close(&file);
+
+  EXPECT_FALSE(luaPackOpen(PACK_FILE, PACK_FORMAT));
+  EXPECT_EQ(0, luaPackCount());
+}
+
+TEST_F(LuaPackTest, EvictsUnusedEntries)
+{
+  luaPackOpen(PACK_FILE, PACK_FORMAT);
+  char path[32];
+  for (int i = 0; i < LUA_PACK_MAX_ENTRIES; i++) {
+    snprintf(path, sizeof(path), "/SCRIPTS/MIXES/s%d.lua", i);
+    EXPECT_TRUE(luaPackAdd(path, i, i, code1, sizeof(code1)));
+  }
+  writePack();
+
+  // after a reload only the scripts looked up are in use
+  ASSERT_TRUE(luaPackOpen(PACK_FILE, PACK_FORMAT));
+  uint32_t len;
+  EXPECT_NE(nullptr, luaPackFind("/SCRIPTS/MIXES/s0.lua", 0, 0, &len));
+
+  EXPECT_TRUE(luaPackAdd("/SCRIPTS/MIXES/new.lua", 1, 1, code2,
+                         sizeof(code2)));
+  EXPECT_LE(luaPackCount(), LUA_PACK_MAX_ENTRIES);
+  EXPECT_NE(nullptr, luaPackFind("/SCRIPTS/MIXES/s0.lua", 0, 0, &len));
+  EXPECT_NE(nullptr, luaPackFind("/SCRIPTS/MIXES/new.lua", 1, 1, &len));
+}
+
+#endif  // LUA
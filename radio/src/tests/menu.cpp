@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "gtests.h"
+
+#if defined(COLORLCD)
+
+#include <string>
+
+#include "mainwindow.h"
+#include "menu.h"
+
+static lv_obj_t* findTable(lv_obj_t* obj)
+{
+  if (lv_obj_check_type(obj, &lv_table_class)) return obj;
+  for (uint32_t i = 0; i < lv_obj_get_child_cnt(obj); i++) {
+    lv_obj_t* table = findTable(lv_obj_get_child(obj, i));
+    if (table) return table;
+  }
+  return nullptr;
+}
+
+class MenuTest : public testing::Test
+{
+ protected:
+  Menu* menu = nullptr;
+  lv_obj_t* table = nullptr;
+  int fetched = 0;
+
+  void SetUp() override
+  {
+    menu = new Menu();
+    menu->setVirtualLines(
+        500,
+        [this](int row) {
+          fetched++;
+          return "Line " + std::to_string(row);
+        },
+        [](int) {});
+    menu->addLine("Extra", []() {});
+    menu->updateLines();
+
+    table = findTable(menu->getLvObj());
+    ASSERT_NE(nullptr, table);
+  }
+
+  void TearDown() override
+  {
+    menu->deleteLater();
+    MainWindow::instance()->emptyTrash();
+  }
+
+  std::string text(int row)
+  {
+    return lv_table_get_cell_value(table, row, 0);
+  }
+};
+
+TEST_F(MenuTest, virtualLinesFetchedOnDemand)
+{
+  EXPECT_EQ(501u, menu->count());
+  EXPECT_EQ(501, lv_table_get_row_cnt(table));
+
+  // only the rows around the visible ones
+  EXPECT_GT(fetched, 0);
+  EXPECT_LT(fetched, 100);
+  EXPECT_EQ("Line 0", text(0));
+  EXPECT_EQ("", text(499));
+
+  // other lines come after the virtual ones, and always have a text
+  EXPECT_EQ("Extra", text(500));
+}
+
+TEST_F(MenuTest, virtualRowsFollowScroll)
+{
+  lv_obj_update_layout(table);
+  lv_coord_t row_h = ((lv_table_t*)table)->row_h[0];
+  ASSERT_GT(row_h, 0);
+
+  lv_obj_scroll_to_y(table, 400 * row_h, LV_ANIM_OFF);
+  EXPECT_EQ("Line 400", text(400));
+
+  // rows out of range are cleared through the table API: the crop
+  // flag stays, and so every row keeps the same height
+  EXPECT_EQ("", text(0));
+  EXPECT_TRUE(lv_table_has_cell_ctrl(table, 0, 0,
+                                     LV_TABLE_CELL_CTRL_TEXT_CROP));
+  lv_obj_update_layout(table);
+  EXPECT_EQ(row_h, ((lv_table_t*)table)->row_h[0]);
+  EXPECT_EQ(row_h, ((lv_table_t*)table)->row_h[400]);
+
+  lv_obj_scroll_to_y(table, 0, LV_ANIM_OFF);
+  EXPECT_EQ("Line 0", text(0));
+  EXPECT_EQ("", text(400));
+}
+
+TEST_F(MenuTest, removeLinesFreesVirtualRows)
+{
+  menu->removeLines();
+  EXPECT_EQ(0u, menu->count());
+  EXPECT_EQ(0, lv_table_get_row_cnt(table));
+
+  fetched = 0;
+  menu->setVirtualLines(
+      3, [this](int row) {
+        fetched++;
+        return std::to_string(row);
+      },
+      nullptr);
+  menu->updateLines();
+  EXPECT_EQ(3, fetched);
+  EXPECT_EQ("2", text(2));
+}
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "gtests.h"
+#include "storage/model_cache.h"
+
+class ModelCacheTest : public EdgeTxTest
+{
+ protected:
+  void SetUp() override
+  {
+    EdgeTxTest::SetUp();
+    modelCacheClear();
+  }
+
+  void TearDown() override
+  {
+    modelCacheClear();
+    EdgeTxTest::TearDown();
+  }
+
+  // store a model that can be told apart by its first receiver number
+  static void store(const char* filename, const char* hash, uint8_t id = 1)
+  {
+    memclear(&g_model, sizeof(g_model));
+    g_model.header.modelId[0] = id;
+    modelCacheStore(filename, hash);
+  }
+
+  static bool restore(const char* filename, const char* hash)
+  {
+    memclear(&g_model, sizeof(g_model));
+    return modelCacheRestore(filename, hash);
+  }
+};
+
+TEST_F(ModelCacheTest, hit)
+{
+  store("model01.yml", "0011");
+  auto hits = modelCacheGetStats().hits;
+
+  ASSERT_TRUE(restore("model01.yml", "0011"));
+  EXPECT_EQ(1, g_model.header.modelId[0]);
+  EXPECT_EQ(hits + 1, modelCacheGetStats().hits);
+
+  // still there after a hit
+  EXPECT_TRUE(restore("model01.yml", "0011"));
+}
+
+TEST_F(ModelCacheTest, miss)
+{
+  auto misses = modelCacheGetStats().misses;
+
+  EXPECT_FALSE(restore("model01.yml", "0011"));
+  EXPECT_EQ(misses + 1, modelCacheGetStats().misses);
+
+  // file changed since it was decoded: the entry is dropped
+  store("model01.yml", "0011");
+  EXPECT_FALSE(restore("model01.yml", "0012"));
+  EXPECT_FALSE(restore("model01.yml", "0011"));
+  EXPECT_EQ(misses + 3, modelCacheGetStats().misses);
+}
+
+TEST_F(ModelCacheTest, invalidation)
+{
+  store("model01.yml", "0011");
+  store("model02.yml", "0022");
+
+  modelCacheInvalidate("model01.yml");
+  EXPECT_FALSE(restore("model01.yml", "0011"));
+  EXPECT_TRUE(restore("model02.yml", "0022"));
+
+  modelCacheClear();
+  EXPECT_FALSE(restore("model02.yml", "0022"));
+}
+
+TEST_F(ModelCacheTest, storeReplacesEntry)
+{
+  store("model01.yml", "0011", 1);
+  store("model01.yml", "0012", 2);
+  EXPECT_TRUE(restore("model01.yml", "0012"));
+  EXPECT_EQ(2, g_model.header.modelId[0]);
+
+  // the file name still takes a single entry
+  for (int i = 0; i < MODEL_CACHE_ENTRIES - 1; i++) {
+    char filename[LEN_MODEL_FILENAME + 1];
+    snprintf(filename, sizeof(filename), "other%02d.yml", i);
+    store(filename, "0033");
+  }
+  EXPECT_TRUE(restore("model01.yml", "0012"));
+}
+
+TEST_F(ModelCacheTest, evictsLeastRecentlyUsed)
+{
+  char filenames[MODEL_CACHE_ENTRIES + 1][LEN_MODEL_FILENAME + 1];
+  for (int i = 0; i <= MODEL_CACHE_ENTRIES; i++) {
+    snprintf(filenames[i], sizeof(filenames[i]), "model%02d.yml", i);
+  }
+
+  for (int i = 0; i < MODEL_CACHE_ENTRIES; i++) {
+    store(filenames[i], "0011", i);
+  }
+
+  // the first model is used again, the second becomes the oldest one
+  EXPECT_TRUE(restore(filenames[0], "0011"));
+  store(filenames[MODEL_CACHE_ENTRIES], "0011", MODEL_CACHE_ENTRIES);
+
+  EXPECT_FALSE(restore(filenames[1], "0011"));
+  EXPECT_TRUE(restore(filenames[0], "0011"));
+  EXPECT_EQ(0, g_model.header.modelId[0]);
+  for (int i = 2; i <= MODEL_CACHE_ENTRIES; i++) {
+    EXPECT_TRUE(restore(filenames[i], "0011")) << filenames[i];
+    EXPECT_EQ(i, g_model.header.modelId[0]);
+  }
+}
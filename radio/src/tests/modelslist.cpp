@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "gtests.h"
+
+#if defined(STORAGE_MODELSLIST)
+
+#include "storage/modelslist.h"
+
+class ModelsListTest : public EdgeTxTest
+{
+ protected:
+  // Labels of the models, "*" standing for the favorite label
+  static constexpr const char* MODELS[][2] = {
+      {"Alpha", "*,race"},       {"bravo", "race,park"},
+      {"Charlie", "park"},       {"delta", ""},
+      {"Echo", "*"},             {"foxtrot", "*,race,park"},
+  };
+
+  ModelCell* cells[DIM(MODELS)];
+
+  void SetUp() override
+  {
+    EdgeTxTest::SetUp();
+    modelslist.clear();
+    modelslabels.clear();
+    modelslabels.setSortOrder(NAME_ASC);
+
+    for (unsigned i = 0; i < DIM(MODELS); i++) {
+      char filename[LEN_MODEL_FILENAME + 1];
+      snprintf(filename, sizeof(filename), "model%02u.yml", i);
+      cells[i] = modelslist.addModel(filename, false);
+      setName(cells[i], MODELS[i][0]);
+      for (auto lbl : ModelMap::fromCSV(MODELS[i][1])) {
+        if (lbl == "*") lbl = STR_FAVORITE_LABEL;
+        modelslabels.addLabelToModel(lbl, cells[i]);
+      }
+    }
+  }
+
+  void TearDown() override
+  {
+    modelslist.clear();
+    modelslabels.clear();
+  }
+
+  static void setName(ModelCell* cell, const char* name)
+  {
+    char buffer[LEN_MODEL_NAME + 1];
+    strncpy(buffer, name, sizeof(buffer));
+    cell->setModelName(buffer);
+  }
+
+  // Names of the models, in the listed order
+  static std::string names(const ModelsVector& models)
+  {
+    std::string result;
+    for (auto cell : models) {
+      if (!result.empty()) result += ",";
+      result += cell->modelName;
+    }
+    return result;
+  }
+};
+
+TEST_F(ModelsListTest, labelAndFavoriteMultiModes)
+{
+  struct {
+    uint8_t labelMultiMode;
+    uint8_t favMultiMode;
+    const char* expected;
+  } cases[] = {
+      {0, 0, "foxtrot"},
+      {0, 1, "foxtrot"},
+      {1, 0, "Alpha,foxtrot"},
+      {1, 1, "Alpha,bravo,Charlie,Echo,foxtrot"},
+  };
+
+  LabelsVector filter = {STR_FAVORITE_LABEL, "race", "park"};
+  for (const auto& c : cases) {
+    g_eeGeneral.labelMultiMode = c.labelMultiMode;
+    g_eeGeneral.favMultiMode = c.favMultiMode;
+    EXPECT_EQ(c.expected, names(modelslabels.getModelsInLabels(filter)))
+        << "labelMultiMode " << (int)c.labelMultiMode << ", favMultiMode "
+        << (int)c.favMultiMode;
+  }
+
+  // without the favorite label, favMultiMode does not matter
+  filter = {"race", "park"};
+  for (uint8_t favMultiMode = 0; favMultiMode <= 1; favMultiMode++) {
+    g_eeGeneral.favMultiMode = favMultiMode;
+    g_eeGeneral.labelMultiMode = 0;
+    EXPECT_EQ("bravo,foxtrot", names(modelslabels.getModelsInLabels(filter)));
+    g_eeGeneral.labelMultiMode = 1;
+    EXPECT_EQ("Alpha,bravo,Charlie,foxtrot",
+              names(modelslabels.getModelsInLabels(filter)));
+  }
+}
+
+TEST_F(ModelsListTest, unlabeledModels)
+{
+  EXPECT_EQ("delta", names(modelslabels.getUnlabeledModels()));
+  EXPECT_EQ("delta", names(modelslabels.getModelsInLabels({STR_UNLABELEDMODEL})));
+
+  // listed once, even when in several of the labels
+  EXPECT_EQ("bravo,Charlie,delta,foxtrot",
+            names(modelslabels.getModelsByLabels({"park", STR_UNLABELEDMODEL})));
+  EXPECT_EQ("Alpha,bravo,Charlie,foxtrot",
+            names(modelslabels.getModelsByLabels({"race", "park"})));
+
+  // no longer unlabeled
+  modelslabels.addLabelToModel("park", cells[3]);
+  EXPECT_EQ("", names(modelslabels.getUnlabeledModels()));
+  EXPECT_EQ("bravo,Charlie,delta,foxtrot",
+            names(modelslabels.getModelsByLabel("park")));
+}
+
+TEST_F(ModelsListTest, sortedAfterOpening)
+{
+  for (unsigned i = 0; i < DIM(MODELS); i++) {
+    cells[i]->lastOpened = i + 1;
+  }
+  modelslabels.setSortOrder(DATE_DES);
+  EXPECT_EQ("foxtrot,Echo,delta,Charlie,bravo,Alpha",
+            names(modelslabels.getAllModels()));
+
+  modelslist.setCurrentModel(cells[2]);
+  EXPECT_EQ("Charlie,foxtrot,Echo,delta,bravo,Alpha",
+            names(modelslabels.getAllModels()));
+  EXPECT_EQ("Charlie,foxtrot,bravo",
+            names(modelslabels.getModelsByLabel("park")));
+
+  modelslabels.setSortOrder(DATE_ASC);
+  EXPECT_EQ("Alpha,bravo,delta,Echo,foxtrot,Charlie",
+            names(modelslabels.getAllModels()));
+}
+
+TEST_F(ModelsListTest, sortedAfterRenaming)
+{
+  EXPECT_EQ("Alpha,bravo,Charlie,delta,Echo,foxtrot",
+            names(modelslabels.getAllModels()));
+
+  setName(cells[0], "zulu");
+  EXPECT_EQ("bravo,Charlie,delta,Echo,foxtrot,zulu",
+            names(modelslabels.getAllModels()));
+  EXPECT_EQ("bravo,foxtrot,zulu",
+            names(modelslabels.getModelsByLabel("race")));
+
+  setName(cells[5], "ALFA");
+  modelslabels.setSortOrder(NAME_DES);
+  EXPECT_EQ("zulu,Echo,delta,Charlie,bravo,ALFA",
+            names(modelslabels.getAllModels()));
+}
+
+#endif
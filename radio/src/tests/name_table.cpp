@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "gtests.h"
+
+class NameTableTest : public EdgeTxTest {};
+
+// model names are not NUL terminated when they fill their field
+template <size_t N>
+static void setName(char (&dest)[N], const char* name)
+{
+  memset(dest, 0, N);
+  memcpy(dest, name, std::min(strlen(name), N));
+}
+
+TEST_F(NameTableTest, matchesStrings)
+{
+  setName(g_model.limitData[1].name, "Ail");
+  setName(g_model.inputNames[0], "Thr");
+  nameTableInvalidate();
+
+  for (mixsrc_t idx = MIXSRC_NONE; idx <= MIXSRC_LAST_TELEM; idx++) {
+    std::string expected = getSourceString(idx);
+    EXPECT_STREQ(expected.c_str(), sourceNameLookup(idx)) << idx;
+  }
+  for (swsrc_t idx = SWSRC_NONE; idx < SWSRC_COUNT; idx++) {
+    std::string expected = getSwitchPositionName(idx);
+    EXPECT_STREQ(expected.c_str(), switchNameLookup(idx)) << idx;
+  }
+
+  std::string expected = getSourceString(-(MIXSRC_FIRST_CH + 1));
+  EXPECT_STREQ(expected.c_str(), sourceNameLookup(-(MIXSRC_FIRST_CH + 1)));
+  expected = getSwitchPositionName(-SWSRC_FIRST_LOGICAL_SWITCH);
+  EXPECT_STREQ(expected.c_str(), switchNameLookup(-SWSRC_FIRST_LOGICAL_SWITCH));
+}
+
+TEST_F(NameTableTest, invalidatedOnRename)
+{
+  std::string before = sourceNameLookup(MIXSRC_FIRST_CH);
+
+  // kept until the table is invalidated, other model edits do not matter
+  setName(g_model.limitData[0].name, "Gr");
+  storageDirty(EE_MODEL);
+  EXPECT_STREQ(before.c_str(), sourceNameLookup(MIXSRC_FIRST_CH));
+
+  nameTableInvalidate();
+  EXPECT_STREQ("Gr", sourceNameLookup(MIXSRC_FIRST_CH));
+  EXPECT_EQ(MIXSRC_FIRST_CH, getSourceIndex("Gr", true));
+}
+
+TEST_F(NameTableTest, invalidatedOnSensorChanges)
+{
+  const mixsrc_t source = MIXSRC_FIRST_TELEM;
+  std::string empty = sourceNameLookup(source);
+
+  // discovered sensor
+  allowNewSensors = true;
+  ASSERT_EQ(0, setTelemetryValue(PROTOCOL_TELEMETRY_FRSKY_SPORT, RSSI_ID, 0,
+                                 0, 75, UNIT_DB, 0));
+  EXPECT_STRNE(empty.c_str(), sourceNameLookup(source));
+  EXPECT_STREQ(getSourceString(source), sourceNameLookup(source));
+
+  delTelemetryIndex(0);
+  EXPECT_STREQ(empty.c_str(), sourceNameLookup(source));
+}
+
+TEST_F(NameTableTest, search)
+{
+  setName(g_model.limitData[2].name, "Flap");
+  setName(g_model.limitData[5].name, "FlpR");
+  setName(g_model.timers[0].name, "Flt");
+  nameTableInvalidate();
+
+  NameSearch search;
+  auto& fl = search.search("fl");
+  ASSERT_EQ(3u, fl.size());
+  EXPECT_EQ(MIXSRC_FIRST_CH + 2, fl[0]);
+  EXPECT_EQ(MIXSRC_FIRST_CH + 5, fl[1]);
+  EXPECT_EQ(MIXSRC_FIRST_TIMER, fl[2]);
+
+  // typed on
+  auto& fla = search.search("FLA");
+  ASSERT_EQ(1u, fla.size());
+  EXPECT_EQ(MIXSRC_FIRST_CH + 2, fla[0]);
+
+  // back to a shorter text: searched again from scratch
+  EXPECT_EQ(3u, search.search("fl").size());
+
+  // substring, but not prefix
+  EXPECT_EQ(1u, search.search("ap").size());
+  NameSearch prefix(false, true);
+  EXPECT_EQ(0u, prefix.search("ap").size());
+  EXPECT_EQ(1u, prefix.search("flap").size());
+
+  // renamed since the last search
+  setName(g_model.limitData[5].name, "Flap");
+  nameTableInvalidate();
+  EXPECT_EQ(2u, prefix.search("flap").size());
+
+  // switches
+  NameSearch switches(true, true);
+  for (auto idx : switches.search("L0")) {
+    EXPECT_GE(idx, SWSRC_FIRST_LOGICAL_SWITCH);
+    EXPECT_LE(idx, SWSRC_LAST_LOGICAL_SWITCH);
+  }
+  EXPECT_EQ(9u, switches.results().size());
+}
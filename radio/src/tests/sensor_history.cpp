@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "gtests.h"
+#include "telemetry/sensor_history.h"
+
+class SensorHistoryTest : public EdgeTxTest
+{
+ protected:
+  tmr10ms_t savedTmr10ms;
+
+  void SetUp() override
+  {
+    EdgeTxTest::SetUp();
+    TELEMETRY_RESET();
+    sensorHistoryReset();
+    for (int i = 0; i < SENSOR_HISTORY_SLOTS + 1; i++) {
+      g_model.telemetrySensors[i].init("Tst", UNIT_RAW, 0);
+    }
+    savedTmr10ms = g_tmr10ms;
+    g_tmr10ms = 1000;
+  }
+
+  void TearDown() override
+  {
+    sensorHistoryReset();
+    g_tmr10ms = savedTmr10ms;
+  }
+
+  void setValue(int index, int32_t value)
+  {
+    telemetryItems[index].setValue(g_model.telemetrySensors[index], value, UNIT_RAW, 0);
+  }
+
+  // requested by a reader, then claimed by the telemetry task
+  const SensorHistoryRing* claim(uint8_t index, SensorHistoryTier tier)
+  {
+    sensorHistory(index, tier);
+    sensorHistoryWakeup();
+    return sensorHistory(index, tier);
+  }
+};
+
+TEST_F(SensorHistoryTest, recordedOnceRequested)
+{
+  setValue(0, 10);
+
+  // claimed by the telemetry task, not by the reader
+  EXPECT_EQ(nullptr, sensorHistory(0, SENSOR_HISTORY_RAW));
+  setValue(0, 11);
+  EXPECT_EQ(nullptr, sensorHistory(0, SENSOR_HISTORY_RAW));
+
+  sensorHistoryWakeup();
+  auto raw = sensorHistory(0, SENSOR_HISTORY_RAW);
+  ASSERT_NE(nullptr, raw);
+  EXPECT_EQ(0, raw->count());
+
+  for (int i = 0; i < SENSOR_HISTORY_LENGTH + 5; i++) {
+    setValue(0, i);
+  }
+
+  EXPECT_EQ(SENSOR_HISTORY_LENGTH, raw->count());
+  EXPECT_EQ(nullptr, raw->get(raw->first() - 1));
+  EXPECT_EQ(5, raw->get(raw->first())->avg);
+  EXPECT_EQ(SENSOR_HISTORY_LENGTH + 4, raw->get(raw->end() - 1)->max);
+}
+
+TEST_F(SensorHistoryTest, downsampledTiers)
+{
+  auto seconds = claim(0, SENSOR_HISTORY_1S);
+  auto tens = sensorHistory(0, SENSOR_HISTORY_10S);
+  ASSERT_NE(nullptr, seconds);
+  ASSERT_EQ(tens, sensorHistory(0, SENSOR_HISTORY_10S));
+
+  // 2 values per 10ms period: 100 buckets of 200 values
+  for (int t = 0; t < 10000; t++) {
+    setValue(0, t % 100);
+    setValue(0, 200);
+    g_tmr10ms++;
+  }
+  setValue(0, 0);
+
+  ASSERT_EQ(std::min<int>(100, SENSOR_HISTORY_LENGTH), seconds->count());
+  for (uint32_t n = seconds->first(); n < seconds->end(); n++) {
+    auto bucket = seconds->get(n);
+    EXPECT_EQ(0, bucket->min);
+    EXPECT_EQ(200, bucket->max);
+    EXPECT_EQ((4950 + 20000) / 200, bucket->avg);
+  }
+
+  // the tenth second is still pending in the 1s tier
+  ASSERT_EQ(9, tens->count());
+  EXPECT_EQ(124, tens->get(0)->avg);
+}
+
+TEST_F(SensorHistoryTest, gapsAreEmptyBuckets)
+{
+  auto seconds = claim(0, SENSOR_HISTORY_1S);
+  setValue(0, 10);
+  g_tmr10ms += 350;
+  setValue(0, 20);
+
+  // the bucket of the first value, then 2 seconds without any
+  ASSERT_EQ(3, seconds->count());
+  EXPECT_EQ(10, seconds->get(0)->avg);
+  EXPECT_TRUE(seconds->get(1)->isEmpty());
+  EXPECT_TRUE(seconds->get(2)->isEmpty());
+}
+
+TEST_F(SensorHistoryTest, tiersFollowTimeWithoutValues)
+{
+  auto seconds = claim(0, SENSOR_HISTORY_1S);
+  auto tens = sensorHistory(0, SENSOR_HISTORY_10S);
+  setValue(0, 10);
+
+  // the sensor stopped sending: its last second is pushed anyway
+  g_tmr10ms += 150;
+  sensorHistoryWakeup();
+  ASSERT_EQ(1, seconds->count());
+  EXPECT_EQ(10, seconds->get(0)->avg);
+
+  g_tmr10ms += 1000;
+  sensorHistoryWakeup();
+  ASSERT_EQ(11, seconds->count());
+  EXPECT_TRUE(seconds->get(10)->isEmpty());
+  ASSERT_EQ(1, tens->count());
+  EXPECT_EQ(10, tens->get(0)->avg);
+
+  // nothing more within the same period
+  sensorHistoryWakeup();
+  EXPECT_EQ(11, seconds->count());
+}
+
+TEST_F(SensorHistoryTest, restartedWhenCleared)
+{
+  auto raw = claim(0, SENSOR_HISTORY_RAW);
+  setValue(0, 10);
+  setValue(0, 20);
+  EXPECT_EQ(2, raw->count());
+
+  telemetryItems[0].clear();
+  setValue(0, 30);
+  ASSERT_EQ(1, raw->count());
+  EXPECT_EQ(30, raw->get(0)->avg);
+}
+
+TEST_F(SensorHistoryTest, slotsRecycledWhenIdle)
+{
+  for (int i = 0; i <= SENSOR_HISTORY_SLOTS; i++) {
+    sensorHistory(i, SENSOR_HISTORY_RAW);
+  }
+  sensorHistoryWakeup();
+  for (int i = 0; i < SENSOR_HISTORY_SLOTS; i++) {
+    EXPECT_NE(nullptr, sensorHistory(i, SENSOR_HISTORY_RAW));
+  }
+  EXPECT_EQ(nullptr, claim(SENSOR_HISTORY_SLOTS, SENSOR_HISTORY_RAW));
+
+  // all read again but the first one
+  g_tmr10ms += SENSOR_HISTORY_IDLE;
+  for (int i = 1; i < SENSOR_HISTORY_SLOTS; i++) {
+    sensorHistory(i, SENSOR_HISTORY_RAW);
+  }
+
+  auto raw = claim(SENSOR_HISTORY_SLOTS, SENSOR_HISTORY_RAW);
+  ASSERT_NE(nullptr, raw);
+  setValue(0, 10);
+  setValue(SENSOR_HISTORY_SLOTS, 20);
+  ASSERT_EQ(1, raw->count());
+  EXPECT_EQ(20, raw->get(0)->avg);
+}
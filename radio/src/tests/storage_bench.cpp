@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <string>
+#include <vector>
+
+#include "gtests.h"
+#include "location.h"
+#include "storage/storage_bench.h"
+
+static void collectResult(const StorageBenchResult& result, void* ctx)
+{
+  ((std::vector<StorageBenchResult>*)ctx)->push_back(result);
+}
+
+class StorageBenchTest : public testing::Test
+{
+ protected:
+  // the workloads write their files: keep them out of the sources
+  void SetUp() override { simuFatfsSetPaths(TESTS_BUILD_PATH, nullptr); }
+  void TearDown() override { simuFatfsSetPaths(TESTS_PATH, nullptr); }
+};
+
+TEST_F(StorageBenchTest, AllWorkloads)
+{
+  std::vector<StorageBenchResult> results;
+  EXPECT_EQ(FR_OK, storageBenchRun("all", collectResult, &results));
+
+  struct {
+    const char* name;
+    uint32_t ops;
+  } expected[] = {
+    {"boot-scan", 30},  {"model-load", 20}, {"model-save", 20},
+    {"log-append", 600}, {"wav-stream", 257}, {"image-load", 64},
+  };
+
+  ASSERT_EQ(DIM(expected), results.size());
+  for (unsigned i = 0; i < DIM(expected); i++) {
+    const auto& r = results[i];
+    EXPECT_STREQ(expected[i].name, r.name);
+    EXPECT_EQ(FR_OK, r.result) << r.name;
+    EXPECT_EQ(expected[i].ops, r.ops) << r.name;
+    EXPECT_LE(r.p50, r.p90) << r.name;
+    EXPECT_LE(r.p90, r.p99) << r.name;
+    EXPECT_LE(r.p99, r.max) << r.name;
+  }
+
+  EXPECT_EQ(20u * 3000, results[1].bytes);
+  EXPECT_EQ(256u * 1024, results[4].bytes);
+
+  // nothing left behind
+  FILINFO fno;
+  EXPECT_NE(FR_OK, f_stat(BENCH_PATH, &fno));
+}
+
+TEST_F(StorageBenchTest, SingleWorkload)
+{
+  std::vector<StorageBenchResult> results;
+  EXPECT_EQ(FR_OK, storageBenchRun("log", collectResult, &results));
+  ASSERT_EQ(1u, results.size());
+  EXPECT_STREQ("log-append", results[0].name);
+
+  char line[160];
+  storageBenchFormat(line, sizeof(line), results[0]);
+  EXPECT_EQ(0u, std::string(line).find("log-append  ops:600 "));
+}
+
+TEST_F(StorageBenchTest, UnknownWorkload)
+{
+  std::vector<StorageBenchResult> results;
+  EXPECT_EQ(FR_INVALID_PARAMETER,
+            storageBenchRun("defrag", collectResult, &results));
+  EXPECT_TRUE(results.empty());
+}
+
+TEST_F(StorageBenchTest, KeepsExistingFolder)
+{
+  ASSERT_EQ(FR_OK, f_mkdir(BENCH_PATH));
+  FIL file;
+  ASSERT_EQ(FR_OK, f_open(&file, BENCH_PATH "/user.txt",
+                          FA_CREATE_ALWAYS | FA_WRITE));
+  f_close(&file);
+
+  std::vector<StorageBenchResult> results;
+  EXPECT_EQ(FR_EXIST, storageBenchRun("log", collectResult, &results));
+  EXPECT_TRUE(results.empty());
+
+  FILINFO fno;
+  EXPECT_EQ(FR_OK, f_stat(BENCH_PATH "/user.txt", &fno));
+  f_unlink(BENCH_PATH "/user.txt");
+  f_unlink(BENCH_PATH);
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <string>
+#include <vector>
+
+#include "gtests.h"
+#include "storage/write_queue.h"
+
+struct WrittenFile {
+  std::string path;
+  std::string data;
+};
+
+static std::vector<WrittenFile> _written;
+static FRESULT _writeResult;
+static uint32_t _now;
+static void (*_duringWrite)() = nullptr;
+
+static FRESULT fakeWriter(const char* path, const char* tmpPath,
+                          const char* data, uint32_t len)
+{
+  _written.push_back({path, std::string(data, len)});
+  if (_duringWrite) _duringWrite();
+  return _writeResult;
+}
+
+static uint32_t fakeClock() { return _now; }
+
+// malloc'ed, as the queue frees it
+static char* snapshot(const char* text) { return strdup(text); }
+
+class WriteQueueTest : public testing::Test
+{
+ protected:
+  StorageWriteQueue queue{fakeWriter, fakeClock};
+
+  void SetUp() override
+  {
+    queue.init();
+    _written.clear();
+    _writeResult = FR_OK;
+    _now = 1000;
+    _duringWrite = nullptr;
+  }
+
+  bool post(StorageWriteSlot slot, const char* path, const char* text)
+  {
+    return queue.post(slot, path, nullptr, snapshot(text), strlen(text));
+  }
+};
+
+TEST_F(WriteQueueTest, writesRadioSettingsFirst)
+{
+  EXPECT_TRUE(post(STORAGE_SLOT_MODEL, "/MODELS/model1.yml", "model"));
+  EXPECT_TRUE(post(STORAGE_SLOT_RADIO, "/RADIO/radio.yml", "radio"));
+  EXPECT_TRUE(queue.pending(STORAGE_SLOT_MODEL));
+  EXPECT_EQ(2, queue.depth());
+
+  _now += 20;
+  queue.process();
+
+  ASSERT_EQ(2u, _written.size());
+  EXPECT_EQ("radio", _written[0].data);
+  EXPECT_EQ("/MODELS/model1.yml", _written[1].path);
+  EXPECT_FALSE(queue.pending());
+  EXPECT_EQ(STORAGE_WRITE_DONE, queue.takeResult(STORAGE_SLOT_MODEL));
+  EXPECT_EQ(STORAGE_WRITE_NONE, queue.takeResult(STORAGE_SLOT_MODEL));
+  EXPECT_EQ(2u, queue.stats().writes);
+  EXPECT_EQ(20u, queue.stats().lastLatency);
+}
+
+TEST_F(WriteQueueTest, coalescesSnapshots)
+{
+  EXPECT_TRUE(post(STORAGE_SLOT_MODEL, "/MODELS/model1.yml", "first"));
+  EXPECT_TRUE(post(STORAGE_SLOT_MODEL, "/MODELS/model1.yml", "second"));
+
+  // another file: the caller has to post it again later
+  EXPECT_TRUE(queue.accepts(STORAGE_SLOT_MODEL, "/MODELS/model1.yml"));
+  EXPECT_FALSE(queue.accepts(STORAGE_SLOT_MODEL, "/MODELS/model2.yml"));
+  char* other = snapshot("other");
+  EXPECT_FALSE(queue.post(STORAGE_SLOT_MODEL, "/MODELS/model2.yml", nullptr,
+                          other, 5));
+  free(other);
+
+  queue.process();
+  ASSERT_EQ(1u, _written.size());
+  EXPECT_EQ("second", _written[0].data);
+  EXPECT_EQ(1u, queue.stats().coalesced);
+  EXPECT_TRUE(queue.accepts(STORAGE_SLOT_MODEL, "/MODELS/model2.yml"));
+}
+
+TEST_F(WriteQueueTest, givesUpAfterRetries)
+{
+  _writeResult = FR_DISK_ERR;
+  EXPECT_TRUE(post(STORAGE_SLOT_MODEL, "/MODELS/model1.yml", "model"));
+
+  queue.process();
+  EXPECT_EQ(1u, _written.size());
+  EXPECT_TRUE(queue.pending(STORAGE_SLOT_MODEL));
+
+  // not retried before the delay
+  _now += STORAGE_WRITE_RETRY_DELAY - 1;
+  queue.process();
+  EXPECT_EQ(1u, _written.size());
+
+  for (int i = 0; i < STORAGE_WRITE_RETRIES; i++) {
+    EXPECT_EQ(STORAGE_WRITE_NONE, queue.takeResult(STORAGE_SLOT_MODEL));
+    _now += STORAGE_WRITE_RETRY_DELAY;
+    queue.process();
+  }
+
+  EXPECT_EQ(1u + STORAGE_WRITE_RETRIES, _written.size());
+  EXPECT_FALSE(queue.pending());
+  EXPECT_EQ(STORAGE_WRITE_FAILED, queue.takeResult(STORAGE_SLOT_MODEL));
+  EXPECT_EQ(STORAGE_WRITE_NONE, queue.takeResult(STORAGE_SLOT_MODEL));
+  EXPECT_EQ(1u + STORAGE_WRITE_RETRIES, queue.stats().errors);
+  EXPECT_EQ(1u, queue.stats().failed);
+
+  // nothing left to retry
+  _now += STORAGE_WRITE_RETRY_DELAY;
+  queue.process();
+  EXPECT_EQ(1u + STORAGE_WRITE_RETRIES, _written.size());
+}
+
+static StorageWriteQueue* _queue;
+
+TEST_F(WriteQueueTest, newerSnapshotReplacesFailedOne)
+{
+  _writeResult = FR_DISK_ERR;
+  EXPECT_TRUE(post(STORAGE_SLOT_MODEL, "/MODELS/model1.yml", "old"));
+
+  // posted while the old one is being written
+  _queue = &queue;
+  _duringWrite = []() {
+    _duringWrite = nullptr;
+    EXPECT_TRUE(_queue->pending(STORAGE_SLOT_MODEL));
+    char* data = snapshot("new");
+    EXPECT_TRUE(_queue->post(STORAGE_SLOT_MODEL, "/MODELS/model1.yml",
+                             nullptr, data, 3));
+  };
+  queue.process();
+  EXPECT_EQ(STORAGE_WRITE_NONE, queue.takeResult(STORAGE_SLOT_MODEL));
+
+  // written right away, not after the retry delay
+  _writeResult = FR_OK;
+  queue.process();
+  ASSERT_EQ(2u, _written.size());
+  EXPECT_EQ("new", _written[1].data);
+  EXPECT_EQ(STORAGE_WRITE_DONE, queue.takeResult(STORAGE_SLOT_MODEL));
+  EXPECT_EQ(0u, queue.stats().failed);
+}
@@ -519,6 +519,7 @@
 #define TR_CV                          "曲线"
 #define TR_GV                          TR("G", "GV")
 #define TR_RANGE                       "范围"
+#define TR_GAUGE_RANGE                 "显示范围"
 #define TR_CENTER                      "中点"
 #define TR_ALARM                       "报警"
 #define TR_BLADES                      "Blades/Poles"
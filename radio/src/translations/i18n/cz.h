@@ -521,6 +521,7 @@
 #define TR_CV                          "K"
 #define TR_GV                          TR("G", "GP")
 #define TR_RANGE                       "Rozsah"
+#define TR_GAUGE_RANGE                 "Zobrazit rozsah"
 #define TR_CENTER                      "Střed"
 #define TR_ALARM                       "Alarm"
 #define TR_BLADES                      TR("ListyVrt", "Listy vrtule")
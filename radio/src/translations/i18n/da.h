@@ -523,6 +523,7 @@
 #define TR_GV                          TR("G", "GV")
 
 #define TR_RANGE                       TR("Max ned/op", "Max synke/stige")
+#define TR_GAUGE_RANGE                 "Vis interval"
 #define TR_CENTER                      TR("Min ned/op", "Min synke/stige")
 
 #define TR_ALARM                       "Alarm"
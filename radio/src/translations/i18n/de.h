@@ -521,6 +521,7 @@
 #define TR_CV                          "KV"
 #define TR_GV                          TR("G", "GV")
 #define TR_RANGE                       TR("Bereich", "Variobereich m/s")
+#define TR_GAUGE_RANGE                 "Bereich anzeigen"
 #define TR_CENTER                      TR("Mitte", "Variomitte     m/s")
 #define TR_ALARM                       "Alarme"
 #define TR_BLADES                      TR("Prop", "Prop-Blätter")
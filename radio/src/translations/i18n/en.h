@@ -520,6 +520,7 @@
 #define TR_CV                          "CV"
 #define TR_GV                          TR("G", "GV")
 #define TR_RANGE                       "Range"
+#define TR_GAUGE_RANGE                 "Show range"
 #define TR_CENTER                      "Center"
 #define TR_ALARM                       "Alarm"
 #define TR_BLADES                      "Blades/Poles"
@@ -518,6 +518,7 @@
 #define TR_CV                  "CV"
 #define TR_GV                  TR("G", "GV")
 #define TR_RANGE               "Alcance"
+#define TR_GAUGE_RANGE         "Mostrar rango"
 #define TR_CENTER              "Centro"
 #define TR_ALARM               "Alarma"
 #define TR_BLADES              "Palas"
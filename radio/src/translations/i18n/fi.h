@@ -519,6 +519,7 @@
 #define TR_CV                          "CV"
 #define TR_GV                          TR("G", "GV")
 #define TR_RANGE                       "Range"
+#define TR_GAUGE_RANGE                 "Näytä vaihteluväli"
 #define TR_CENTER                      "Center"
 #define TR_ALARM                       "Alarm"
 #define TR_BLADES                      "Blades/Poles"
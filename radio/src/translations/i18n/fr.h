@@ -522,6 +522,7 @@
 #define TR_CV                          "CV"
 #define TR_GV                          TR("G", "VG")
 #define TR_RANGE                       "Plage"
+#define TR_GAUGE_RANGE                 "Afficher plage"
 #define TR_CENTER                      "Centre"
 #define TR_ALARM                       "Alarme"
 #define TR_BLADES                      "Pales/Poles"
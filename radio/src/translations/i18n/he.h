@@ -523,6 +523,7 @@
 #define TR_CV                          "CV"
 #define TR_GV                          TR("G", "GV")
 #define TR_RANGE                       "טווח"
+#define TR_GAUGE_RANGE                 "הצג טווח"
 #define TR_CENTER                      "מרכז"
 #define TR_ALARM                       "התראה"
 #define TR_BLADES                      "Blades/Poles"
@@ -520,6 +520,7 @@
 #define TR_CV                           "CV"
 #define TR_GV                           TR("G", "GV")
 #define TR_RANGE                        TR("Inter.", "Intervallo")
+#define TR_GAUGE_RANGE                  "Mostra intervallo"
 #define TR_CENTER                       "Centro"
 #define TR_ALARM                        TR( "Allar.",  "Allarme")
 #define TR_BLADES                       "Pale"
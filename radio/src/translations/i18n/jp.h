@@ -519,6 +519,7 @@
 #define TR_CV                          "CV"
 #define TR_GV                          TR("G", "GV")
 #define TR_RANGE                       "範囲"
+#define TR_GAUGE_RANGE                 "範囲を表示"
 #define TR_CENTER                      "中央値"
 #define TR_ALARM                       "アラーム"
 #define TR_BLADES                      "ブレード/ポール"
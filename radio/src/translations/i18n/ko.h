@@ -525,6 +525,7 @@
 #define TR_CV                             "CV"
 #define TR_GV                             TR("G", "GV")
 #define TR_RANGE                          "범위"
+#define TR_GAUGE_RANGE                    "범위 표시"
 #define TR_CENTER                         "중앙"
 #define TR_ALARM                          "알람"
 #define TR_BLADES                         "블레이드/극수"
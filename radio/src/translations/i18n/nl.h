@@ -520,6 +520,7 @@
 #define TR_CV                  "CV"
 #define TR_GV                  TR("G", "GV")
 #define TR_RANGE               "Bereik"
+#define TR_GAUGE_RANGE         "Toon bereik"
 #define TR_CENTER              "Centreer"
 #define TR_ALARM               "Alarm"
 #define TR_BLADES              "Bladen"
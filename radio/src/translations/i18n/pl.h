@@ -519,6 +519,7 @@
 #define TR_CV                  "Kr"
 #define TR_GV                  TR("G", "ZG")
 #define TR_RANGE               "Zakres"
+#define TR_GAUGE_RANGE         "Pokaż zakres"
 #define TR_CENTER              "Środek"
 #define TR_ALARM               "Alarm"
 #define TR_BLADES              "Łopaty śmigla"
@@ -519,6 +519,7 @@
 #define TR_CV                          "CV"
 #define TR_GV                          TR("G", "GV")
 #define TR_RANGE                       "Alcance"
+#define TR_GAUGE_RANGE                 "Mostrar faixa"
 #define TR_CENTER                      "Centro"
 #define TR_ALARM                       "Alarme"
 #define TR_BLADES                      "Lâminas/Pás"
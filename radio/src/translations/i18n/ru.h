@@ -522,6 +522,7 @@
 #define TR_CV                          "CV"
 #define TR_GV                          TR("G", "GV")
 #define TR_RANGE                       "Диапаз"
+#define TR_GAUGE_RANGE                 "Показать диапазон"
 #define TR_CENTER                      "Центр"
 #define TR_ALARM                       "Сигнал тревоги"
 #define TR_BLADES                      "Blades/Poles"
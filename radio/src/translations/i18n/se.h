@@ -523,6 +523,7 @@
 #define TR_CV                           "KU"
 #define TR_GV                           TR("G","GV")
 #define TR_RANGE                        "MinMax"
+#define TR_GAUGE_RANGE                  "Visa intervall"
 #define TR_CENTER                       "Center"
 #define TR_ALARM                        "Alarm"
 #define TR_BLADES                       "Blad"
@@ -517,6 +517,7 @@
 #define TR_CV                          "曲線"
 #define TR_GV                          TR("G", "GV")
 #define TR_RANGE                       "範圍"
+#define TR_GAUGE_RANGE                 "顯示範圍"
 #define TR_CENTER                      "中點"
 #define TR_ALARM                       "報警"
 #define TR_BLADES                      "Blades/Poles"
@@ -521,6 +521,7 @@
 #define TR_CV                          "CV"
 #define TR_GV                          TR("G", "GV")
 #define TR_RANGE                       "Діапаз."
+#define TR_GAUGE_RANGE                 "Показати діапазон"
 #define TR_CENTER                      "Центр"
 #define TR_ALARM                       "Тривога"
 #define TR_BLADES                      "Леза/Піни"	/*need to be clarified by context*/
@@ -825,6 +825,7 @@
 #define STR_RADIO_SETUP currentLangStrings->STR_RADIO_SETUP
 #define STR_RANGE_TEST currentLangStrings->STR_RANGE_TEST
 #define STR_RANGE currentLangStrings->STR_RANGE
+#define STR_GAUGE_RANGE currentLangStrings->STR_GAUGE_RANGE
 #define STR_RATIO currentLangStrings->STR_RATIO
 #define STR_RECEIVER_DELETE currentLangStrings->STR_RECEIVER_DELETE
 #define STR_RECEIVER_OPTIONS currentLangStrings->STR_RECEIVER_OPTIONS
@@ -821,6 +821,7 @@ STR(RADIO_MENU_TABS)
 STR(RADIO_SETUP)
 STR(RANGE_TEST)
 STR(RANGE)
+STR(GAUGE_RANGE)
 STR(RATIO)
 STR(RECEIVER_DELETE)
 STR(RECEIVER_OPTIONS)